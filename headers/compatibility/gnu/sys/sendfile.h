@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * The Linux sendfile() interface.
+ */
+#ifndef _GNU_SYS_SENDFILE_H
+#define _GNU_SYS_SENDFILE_H
+
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+
+__BEGIN_DECLS
+
+
+ssize_t	sendfile(int outFD, int inFD, off_t* offset, size_t count);
+
+
+__END_DECLS
+
+
+#endif	/* _GNU_SYS_SENDFILE_H */
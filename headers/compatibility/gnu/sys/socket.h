@@ -0,0 +1,35 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _GNU_SYS_SOCKET_H
+#define _GNU_SYS_SOCKET_H
+
+
+#include_next <sys/socket.h>
+
+
+#ifdef _GNU_SOURCE
+
+
+#include <time.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int		recvmmsg(int socket, struct mmsghdr* messages, unsigned int count,
+			int flags, struct timespec* timeout);
+int		sendmmsg(int socket, struct mmsghdr* messages, unsigned int count,
+			int flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
+
+
+#endif	/* _GNU_SYS_SOCKET_H */
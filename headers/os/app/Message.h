@@ -546,8 +546,12 @@ private:
 
 			void				_UpdateOffsets(uint32 offset, int32 change);
 			status_t			_ResizeData(uint32 offset, int32 change);
+			status_t			_ReallocateFields(uint32 count);
+			status_t			_ReallocateData(size_t size);
+			void				_FreeFieldsAndData();
 
-			uint32				_HashName(const char* name) const;
+			uint32				_HashName(const char* name,
+									size_t* _length = NULL) const;
 			status_t			_FindField(const char* name, type_code type,
 									field_header** _result) const;
 			status_t			_AddField(const char* name, type_code type,
@@ -659,6 +659,41 @@ extern ssize_t		wait_for_objects(object_wait_info* infos, int numInfos);
 extern ssize_t		wait_for_objects_etc(object_wait_info* infos, int numInfos,
 						uint32 flags, bigtime_t timeout);
 
+/* Event queues keep the objects registered across waits, and only report
+   the ones that changed state, so that waiting does not get more expensive
+   with the number of objects watched.
+   By default, an event is reported once whenever it occurs (edge-triggered):
+   after B_EVENT_READ has been reported for a socket, it is only reported
+   again once more data has arrived, so the socket should be read until it
+   would block. With B_EVENT_LEVEL_TRIGGERED, the event is reported for as
+   long as the condition holds, and with B_EVENT_ONE_SHOT, the object is
+   removed from the queue after its first event.
+   event_queue_select() applies several changes at once: an
+   event_wait_info::events value > 0 adds or changes the object, 0 removes
+   it, and -1 retrieves its current selection. If any change failed,
+   B_ERROR is returned, and the events field of the failed entries is set
+   to the error code. */
+
+enum {
+	B_EVENT_LEVEL_TRIGGERED		= (1 << 26),	/* Event is level-triggered,
+												   not edge-triggered */
+	B_EVENT_ONE_SHOT			= (1 << 27),	/* Delete event after
+												   delivery */
+};
+
+typedef struct event_wait_info {
+	int32		object;						/* ID of the object */
+	uint16		type;						/* type of the object */
+	int32		events;						/* events mask */
+	void*		user_data;					/* passed back with the events */
+} event_wait_info;
+
+extern int			create_event_queue(uint32 openFlags);
+extern status_t		event_queue_select(int queue, event_wait_info* infos,
+						int numInfos);
+extern ssize_t		event_queue_wait(int queue, event_wait_info* infos,
+						int numInfos, uint32 flags, bigtime_t timeout);
+
 
 #ifdef __cplusplus
 }
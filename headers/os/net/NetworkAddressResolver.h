@@ -1,5 +1,5 @@
 /*
- * Copyright 2010-2017, Haiku, Inc. All Rights Reserved.
+ * Copyright 2010-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  */
 #ifndef _NETWORK_ADDRESS_RESOLVER_H
@@ -13,6 +13,7 @@
 #include <SupportDefs.h>
 
 
+class BMessenger;
 class BNetworkAddress;
 struct addrinfo;
 
@@ -23,6 +24,11 @@ enum {
 	B_UNCONFIGURED_ADDRESS_FAMILIES	= 0x0002,
 };
 
+// message sent by BNetworkAddressResolver::ResolveAsync()
+enum {
+	B_NETWORK_ADDRESS_RESOLVED		= '_NAR',
+};
+
 
 class BNetworkAddressResolver: public BReferenceable {
 public:
@@ -73,6 +79,18 @@ public:
 									const char* address, uint16 port = 0,
 									uint32 flags = 0);
 
+	static	status_t			ResolveAsync(int family, const char* address,
+									const char* service, uint32 flags,
+									const BMessenger& target,
+									uint32 what = B_NETWORK_ADDRESS_RESOLVED);
+	static	status_t			ResolveAsync(int family, const char* address,
+									uint16 port, uint32 flags,
+									const BMessenger& target,
+									uint32 what = B_NETWORK_ADDRESS_RESOLVED);
+
+private:
+	static	status_t			_ResolveThread(void* data);
+
 private:
 			addrinfo*			fInfo;
 			status_t			fStatus;
@@ -80,12 +98,13 @@ private:
 
 	struct CacheEntry {
 		CacheEntry(int family, const char* address, const char* service,
-			uint32 flags, BNetworkAddressResolver* resolver)
+			uint32 flags, BNetworkAddressResolver* resolver, bigtime_t created)
 			:
 			fFamily(family),
 			fAddress(address),
 			fService(service),
 			fFlags(flags),
+			fCreated(created),
 			fResolver(resolver, false)
 		{
 		}
@@ -100,6 +119,7 @@ private:
 		BString fAddress;
 		BString fService;
 		uint32 fFlags;
+		bigtime_t fCreated;
 
 		BReference<const BNetworkAddressResolver> fResolver;
 	};
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SUPPORT_EVENT_LOOP_H_
+#define _SUPPORT_EVENT_LOOP_H_
+
+
+#include <OS.h>
+
+
+namespace BSupportKit {
+
+
+class BEventLoop;
+
+
+struct BEventListener {
+	virtual						~BEventListener();
+
+	virtual	void				EventsReceived(BEventLoop* loop, int32 object,
+									uint16 type, int32 events) = 0;
+};
+
+
+class BEventLoop {
+public:
+								BEventLoop();
+	virtual						~BEventLoop();
+
+			status_t			InitCheck() const;
+
+			status_t			Watch(int32 object, uint16 type, int32 events,
+									BEventListener* listener);
+			status_t			WatchFile(int fd, int32 events,
+									BEventListener* listener);
+			status_t			Unwatch(int32 object, uint16 type);
+			status_t			UnwatchFile(int fd);
+
+			status_t			ApplyChanges();
+
+			ssize_t				Dispatch(
+									bigtime_t timeout = B_INFINITE_TIMEOUT);
+			status_t			Run();
+			void				Quit();
+
+private:
+			status_t			_AddChange(int32 object, uint16 type,
+									int32 events, BEventListener* listener);
+
+private:
+			int					fQueue;
+			sem_id				fQuitSemaphore;
+			bool				fQuitting;
+
+			event_wait_info*	fChanges;
+			int32				fChangeCount;
+			int32				fChangeCapacity;
+
+			event_wait_info*	fEvents;
+			int32				fEventCount;
+			int32				fEventIndex;
+
+			uint32				_reserved[4];
+};
+
+
+}	// namespace BSupportKit
+
+
+#endif // _SUPPORT_EVENT_LOOP_H_
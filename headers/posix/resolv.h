@@ -157,6 +157,7 @@ typedef struct __res_state *res_state;
 #define RES_USE_DNSSEC	(1 << 21)	/* use DNSSEC using OK bit in OPT */
 
 #define RES_USE_INET4	(1 << 23)	/* use IPv4 in gethostbyname() */
+#define RES_NOCACHE		(1 << 24)	/* do not use the answer cache */
 
 /* KAME extensions: use higher bit to avoid conflict with ISC use */
 #define RES_USE_EDNS0	0x40000000	/* use EDNS0 if configured */
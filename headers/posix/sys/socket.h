@@ -109,6 +109,12 @@ struct msghdr {
 	int			msg_flags;		/* flags */
 };
 
+/* used by recvmmsg() and sendmmsg() */
+struct mmsghdr {
+	struct msghdr	msg_hdr;	/* the message */
+	unsigned int	msg_len;	/* number of bytes transferred */
+};
+
 /* Flags for the msghdr.msg_flags field */
 #define MSG_OOB			0x0001	/* process out-of-band data */
 #define MSG_PEEK		0x0002	/* peek at incoming message */
@@ -122,6 +128,7 @@ struct msghdr {
 #define MSG_MCAST		0x0200	/* this message rec'd as multicast */
 #define	MSG_EOF			0x0400	/* data completes connection */
 #define MSG_NOSIGNAL	0x0800	/* don't raise SIGPIPE if socket is closed */
+#define MSG_WAITFORONE	0x1000	/* recvmmsg(): only wait for the first message */
 
 struct cmsghdr {
 	socklen_t	cmsg_len;
@@ -40,12 +40,17 @@ class LinkSender {
 			return Attach(&data, sizeof(Type));
 		}
 
+		uint32 MessageCount() const { return fMessageCount; }
+		uint32 FlushCount() const { return fFlushCount; }
+
 	protected:
 		size_t SpaceLeft() const { return fBufferSize - fCurrentEnd; }
 		size_t CurrentMessageSize() const { return fCurrentEnd - fCurrentStart; }
 
 		status_t AdjustBuffer(size_t newBufferSize, char **_oldBuffer = NULL);
 		status_t FlushCompleted(size_t newBufferSize);
+		status_t GrowBuffer(size_t newBufferSize);
+		void UpdateBatchSize();
 
 		port_id	fPort;
 		team_id fTargetTeam;
@@ -57,6 +62,11 @@ class LinkSender {
 		uint32	fCurrentStart;		// start of current message
 
 		status_t fCurrentStatus;
+
+		size_t	fBatchSize;			// buffer fill level that triggers a flush
+		bigtime_t fLastFlush;
+		uint32	fMessageCount;
+		uint32	fFlushCount;
 };
 
 
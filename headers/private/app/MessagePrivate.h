@@ -19,6 +19,16 @@
 #define MAX_DATA_PREALLOCATION			B_PAGE_SIZE * 10
 #define MAX_FIELD_PREALLOCATION			50
 
+// Small messages keep their fields and data in the same allocation as the
+// message header, see BMessage::_ReallocateFields()/_ReallocateData().
+#define MESSAGE_INLINE_FIELD_COUNT		4
+#define MESSAGE_INLINE_DATA_SIZE		256
+
+// Messages with more data than this are not pushed through the port, but
+// passed in an area that is transferred to the receiving team, see
+// BMessage::_FlattenToArea().
+#define MESSAGE_AREA_THRESHOLD			(B_PAGE_SIZE * 10)
+
 
 static const int32 kPortMessageCode = 'pjpp';
 
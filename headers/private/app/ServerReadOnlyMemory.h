@@ -22,6 +22,8 @@ static const int32 kColorWhichCount = kColorWhichLastContinuous + 3;
 
 struct server_read_only_memory {
 	rgb_color	colors[kColorWhichCount];
+	int32		font_generation;
+		// changes whenever text measurements may change, see BFont
 };
 
 
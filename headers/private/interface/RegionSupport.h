@@ -77,7 +77,26 @@ class BRegion::Support {
 	static	int					XRectInRegion(const BRegion* region,
 									const clipping_rect& rect);
 
+	static	int					FindBand(const BRegion* region, int y);
+
+	static	bool				IncludeRect(BRegion* region,
+									const clipping_rect& rect);
+	static	bool				ExcludeRect(BRegion* region,
+									const clipping_rect& rect);
+	static	void				IntersectWithRect(BRegion* region,
+									const clipping_rect& rect);
+
  private:
+	static	bool				_BandsCoalesce(const clipping_rect* data,
+									int previousBand, int bandStart,
+									int bandEnd);
+	static	bool				_AppendBand(BRegion* region,
+									const clipping_rect& rect);
+	static	bool				_AppendToLastBand(BRegion* region,
+									const clipping_rect& rect);
+	static	bool				_PrependBand(BRegion* region,
+									const clipping_rect& rect);
+
 	static	BRegion*			CreateRegion();
 	static	void				DestroyRegion(BRegion* r);
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _STRING_WIDTH_CACHE_H
+#define _STRING_WIDTH_CACHE_H
+
+
+#include <string.h>
+
+#include <SupportDefs.h>
+
+
+namespace BPrivate {
+
+
+/*!	A small direct mapped cache for the widths of short strings, used by the
+	app_server per font cache entry, and by BFont for the whole team.
+
+	\a Key describes everything besides the string that the width depends
+	on. It must be a plain struct with a Hash() method and operator==.
+
+	The cache never blocks: when another thread is using it at the same time,
+	lookups just miss and new widths are not stored.
+*/
+template<typename Key, int32 kSlotCount>
+class StringWidthCache {
+public:
+	enum {
+		kMaxStringLength = 47
+	};
+
+	StringWidthCache()
+		:
+		fBusy(0)
+	{
+		memset(fSlots, 0, sizeof(fSlots));
+	}
+
+	bool Lookup(const Key& key, const char* string, int32 length,
+		float& _width)
+	{
+		if (length <= 0 || length > kMaxStringLength)
+			return false;
+
+		uint32 hash = _Hash(key, string, length);
+		if (atomic_test_and_set(&fBusy, 1, 0) != 0)
+			return false;
+
+		const Slot& slot = fSlots[hash % kSlotCount];
+		bool found = slot.hash == hash && slot.length == length
+			&& slot.key == key && memcmp(slot.string, string, length) == 0;
+		if (found)
+			_width = slot.width;
+
+		atomic_set(&fBusy, 0);
+		return found;
+	}
+
+	void Store(const Key& key, const char* string, int32 length, float width)
+	{
+		if (length <= 0 || length > kMaxStringLength)
+			return;
+
+		uint32 hash = _Hash(key, string, length);
+		if (atomic_test_and_set(&fBusy, 1, 0) != 0)
+			return;
+
+		Slot& slot = fSlots[hash % kSlotCount];
+		slot.key = key;
+		slot.width = width;
+		slot.hash = hash;
+		slot.length = length;
+		memcpy(slot.string, string, length);
+
+		atomic_set(&fBusy, 0);
+	}
+
+private:
+	struct Slot {
+		Key		key;
+		float	width;
+		uint32	hash;
+		uint8	length;
+		char	string[kMaxStringLength];
+	};
+
+	static uint32 _Hash(const Key& key, const char* string, int32 length)
+	{
+		// FNV-1a over the string, seeded with the key
+		uint32 hash = 2166136261UL ^ key.Hash();
+		for (int32 i = 0; i < length; i++) {
+			hash ^= (uint8)string[i];
+			hash *= 16777619UL;
+		}
+		return hash;
+	}
+
+private:
+	int32	fBusy;
+	Slot	fSlots[kSlotCount];
+};
+
+
+}	// namespace BPrivate
+
+
+using BPrivate::StringWidthCache;
+
+
+#endif	// _STRING_WIDTH_CACHE_H
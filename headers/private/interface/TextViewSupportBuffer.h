@@ -26,6 +26,9 @@ virtual			~_BTextViewSupportBuffer_();
 
 		int32	ItemCount() const;
 
+private:
+		int32	_SlackFor(int32 logSize) const;
+
 protected:
 		int32	fExtraCount;
 		int32	fItemCount;
@@ -68,7 +71,7 @@ _BTextViewSupportBuffer_<T>::InsertItemsAt(int32 inNumItems,
 	int32 delta = inNumItems * sizeof(T);
 	int32 logSize = fItemCount * sizeof(T);
 	if ((logSize + delta) >= fBufferCount) {
-		fBufferCount = logSize + delta + (fExtraCount * sizeof(T));
+		fBufferCount = logSize + delta + _SlackFor(logSize + delta);
 		fBuffer = (T*)realloc((void*)fBuffer, fBufferCount);
 		if (fBuffer == NULL)
 			debugger("InsertItemsAt(): reallocation failed");
@@ -100,9 +103,11 @@ _BTextViewSupportBuffer_<T>::RemoveItemsAt(int32 inNumItems,
 
 	int32 delta = inNumItems * sizeof(T);
 	int32 logSize = fItemCount * sizeof(T);
-	uint32 extraSize = fBufferCount - (logSize - delta);
-	if (extraSize > (fExtraCount * sizeof(T))) {
-		fBufferCount = (logSize - delta) + (fExtraCount * sizeof(T));
+	int32 extraSize = fBufferCount - (logSize - delta);
+	if (extraSize > 2 * _SlackFor(logSize - delta)) {
+		// only shrink when a lot of space is unused, so that removing and
+		// adding single items doesn't realloc every time
+		fBufferCount = (logSize - delta) + _SlackFor(logSize - delta);
 		fBuffer = (T*)realloc(fBuffer, fBufferCount);
 		if (fBuffer == NULL)
 			debugger("RemoveItemsAt(): reallocation failed");
@@ -120,4 +125,18 @@ _BTextViewSupportBuffer_<T>::ItemCount() const
 }
 
 
+/*!	Returns the number of bytes to keep allocated beyond \a logSize bytes
+	of items. The slack grows with the buffer, so that building up large
+	buffers item by item, like the line breaks of a large text, takes
+	amortized constant time per item.
+*/
+template<class T>
+inline int32
+_BTextViewSupportBuffer_<T>::_SlackFor(int32 logSize) const
+{
+	int32 minimum = fExtraCount * sizeof(T);
+	return logSize / 2 > minimum ? logSize / 2 : minimum;
+}
+
+
 #endif // __TEXT_VIEW_SUPPORT_BUFFER__H__
@@ -50,11 +50,14 @@ private:
 			float				HashEscapements(const char* chars,
 									int32 numChars, int32 numBytes,
 									int32 tableIndex, const BFont* font);
+			void				InsertEscapement(uint32 value,
+									float escapement, int32 tableIndex);
 
 	static	uint32				Hash(uint32);
 
 private:
 			BLocker				fLock;
+			int32				fLastTableIndex;
 };
 
 
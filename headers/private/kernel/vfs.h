@@ -244,6 +244,7 @@ ssize_t		_user_readv(int fd, off_t pos, const iovec *vecs, size_t count);
 ssize_t		_user_write(int fd, off_t pos, const void *buffer,
 				size_t bufferSize);
 ssize_t		_user_writev(int fd, off_t pos, const iovec *vecs, size_t count);
+ssize_t		_user_sendfile(int outFD, int inFD, off_t *offset, size_t count);
 status_t	_user_ioctl(int fd, uint32 cmd, void *data, size_t length);
 ssize_t		_user_read_dir(int fd, struct dirent *buffer, size_t bufferSize,
 				uint32 maxCount);
@@ -269,10 +270,14 @@ ssize_t		_user_recv(int socket, void *data, size_t length, int flags);
 ssize_t		_user_recvfrom(int socket, void *data, size_t length, int flags,
 				struct sockaddr *address, socklen_t *_addressLength);
 ssize_t		_user_recvmsg(int socket, struct msghdr *message, int flags);
+ssize_t		_user_recvmmsg(int socket, struct mmsghdr *messages, uint32 count,
+				int flags, bigtime_t timeout);
 ssize_t		_user_send(int socket, const void *data, size_t length, int flags);
 ssize_t		_user_sendto(int socket, const void *data, size_t length, int flags,
 				const struct sockaddr *address, socklen_t addressLength);
 ssize_t		_user_sendmsg(int socket, const struct msghdr *message, int flags);
+ssize_t		_user_sendmmsg(int socket, struct mmsghdr *messages, uint32 count,
+				int flags);
 status_t	_user_getsockopt(int socket, int level, int option, void *value,
 				socklen_t *_length);
 status_t	_user_setsockopt(int socket, int level, int option,
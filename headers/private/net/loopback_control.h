@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef LOOPBACK_CONTROL_H
+#define LOOPBACK_CONTROL_H
+
+
+#include <SupportDefs.h>
+
+
+// The loopback device can emulate a slower network, to test how protocols
+// behave with latency and packet loss. The settings are passed in
+// ifreq::ifr_data with SIOCSDRVSPEC, and retrieved with SIOCGDRVSPEC.
+
+#define LOOPBACK_MAX_DELAY		2000000		// 2 secs
+#define LOOPBACK_LOSS_SCALE		1000000		// loss is in parts per million
+
+struct loopback_emulation {
+	uint32	delay;		// in usecs, for each direction
+	uint32	loss;		// share of packets dropped, in parts per million
+};
+
+#endif	// LOOPBACK_CONTROL_H
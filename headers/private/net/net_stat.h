@@ -27,4 +27,14 @@ typedef struct net_stat {
 	size_t	send_queue_size;
 } net_stat;
 
+typedef struct net_buffer_stats {
+	int32	allocated_net_buffers;
+	int32	max_allocated_net_buffers;
+	int64	ever_allocated_net_buffers;
+	int32	allocated_data_headers;
+	int32	max_allocated_data_headers;
+	int64	ever_allocated_data_headers;
+	size_t	data_header_size;
+} net_buffer_stats;
+
 #endif	// NET_STAT_H
@@ -131,7 +131,8 @@ private:
 	struct Data;
 
 			bool				RewindBody() noexcept;
-			void				SerializeHeaderTo(HttpBuffer& buffer) const;
+			void				SerializeHeaderTo(HttpBuffer& buffer,
+									bool keepAlive = false) const;
 
 			std::unique_ptr<Data> fData;
 };
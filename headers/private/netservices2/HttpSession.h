@@ -45,6 +45,14 @@ public:
 			void				SetMaxConnectionsPerHost(size_t maxConnections);
 			void				SetMaxHosts(size_t maxConnections);
 
+	// Connection reuse
+			void				SetMaxIdleConnectionsPerHost(size_t maxConnections);
+			void				SetIdleConnectionTimeout(bigtime_t timeout);
+
+	// Statistics
+	struct Statistics;
+			Statistics			GetStatistics() const;
+
 private:
 	struct Redirect;
 	class Request;
@@ -53,6 +61,16 @@ private:
 };
 
 
+struct BHttpSession::Statistics {
+			size_t				requests = 0;
+			size_t				connectionsOpened = 0;
+			size_t				connectionsReused = 0;
+			size_t				requestsQueued = 0;
+			size_t				requestsRetried = 0;
+			size_t				idleConnections = 0;
+};
+
+
 namespace UrlEvent {
 enum { HttpStatus = '_HST', HttpFields = '_HHF', CertificateError = '_CER', HttpRedirect = '_HRE' };
 }
@@ -6,21 +6,12 @@
 #define _SYSTEM_EVENT_QUEUE_DEFS_H
 
 
-// extends B_EVENT_* constants defined in OS.h
-enum {
-	B_EVENT_LEVEL_TRIGGERED		= (1 << 26),	/* Event is level-triggered, not edge-triggered */
-	B_EVENT_ONE_SHOT			= (1 << 27),	/* Delete event after delivery */
+#include <OS.h>
 
-	/* bits 28 through 30 are reserved for the kernel */
-};
 
-
-typedef struct event_wait_info {
-	int32		object;
-	uint16		type;
-	int32		events;		/* select(): > 0 to select, -1 to get selection, 0 to deselect */
-	void*		user_data;
-} event_wait_info;
+// B_EVENT_LEVEL_TRIGGERED, B_EVENT_ONE_SHOT, and event_wait_info are public
+// now, and defined in OS.h.
+// Bits 28 through 30 of the events are reserved for the kernel.
 
 
 #endif	/* _SYSTEM_EVENT_QUEUE_DEFS_H */
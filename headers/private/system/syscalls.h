@@ -28,6 +28,7 @@ struct fd_info;
 struct fd_set;
 struct fs_info;
 struct iovec;
+struct mmsghdr;
 struct msqid_ds;
 struct net_stat;
 struct pollfd;
@@ -336,6 +337,8 @@ extern ssize_t		_kern_write(int fd, off_t pos, const void *buffer,
 						size_t bufferSize);
 extern ssize_t		_kern_writev(int fd, off_t pos, const struct iovec *vecs,
 						size_t count);
+extern ssize_t		_kern_sendfile(int outFD, int inFD, off_t *offset,
+						size_t count);
 extern status_t		_kern_ioctl(int fd, uint32 cmd, void *data, size_t length);
 extern ssize_t		_kern_read_dir(int fd, struct dirent *buffer,
 						size_t bufferSize, uint32 maxCount);
@@ -371,6 +374,8 @@ extern ssize_t		_kern_recvfrom(int socket, void *data, size_t length,
 						socklen_t *_addressLength);
 extern ssize_t		_kern_recvmsg(int socket, struct msghdr *message,
 						int flags);
+extern ssize_t		_kern_recvmmsg(int socket, struct mmsghdr *messages,
+						uint32 count, int flags, bigtime_t timeout);
 extern ssize_t		_kern_send(int socket, const void *data, size_t length,
 						int flags);
 extern ssize_t		_kern_sendto(int socket, const void *data, size_t length,
@@ -378,6 +383,8 @@ extern ssize_t		_kern_sendto(int socket, const void *data, size_t length,
 						socklen_t addressLength);
 extern ssize_t		_kern_sendmsg(int socket, const struct msghdr *message,
 						int flags);
+extern ssize_t		_kern_sendmmsg(int socket, struct mmsghdr *messages,
+						uint32 count, int flags);
 extern status_t		_kern_getsockopt(int socket, int level, int option,
 						void *value, socklen_t *_length);
 extern status_t		_kern_setsockopt(int socket, int level, int option,
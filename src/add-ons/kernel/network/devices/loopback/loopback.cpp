@@ -7,11 +7,15 @@
  */
 
 
+#include <loopback_control.h>
 #include <net_buffer.h>
 #include <net_device.h>
 #include <net_stack.h>
 
 #include <KernelExport.h>
+#include <lock.h>
+#include <util/AutoLock.h>
+#include <util/DoublyLinkedList.h>
 
 #include <net/if.h>
 #include <net/if_types.h>
@@ -19,9 +23,26 @@
 #include <new>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/sockio.h>
+#include <unistd.h>
 
 
+static const int32 kMaxDelayedBuffers = 4096;
+
+
+struct delayed_buffer : DoublyLinkedListLinkImpl<delayed_buffer> {
+	net_buffer*	buffer;
+	bigtime_t	due;
+};
+
+typedef DoublyLinkedList<delayed_buffer> DelayedBufferList;
+
 struct loopback_device : net_device {
+	mutex				lock;
+	loopback_emulation	emulation;
+	DelayedBufferList	delayed;
+	int32				delayed_count;
+	net_timer			timer;
 };
 
 
@@ -29,6 +50,108 @@ struct net_buffer_module_info *gBufferModule;
 static struct net_stack_module_info *sStackModule;
 
 
+//	#pragma mark - network emulation
+
+
+static void
+loopback_deliver_delayed(net_timer *timer, void *_device)
+{
+	loopback_device *device = (loopback_device *)_device;
+
+	MutexLocker locker(device->lock);
+
+	bigtime_t now = system_time();
+	while (delayed_buffer *delayed = device->delayed.Head()) {
+		if (delayed->due > now) {
+			sStackModule->set_timer(&device->timer, delayed->due - now);
+			break;
+		}
+
+		device->delayed.Remove(delayed);
+		device->delayed_count--;
+
+		if (sStackModule->device_enqueue_buffer(device, delayed->buffer)
+				!= B_OK)
+			gBufferModule->free(delayed->buffer);
+		delete delayed;
+	}
+}
+
+
+static void
+loopback_flush_delayed(loopback_device *device)
+{
+	MutexLocker locker(device->lock);
+
+	while (delayed_buffer *delayed = device->delayed.RemoveHead()) {
+		gBufferModule->free(delayed->buffer);
+		delete delayed;
+	}
+	device->delayed_count = 0;
+
+	locker.Unlock();
+
+	// with the list empty, the timer hook won't set the timer again
+	sStackModule->cancel_timer(&device->timer);
+	sStackModule->wait_for_timer(&device->timer);
+}
+
+
+/*!	Drops or delays \a buffer as the emulation settings ask for. Returns
+	\c false if the buffer should be delivered right away.
+*/
+static bool
+loopback_emulate(loopback_device *device, net_buffer *buffer)
+{
+	uint32 loss = device->emulation.loss;
+	if (loss != 0 && (uint32)rand() % LOOPBACK_LOSS_SCALE < loss) {
+		device->stats.send.dropped++;
+		gBufferModule->free(buffer);
+		return true;
+	}
+
+	bigtime_t delay = device->emulation.delay;
+	if (delay == 0)
+		return false;
+
+	delayed_buffer *delayed = new(std::nothrow) delayed_buffer;
+	if (delayed == NULL) {
+		device->stats.send.dropped++;
+		gBufferModule->free(buffer);
+		return true;
+	}
+
+	delayed->buffer = buffer;
+	delayed->due = system_time() + delay;
+
+	MutexLocker locker(device->lock);
+
+	if (device->delayed_count >= kMaxDelayedBuffers) {
+		// the emulated link is congested
+		locker.Unlock();
+		device->stats.send.dropped++;
+		gBufferModule->free(buffer);
+		delete delayed;
+		return true;
+	}
+
+	// keep the list ordered by due time, even if the delay was lowered
+	delayed_buffer *next = NULL;
+	delayed_buffer *previous = device->delayed.Tail();
+	while (previous != NULL && previous->due > delayed->due) {
+		next = previous;
+		previous = device->delayed.GetPrevious(previous);
+	}
+
+	device->delayed.InsertBefore(next, delayed);
+	device->delayed_count++;
+
+	if (device->delayed.Head() == delayed)
+		sStackModule->set_timer(&device->timer, delay);
+	return true;
+}
+
+
 //	#pragma mark -
 
 
@@ -55,6 +178,10 @@ loopback_init(const char *name, net_device **_device)
 	}
 
 	memset(device, 0, sizeof(loopback_device));
+	new(&device->delayed) DelayedBufferList;
+
+	mutex_init(&device->lock, "loopback emulation");
+	sStackModule->init_timer(&device->timer, loopback_deliver_delayed, device);
 
 	strcpy(device->name, name);
 	device->flags = IFF_LOOPBACK | IFF_LINK;
@@ -78,6 +205,9 @@ loopback_uninit(net_device *_device)
 {
 	loopback_device *device = (loopback_device *)_device;
 
+	loopback_flush_delayed(device);
+	mutex_destroy(&device->lock);
+
 	put_module(NET_STACK_MODULE_NAME);
 	put_module(NET_BUFFER_MODULE_NAME);
 	delete device;
@@ -96,20 +226,64 @@ loopback_up(net_device *device)
 void
 loopback_down(net_device *device)
 {
+	loopback_flush_delayed((loopback_device *)device);
 }
 
 
 status_t
-loopback_control(net_device *device, int32 op, void *argument,
+loopback_control(net_device *_device, int32 op, void *argument,
 	size_t length)
 {
+	loopback_device *device = (loopback_device *)_device;
+
+	switch (op) {
+		case SIOCSDRVSPEC:
+		case SIOCGDRVSPEC:
+		{
+			struct ifreq request;
+			if (user_memcpy(&request, argument, sizeof(request)) != B_OK)
+				return B_BAD_ADDRESS;
+
+			// only root may change how the device behaves
+			if (op == SIOCSDRVSPEC && geteuid() != 0)
+				return B_NOT_ALLOWED;
+
+			loopback_emulation emulation;
+			if (op == SIOCGDRVSPEC) {
+				MutexLocker locker(device->lock);
+				emulation = device->emulation;
+				locker.Unlock();
+
+				return user_memcpy(request.ifr_data, &emulation,
+					sizeof(emulation));
+			}
+
+			if (user_memcpy(&emulation, request.ifr_data, sizeof(emulation))
+					!= B_OK)
+				return B_BAD_ADDRESS;
+			if (emulation.delay > LOOPBACK_MAX_DELAY
+				|| emulation.loss > LOOPBACK_LOSS_SCALE)
+				return B_BAD_VALUE;
+
+			MutexLocker locker(device->lock);
+			device->emulation = emulation;
+			return B_OK;
+		}
+	}
+
 	return B_BAD_VALUE;
 }
 
 
 status_t
-loopback_send_data(net_device *device, net_buffer *buffer)
+loopback_send_data(net_device *_device, net_buffer *buffer)
 {
+	loopback_device *device = (loopback_device *)_device;
+
+	if ((device->emulation.delay != 0 || device->emulation.loss != 0)
+		&& loopback_emulate(device, buffer))
+		return B_OK;
+
 	return sStackModule->device_enqueue_buffer(device, buffer);
 }
 
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "CongestionControl.h"
+
+#include <new>
+#include <string.h>
+
+#include <KernelExport.h>
+
+
+// References:
+//	- RFC 5681 - TCP Congestion Control
+//	- RFC 8312 - CUBIC for Fast Long-Distance Networks
+
+
+// CUBIC uses C = 0.4 and beta = 0.7. The window is computed in integer
+// arithmetic only, with the time in milliseconds:
+//	K^3 = (W_max - cwnd) / MSS / C, in ms^3
+static const uint64 kCubicTimeFactor = 2500000;
+	// 1 / C * 10^9 / 1000, the rest is multiplied in afterwards
+static const int64 kCubicMaxDelta = 1000000;
+	// limits (t - K) to 1000 seconds, so that its cube cannot overflow
+
+
+static uint32
+cube_root(uint64 value)
+{
+	// bitwise integer cube root, see "Hacker's Delight", section 11-2
+	uint64 root = 0;
+	for (int32 shift = 63; shift >= 0; shift -= 3) {
+		root <<= 1;
+		uint64 bit = 3 * root * (root + 1) + 1;
+		if ((value >> shift) >= bit) {
+			value -= bit << shift;
+			root++;
+		}
+	}
+
+	return (uint32)root;
+}
+
+
+CongestionControl::~CongestionControl()
+{
+}
+
+
+//	#pragma mark - NewReno
+
+
+const char*
+NewRenoCongestionControl::Name() const
+{
+	return "newreno";
+}
+
+
+uint32
+NewRenoCongestionControl::Increase(uint32 window, uint32 bytesAcknowledged,
+	uint32 maxSegmentSize, int32 roundTripTime)
+{
+	// grow by about one segment per round trip
+	uint32 increment = maxSegmentSize * maxSegmentSize;
+
+	if (increment < window)
+		increment = 1;
+	else
+		increment /= window;
+
+	return window + increment;
+}
+
+
+uint32
+NewRenoCongestionControl::Decrease(uint32 window, uint32 flightSize,
+	uint32 maxSegmentSize)
+{
+	return max_c(flightSize / 2, 2 * maxSegmentSize);
+}
+
+
+//	#pragma mark - CUBIC
+
+
+CubicCongestionControl::CubicCongestionControl()
+	:
+	fMaxWindow(0),
+	fOriginWindow(0),
+	fRenoWindow(0),
+	fRenoAcknowledged(0),
+	fEpochStart(0),
+	fTimeToOrigin(0)
+{
+}
+
+
+const char*
+CubicCongestionControl::Name() const
+{
+	return "cubic";
+}
+
+
+uint32
+CubicCongestionControl::Increase(uint32 window, uint32 bytesAcknowledged,
+	uint32 maxSegmentSize, int32 roundTripTime)
+{
+	bigtime_t now = system_time();
+
+	if (fEpochStart == 0) {
+		// start a new congestion avoidance epoch
+		fEpochStart = now;
+		if (window < fMaxWindow) {
+			fTimeToOrigin = cube_root((uint64)(fMaxWindow - window)
+				* kCubicTimeFactor / maxSegmentSize * 1000);
+			fOriginWindow = fMaxWindow;
+		} else {
+			fTimeToOrigin = 0;
+			fOriginWindow = window;
+		}
+		fRenoWindow = window;
+		fRenoAcknowledged = 0;
+	}
+
+	// W_cubic(t + RTT) = C * (t + RTT - K)^3 + W_max
+	int64 delta = (now - fEpochStart) / 1000 + max_c(roundTripTime, 0)
+		- fTimeToOrigin;
+	delta = max_c(min_c(delta, kCubicMaxDelta), -kCubicMaxDelta);
+
+	int64 target = (int64)fOriginWindow
+		+ delta * delta * delta / 1000000 * 4 * maxSegmentSize / 10000;
+
+	// never grow faster than by half the window per round trip
+	target = min_c(target, (int64)window + window / 2);
+
+	uint32 newWindow = window;
+	if (target > window)
+		newWindow += (uint32)((target - window) * bytesAcknowledged / window);
+
+	// In the TCP friendly region, the window grows at least as fast as the
+	// one of standard TCP would, that is by 3 * (1 - beta) / (1 + beta), or
+	// 9/17 segments per round trip.
+	fRenoAcknowledged += bytesAcknowledged;
+	uint32 perSegment = (uint32)((uint64)fRenoWindow * 17 / 9);
+	if (fRenoAcknowledged >= perSegment) {
+		fRenoWindow += maxSegmentSize;
+		fRenoAcknowledged -= perSegment;
+	}
+
+	return max_c(newWindow, fRenoWindow);
+}
+
+
+uint32
+CubicCongestionControl::Decrease(uint32 window, uint32 flightSize,
+	uint32 maxSegmentSize)
+{
+	fEpochStart = 0;
+
+	// fast convergence: if the window did not reach the previous maximum,
+	// another flow probably joined, so leave it some more room
+	if (window < fMaxWindow)
+		fMaxWindow = (uint32)((uint64)window * 17 / 20);
+	else
+		fMaxWindow = window;
+
+	return max_c((uint32)((uint64)window * 7 / 10), 2 * maxSegmentSize);
+}
+
+
+//	#pragma mark -
+
+
+/*!	Creates the congestion control algorithm with the given name, or the
+	default one if \a name is \c NULL.
+	Returns \c NULL if there is no such algorithm, or not enough memory.
+*/
+CongestionControl*
+create_congestion_control(const char* name)
+{
+	if (name == NULL || strcmp(name, "newreno") == 0)
+		return new(std::nothrow) NewRenoCongestionControl;
+	if (strcmp(name, "cubic") == 0)
+		return new(std::nothrow) CubicCongestionControl;
+
+	return NULL;
+}
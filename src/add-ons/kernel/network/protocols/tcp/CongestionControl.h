@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef CONGESTION_CONTROL_H
+#define CONGESTION_CONTROL_H
+
+
+#include <SupportDefs.h>
+
+
+/*!	The congestion control algorithm of a TCP endpoint decides how the
+	congestion window grows once the slow start threshold has been reached,
+	and how far it is reduced when a loss has been detected. Slow start,
+	fast retransmit, and fast recovery are handled by the endpoint itself.
+
+	All windows are measured in bytes, round trip times in milliseconds.
+*/
+class CongestionControl {
+public:
+	virtual						~CongestionControl();
+
+	virtual	const char*			Name() const = 0;
+
+	virtual	uint32				Increase(uint32 window,
+									uint32 bytesAcknowledged,
+									uint32 maxSegmentSize,
+									int32 roundTripTime) = 0;
+									// returns the new congestion window
+	virtual	uint32				Decrease(uint32 window, uint32 flightSize,
+									uint32 maxSegmentSize) = 0;
+									// returns the new slow start threshold
+};
+
+
+class NewRenoCongestionControl : public CongestionControl {
+public:
+	virtual	const char*			Name() const;
+
+	virtual	uint32				Increase(uint32 window,
+									uint32 bytesAcknowledged,
+									uint32 maxSegmentSize,
+									int32 roundTripTime);
+	virtual	uint32				Decrease(uint32 window, uint32 flightSize,
+									uint32 maxSegmentSize);
+};
+
+
+class CubicCongestionControl : public CongestionControl {
+public:
+								CubicCongestionControl();
+
+	virtual	const char*			Name() const;
+
+	virtual	uint32				Increase(uint32 window,
+									uint32 bytesAcknowledged,
+									uint32 maxSegmentSize,
+									int32 roundTripTime);
+	virtual	uint32				Decrease(uint32 window, uint32 flightSize,
+									uint32 maxSegmentSize);
+
+private:
+			uint32				fMaxWindow;
+			uint32				fOriginWindow;
+			uint32				fRenoWindow;
+			uint32				fRenoAcknowledged;
+			bigtime_t			fEpochStart;
+			int64				fTimeToOrigin;
+};
+
+
+CongestionControl* create_congestion_control(const char* name);
+
+#endif	// CONGESTION_CONTROL_H
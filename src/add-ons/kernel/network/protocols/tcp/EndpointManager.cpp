@@ -11,6 +11,7 @@
 #include "EndpointManager.h"
 
 #include <new>
+#include <string.h>
 #include <unistd.h>
 
 #include <KernelExport.h>
@@ -214,44 +215,171 @@ EndpointHashDefinition::GetLink(TCPEndpoint* endpoint) const
 //	#pragma mark -
 
 
+EndpointManager::ConnectionShard::ConnectionShard(EndpointManager* manager)
+	:
+	table(manager)
+{
+	rw_lock_init(&lock, "TCP connections");
+}
+
+
+EndpointManager::ConnectionShard::~ConnectionShard()
+{
+	rw_lock_destroy(&lock);
+}
+
+
+EndpointManager::PortShard::PortShard()
+{
+	mutex_init(&lock, "TCP ports");
+}
+
+
+EndpointManager::PortShard::~PortShard()
+{
+	mutex_destroy(&lock);
+}
+
+
+//	#pragma mark -
+
+
 EndpointManager::EndpointManager(net_domain* domain)
 	:
 	fDomain(domain),
-	fConnectionHash(this),
 	fLastPort(kFirstEphemeralPort)
 {
-	rw_lock_init(&fLock, "TCP endpoint manager");
+	memset(fConnectionShards, 0, sizeof(fConnectionShards));
+	memset(fPortShards, 0, sizeof(fPortShards));
+	memset(fUsedPorts, 0, sizeof(fUsedPorts));
 }
 
 
 EndpointManager::~EndpointManager()
 {
-	rw_lock_destroy(&fLock);
+	for (uint32 i = 0; i < kConnectionShardCount; i++)
+		delete fConnectionShards[i];
+	for (uint32 i = 0; i < kPortShardCount; i++)
+		delete fPortShards[i];
 }
 
 
 status_t
 EndpointManager::Init()
 {
-	status_t status = fConnectionHash.Init();
-	if (status == B_OK)
-		status = fEndpointHash.Init();
+	for (uint32 i = 0; i < kConnectionShardCount; i++) {
+		fConnectionShards[i] = new(std::nothrow) ConnectionShard(this);
+		if (fConnectionShards[i] == NULL)
+			return B_NO_MEMORY;
 
-	return status;
+		status_t status = fConnectionShards[i]->table.Init();
+		if (status != B_OK)
+			return status;
+	}
+
+	for (uint32 i = 0; i < kPortShardCount; i++) {
+		fPortShards[i] = new(std::nothrow) PortShard;
+		if (fPortShards[i] == NULL)
+			return B_NO_MEMORY;
+
+		status_t status = fPortShards[i]->table.Init();
+		if (status != B_OK)
+			return status;
+	}
+
+	return B_OK;
+}
+
+
+/*!	Returns the shard responsible for the connection between \a local and
+	\a peer. The connection hash itself only mixes the addresses and ports
+	together, so it is scrambled first, to not use the same bits the table
+	in the shard uses.
+*/
+EndpointManager::ConnectionShard&
+EndpointManager::_ConnectionShard(const sockaddr* local,
+	const sockaddr* peer) const
+{
+	uint32 hash = ConstSocketAddress(AddressModule(), local).HashPair(peer);
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3b;
+	hash ^= hash >> 16;
+
+	return *fConnectionShards[hash % kConnectionShardCount];
+}
+
+
+EndpointManager::ConnectionShard&
+EndpointManager::_ConnectionShard(TCPEndpoint* endpoint) const
+{
+	return _ConnectionShard(*endpoint->LocalAddress(),
+		*endpoint->PeerAddress());
+}
+
+
+/*!	Returns the shard responsible for the given \a port, in network byte
+	order. Each group of 64 ports belongs to the same shard, so that the
+	shard's lock also protects the ports' word in the used port bitmap.
+*/
+EndpointManager::PortShard&
+EndpointManager::_PortShard(uint16 port) const
+{
+	return *fPortShards[(ntohs(port) / 64) % kPortShardCount];
+}
+
+
+/*!	Returns whether the \a port, in host byte order, is bound by any endpoint.
+	This may be called without holding the port's lock, and is then only a
+	hint.
+*/
+bool
+EndpointManager::_IsPortUsed(uint16 port) const
+{
+	return (fUsedPorts[port / 64] & ((uint64)1 << (port % 64))) != 0;
+}
+
+
+/*!	You must hold the lock of the port's shard when calling this method. */
+void
+EndpointManager::_SetPortUsed(uint16 port, bool used)
+{
+	if (used)
+		fUsedPorts[port / 64] |= (uint64)1 << (port % 64);
+	else
+		fUsedPorts[port / 64] &= ~((uint64)1 << (port % 64));
 }
 
 
 //	#pragma mark - connections
 
 
-/*!	Returns the endpoint matching the connection.
-	You must hold the manager's lock when calling this method (either read or
-	write).
+/*!	Looks up the connection, and returns its endpoint with a reference to its
+	socket acquired.
 */
 TCPEndpoint*
-EndpointManager::_LookupConnection(const sockaddr* local, const sockaddr* peer)
+EndpointManager::_FindConnection(const sockaddr* local, const sockaddr* peer)
+{
+	ConnectionShard& shard = _ConnectionShard(local, peer);
+	ReadLocker _(shard.lock);
+
+	TCPEndpoint* endpoint = shard.table.Lookup(std::make_pair(local, peer));
+	if (endpoint != NULL && gSocketModule->acquire_socket(endpoint->socket))
+		return endpoint;
+
+	return NULL;
+}
+
+
+/*!	Removes the endpoint from the connection table, if it is in there.
+	Its addresses must not have been changed since it has been inserted.
+*/
+void
+EndpointManager::_RemoveConnection(TCPEndpoint* endpoint)
 {
-	return fConnectionHash.Lookup(std::make_pair(local, peer));
+	ConnectionShard& shard = _ConnectionShard(endpoint);
+	WriteLocker _(shard.lock);
+
+	shard.table.RemoveUnchecked(endpoint);
 }
 
 
@@ -261,8 +389,6 @@ EndpointManager::SetConnection(TCPEndpoint* endpoint, const sockaddr* _local,
 {
 	TRACE(("EndpointManager::SetConnection(%p)\n", endpoint));
 
-	WriteLocker _(fLock);
-
 	SocketAddressStorage local(AddressModule());
 	local.SetTo(_local);
 
@@ -272,14 +398,10 @@ EndpointManager::SetConnection(TCPEndpoint* endpoint, const sockaddr* _local,
 		local.SetPort(port);
 	}
 
-	// We want to create a connection for (local, peer), so check to make sure
-	// that this pair is not already in use by an existing connection.
-	if (_LookupConnection(*local, peer) != NULL)
-		return EADDRINUSE;
-
-	endpoint->LocalAddress().SetTo(*local);
-	endpoint->PeerAddress().SetTo(peer);
-	T(Connect(endpoint));
+	// the endpoints bound to a port are looked at while binding, so their
+	// local address may only change with the port's lock held
+	PortShard& ports = _PortShard(local.Port());
+	MutexLocker portLocker(ports.lock);
 
 	// BOpenHashTable doesn't support inserting duplicate objects. Since
 	// BOpenHashTable is a chained hash table where the items are required to
@@ -289,14 +411,23 @@ EndpointManager::SetConnection(TCPEndpoint* endpoint, const sockaddr* _local,
 	// We need to makes sure to remove any existing copy of this endpoint
 	// object from the table in order to handle calling connect() on a closed
 	// socket to connect to a different remote (address, port) than it was
-	// originally used for.
-	//
-	// We use RemoveUnchecked here because we don't want the hash table to
-	// resize itself after this removal when we are planning to just add
-	// another.
-	fConnectionHash.RemoveUnchecked(endpoint);
+	// originally used for. Since the old connection might be in another
+	// shard, this has to be done before its addresses are changed.
+	_RemoveConnection(endpoint);
+
+	ConnectionShard& shard = _ConnectionShard(*local, peer);
+	WriteLocker _(shard.lock);
+
+	// We want to create a connection for (local, peer), so check to make sure
+	// that this pair is not already in use by an existing connection.
+	if (shard.table.Lookup(std::make_pair(*local, peer)) != NULL)
+		return EADDRINUSE;
+
+	endpoint->LocalAddress().SetTo(*local);
+	endpoint->PeerAddress().SetTo(peer);
+	T(Connect(endpoint));
 
-	fConnectionHash.Insert(endpoint);
+	shard.table.Insert(endpoint);
 	return B_OK;
 }
 
@@ -304,8 +435,6 @@ EndpointManager::SetConnection(TCPEndpoint* endpoint, const sockaddr* _local,
 status_t
 EndpointManager::SetPassive(TCPEndpoint* endpoint)
 {
-	WriteLocker _(fLock);
-
 	if (!endpoint->IsBound()) {
 		// if the socket is unbound first bind it to ephemeral
 		SocketAddressStorage local(AddressModule());
@@ -319,11 +448,17 @@ EndpointManager::SetPassive(TCPEndpoint* endpoint)
 	SocketAddressStorage passive(AddressModule());
 	passive.SetToEmpty();
 
-	if (_LookupConnection(*endpoint->LocalAddress(), *passive))
+	ConnectionShard& shard = _ConnectionShard(*endpoint->LocalAddress(),
+		*passive);
+	WriteLocker _(shard.lock);
+
+	if (shard.table.Lookup(std::make_pair(*endpoint->LocalAddress(),
+			*passive)) != NULL) {
 		return EADDRINUSE;
+	}
 
 	endpoint->PeerAddress().SetTo(*passive);
-	fConnectionHash.Insert(endpoint);
+	shard.table.Insert(endpoint);
 	return B_OK;
 }
 
@@ -331,14 +466,11 @@ EndpointManager::SetPassive(TCPEndpoint* endpoint)
 TCPEndpoint*
 EndpointManager::FindConnection(sockaddr* local, sockaddr* peer)
 {
-	ReadLocker _(fLock);
-
-	TCPEndpoint *endpoint = _LookupConnection(local, peer);
+	TCPEndpoint *endpoint = _FindConnection(local, peer);
 	if (endpoint != NULL) {
 		TRACE(("TCP: Received packet corresponds to explicit endpoint %p\n",
 			endpoint));
-		if (gSocketModule->acquire_socket(endpoint->socket))
-			return endpoint;
+		return endpoint;
 	}
 
 	// no explicit endpoint exists, check for wildcard endpoints
@@ -346,24 +478,22 @@ EndpointManager::FindConnection(sockaddr* local, sockaddr* peer)
 	SocketAddressStorage wildcard(AddressModule());
 	wildcard.SetToEmpty();
 
-	endpoint = _LookupConnection(local, *wildcard);
+	endpoint = _FindConnection(local, *wildcard);
 	if (endpoint != NULL) {
 		TRACE(("TCP: Received packet corresponds to wildcard endpoint %p\n",
 			endpoint));
-		if (gSocketModule->acquire_socket(endpoint->socket))
-			return endpoint;
+		return endpoint;
 	}
 
 	SocketAddressStorage localWildcard(AddressModule());
 	localWildcard.SetToEmpty();
 	localWildcard.SetPort(AddressModule()->get_port(local));
 
-	endpoint = _LookupConnection(*localWildcard, *wildcard);
+	endpoint = _FindConnection(*localWildcard, *wildcard);
 	if (endpoint != NULL) {
 		TRACE(("TCP: Received packet corresponds to local wildcard endpoint "
 			"%p\n", endpoint));
-		if (gSocketModule->acquire_socket(endpoint->socket))
-			return endpoint;
+		return endpoint;
 	}
 
 	// no matching endpoint exists
@@ -383,27 +513,23 @@ EndpointManager::Bind(TCPEndpoint* endpoint, const sockaddr* address)
 	if (!AddressModule()->is_same_family(address))
 		return EAFNOSUPPORT;
 
-	WriteLocker locker(fLock);
-
 	if (AddressModule()->get_port(address) == 0)
 		return _BindToEphemeral(endpoint, address);
 
-	return _BindToAddress(locker, endpoint, address);
+	return _BindToAddress(endpoint, address);
 }
 
 
 status_t
 EndpointManager::BindChild(TCPEndpoint* endpoint, const sockaddr* address)
 {
-	WriteLocker _(fLock);
+	MutexLocker _(_PortShard(AddressModule()->get_port(address)).lock);
 	return _Bind(endpoint, address);
 }
 
 
-/*! You must have fLock write locked when calling this method. */
 status_t
-EndpointManager::_BindToAddress(WriteLocker& locker, TCPEndpoint* endpoint,
-	const sockaddr* _address)
+EndpointManager::_BindToAddress(TCPEndpoint* endpoint, const sockaddr* _address)
 {
 	ConstSocketAddress address(AddressModule(), _address);
 	uint16 port = address.Port();
@@ -416,10 +542,13 @@ EndpointManager::_BindToAddress(WriteLocker& locker, TCPEndpoint* endpoint,
 	if (ntohs(port) <= kLastReservedPort && geteuid() != 0)
 		return B_PERMISSION_DENIED;
 
+	PortShard& shard = _PortShard(port);
+	MutexLocker locker(shard.lock);
+
 	bool retrying = false;
 	int32 retry = 0;
 	do {
-		EndpointTable::ValueIterator portUsers = fEndpointHash.Lookup(port);
+		EndpointTable::ValueIterator portUsers = shard.table.Lookup(port);
 		retry = false;
 
 		while (portUsers.HasNext()) {
@@ -461,44 +590,51 @@ EndpointManager::_BindToAddress(WriteLocker& locker, TCPEndpoint* endpoint,
 }
 
 
-/*! You must have fLock write locked when calling this method. */
+/*!	Binds the endpoint to the first free port after a more or less random
+	step from the last one chosen. The used port bitmap is consulted without
+	holding any lock, so that ports in use, and whole groups of them, can be
+	skipped without looking at the port tables.
+*/
 status_t
 EndpointManager::_BindToEphemeral(TCPEndpoint* endpoint,
 	const sockaddr* address)
 {
 	TRACE(("EndpointManager::BindToEphemeral(%p)\n", endpoint));
 
-	uint32 max = fLastPort + 65536;
+	uint32 first = atomic_get(&fLastPort) + (system_time() & 0x1f) + 1;
 
-	for (int32 i = 1; i < 5; i++) {
-		// try to retrieve a more or less random port
-		uint32 step = i == 4 ? 1 : (system_time() & 0x1f) + 1;
-		uint32 counter = fLastPort + step;
+	for (uint32 i = 0; i < 65536; i++) {
+		uint16 port = (first + i) & 0xffff;
+		if (port <= kLastReservedPort) {
+			i += kLastReservedPort - port;
+			continue;
+		}
+		if (port % 64 == 0 && fUsedPorts[port / 64] == ~(uint64)0) {
+			i += 63;
+			continue;
+		}
+		if (_IsPortUsed(port))
+			continue;
 
-		while (counter < max) {
-			uint16 port = counter & 0xffff;
-			if (port <= kLastReservedPort)
-				port += kLastReservedPort;
+		PortShard& shard = _PortShard(htons(port));
+		MutexLocker _(shard.lock);
 
-			fLastPort = port;
-			port = htons(port);
+		if (shard.table.Lookup(htons(port)).HasNext())
+			continue;
 
-			if (!fEndpointHash.Lookup(port).HasNext()) {
-				// found a port
-				SocketAddressStorage newAddress(AddressModule());
-				newAddress.SetTo(address);
-				newAddress.SetPort(port);
+		// found a port
+		atomic_set(&fLastPort, port);
 
-				TRACE(("   EndpointManager::BindToEphemeral(%p) -> %s\n",
-					endpoint, AddressString(Domain(), *newAddress,
-					true).Data()));
-				T(Bind(endpoint, newAddress, true));
+		SocketAddressStorage newAddress(AddressModule());
+		newAddress.SetTo(address);
+		newAddress.SetPort(htons(port));
 
-				return _Bind(endpoint, *newAddress);
-			}
+		TRACE(("   EndpointManager::BindToEphemeral(%p) -> %s\n",
+			endpoint, AddressString(Domain(), *newAddress,
+			true).Data()));
+		T(Bind(endpoint, newAddress, true));
 
-			counter += step;
-		}
+		return _Bind(endpoint, *newAddress);
 	}
 
 	// could not find a port!
@@ -506,6 +642,7 @@ EndpointManager::_BindToEphemeral(TCPEndpoint* endpoint,
 }
 
 
+/*!	You must hold the lock of the port's shard when calling this method. */
 status_t
 EndpointManager::_Bind(TCPEndpoint* endpoint, const sockaddr* address)
 {
@@ -515,7 +652,9 @@ EndpointManager::_Bind(TCPEndpoint* endpoint, const sockaddr* address)
 	if (status < B_OK)
 		return status;
 
-	fEndpointHash.Insert(endpoint);
+	uint16 port = AddressModule()->get_port(address);
+	_PortShard(port).table.Insert(endpoint);
+	_SetPortUsed(ntohs(port), true);
 
 	return B_OK;
 }
@@ -532,12 +671,19 @@ EndpointManager::Unbind(TCPEndpoint* endpoint)
 		return B_BAD_VALUE;
 	}
 
-	WriteLocker _(fLock);
+	uint16 port = endpoint->LocalAddress().Port();
+	PortShard& ports = _PortShard(port);
+	MutexLocker portLocker(ports.lock);
 
-	if (!fEndpointHash.Remove(endpoint))
+	if (!ports.table.Remove(endpoint))
 		panic("bound endpoint %p not in hash!", endpoint);
+	if (!ports.table.Lookup(port).HasNext())
+		_SetPortUsed(ntohs(port), false);
+
+	ConnectionShard& shard = _ConnectionShard(endpoint);
+	WriteLocker _(shard.lock);
 
-	fConnectionHash.Remove(endpoint);
+	shard.table.Remove(endpoint);
 
 	(*endpoint->LocalAddress())->sa_len = 0;
 
@@ -590,18 +736,22 @@ EndpointManager::Dump() const
 	kprintf("%10s %21s %21s %8s %8s %12s\n", "address", "local", "peer",
 		"recv-q", "send-q", "state");
 
-	ConnectionTable::Iterator iterator = fConnectionHash.GetIterator();
+	for (uint32 i = 0; i < kConnectionShardCount; i++) {
+		ConnectionTable::Iterator iterator
+			= fConnectionShards[i]->table.GetIterator();
 
-	while (iterator.HasNext()) {
-		TCPEndpoint *endpoint = iterator.Next();
+		while (iterator.HasNext()) {
+			TCPEndpoint *endpoint = iterator.Next();
 
-		char localBuf[64], peerBuf[64];
-		endpoint->LocalAddress().AsString(localBuf, sizeof(localBuf), true);
-		endpoint->PeerAddress().AsString(peerBuf, sizeof(peerBuf), true);
+			char localBuf[64], peerBuf[64];
+			endpoint->LocalAddress().AsString(localBuf, sizeof(localBuf),
+				true);
+			endpoint->PeerAddress().AsString(peerBuf, sizeof(peerBuf), true);
 
-		kprintf("%p %21s %21s %8lu %8lu %12s\n", endpoint, localBuf, peerBuf,
-			endpoint->fReceiveQueue.Available(), endpoint->fSendQueue.Used(),
-			name_for_state(endpoint->State()));
+			kprintf("%p %21s %21s %8lu %8lu %12s\n", endpoint, localBuf,
+				peerBuf, endpoint->fReceiveQueue.Available(),
+				endpoint->fSendQueue.Used(), name_for_state(endpoint->State()));
+		}
 	}
 }
 
@@ -96,23 +96,55 @@ public:
 			void			Dump() const;
 
 private:
-			TCPEndpoint*	_LookupConnection(const sockaddr* local,
+	typedef BOpenHashTable<ConnectionHashDefinition> ConnectionTable;
+	typedef MultiHashTable<EndpointHashDefinition> EndpointTable;
+
+	// The connections and the bound ports are spread over several tables,
+	// each with its own lock. The port lock has to be acquired before the
+	// connection lock, and only one of each may be held at a time.
+
+	struct ConnectionShard {
+								ConnectionShard(EndpointManager* manager);
+								~ConnectionShard();
+
+			rw_lock				lock;
+			ConnectionTable		table;
+	};
+
+	struct PortShard {
+								PortShard();
+								~PortShard();
+
+			mutex				lock;
+			EndpointTable		table;
+	};
+
+	static	const uint32	kConnectionShardCount = 16;
+	static	const uint32	kPortShardCount = 16;
+
+			ConnectionShard& _ConnectionShard(const sockaddr* local,
+								const sockaddr* peer) const;
+			ConnectionShard& _ConnectionShard(TCPEndpoint* endpoint) const;
+			PortShard&		_PortShard(uint16 port) const;
+
+			TCPEndpoint*	_FindConnection(const sockaddr* local,
 								const sockaddr* peer);
+			void			_RemoveConnection(TCPEndpoint* endpoint);
 			status_t		_Bind(TCPEndpoint* endpoint,
 								const sockaddr* address);
-			status_t		_BindToAddress(WriteLocker& locker,
-								TCPEndpoint* endpoint, const sockaddr* address);
+			status_t		_BindToAddress(TCPEndpoint* endpoint,
+								const sockaddr* address);
 			status_t		_BindToEphemeral(TCPEndpoint* endpoint,
 								const sockaddr* address);
 
-	typedef BOpenHashTable<ConnectionHashDefinition> ConnectionTable;
-	typedef MultiHashTable<EndpointHashDefinition> EndpointTable;
+			bool			_IsPortUsed(uint16 port) const;
+			void			_SetPortUsed(uint16 port, bool used);
 
-	rw_lock					fLock;
 	net_domain*				fDomain;
-	ConnectionTable			fConnectionHash;
-	EndpointTable			fEndpointHash;
-	uint16					fLastPort;
+	ConnectionShard*		fConnectionShards[kConnectionShardCount];
+	PortShard*				fPortShards[kPortShardCount];
+	int32					fLastPort;
+	uint64					fUsedPorts[65536 / 64];
 };
 
 #endif	// ENDPOINT_MANAGER_H
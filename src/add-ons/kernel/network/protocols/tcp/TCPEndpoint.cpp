@@ -41,12 +41,14 @@
 //	- RFC 793 - Transmission Control Protocol
 //	- RFC 813 - Window and Acknowledgement Strategy in TCP
 //	- RFC 1337 - TIME_WAIT Assassination Hazards in TCP
+//	- RFC 8312 - CUBIC for Fast Long-Distance Networks (CongestionControl.cpp)
 //
 // Things incomplete in this implementation:
 //	- TCP Extensions for High Performance, RFC 1323 - RTTM, PAWS
 //	- Congestion Control, RFC 5681
 //	- Limited Transit, RFC 3042
-//	- SACK, Selective Acknowledgment; RFC 2018, RFC 2883, RFC 6675
+//	- SACK, Selective Acknowledgment; RFC 2018, RFC 2883, RFC 6675 (holes
+//	  are retransmitted during fast recovery, but there is no pipe estimate)
 //	- NewReno Modification to TCP's Fast Recovery, RFC 2582
 //
 // Things this implementation currently doesn't implement:
@@ -321,6 +323,8 @@ enum {
 	FLAG_LOCAL					= 0x20,
 	FLAG_RECOVERY				= 0x40,
 	FLAG_OPTION_SACK_PERMITTED	= 0x80,
+	FLAG_AUTO_RECEIVE_BUFFER	= 0x100,
+	FLAG_AUTO_SEND_BUFFER		= 0x200,
 };
 
 
@@ -437,6 +441,8 @@ TCPEndpoint::TCPEndpoint(net_socket* socket)
 	fDuplicateAcknowledgeCount(0),
 	fPreviousFlightSize(0),
 	fRecover(0),
+	fSackedBlockCount(0),
+	fRetransmitNext(0),
 	fRoute(NULL),
 	fReceiveNext(0),
 	fReceiveMaxAdvertised(0),
@@ -449,10 +455,15 @@ TCPEndpoint::TCPEndpoint(net_socket* socket)
 	fRoundTripStartSequence(0),
 	fRetransmitTimeout(TCP_INITIAL_RTT),
 	fReceivedTimestamp(0),
+	fReceiveRoundTripTime(0),
+	fReceiveMeasureTime(0),
+	fReceiveMeasureSequence(0),
 	fCongestionWindow(0),
 	fSlowStartThreshold(0),
+	fCongestionControl(create_congestion_control(NULL)),
 	fState(CLOSED),
-	fFlags(FLAG_OPTION_WINDOW_SCALE | FLAG_OPTION_TIMESTAMP | FLAG_OPTION_SACK_PERMITTED)
+	fFlags(FLAG_OPTION_WINDOW_SCALE | FLAG_OPTION_TIMESTAMP | FLAG_OPTION_SACK_PERMITTED
+		| FLAG_AUTO_RECEIVE_BUFFER | FLAG_AUTO_SEND_BUFFER)
 {
 	// TODO: to be replaced with a real read/write locking strategy!
 	mutex_init(&fLock, "tcp lock");
@@ -496,13 +507,14 @@ TCPEndpoint::~TCPEndpoint()
 	gStackModule->wait_for_timer(&fTimeWaitTimer);
 
 	gDatalinkModule->put_route(Domain(), fRoute);
+	delete fCongestionControl;
 }
 
 
 status_t
 TCPEndpoint::InitCheck() const
 {
-	return B_OK;
+	return fCongestionControl != NULL ? B_OK : B_NO_MEMORY;
 }
 
 
@@ -1055,6 +1067,7 @@ status_t
 TCPEndpoint::SetSendBufferSize(size_t length)
 {
 	MutexLocker _(fLock);
+	fFlags &= ~FLAG_AUTO_SEND_BUFFER;
 	fSendQueue.SetMaxBytes(length);
 	return B_OK;
 }
@@ -1064,6 +1077,7 @@ status_t
 TCPEndpoint::SetReceiveBufferSize(size_t length)
 {
 	MutexLocker _(fLock);
+	fFlags &= ~FLAG_AUTO_RECEIVE_BUFFER;
 	fReceiveQueue.SetMaxBytes(length);
 	return B_OK;
 }
@@ -1072,6 +1086,17 @@ TCPEndpoint::SetReceiveBufferSize(size_t length)
 status_t
 TCPEndpoint::GetOption(int option, void* _value, int* _length)
 {
+	if (option == TCP_CONGESTION) {
+		if (*_length <= 0)
+			return B_BAD_VALUE;
+
+		MutexLocker _(fLock);
+		const char* name = fCongestionControl->Name();
+		strlcpy((char*)_value, name, *_length);
+		*_length = min_c((int)strlen(name) + 1, *_length);
+		return B_OK;
+	}
+
 	if (*_length != sizeof(int))
 		return B_BAD_VALUE;
 
@@ -1098,6 +1123,20 @@ TCPEndpoint::GetOption(int option, void* _value, int* _length)
 status_t
 TCPEndpoint::SetOption(int option, const void* _value, int length)
 {
+	if (option == TCP_CONGESTION) {
+		if (length <= 0)
+			return B_BAD_VALUE;
+
+		// the name does not need to be null terminated
+		char name[TCP_CA_NAME_MAX];
+		size_t nameLength = min_c((size_t)length, sizeof(name) - 1);
+		memcpy(name, _value, nameLength);
+		name[nameLength] = '\0';
+
+		MutexLocker _(fLock);
+		return _SetCongestionControl(name);
+	}
+
 	if (option != TCP_NODELAY)
 		return B_BAD_VALUE;
 
@@ -1195,6 +1234,22 @@ TCPEndpoint::_CancelConnectionTimers()
 }
 
 
+status_t
+TCPEndpoint::_SetCongestionControl(const char* name)
+{
+	if (strcmp(name, fCongestionControl->Name()) == 0)
+		return B_OK;
+
+	CongestionControl* congestionControl = create_congestion_control(name);
+	if (congestionControl == NULL)
+		return ENOENT;
+
+	delete fCongestionControl;
+	fCongestionControl = congestionControl;
+	return B_OK;
+}
+
+
 /*!	Sends the FIN flag to the peer when the connection is still open.
 	Moves the endpoint to the next state depending on where it was.
 */
@@ -1294,6 +1349,8 @@ TCPEndpoint::_HandleReset(status_t error)
 void
 TCPEndpoint::_DuplicateAcknowledge(tcp_segment_header &segment)
 {
+	_UpdateSackScoreboard(segment);
+
 	if (fDuplicateAcknowledgeCount == 0)
 		fPreviousFlightSize = (fSendMax - fSendUnacknowledged).Number();
 
@@ -1312,17 +1369,22 @@ TCPEndpoint::_DuplicateAcknowledge(tcp_segment_header &segment)
 			(fSendUnacknowledged - fPreviousHighestAcknowledge) <= 4 * fSendMaxSegmentSize)) {
 			fFlags |= FLAG_RECOVERY;
 			fRecover = fSendMax.Number() - 1;
-			fSlowStartThreshold = max_c(fPreviousFlightSize / 2, 2 * fSendMaxSegmentSize);
+			fSlowStartThreshold = fCongestionControl->Decrease(
+				fCongestionWindow, fPreviousFlightSize, fSendMaxSegmentSize);
 			fCongestionWindow = fSlowStartThreshold + 3 * fSendMaxSegmentSize;
 			fSendNext = segment.acknowledge;
 			_SendQueued();
+			fRetransmitNext = fSendNext;
 			TRACE("_DuplicateAcknowledge(): packet sent under fast restransmit on the receipt of 3rd dup ack");
 		}
 	} else if (fDuplicateAcknowledgeCount > 3) {
 		uint32 flightSize = (fSendMax - fSendUnacknowledged).Number();
 		if ((fDuplicateAcknowledgeCount - 3) * fSendMaxSegmentSize <= flightSize)
 			fCongestionWindow += fSendMaxSegmentSize;
-		if (fSendQueue.Available(fSendMax) != 0) {
+
+		// fill the holes the peer told us about before sending new data
+		if (((fFlags & FLAG_RECOVERY) == 0 || _RetransmitSackHole() != B_OK)
+			&& fSendQueue.Available(fSendMax) != 0) {
 			fSendNext = fSendMax;
 			_SendQueued();
 		}
@@ -1330,6 +1392,85 @@ TCPEndpoint::_DuplicateAcknowledge(tcp_segment_header &segment)
 }
 
 
+/*!	Remembers the ranges the peer selectively acknowledged in \a segment, and
+	forgets about those that are now acknowledged cumulatively.
+*/
+void
+TCPEndpoint::_UpdateSackScoreboard(tcp_segment_header& segment)
+{
+	int32 count = 0;
+	for (int32 i = 0; i < fSackedBlockCount; i++) {
+		tcp_sack& block = fSackedBlocks[i];
+		if (tcp_sequence(block.right_edge) <= fSendUnacknowledged)
+			continue;
+		if (tcp_sequence(block.left_edge) < fSendUnacknowledged)
+			block.left_edge = fSendUnacknowledged.Number();
+
+		fSackedBlocks[count++] = block;
+	}
+	fSackedBlockCount = count;
+
+	if (fRetransmitNext < fSendUnacknowledged)
+		fRetransmitNext = fSendUnacknowledged;
+
+	if ((segment.options & TCP_HAS_SACK) == 0
+		|| (fFlags & FLAG_OPTION_SACK_PERMITTED) == 0)
+		return;
+
+	for (int i = 0; i < segment.sackCount; i++) {
+		tcp_sequence left = segment.sacks[i].left_edge;
+		tcp_sequence right = segment.sacks[i].right_edge;
+
+		// ignore invalid blocks, as well as duplicate SACKs (RFC 2883)
+		if (left >= right || left < fSendUnacknowledged || right > fSendMax)
+			continue;
+
+		_AddSackedBlock(left, right);
+	}
+}
+
+
+void
+TCPEndpoint::_AddSackedBlock(tcp_sequence left, tcp_sequence right)
+{
+	int32 index = 0;
+	while (index < fSackedBlockCount
+		&& tcp_sequence(fSackedBlocks[index].right_edge) < left)
+		index++;
+
+	// merge all blocks that overlap or touch the new one
+	int32 end = index;
+	while (end < fSackedBlockCount
+		&& tcp_sequence(fSackedBlocks[end].left_edge) <= right) {
+		if (tcp_sequence(fSackedBlocks[end].left_edge) < left)
+			left = fSackedBlocks[end].left_edge;
+		if (tcp_sequence(fSackedBlocks[end].right_edge) > right)
+			right = fSackedBlocks[end].right_edge;
+		end++;
+	}
+
+	if (end == index) {
+		if (fSackedBlockCount == TCP_MAX_SACKED_BLOCKS) {
+			// The scoreboard is full, drop the highest block; the holes
+			// below it are more important.
+			if (index == fSackedBlockCount)
+				return;
+			fSackedBlockCount--;
+		}
+		memmove(&fSackedBlocks[index + 1], &fSackedBlocks[index],
+			(fSackedBlockCount - index) * sizeof(tcp_sack));
+		fSackedBlockCount++;
+	} else if (end > index + 1) {
+		memmove(&fSackedBlocks[index + 1], &fSackedBlocks[end],
+			(fSackedBlockCount - end) * sizeof(tcp_sack));
+		fSackedBlockCount -= end - index - 1;
+	}
+
+	fSackedBlocks[index].left_edge = left.Number();
+	fSackedBlocks[index].right_edge = right.Number();
+}
+
+
 void
 TCPEndpoint::_UpdateTimestamps(tcp_segment_header& segment,
 	size_t segmentLength)
@@ -1340,6 +1481,20 @@ TCPEndpoint::_UpdateTimestamps(tcp_segment_header& segment,
 		if (fLastAcknowledgeSent >= sequence
 			&& fLastAcknowledgeSent < (sequence + segmentLength))
 			fReceivedTimestamp = segment.timestamp_value;
+
+		if (segmentLength > 0 && segment.timestamp_reply != 0) {
+			// The peer echoes one of our timestamps, which lets us measure
+			// the round trip time even if we don't send any data ourselves.
+			int32 roundTripTime = max_c(
+				(int32)tcp_diff_timestamp(segment.timestamp_reply), 1);
+			if (fReceiveRoundTripTime == 0
+				|| roundTripTime < fReceiveRoundTripTime)
+				fReceiveRoundTripTime = roundTripTime;
+			else {
+				fReceiveRoundTripTime
+					+= (roundTripTime - fReceiveRoundTripTime) / 8;
+			}
+		}
 	}
 }
 
@@ -1373,6 +1528,49 @@ TCPEndpoint::_NotifyReader()
 }
 
 
+/*!	Grows the receive buffer so that it can hold twice as much as the peer
+	sent within the last round trip. As long as the window we advertise
+	limits the connection, this doubles it every round trip, until the
+	bandwidth-delay product fits into it.
+*/
+void
+TCPEndpoint::_AutoTuneReceiveBuffer()
+{
+	if ((fFlags & FLAG_AUTO_RECEIVE_BUFFER) == 0)
+		return;
+
+	int32 roundTripTime = fReceiveRoundTripTime;
+	if (roundTripTime == 0)
+		roundTripTime = fSmoothedRoundTripTime;
+
+	bigtime_t now = system_time();
+	if (fReceiveMeasureTime == 0 || roundTripTime <= 0) {
+		fReceiveMeasureTime = now;
+		fReceiveMeasureSequence = fReceiveNext;
+		return;
+	}
+
+	if (now - fReceiveMeasureTime < (bigtime_t)roundTripTime * 1000)
+		return;
+
+	uint32 received = (fReceiveNext - fReceiveMeasureSequence).Number();
+	fReceiveMeasureTime = now;
+	fReceiveMeasureSequence = fReceiveNext;
+
+	size_t size = min_c(2 * (size_t)received,
+		(size_t)TCP_MAX_AUTO_BUFFER_SIZE);
+	if (size <= fReceiveQueue.Size())
+		return;
+
+	TRACE("  _AutoTuneReceiveBuffer(): %" B_PRIu32 " bytes in %" B_PRId32
+		" ms, receive buffer now %" B_PRIuSIZE " bytes", received,
+		roundTripTime, size);
+
+	fReceiveQueue.SetMaxBytes(size);
+	socket->receive.buffer_size = size;
+}
+
+
 bool
 TCPEndpoint::_AddData(tcp_segment_header& segment, net_buffer* buffer)
 {
@@ -1399,6 +1597,8 @@ TCPEndpoint::_AddData(tcp_segment_header& segment, net_buffer* buffer)
 	if ((segment.flags & TCP_FLAG_PUSH) != 0)
 		fReceiveQueue.SetPushPointer();
 
+	_AutoTuneReceiveBuffer();
+
 	return fReceiveQueue.Available() > 0;
 }
 
@@ -1428,7 +1628,8 @@ TCPEndpoint::_PrepareReceivePath(tcp_segment_header& segment)
 			fFlags |= FLAG_OPTION_WINDOW_SCALE;
 			fSendWindowShift = segment.window_shift;
 		} else {
-			fFlags &= ~FLAG_OPTION_WINDOW_SCALE;
+			// without window scaling, we cannot advertise a larger window
+			fFlags &= ~(FLAG_OPTION_WINDOW_SCALE | FLAG_AUTO_RECEIVE_BUFFER);
 			fReceiveWindowShift = 0;
 		}
 
@@ -1484,6 +1685,14 @@ TCPEndpoint::_Spawn(TCPEndpoint* parent, tcp_segment_header& segment,
 
 	fManager = parent->fManager;
 
+	// inherit what has been configured on the listening socket
+	fFlags = (fFlags & ~(FLAG_AUTO_RECEIVE_BUFFER | FLAG_AUTO_SEND_BUFFER))
+		| (parent->fFlags & (FLAG_AUTO_RECEIVE_BUFFER | FLAG_AUTO_SEND_BUFFER));
+	if (_SetCongestionControl(parent->fCongestionControl->Name()) != B_OK) {
+		T(Error(this, "congestion control failed", __LINE__));
+		return DROP;
+	}
+
 	if (fManager->BindChild(this, buffer->destination) != B_OK) {
 		T(Error(this, "binding failed", __LINE__));
 		return DROP;
@@ -2008,7 +2217,7 @@ TCPEndpoint::_PrepareSendSegment()
 				&& (fFlags & FLAG_OPTION_SACK_PERMITTED) != 0) {
 			segment.options |= TCP_HAS_SACK;
 			int maxSackCount = MAX_SACK_BLKS
-				- ((fFlags & FLAG_OPTION_TIMESTAMP) != 0) ? 1 : 0;
+				- (((fFlags & FLAG_OPTION_TIMESTAMP) != 0) ? 1 : 0);
 			memset(segment.sacks, 0, sizeof(segment.sacks));
 			segment.sackCount = fReceiveQueue.PopulateSackInfo(fReceiveNext,
 				maxSackCount, segment.sacks);
@@ -2289,6 +2498,81 @@ TCPEndpoint::_SendQueued(bool force)
 }
 
 
+/*!	Finds the first hole at or after fRetransmitNext that is followed by
+	enough selectively acknowledged data to consider it lost (RFC 6675), and
+	returns its start and length.
+*/
+bool
+TCPEndpoint::_NextSackHole(tcp_sequence& start, uint32& length)
+{
+	tcp_sequence sequence = max_c(fRetransmitNext, fSendUnacknowledged);
+
+	for (int32 i = 0; i < fSackedBlockCount; i++) {
+		tcp_sequence left = fSackedBlocks[i].left_edge;
+		tcp_sequence right = fSackedBlocks[i].right_edge;
+		if (sequence >= right)
+			continue;
+		if (sequence >= left) {
+			sequence = right;
+			continue;
+		}
+
+		uint32 sackedAbove = 0;
+		for (int32 j = i; j < fSackedBlockCount; j++) {
+			sackedAbove += fSackedBlocks[j].right_edge
+				- fSackedBlocks[j].left_edge;
+		}
+		if (sackedAbove <= 2 * fSendMaxSegmentSize)
+			return false;
+
+		start = sequence;
+		length = (left - sequence).Number();
+		return true;
+	}
+
+	return false;
+}
+
+
+/*!	Retransmits one segment from the next hole in the data the peer has
+	received, as reported by its selective acknowledgments.
+*/
+status_t
+TCPEndpoint::_RetransmitSackHole()
+{
+	tcp_sequence start;
+	uint32 length;
+	if (!_NextSackHole(start, length))
+		return B_ENTRY_NOT_FOUND;
+
+	tcp_segment_header segment = _PrepareSendSegment();
+	length = min_c(length, fSendMaxSegmentSize - tcp_options_length(segment));
+
+	net_buffer* buffer = gBufferModule->create(256);
+	if (buffer == NULL)
+		return B_NO_MEMORY;
+
+	status_t status = fSendQueue.Get(buffer, start, length);
+	if (status != B_OK) {
+		gBufferModule->free(buffer);
+		return status;
+	}
+
+	TRACE("_RetransmitSackHole(): %" B_PRIu32 " bytes at %" B_PRIu32, length,
+		start.Number());
+
+	tcp_sequence sendNext = fSendNext;
+	fSendNext = start;
+	status = _PrepareAndSend(segment, buffer, true);
+	fSendNext = sendNext;
+
+	if (status == B_OK)
+		fRetransmitNext = start + length;
+
+	return status;
+}
+
+
 int
 TCPEndpoint::_MaxSegmentSize(const sockaddr* address) const
 {
@@ -2320,6 +2604,7 @@ TCPEndpoint::_PrepareSendPath(const sockaddr* peer)
 	fSendMax = fInitialSendSequence;
 	fSendUrgentOffset = fInitialSendSequence;
 	fRecover = fInitialSendSequence.Number();
+	fRetransmitNext = fInitialSendSequence;
 
 	// we are counting the SYN here
 	fSendQueue.SetInitialSequence(fSendNext + 1);
@@ -2327,10 +2612,17 @@ TCPEndpoint::_PrepareSendPath(const sockaddr* peer)
 	fReceiveMaxSegmentSize = _MaxSegmentSize(peer);
 
 	// Compute the window shift we advertise to our peer - if it doesn't support
-	// this option, this will be reset to 0 (when its SYN is received)
+	// this option, this will be reset to 0 (when its SYN is received).
+	// An automatically sized receive buffer may grow up to its maximum size
+	// later on, so the shift has to account for that already.
+	uint32 receiveBufferSize = socket->receive.buffer_size;
+	if ((fFlags & FLAG_AUTO_RECEIVE_BUFFER) != 0)
+		receiveBufferSize = max_c(receiveBufferSize,
+			(uint32)TCP_MAX_AUTO_BUFFER_SIZE);
+
 	fReceiveWindowShift = 0;
 	while (fReceiveWindowShift < TCP_MAX_WINDOW_SHIFT
-		&& (0xffffUL << fReceiveWindowShift) < socket->receive.buffer_size) {
+		&& (0xffffUL << fReceiveWindowShift) < receiveBufferSize) {
 		fReceiveWindowShift++;
 	}
 
@@ -2353,6 +2645,8 @@ TCPEndpoint::_Acknowledged(tcp_segment_header& segment)
 		uint32 bytesAcknowledged = segment.acknowledge - fSendUnacknowledged.Number();
 		fPreviousHighestAcknowledge = fSendUnacknowledged;
 		fSendUnacknowledged = segment.acknowledge;
+		_UpdateSackScoreboard(segment);
+
 		uint32 flightSize = (fSendMax - fSendUnacknowledged).Number();
 		int32 expectedSamples = flightSize / (fSendMaxSegmentSize << 1);
 
@@ -2366,22 +2660,20 @@ TCPEndpoint::_Acknowledged(tcp_segment_header& segment)
 			if (fCongestionWindow < fSlowStartThreshold)
 				fCongestionWindow += min_c(bytesAcknowledged, fSendMaxSegmentSize);
 			else {
-				uint32 increment = fSendMaxSegmentSize * fSendMaxSegmentSize;
-
-				if (increment < fCongestionWindow)
-					increment = 1;
-				else
-					increment /= fCongestionWindow;
-
-				fCongestionWindow += increment;
+				fCongestionWindow = fCongestionControl->Increase(
+					fCongestionWindow, bytesAcknowledged, fSendMaxSegmentSize,
+					fSmoothedRoundTripTime);
 			}
 
 			fSendMaxSegments = UINT32_MAX;
+			_AutoTuneSendBuffer();
 		}
 
 		if ((fFlags & FLAG_RECOVERY) != 0) {
 			fSendNext = fSendUnacknowledged;
 			_SendQueued();
+			if (fRetransmitNext < fSendNext)
+				fRetransmitNext = fSendNext;
 			fCongestionWindow -= bytesAcknowledged;
 
 			if (bytesAcknowledged > fSendMaxSegmentSize)
@@ -2443,6 +2735,10 @@ TCPEndpoint::_Retransmit()
 			fRetransmitTimeout = TCP_MAX_RETRANSMIT_TIMEOUT;
 	}
 
+	// the peer may have dropped what it selectively acknowledged before
+	fSackedBlockCount = 0;
+	fRetransmitNext = fSendUnacknowledged;
+
 	fSendNext = fSendUnacknowledged;
 	_SendQueued();
 
@@ -2484,12 +2780,31 @@ TCPEndpoint::_UpdateRoundTripTime(int32 roundTripTime, int32 expectedSamples)
 void
 TCPEndpoint::_ResetSlowStart()
 {
-	fSlowStartThreshold = max_c((fSendMax - fSendUnacknowledged).Number() / 2,
-		2 * fSendMaxSegmentSize);
+	fSlowStartThreshold = fCongestionControl->Decrease(fCongestionWindow,
+		(fSendMax - fSendUnacknowledged).Number(), fSendMaxSegmentSize);
 	fCongestionWindow = fSendMaxSegmentSize;
 }
 
 
+/*!	Grows the send buffer along with the window, so that there is always
+	enough data queued to fill it, and to retransmit from.
+*/
+void
+TCPEndpoint::_AutoTuneSendBuffer()
+{
+	if ((fFlags & FLAG_AUTO_SEND_BUFFER) == 0)
+		return;
+
+	size_t size = min_c(2 * (size_t)min_c(fCongestionWindow, fSendMaxWindow),
+		(size_t)TCP_MAX_AUTO_BUFFER_SIZE);
+	if (size <= fSendQueue.Size())
+		return;
+
+	fSendQueue.SetMaxBytes(size);
+	socket->send.buffer_size = size;
+}
+
+
 //	#pragma mark - timer
 
 
@@ -2633,5 +2948,12 @@ TCPEndpoint::Dump() const
 	kprintf("  retransmit timeout: %" B_PRId64 "\n", fRetransmitTimeout);
 	kprintf("  congestion window: %" B_PRIu32 "\n", fCongestionWindow);
 	kprintf("  slow start threshold: %" B_PRIu32 "\n", fSlowStartThreshold);
+	kprintf("  congestion control: %s\n", fCongestionControl->Name());
+	kprintf("  selectively acknowledged:");
+	for (int32 i = 0; i < fSackedBlockCount; i++) {
+		kprintf(" %" B_PRIu32 "-%" B_PRIu32, fSackedBlocks[i].left_edge,
+			fSackedBlocks[i].right_edge);
+	}
+	kprintf("\n");
 }
 
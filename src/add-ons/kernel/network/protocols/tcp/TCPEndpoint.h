@@ -12,6 +12,7 @@
 
 
 #include "BufferQueue.h"
+#include "CongestionControl.h"
 #include "EndpointManager.h"
 #include "tcp.h"
 
@@ -113,6 +114,14 @@ private:
 			void		_UpdateRoundTripTime(int32 roundTripTime, int32 expectedSamples);
 			void		_ResetSlowStart();
 			void		_DuplicateAcknowledge(tcp_segment_header& segment);
+			void		_UpdateSackScoreboard(tcp_segment_header& segment);
+			void		_AddSackedBlock(tcp_sequence left,
+							tcp_sequence right);
+			bool		_NextSackHole(tcp_sequence& start, uint32& length);
+			status_t	_RetransmitSackHole();
+			void		_AutoTuneReceiveBuffer();
+			void		_AutoTuneSendBuffer();
+			status_t	_SetCongestionControl(const char* name);
 
 	static	void		_TimeWaitTimer(net_timer* timer, void* _endpoint);
 	static	void		_RetransmitTimer(net_timer* timer, void* _endpoint);
@@ -158,6 +167,12 @@ private:
 	uint32			fPreviousFlightSize;
 	uint32			fRecover;
 
+	// ranges above fSendUnacknowledged the peer has selectively acknowledged,
+	// sorted by sequence
+	tcp_sack		fSackedBlocks[TCP_MAX_SACKED_BLOCKS];
+	int32			fSackedBlockCount;
+	tcp_sequence	fRetransmitNext;
+
 	net_route		*fRoute;
 		// TODO: don't use a net_route, but a net_route_info!!!
 		// (the latter will automatically adapt to routing changes)
@@ -180,8 +195,15 @@ private:
 
 	uint32			fReceivedTimestamp;
 
+	// receive buffer auto tuning
+	int32			fReceiveRoundTripTime;
+	bigtime_t		fReceiveMeasureTime;
+	tcp_sequence	fReceiveMeasureSequence;
+
 	uint32			fCongestionWindow;
 	uint32			fSlowStartThreshold;
+	CongestionControl*
+					fCongestionControl;
 
 	tcp_state		fState;
 	uint32			fFlags;
@@ -195,6 +195,10 @@ operator==(tcp_sequence a, tcp_sequence b)
 #define TCP_MAX_RETRANSMIT_TIMEOUT		60000000	// 60 secs
 // New value for timeout in case of lost SYN (RFC 6298)
 #define TCP_SYN_RETRANSMIT_TIMEOUT 		3000000		// 3 secs
+// Upper limit for automatically sized send and receive buffers
+#define TCP_MAX_AUTO_BUFFER_SIZE		(4 * 1024 * 1024)
+// Number of selectively acknowledged ranges a sender keeps track of
+#define TCP_MAX_SACKED_BLOCKS			8
 
 struct tcp_sack {
 	uint32 left_edge;
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 #include <new>
 #include <stdlib.h>
 #include <string.h>
@@ -73,6 +74,10 @@ struct udp_header {
 typedef NetBufferField<uint16, offsetof(udp_header, udp_checksum)>
 	UDPChecksumField;
 
+// the maximum number of datagrams a single send can be split into with
+// UDP_SEGMENT
+static const uint32 kMaxSegments = 64;
+
 class UdpDomainSupport;
 
 class UdpEndpoint : public net_protocol, public DatagramSocket<> {
@@ -91,6 +96,11 @@ public:
 									net_route* route);
 			status_t			SendData(net_buffer* buffer);
 
+			status_t			GetOption(int option, void* value,
+									int* _length);
+			status_t			SetOption(int option, const void* value,
+									int length);
+
 			ssize_t				BytesAvailable();
 			status_t			FetchData(size_t numBytes, uint32 flags,
 									net_buffer** _buffer);
@@ -107,6 +117,10 @@ public:
 
 			void				Dump() const;
 
+private:
+			status_t			_SendSegment(net_buffer* buffer,
+									net_route* route);
+
 private:
 			UdpDomainSupport*	fManager;
 			bool				fActive;
@@ -115,6 +129,7 @@ private:
 									// optionally connected)
 
 			UdpEndpoint*		fLink;
+			uint16				fSegmentSize;
 };
 
 
@@ -939,7 +954,8 @@ UdpEndpointManager::_GetDomainSupport(net_buffer* buffer)
 UdpEndpoint::UdpEndpoint(net_socket *socket)
 	:
 	DatagramSocket<>("udp endpoint", socket),
-	fActive(false)
+	fActive(false),
+	fSegmentSize(0)
 {
 }
 
@@ -1018,6 +1034,44 @@ UdpEndpoint::SendRoutedData(net_buffer *buffer, net_route *route)
 	TRACE_EP("SendRoutedData(%p [%" B_PRIu32 " bytes], %p)", buffer,
 		buffer->size, route);
 
+	uint32 segmentSize = fSegmentSize;
+	if (segmentSize == 0 || buffer->size <= segmentSize)
+		return _SendSegment(buffer, route);
+
+	if (buffer->size > segmentSize * kMaxSegments)
+		return EMSGSIZE;
+
+	// With UDP_SEGMENT set, the data is sent as datagrams of the segment
+	// size, only the last one may be shorter. The segments are split off the
+	// front, the last one is the buffer itself, as the caller expects.
+	while (buffer->size > segmentSize) {
+		net_buffer* segment = gBufferModule->split(buffer, segmentSize);
+		if (segment == NULL)
+			return B_NO_MEMORY;
+
+		status_t status = _SendSegment(segment, route);
+		if (status != B_OK) {
+			gBufferModule->free(segment);
+			return status;
+		}
+	}
+
+	return _SendSegment(buffer, route);
+}
+
+
+status_t
+UdpEndpoint::SendData(net_buffer *buffer)
+{
+	TRACE_EP("SendData(%p [%" B_PRIu32 " bytes])", buffer, buffer->size);
+
+	return gDatalinkModule->send_data(this, NULL, buffer);
+}
+
+
+status_t
+UdpEndpoint::_SendSegment(net_buffer* buffer, net_route* route)
+{
 	if (buffer->size > (0xffff - sizeof(udp_header)))
 		return EMSGSIZE;
 
@@ -1047,12 +1101,36 @@ UdpEndpoint::SendRoutedData(net_buffer *buffer, net_route *route)
 }
 
 
+// #pragma mark - options
+
+
 status_t
-UdpEndpoint::SendData(net_buffer *buffer)
+UdpEndpoint::GetOption(int option, void* _value, int* _length)
 {
-	TRACE_EP("SendData(%p [%" B_PRIu32 " bytes])", buffer, buffer->size);
+	if (option != UDP_SEGMENT)
+		return B_BAD_VALUE;
+	if (*_length != sizeof(int))
+		return B_BAD_VALUE;
 
-	return gDatalinkModule->send_data(this, NULL, buffer);
+	*(int*)_value = fSegmentSize;
+	return B_OK;
+}
+
+
+status_t
+UdpEndpoint::SetOption(int option, const void* _value, int length)
+{
+	if (option != UDP_SEGMENT)
+		return B_BAD_VALUE;
+	if (length != sizeof(int))
+		return B_BAD_VALUE;
+
+	int value = *(const int*)_value;
+	if (value < 0 || value > int(0xffff - sizeof(udp_header)))
+		return B_BAD_VALUE;
+
+	fSegmentSize = value;
+	return B_OK;
 }
 
 
@@ -1198,6 +1276,9 @@ status_t
 udp_getsockopt(net_protocol *protocol, int level, int option, void *value,
 	int *length)
 {
+	if (level == IPPROTO_UDP)
+		return ((UdpEndpoint *)protocol)->GetOption(option, value, length);
+
 	return protocol->next->module->getsockopt(protocol->next, level, option,
 		value, length);
 }
@@ -1207,6 +1288,9 @@ status_t
 udp_setsockopt(net_protocol *protocol, int level, int option,
 	const void *value, int length)
 {
+	if (level == IPPROTO_UDP)
+		return ((UdpEndpoint *)protocol)->SetOption(option, value, length);
+
 	return protocol->next->module->setsockopt(protocol->next, level, option,
 		value, length);
 }
@@ -446,6 +446,9 @@ datalink_send_data(net_protocol* protocol, net_domain* domain,
 		&& protocol->socket->bound_to_device != 0) {
 		status = get_device_route(domain, protocol->socket->bound_to_device,
 			&route);
+	} else if (protocol != NULL && protocol->socket != NULL) {
+		status = get_cached_buffer_route(domain,
+			get_socket_route_cache(protocol->socket), buffer, &route);
 	} else
 		status = get_buffer_route(domain, buffer, &route);
 
@@ -10,6 +10,7 @@
 #include "device_interfaces.h"
 #include "domains.h"
 #include "interfaces.h"
+#include "routes.h"
 #include "stack_private.h"
 #include "utility.h"
 
@@ -779,6 +780,9 @@ unregister_device_monitor(net_device* device, net_device_monitor* monitor)
 status_t
 device_link_changed(net_device* device)
 {
+	// routes to devices without a link are only used as a last resort
+	invalidate_route_caches();
+
 	notify_link_changed(device);
 	return B_OK;
 }
@@ -138,6 +138,7 @@ register_domain(int family, const char* name,
 	domain->name = name;
 	domain->module = module;
 	domain->address_module = addressModule;
+	domain->route_table.Init(family);
 
 	sDomains.Add(domain);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2010, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  *
  * Authors:
@@ -13,6 +13,7 @@
 #include <util/list.h>
 #include <util/DoublyLinkedList.h>
 
+#include "route_table.h"
 #include "routes.h"
 
 
@@ -24,6 +25,7 @@ struct net_domain_private : net_domain,
 	recursive_lock		lock;
 
 	RouteList			routes;
+	RouteTable			route_table;
 	RouteInfoList		route_infos;
 };
 
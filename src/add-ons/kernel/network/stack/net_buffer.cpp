@@ -16,9 +16,12 @@
 #include <util/list.h>
 
 #include <ByteOrder.h>
+#include <cpu.h>
 #include <debug.h>
 #include <kernel.h>
 #include <KernelExport.h>
+#include <net_stat.h>
+#include <smp.h>
 #include <util/DoublyLinkedList.h>
 
 #include <algorithm>
@@ -42,6 +45,12 @@
 
 #define BUFFER_SIZE 2048
 	// maximum implementation derived buffer size is 65536
+#define PREPEND_HEADER_SPACE 256
+	// header space for buffers we create ourselves, enough for the
+	// protocol headers that are usually prepended to them
+#define DATA_HEADER_MAGAZINE_CAPACITY 32
+	// per CPU data headers kept in the object cache, the default for
+	// BUFFER_SIZE objects would be 8
 
 #define ENABLE_DEBUGGER_COMMANDS	1
 #define ENABLE_STATS				1
@@ -166,10 +175,21 @@ static status_t read_data(net_buffer* _buffer, size_t offset, void* data,
 
 
 #if ENABLE_STATS
-static int32 sAllocatedDataHeaderCount = 0;
-static int32 sAllocatedNetBufferCount = 0;
-static int32 sEverAllocatedDataHeaderCount = 0;
-static int32 sEverAllocatedNetBufferCount = 0;
+// The counters are kept per CPU, so that allocating and freeing buffers
+// doesn't write to the same cache line from all CPUs. The allocated counts
+// of a single CPU may become negative, as buffers are often freed on
+// another CPU than the one they were allocated on. The peaks are only
+// updated every PEAK_SAMPLE_INTERVAL allocations.
+#define PEAK_SAMPLE_INTERVAL	64
+
+struct net_buffer_cpu_stats {
+	int32	allocated_data_headers;
+	int32	allocated_net_buffers;
+	int64	ever_allocated_data_headers;
+	int64	ever_allocated_net_buffers;
+} CACHE_LINE_ALIGN;
+
+static net_buffer_cpu_stats sCPUStats[SMP_MAX_CPUS];
 static int32 sMaxAllocatedDataHeaderCount = 0;
 static int32 sMaxAllocatedNetBufferCount = 0;
 #endif
@@ -647,17 +667,82 @@ dump_net_buffer(int argc, char** argv)
 
 #endif	// ENABLE_DEBUGGER_COMMANDS
 
+#if ENABLE_STATS
+
+static int32
+sum_allocated(int32 net_buffer_cpu_stats::*counter)
+{
+	int32 count = 0;
+	for (int32 i = 0; i < SMP_MAX_CPUS; i++)
+		count += atomic_get(&(sCPUStats[i].*counter));
+	return count;
+}
+
+
+static int64
+sum_ever_allocated(int64 net_buffer_cpu_stats::*counter)
+{
+	int64 count = 0;
+	for (int32 i = 0; i < SMP_MAX_CPUS; i++)
+		count += atomic_get64(&(sCPUStats[i].*counter));
+	return count;
+}
+
+
+static void
+update_peak(int32* _peak, int32 net_buffer_cpu_stats::*counter)
+{
+	int32 current = sum_allocated(counter);
+	int32 peak = atomic_get(_peak);
+	if (current > peak)
+		atomic_test_and_set(_peak, current, peak);
+}
+
+
+#endif	// ENABLE_STATS
+
+
+status_t
+get_net_buffer_stats(net_buffer_stats* stats)
+{
+	memset(stats, 0, sizeof(net_buffer_stats));
+	stats->data_header_size = BUFFER_SIZE;
+
+#if ENABLE_STATS
+	stats->allocated_data_headers
+		= sum_allocated(&net_buffer_cpu_stats::allocated_data_headers);
+	stats->max_allocated_data_headers = max_c(stats->allocated_data_headers,
+		atomic_get(&sMaxAllocatedDataHeaderCount));
+	stats->ever_allocated_data_headers = sum_ever_allocated(
+		&net_buffer_cpu_stats::ever_allocated_data_headers);
+
+	stats->allocated_net_buffers
+		= sum_allocated(&net_buffer_cpu_stats::allocated_net_buffers);
+	stats->max_allocated_net_buffers = max_c(stats->allocated_net_buffers,
+		atomic_get(&sMaxAllocatedNetBufferCount));
+	stats->ever_allocated_net_buffers = sum_ever_allocated(
+		&net_buffer_cpu_stats::ever_allocated_net_buffers);
+	return B_OK;
+#else
+	return B_NOT_SUPPORTED;
+#endif
+}
+
+
 #if ENABLE_STATS
 
 static int
 dump_net_buffer_stats(int argc, char** argv)
 {
-	kprintf("allocated data headers: %7" B_PRId32 " / %7" B_PRId32 ", peak %7"
-		B_PRId32 "\n", sAllocatedDataHeaderCount, sEverAllocatedDataHeaderCount,
-		sMaxAllocatedDataHeaderCount);
-	kprintf("allocated net buffers:  %7" B_PRId32 " / %7" B_PRId32 ", peak %7"
-		B_PRId32 "\n", sAllocatedNetBufferCount, sEverAllocatedNetBufferCount,
-		sMaxAllocatedNetBufferCount);
+	net_buffer_stats stats;
+	get_net_buffer_stats(&stats);
+
+	kprintf("allocated data headers: %7" B_PRId32 " / %10" B_PRId64 ", peak %7"
+		B_PRId32 "\n", stats.allocated_data_headers,
+		stats.ever_allocated_data_headers, stats.max_allocated_data_headers);
+	kprintf("allocated net buffers:  %7" B_PRId32 " / %10" B_PRId64 ", peak %7"
+		B_PRId32 "\n", stats.allocated_net_buffers,
+		stats.ever_allocated_net_buffers, stats.max_allocated_net_buffers);
 	return 0;
 }
 
@@ -749,12 +834,13 @@ static inline data_header*
 allocate_data_header()
 {
 #if ENABLE_STATS
-	int32 current = atomic_add(&sAllocatedDataHeaderCount, 1) + 1;
-	int32 max = atomic_get(&sMaxAllocatedDataHeaderCount);
-	if (current > max)
-		atomic_test_and_set(&sMaxAllocatedDataHeaderCount, current, max);
-
-	atomic_add(&sEverAllocatedDataHeaderCount, 1);
+	net_buffer_cpu_stats& stats = sCPUStats[smp_get_current_cpu()];
+	atomic_add(&stats.allocated_data_headers, 1);
+	if (atomic_add64(&stats.ever_allocated_data_headers, 1)
+			% PEAK_SAMPLE_INTERVAL == 0) {
+		update_peak(&sMaxAllocatedDataHeaderCount,
+			&net_buffer_cpu_stats::allocated_data_headers);
+	}
 #endif
 	return (data_header*)object_cache_alloc(sDataNodeCache, 0);
 }
@@ -764,12 +850,13 @@ static inline net_buffer_private*
 allocate_net_buffer()
 {
 #if ENABLE_STATS
-	int32 current = atomic_add(&sAllocatedNetBufferCount, 1) + 1;
-	int32 max = atomic_get(&sMaxAllocatedNetBufferCount);
-	if (current > max)
-		atomic_test_and_set(&sMaxAllocatedNetBufferCount, current, max);
-
-	atomic_add(&sEverAllocatedNetBufferCount, 1);
+	net_buffer_cpu_stats& stats = sCPUStats[smp_get_current_cpu()];
+	atomic_add(&stats.allocated_net_buffers, 1);
+	if (atomic_add64(&stats.ever_allocated_net_buffers, 1)
+			% PEAK_SAMPLE_INTERVAL == 0) {
+		update_peak(&sMaxAllocatedNetBufferCount,
+			&net_buffer_cpu_stats::allocated_net_buffers);
+	}
 #endif
 	return (net_buffer_private*)object_cache_alloc(sNetBufferCache, 0);
 }
@@ -779,8 +866,10 @@ static inline void
 free_data_header(data_header* header)
 {
 #if ENABLE_STATS
-	if (header != NULL)
-		atomic_add(&sAllocatedDataHeaderCount, -1);
+	if (header != NULL) {
+		atomic_add(
+			&sCPUStats[smp_get_current_cpu()].allocated_data_headers, -1);
+	}
 #endif
 	object_cache_free(sDataNodeCache, header, 0);
 }
@@ -790,8 +879,10 @@ static inline void
 free_net_buffer(net_buffer_private* buffer)
 {
 #if ENABLE_STATS
-	if (buffer != NULL)
-		atomic_add(&sAllocatedNetBufferCount, -1);
+	if (buffer != NULL) {
+		atomic_add(
+			&sCPUStats[smp_get_current_cpu()].allocated_net_buffers, -1);
+	}
 #endif
 	object_cache_free(sNetBufferCache, buffer, 0);
 }
@@ -1179,10 +1270,9 @@ duplicate_buffer(net_buffer* _buffer)
 
 	TRACE(("%d: duplicate_buffer(buffer %p)\n", find_thread(NULL), buffer));
 
-	// TODO: We might want to choose a better header space. The minimal
-	// one doesn't allow to prepend any data without allocating a new header.
-	// The same holds for appending cloned data.
-	net_buffer* duplicate = create_buffer(DATA_NODE_SIZE);
+	// Leave room for the headers that are usually prepended, so that this
+	// does not need another data header.
+	net_buffer* duplicate = create_buffer(PREPEND_HEADER_SPACE);
 	if (duplicate == NULL)
 		return NULL;
 
@@ -1333,7 +1423,7 @@ clone_buffer(net_buffer* _buffer, bool shareFreeSpace)
 static net_buffer*
 split_buffer(net_buffer* from, uint32 offset)
 {
-	net_buffer* buffer = create_buffer(DATA_NODE_SIZE);
+	net_buffer* buffer = create_buffer(PREPEND_HEADER_SPACE);
 	if (buffer == NULL)
 		return NULL;
 
@@ -2317,8 +2407,9 @@ std_ops(int32 op, ...)
 			if (sNetBufferCache == NULL)
 				return B_NO_MEMORY;
 
-			sDataNodeCache = create_object_cache("data node cache", BUFFER_SIZE,
-				0, NULL, NULL, NULL);
+			sDataNodeCache = create_object_cache_etc("data node cache",
+				BUFFER_SIZE, 0, 0, DATA_HEADER_MAGAZINE_CAPACITY, 0, 0, NULL,
+				NULL, NULL, NULL);
 			if (sDataNodeCache == NULL) {
 				delete_object_cache(sNetBufferCache);
 				return B_NO_MEMORY;
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/sockio.h>
 #include <sys/time.h>
 
 #include <new>
@@ -34,6 +35,7 @@
 #include <net_stat.h>
 
 #include "ancillary_data.h"
+#include "routes.h"
 #include "utility.h"
 
 
@@ -65,6 +67,7 @@ struct net_socket_private : net_socket,
 
 	struct select_sync_pool*	select_pool;
 	mutex						lock;
+	net_route_cache				route_cache;
 
 	bool						is_connected;
 	bool						is_in_socket_list;
@@ -101,6 +104,7 @@ net_socket_private::net_socket_private()
 	peer.ss_len = 0;
 
 	mutex_init(&lock, "socket");
+	init_route_cache(&route_cache);
 
 	// set defaults (may be overridden by the protocols)
 	send.buffer_size = 65535;
@@ -136,6 +140,7 @@ net_socket_private::~net_socket_private()
 
 	mutex_unlock(&lock);
 
+	uninit_route_cache(&route_cache);
 	put_domain_protocols(this);
 
 	mutex_destroy(&lock);
@@ -412,6 +417,16 @@ dump_sockets(int argc, char** argv)
 //	#pragma mark -
 
 
+/*!	Returns the route the \a socket sent its last packet along.
+*/
+net_route_cache*
+get_socket_route_cache(net_socket* _socket)
+{
+	net_socket_private* socket = (net_socket_private*)_socket;
+	return &socket->route_cache;
+}
+
+
 status_t
 socket_open(int family, int type, int protocol, net_socket** _socket)
 {
@@ -505,6 +520,27 @@ socket_control(net_socket* socket, uint32 op, void* data, size_t length)
 			return socket_setsockopt(socket, SOL_SOCKET, SO_NONBLOCK, &value,
 				sizeof(int));
 		}
+
+		case B_SOCKET_GET_BUFFER_STATS:
+		{
+			if (data == NULL)
+				return B_BAD_VALUE;
+
+			net_buffer_stats stats;
+			status_t status = get_net_buffer_stats(&stats);
+			if (status != B_OK)
+				return status;
+
+			if (is_syscall()) {
+				if (!IS_USER_ADDRESS(data)
+					|| user_memcpy(data, &stats, sizeof(stats)) != B_OK) {
+					return B_BAD_ADDRESS;
+				}
+			} else
+				memcpy(data, &stats, sizeof(stats));
+
+			return B_OK;
+		}
 	}
 
 	return socket->first_info->control(socket->first_protocol,
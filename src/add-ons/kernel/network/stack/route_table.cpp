@@ -0,0 +1,350 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "route_table.h"
+
+#include <net_device.h>
+
+#include <net/if.h>
+#include <net/route.h>
+#include <netinet/in.h>
+#include <new>
+#include <string.h>
+
+
+static const uint8 kZeroAddress[16] = {};
+
+
+RouteTable::RouteTable()
+	:
+	fFamily(AF_UNSPEC),
+	fAddressBits(0),
+	fRoot(NULL)
+{
+}
+
+
+RouteTable::~RouteTable()
+{
+	_Free(fRoot);
+}
+
+
+void
+RouteTable::Init(int family)
+{
+	fFamily = family;
+
+	switch (family) {
+		case AF_INET:
+			fAddressBits = 32;
+			break;
+		case AF_INET6:
+			fAddressBits = 128;
+			break;
+		default:
+			// other domains keep using the route list only
+			fAddressBits = 0;
+			break;
+	}
+}
+
+
+/*!	Adds \a route to the table. Among the routes for the same prefix, it is
+	tried after the existing ones, except for default routes, which are
+	ordered by the link speed of their device.
+*/
+status_t
+RouteTable::Add(net_route_private* route)
+{
+	if (fAddressBits == 0)
+		return B_OK;
+
+	Node* node = _Insert(_Address(route->destination), _PrefixLength(route));
+	if (node == NULL)
+		return B_NO_MEMORY;
+
+	RouteTableList::Iterator iterator = node->routes.GetIterator();
+	net_route_private* before = NULL;
+
+	while ((before = iterator.Next()) != NULL) {
+		if ((route->flags & RTF_DEFAULT) != 0
+			&& (before->flags & RTF_DEFAULT) != 0
+			&& before->interface_address->interface->device->link_speed
+				< route->interface_address->interface->device->link_speed)
+			break;
+	}
+
+	node->routes.InsertBefore(before, route);
+	return B_OK;
+}
+
+
+void
+RouteTable::Remove(net_route_private* route)
+{
+	if (fAddressBits == 0)
+		return;
+
+	Node* node = _Find(_Address(route->destination), _PrefixLength(route));
+	if (node == NULL)
+		return;
+
+	node->routes.Remove(route);
+	_Prune(node);
+}
+
+
+/*!	Returns the routes with the same prefix as \a description, or \c NULL
+	if there are none.
+*/
+const RouteTableList*
+RouteTable::Routes(const net_route* description) const
+{
+	if (fAddressBits == 0)
+		return NULL;
+
+	Node* node = _Find(_Address(description->destination),
+		_PrefixLength(description));
+	if (node == NULL)
+		return NULL;
+
+	return &node->routes;
+}
+
+
+/*!	Returns the route for the longest prefix that matches \a address. Routes
+	to devices without a link are only returned if there is no other match.
+*/
+net_route_private*
+RouteTable::Lookup(const sockaddr* address) const
+{
+	const uint8* bits = _Address(address);
+
+	// find the most specific node that matches
+	Node* match = NULL;
+	for (Node* node = fRoot; node != NULL && _Matches(node, bits);
+			node = node->child[_Bit(bits, node->length)]) {
+		match = node;
+		if (node->length == fAddressBits)
+			break;
+	}
+
+	// all of its parents match, too
+	net_route_private* candidate = NULL;
+	for (; match != NULL; match = match->parent) {
+		RouteTableList::Iterator iterator = match->routes.GetIterator();
+		while (net_route_private* route = iterator.Next()) {
+			if ((route->interface_address->interface->device->flags & IFF_LINK)
+					!= 0)
+				return route;
+
+			if (candidate == NULL)
+				candidate = route;
+		}
+	}
+
+	return candidate;
+}
+
+
+const uint8*
+RouteTable::_Address(const sockaddr* address) const
+{
+	if (address == NULL)
+		return kZeroAddress;
+
+	if (fFamily == AF_INET)
+		return (const uint8*)&((const sockaddr_in*)address)->sin_addr;
+
+	return ((const sockaddr_in6*)address)->sin6_addr.s6_addr;
+}
+
+
+uint8
+RouteTable::_PrefixLength(const net_route* route) const
+{
+	if ((route->flags & RTF_DEFAULT) != 0)
+		return 0;
+	if (route->mask == NULL)
+		return fAddressBits;
+
+	// the mask has been checked to be contiguous already
+	const uint8* mask = _Address(route->mask);
+	uint8 length = 0;
+	while (length < fAddressBits && _Bit(mask, length) != 0)
+		length++;
+
+	return length;
+}
+
+
+RouteTable::Node*
+RouteTable::_Find(const uint8* prefix, uint8 length) const
+{
+	Node* node = fRoot;
+	while (node != NULL && node->length <= length
+		&& _CommonLength(node->prefix, prefix, node->length) == node->length) {
+		if (node->length == length)
+			return node;
+
+		node = node->child[_Bit(prefix, node->length)];
+	}
+
+	return NULL;
+}
+
+
+/*!	Returns the node for the given prefix, and creates it if needed.
+*/
+RouteTable::Node*
+RouteTable::_Insert(const uint8* prefix, uint8 length)
+{
+	Node* parent = NULL;
+	Node* node = fRoot;
+	uint8 common = 0;
+
+	while (node != NULL) {
+		common = _CommonLength(node->prefix, prefix,
+			min_c(node->length, length));
+		if (common < node->length)
+			break;
+		if (node->length == length)
+			return node;
+
+		parent = node;
+		node = node->child[_Bit(prefix, node->length)];
+	}
+
+	Node* leaf = new(std::nothrow) Node;
+	if (leaf == NULL)
+		return NULL;
+
+	memset(leaf->prefix, 0, sizeof(leaf->prefix));
+	memcpy(leaf->prefix, prefix, (length + 7) / 8);
+	leaf->length = length;
+	leaf->parent = parent;
+	leaf->child[0] = leaf->child[1] = NULL;
+
+	if (node == NULL) {
+		_SetChild(parent, leaf);
+		return leaf;
+	}
+
+	if (common == length) {
+		// the new prefix is a prefix of the node we stopped at
+		leaf->child[_Bit(node->prefix, length)] = node;
+		node->parent = leaf;
+		_SetChild(parent, leaf);
+		return leaf;
+	}
+
+	// the prefixes diverge, and need a node to branch
+	Node* branch = new(std::nothrow) Node;
+	if (branch == NULL) {
+		delete leaf;
+		return NULL;
+	}
+
+	memset(branch->prefix, 0, sizeof(branch->prefix));
+	memcpy(branch->prefix, prefix, (common + 7) / 8);
+	branch->length = common;
+	branch->parent = parent;
+	branch->child[_Bit(prefix, common)] = leaf;
+	branch->child[_Bit(node->prefix, common)] = node;
+	leaf->parent = branch;
+	node->parent = branch;
+	_SetChild(parent, branch);
+
+	return leaf;
+}
+
+
+/*!	Removes \a node, and the branches above it, if they are no longer
+	needed.
+*/
+void
+RouteTable::_Prune(Node* node)
+{
+	while (node != NULL && node->routes.IsEmpty()
+		&& (node->child[0] == NULL || node->child[1] == NULL)) {
+		Node* child = node->child[0] != NULL ? node->child[0] : node->child[1];
+		Node* parent = node->parent;
+
+		if (child != NULL)
+			child->parent = parent;
+		if (parent == NULL)
+			fRoot = child;
+		else
+			parent->child[parent->child[1] == node ? 1 : 0] = child;
+
+		delete node;
+
+		if (child != NULL) {
+			// the parent still has as many children as before
+			break;
+		}
+		node = parent;
+	}
+}
+
+
+void
+RouteTable::_SetChild(Node* parent, Node* node)
+{
+	if (parent == NULL)
+		fRoot = node;
+	else
+		parent->child[_Bit(node->prefix, parent->length)] = node;
+}
+
+
+void
+RouteTable::_Free(Node* node)
+{
+	if (node == NULL)
+		return;
+
+	_Free(node->child[0]);
+	_Free(node->child[1]);
+	delete node;
+}
+
+
+/*static*/ bool
+RouteTable::_Matches(const Node* node, const uint8* address)
+{
+	uint8 bytes = node->length / 8;
+	if (memcmp(node->prefix, address, bytes) != 0)
+		return false;
+
+	uint8 bits = node->length % 8;
+	if (bits == 0)
+		return true;
+
+	uint8 mask = 0xff << (8 - bits);
+	return ((node->prefix[bytes] ^ address[bytes]) & mask) == 0;
+}
+
+
+/*static*/ uint8
+RouteTable::_Bit(const uint8* address, uint8 index)
+{
+	return (address[index / 8] >> (7 - index % 8)) & 1;
+}
+
+
+/*static*/ uint8
+RouteTable::_CommonLength(const uint8* a, const uint8* b, uint8 length)
+{
+	uint8 common = 0;
+	while (common + 8 <= length && a[common / 8] == b[common / 8])
+		common += 8;
+	while (common < length && _Bit(a, common) == _Bit(b, common))
+		common++;
+
+	return common;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+
+#include "routes.h"
+
+
+/*!	Longest prefix match table for the routes of an IPv4 or IPv6 domain.
+
+	This is a path compressed binary trie: every node stores the complete
+	prefix it stands for, and only nodes that branch or have routes exist.
+	The routes for the same prefix are kept in the order in which they
+	should be tried.
+*/
+class RouteTable {
+public:
+								RouteTable();
+								~RouteTable();
+
+			void				Init(int family);
+
+			bool				IsEnabled() const
+									{ return fAddressBits != 0; }
+			bool				IsSupported(const sockaddr* address) const
+									{ return IsEnabled() && address != NULL
+										&& address->sa_family == fFamily; }
+
+			status_t			Add(net_route_private* route);
+			void				Remove(net_route_private* route);
+
+			const RouteTableList* Routes(const net_route* description) const;
+			net_route_private*	Lookup(const sockaddr* address) const;
+
+private:
+	struct Node {
+		uint8				prefix[16];
+		uint8				length;
+		Node*				parent;
+		Node*				child[2];
+		RouteTableList		routes;
+	};
+
+			const uint8*		_Address(const sockaddr* address) const;
+			uint8				_PrefixLength(const net_route* route) const;
+			Node*				_Find(const uint8* prefix, uint8 length) const;
+			Node*				_Insert(const uint8* prefix, uint8 length);
+			void				_Prune(Node* node);
+			void				_SetChild(Node* parent, Node* node);
+			void				_Free(Node* node);
+
+	static	bool				_Matches(const Node* node,
+									const uint8* address);
+	static	uint8				_Bit(const uint8* address, uint8 index);
+	static	uint8				_CommonLength(const uint8* a, const uint8* b,
+									uint8 length);
+
+private:
+			int					fFamily;
+			uint8				fAddressBits;
+			Node*				fRoot;
+};
+
+
+#endif	// ROUTE_TABLE_H
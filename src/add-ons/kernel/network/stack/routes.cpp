@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2010, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  *
  * Authors:
@@ -37,6 +37,12 @@
 #endif
 
 
+/*!	Changes whenever the result of a route lookup might change, and thus
+	invalidates the routes cached by the sockets.
+*/
+static int32 sRouteGeneration;
+
+
 net_route_private::net_route_private()
 {
 	destination = mask = gateway = NULL;
@@ -100,36 +106,53 @@ user_copy_address(const sockaddr* from, sockaddr_storage* to)
 }
 
 
+static bool
+route_matches(net_domain_private* domain, net_route_private* route,
+	const net_route* description)
+{
+	if ((route->flags & RTF_DEFAULT) != 0
+		&& (description->flags & RTF_DEFAULT) != 0) {
+		// there can only be one default route per interface address family
+		// TODO: check this better
+		return route->interface_address == description->interface_address;
+	}
+
+	return (route->flags & (RTF_GATEWAY | RTF_HOST | RTF_LOCAL | RTF_DEFAULT))
+			== (description->flags
+				& (RTF_GATEWAY | RTF_HOST | RTF_LOCAL | RTF_DEFAULT))
+		&& domain->address_module->equal_masked_addresses(
+			route->destination, description->destination, description->mask)
+		&& domain->address_module->equal_addresses(route->mask,
+			description->mask)
+		&& domain->address_module->equal_addresses(route->gateway,
+			description->gateway)
+		&& (description->interface_address == NULL
+			|| description->interface_address == route->interface_address);
+}
+
+
 static net_route_private*
 find_route(struct net_domain* _domain, const net_route* description)
 {
 	struct net_domain_private* domain = (net_domain_private*)_domain;
-	RouteList::Iterator iterator = domain->routes.GetIterator();
 
-	while (iterator.HasNext()) {
-		net_route_private* route = iterator.Next();
+	if (domain->route_table.IsEnabled()) {
+		// only routes with the same prefix can match
+		const RouteTableList* routes = domain->route_table.Routes(description);
+		if (routes == NULL)
+			return NULL;
 
-		if ((route->flags & RTF_DEFAULT) != 0
-			&& (description->flags & RTF_DEFAULT) != 0) {
-			// there can only be one default route per interface address family
-			// TODO: check this better
-			if (route->interface_address == description->interface_address)
+		RouteTableList::ConstIterator iterator = routes->GetIterator();
+		while (net_route_private* route = iterator.Next()) {
+			if (route_matches(domain, route, description))
 				return route;
-
-			continue;
 		}
+		return NULL;
+	}
 
-		if ((route->flags & (RTF_GATEWAY | RTF_HOST | RTF_LOCAL | RTF_DEFAULT))
-				== (description->flags
-					& (RTF_GATEWAY | RTF_HOST | RTF_LOCAL | RTF_DEFAULT))
-			&& domain->address_module->equal_masked_addresses(
-				route->destination, description->destination, description->mask)
-			&& domain->address_module->equal_addresses(route->mask,
-				description->mask)
-			&& domain->address_module->equal_addresses(route->gateway,
-				description->gateway)
-			&& (description->interface_address == NULL
-				|| description->interface_address == route->interface_address))
+	RouteList::Iterator iterator = domain->routes.GetIterator();
+	while (net_route_private* route = iterator.Next()) {
+		if (route_matches(domain, route, description))
 			return route;
 	}
 
@@ -142,14 +165,17 @@ find_route(net_domain* _domain, const sockaddr* address)
 {
 	net_domain_private* domain = (net_domain_private*)_domain;
 
+	TRACE("test address %s for routes...\n",
+		AddressString(domain, address).Data());
+
+	if (domain->route_table.IsSupported(address))
+		return domain->route_table.Lookup(address);
+
 	// find last matching route
 
 	RouteList::Iterator iterator = domain->routes.GetIterator();
 	net_route_private* candidate = NULL;
 
-	TRACE("test address %s for routes...\n",
-		AddressString(domain, address).Data());
-
 	// TODO: alternate equal default routes
 
 	while (iterator.HasNext()) {
@@ -187,11 +213,13 @@ find_route(net_domain* _domain, const sockaddr* address)
 }
 
 
+/*!	Does not need the domain lock: the routing table holds a reference to all
+	of its routes, so the last one can only go away once the route has been
+	removed from the table, and can no longer be found.
+*/
 static void
 put_route_internal(struct net_domain_private* domain, net_route* _route)
 {
-	ASSERT_LOCKED_RECURSIVE(&domain->lock);
-
 	net_route_private* route = (net_route_private*)_route;
 	if (route == NULL || atomic_add(&route->ref_count, -1) != 1)
 		return;
@@ -284,6 +312,32 @@ fill_route_entry(route_entry* target, void* _buffer, size_t bufferSize,
 }
 
 
+/*!	Sets the source of the \a buffer to the local address of the \a route.
+	Releases the reference to the route on failure.
+*/
+static status_t
+update_buffer_source(net_domain_private* domain, net_buffer* buffer,
+	net_route* route)
+{
+	status_t status = B_OK;
+	sockaddr* source = buffer->source;
+
+	// TODO: we are quite relaxed in the address checking here
+	// as we might proceed with source = INADDR_ANY.
+
+	if (route->interface_address != NULL
+		&& route->interface_address->local != NULL) {
+		status = domain->address_module->update_to(source,
+			route->interface_address->local);
+	}
+
+	if (status != B_OK)
+		put_route_internal(domain, route);
+
+	return status;
+}
+
+
 //	#pragma mark - exported functions
 
 
@@ -491,6 +545,20 @@ add_route(struct net_domain* _domain, const struct net_route* newRoute)
 	route->mtu = 0;
 	route->ref_count = 1;
 
+	if (domain->route_table.IsEnabled()) {
+		// the table decides the order in which routes are tried, so there is
+		// no need to keep the list sorted
+		if (domain->route_table.Add(route) != B_OK) {
+			put_route_internal(domain, route);
+			return B_NO_MEMORY;
+		}
+
+		domain->routes.Add(route);
+		invalidate_route_caches();
+		update_route_infos(domain);
+		return B_OK;
+	}
+
 	// Insert the route sorted by completeness of its mask
 
 	RouteList::Iterator iterator = domain->routes.GetIterator();
@@ -514,6 +582,7 @@ add_route(struct net_domain* _domain, const struct net_route* newRoute)
 	}
 
 	domain->routes.InsertBefore(before, route);
+	invalidate_route_caches();
 	update_route_infos(domain);
 
 	return B_OK;
@@ -541,7 +610,9 @@ remove_route(struct net_domain* _domain, const struct net_route* removeRoute)
 	if (route == NULL)
 		return B_ENTRY_NOT_FOUND;
 
+	domain->route_table.Remove(route);
 	domain->routes.Remove(route);
+	invalidate_route_caches();
 
 	put_route_internal(domain, route);
 	update_route_infos(domain);
@@ -658,21 +729,8 @@ get_buffer_route(net_domain* _domain, net_buffer* buffer, net_route** _route)
 	if (route == NULL)
 		return ENETUNREACH;
 
-	status_t status = B_OK;
-	sockaddr* source = buffer->source;
-
-	// TODO: we are quite relaxed in the address checking here
-	// as we might proceed with source = INADDR_ANY.
-
-	if (route->interface_address != NULL
-		&& route->interface_address->local != NULL) {
-		status = domain->address_module->update_to(source,
-			route->interface_address->local);
-	}
-
-	if (status != B_OK)
-		put_route_internal(domain, route);
-	else
+	status_t status = update_buffer_source(domain, buffer, route);
+	if (status == B_OK)
 		*_route = route;
 
 	return status;
@@ -686,12 +744,92 @@ put_route(struct net_domain* _domain, net_route* route)
 	if (domain == NULL || route == NULL)
 		return;
 
-	RecursiveLocker locker(domain->lock);
-
 	put_route_internal(domain, (net_route*)route);
 }
 
 
+void
+init_route_cache(net_route_cache* cache)
+{
+	mutex_init(&cache->lock, "route cache");
+	cache->domain = NULL;
+	cache->route = NULL;
+	cache->generation = 0;
+	cache->destination.ss_len = 0;
+}
+
+
+void
+uninit_route_cache(net_route_cache* cache)
+{
+	mutex_destroy(&cache->lock);
+}
+
+
+/*!	Like get_buffer_route(), but first tries the route that was used the last
+	time, if neither the destination nor the routing changed since then.
+	This saves senders the lookup.
+
+	The cache does not hold a reference to its route, so that it does not
+	keep removed routes, and their interfaces, alive. Since routes are only
+	removed with the domain lock held, and the generation is changed before
+	they are released, the route is still in the table as long as the
+	generation is unchanged while holding the domain lock.
+*/
+status_t
+get_cached_buffer_route(net_domain* _domain, net_route_cache* cache,
+	net_buffer* buffer, net_route** _route)
+{
+	net_domain_private* domain = (net_domain_private*)_domain;
+	MutexLocker locker(cache->lock);
+
+	net_route* route = cache->route;
+	int32 generation = atomic_get(&sRouteGeneration);
+
+	if (route != NULL && cache->domain == domain
+		&& cache->generation == generation
+		&& domain->address_module->equal_addresses(buffer->destination,
+			(sockaddr*)&cache->destination)) {
+		RecursiveLocker domainLocker(domain->lock);
+
+		if (cache->generation == atomic_get(&sRouteGeneration)) {
+			atomic_add(&((net_route_private*)route)->ref_count, 1);
+
+			status_t status = update_buffer_source(domain, buffer, route);
+			if (status == B_OK)
+				*_route = route;
+
+			return status;
+		}
+	}
+
+	status_t status = get_buffer_route(domain, buffer, &route);
+	if (status != B_OK) {
+		cache->route = NULL;
+		return status;
+	}
+
+	cache->domain = domain;
+	cache->route = route;
+	cache->generation = generation;
+	memcpy(&cache->destination, buffer->destination,
+		min_c(buffer->destination->sa_len, sizeof(sockaddr_storage)));
+
+	*_route = route;
+	return B_OK;
+}
+
+
+/*!	Makes the sockets look up their routes again. This needs to be called
+	whenever a lookup could return a different route than before.
+*/
+void
+invalidate_route_caches()
+{
+	atomic_add(&sRouteGeneration, 1);
+}
+
+
 status_t
 register_route_info(struct net_domain* _domain, struct net_route_info* info)
 {
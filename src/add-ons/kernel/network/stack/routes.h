@@ -1,5 +1,5 @@
 /*
- * Copyright 2006-2010, Haiku, Inc. All Rights Reserved.
+ * Copyright 2006-2026, Haiku, Inc. All Rights Reserved.
  * Distributed under the terms of the MIT License.
  *
  * Authors:
@@ -12,8 +12,11 @@
 #include <net_datalink.h>
 #include <net_stack.h>
 
+#include <lock.h>
 #include <util/DoublyLinkedList.h>
 
+#include <sys/socket.h>
+
 
 struct InterfaceAddress;
 
@@ -21,15 +24,30 @@ struct InterfaceAddress;
 struct net_route_private
 	: net_route, DoublyLinkedListLinkImpl<net_route_private> {
 	int32	ref_count;
+	DoublyLinkedListLink<net_route_private> table_link;
 
 	net_route_private();
 	~net_route_private();
 };
 
 typedef DoublyLinkedList<net_route_private> RouteList;
+typedef DoublyLinkedList<net_route_private,
+	DoublyLinkedListMemberGetLink<net_route_private,
+		&net_route_private::table_link> > RouteTableList;
 typedef DoublyLinkedList<net_route_info,
 	DoublyLinkedListCLink<net_route_info> > RouteInfoList;
 
+/*!	The last route a socket sent to, valid as long as the routing is
+	unchanged. It does not hold a reference to the route.
+*/
+struct net_route_cache {
+	mutex				lock;
+	net_domain*			domain;
+	net_route*			route;
+	int32				generation;
+	sockaddr_storage	destination;
+};
+
 
 uint32 route_table_size(struct net_domain_private* domain);
 status_t list_routes(struct net_domain_private* domain, void* buffer,
@@ -53,6 +71,13 @@ status_t get_buffer_route(struct net_domain* domain,
 				struct net_buffer* buffer, struct net_route** _route);
 void put_route(struct net_domain* domain, struct net_route* route);
 
+void init_route_cache(struct net_route_cache* cache);
+void uninit_route_cache(struct net_route_cache* cache);
+status_t get_cached_buffer_route(struct net_domain* domain,
+				struct net_route_cache* cache, struct net_buffer* buffer,
+				struct net_route** _route);
+void invalidate_route_caches();
+
 status_t register_route_info(struct net_domain* domain,
 				struct net_route_info* info);
 status_t unregister_route_info(struct net_domain* domain,
@@ -24,6 +24,8 @@
 
 
 class Interface;
+struct net_buffer_stats;
+struct net_route_cache;
 
 
 extern net_stack_module_info gNetStackModule;
@@ -43,6 +45,12 @@ status_t get_domain_datalink_protocols(Interface* interface,
 status_t put_domain_datalink_protocols(Interface* interface,
 	net_domain* domain);
 
+// net_buffer.cpp
+status_t get_net_buffer_stats(net_buffer_stats* stats);
+
+// net_socket.cpp
+net_route_cache* get_socket_route_cache(net_socket* socket);
+
 // notifications.cpp
 status_t notify_interface_added(net_interface* interface);
 status_t notify_interface_removed(net_interface* interface);
@@ -9,10 +9,12 @@
 #include "PoorManServer.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h> //for struct timeval
+#include <sys/sendfile.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -417,7 +419,38 @@ status_t PoorManServer::_HandleGet(httpd_conn* hc)
 		delete [] buf;
 		return B_ERROR;
 	}
-	
+
+	// let the kernel send the file, so that it is not copied to us and back
+	int fd = open(hc->expnfilename, O_RDONLY);
+	if (fd >= 0) {
+		off_t offset = hc->first_byte_index;
+		ssize_t bytesSent = 0;
+		while (offset < hc->sb.st_size) {
+			bytesSent = sendfile(hc->conn_fd, fd, &offset,
+				min_c(hc->sb.st_size - offset, POOR_MAN_BUF_SIZE));
+			if (bytesSent <= 0)
+				break;
+		}
+		close(fd);
+
+		if (bytesSent >= 0) {
+			delete [] buf;
+			return B_OK;
+		}
+		if (offset != hc->first_byte_index) {
+			log.SetTo("Error sending file: ");
+			if (pthread_rwlock_rdlock(&fWebDirLock) == 0) {
+				log << hc->hs->cwd;
+				pthread_rwlock_unlock(&fWebDirLock);
+			}
+			log << '/' << hc->expnfilename << '\n';
+			poorman_log(log.String(), true, &hc->client_addr, RED);
+			delete [] buf;
+			return B_ERROR;
+		}
+		// nothing was sent, try again the old way
+	}
+
 	file.Seek(hc->first_byte_index, SEEK_SET);
 	while (true) {
 		bytesRead = file.Read(buf, POOR_MAN_BUF_SIZE);
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/sockio.h>
 #include <unistd.h>
 
 #include <SupportDefs.h>
@@ -118,9 +119,10 @@ inet_print_address(sockaddr* _address)
 void
 usage(int status)
 {
-	printf("Usage: %s [-nh]\n", kProgramName);
+	printf("Usage: %s [-nmh]\n", kProgramName);
 	printf("Options:\n");
 	printf("	-n	don't resolve names\n");
+	printf("	-m	show network buffer statistics\n");
 	printf("	-h	this help\n");
 	printf("Filter options:\n");
 	printf("	-4	IPv4\n");
@@ -134,6 +136,39 @@ usage(int status)
 }
 
 
+int
+print_buffer_stats()
+{
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0) {
+		fprintf(stderr, "%s: Could not open socket: %s\n", kProgramName,
+			strerror(errno));
+		return 1;
+	}
+
+	net_buffer_stats stats;
+	if (ioctl(fd, B_SOCKET_GET_BUFFER_STATS, &stats, sizeof(stats)) != 0) {
+		fprintf(stderr, "%s: Could not get buffer statistics: %s\n",
+			kProgramName, strerror(errno));
+		close(fd);
+		return 1;
+	}
+	close(fd);
+
+	printf("Type          In use       Peak        Allocated\n");
+	printf("buffers   %10" B_PRId32 " %10" B_PRId32 " %16" B_PRId64 "\n",
+		stats.allocated_net_buffers, stats.max_allocated_net_buffers,
+		stats.ever_allocated_net_buffers);
+	printf("data      %10" B_PRId32 " %10" B_PRId32 " %16" B_PRId64 "\n",
+		stats.allocated_data_headers, stats.max_allocated_data_headers,
+		stats.ever_allocated_data_headers);
+	printf("%" B_PRId64 " KB in use by data (%" B_PRIuSIZE " bytes each)\n",
+		(int64)stats.allocated_data_headers * stats.data_header_size / 1024,
+		stats.data_header_size);
+	return 0;
+}
+
+
 bool
 get_address_family(const char* argument, int32& familyIndex)
 {
@@ -162,10 +197,12 @@ main(int argc, char** argv)
 	int optionIndex = 0;
 	int opt;
 	int filter = 0;
+	bool bufferStats = false;
 
 	const static struct option kLongOptions[] = {
 		{"help", no_argument, 0, 'h'},
 		{"numeric", no_argument, 0, 'n'},
+		{"memory", no_argument, 0, 'm'},
 
 		{"inet", no_argument, 0, '4'},
 		{"inet6", no_argument, 0, '6'},
@@ -180,7 +217,7 @@ main(int argc, char** argv)
 	};
 
 	do {
-		opt = getopt_long(argc, argv, "hn46xtul", kLongOptions,
+		opt = getopt_long(argc, argv, "hnm46xtul", kLongOptions,
 			&optionIndex);
 		switch (opt) {
 			case -1:
@@ -190,6 +227,9 @@ main(int argc, char** argv)
 			case 'n':
 				sResolveNames = 0;
 				break;
+			case 'm':
+				bufferStats = true;
+				break;
 
 			// Family filter
 			case '4':
@@ -220,6 +260,9 @@ main(int argc, char** argv)
 		}
 	} while (opt != -1);
 
+	if (bufferStats)
+		return print_buffer_stats();
+
 	bool printProgram = true;
 		// TODO: add some more program options... :-)
 
@@ -29,8 +29,11 @@
 #endif
 
 static const size_t kMaxStringSize = 4096;
-static const size_t kWatermark = kInitialBufferSize - 24;
-	// if a message is started after this mark, the buffer is flushed automatically
+static const size_t kWatermarkSlack = 24;
+	// if a message is started within this distance to the batch size, the
+	// buffer is flushed automatically
+static const bigtime_t kBatchInterval = 2000;
+	// automatic flushes closer together than this let the batch size grow
 
 namespace BPrivate {
 
@@ -43,7 +46,12 @@ LinkSender::LinkSender(port_id port)
 
 	fCurrentEnd(0),
 	fCurrentStart(0),
-	fCurrentStatus(B_OK)
+	fCurrentStatus(B_OK),
+
+	fBatchSize(kInitialBufferSize),
+	fLastFlush(0),
+	fMessageCount(0),
+	fFlushCount(0)
 {
 }
 
@@ -77,11 +85,22 @@ LinkSender::StartMessage(int32 code, size_t minSize)
 
 	// Eventually flush buffer to make space for the new message.
 	// Note, we do not take the actual buffer size into account to not
-	// delay the time between buffer flushes too much.
-	if (fBufferSize > 0 && (minSize > SpaceLeft() || fCurrentStart >= kWatermark)) {
-		status_t status = Flush();
-		if (status < B_OK)
-			return status;
+	// delay the time between buffer flushes too much; instead, the batch
+	// size adapts to how quickly the messages are coming in.
+	if (fBufferSize > 0) {
+		bool flush = fCurrentStart + kWatermarkSlack >= fBatchSize;
+		if (!flush && minSize > SpaceLeft()) {
+			flush = fCurrentEnd + minSize > fBatchSize
+				|| GrowBuffer(fBatchSize) != B_OK;
+		}
+
+		if (flush) {
+			UpdateBatchSize();
+
+			status_t status = Flush();
+			if (status < B_OK)
+				return status;
+		}
 	}
 
 	if (minSize > fBufferSize) {
@@ -119,6 +138,7 @@ LinkSender::EndMessage(bool needsReply)
 
 	// bump to start of next message
 	fCurrentStart = fCurrentEnd;
+	fMessageCount++;
 	return B_OK;
 }
 
@@ -153,9 +173,10 @@ LinkSender::Attach(const void *passedData, size_t passedSize)
 	}
 
 	if (SpaceLeft() < size) {
-		// we have to make space for the data
+		// we have to make space for the data, but keep the batch size
 
-		status_t status = FlushCompleted(size + CurrentMessageSize());
+		status_t status = FlushCompleted(max_c(fBatchSize,
+			size + CurrentMessageSize()));
 		if (status < B_OK)
 			return fCurrentStatus = status;
 	}
@@ -261,6 +282,45 @@ LinkSender::AdjustBuffer(size_t newSize, char **_oldBuffer)
 }
 
 
+/*!	Grows the buffer to \a newBufferSize while keeping its contents, unlike
+	AdjustBuffer().
+*/
+status_t
+LinkSender::GrowBuffer(size_t newBufferSize)
+{
+	if (newBufferSize <= fBufferSize)
+		return B_OK;
+
+	char *oldBuffer = NULL;
+	status_t status = AdjustBuffer(newBufferSize, &oldBuffer);
+	if (status != B_OK)
+		return status;
+
+	if (oldBuffer != fBuffer) {
+		memcpy(fBuffer, oldBuffer, fCurrentEnd);
+		free(oldBuffer);
+	}
+
+	return B_OK;
+}
+
+
+/*!	Called before an automatic flush. If the buffer fills up quickly, for
+	example while a window is drawing many small views, the batch size is
+	doubled, so that fewer and larger port messages are written. Once the
+	messages come in slowly again, it shrinks back to keep the latency low.
+*/
+void
+LinkSender::UpdateBatchSize()
+{
+	if (system_time() - fLastFlush < kBatchInterval) {
+		if (fBatchSize < kMaxBatchSize)
+			fBatchSize *= 2;
+	} else if (fBatchSize > kInitialBufferSize)
+		fBatchSize /= 2;
+}
+
+
 status_t
 LinkSender::FlushCompleted(size_t newBufferSize)
 {
@@ -329,6 +389,9 @@ LinkSender::Flush(bigtime_t timeout, bool needsReply)
 	fCurrentEnd = 0;
 	fCurrentStart = 0;
 
+	fLastFlush = system_time();
+	fFlushCount++;
+
 	return B_OK;
 }
 
@@ -82,6 +82,35 @@ port_id BMessage::sReplyPorts[sNumReplyPorts];
 int32 BMessage::sReplyPortInUse[sNumReplyPorts];
 
 
+static const size_t kMessageHeaderBlockSize = sizeof(BMessage::message_header)
+	+ MESSAGE_INLINE_FIELD_COUNT * sizeof(BMessage::field_header)
+	+ MESSAGE_INLINE_DATA_SIZE;
+
+
+/*!	Allocates a message header together with the inline storage that holds
+	the fields and data of small messages.
+*/
+static inline BMessage::message_header*
+allocate_message_header()
+{
+	return (BMessage::message_header*)malloc(kMessageHeaderBlockSize);
+}
+
+
+static inline BMessage::field_header*
+inline_fields(BMessage::message_header* header)
+{
+	return (BMessage::field_header*)(header + 1);
+}
+
+
+static inline uint8*
+inline_data(BMessage::message_header* header)
+{
+	return (uint8*)(inline_fields(header) + MESSAGE_INLINE_FIELD_COUNT);
+}
+
+
 template<typename Type>
 static void
 print_to_stream_type(uint8* pointer)
@@ -194,7 +223,7 @@ BMessage::operator=(const BMessage& other)
 
 	_Clear();
 
-	fHeader = (message_header*)malloc(sizeof(message_header));
+	fHeader = allocate_message_header();
 	if (fHeader == NULL)
 		return *this;
 
@@ -210,34 +239,35 @@ BMessage::operator=(const BMessage& other)
 		| MESSAGE_FLAG_PASS_BY_AREA);
 	// Note, that BeOS R5 seems to keep the reply info.
 
-	if (fHeader->field_count > 0) {
-		size_t fieldsSize = fHeader->field_count * sizeof(field_header);
-		if (other.fFields != NULL)
-			fFields = (field_header*)malloc(fieldsSize);
-
-		if (fFields == NULL) {
-			fHeader->field_count = 0;
-			fHeader->data_size = 0;
-		} else if (other.fFields != NULL)
-			memcpy(fFields, other.fFields, fieldsSize);
+	// The header has been copied from the other message, so we temporarily
+	// need to pretend to have no fields or data for the reallocations below.
+	uint32 fieldCount = fHeader->field_count;
+	uint32 dataSize = fHeader->data_size;
+	fHeader->field_count = 0;
+	fHeader->data_size = 0;
+
+	if (fieldCount > 0) {
+		if (other.fFields != NULL && _ReallocateFields(fieldCount) == B_OK) {
+			memcpy(fFields, other.fFields, fieldCount * sizeof(field_header));
+			fHeader->field_count = fieldCount;
+			fFieldsAvailable -= fieldCount;
+		} else
+			dataSize = 0;
 	}
 
-	if (fHeader->data_size > 0) {
-		if (other.fData != NULL)
-			fData = (uint8*)malloc(fHeader->data_size);
-
-		if (fData == NULL) {
+	if (dataSize > 0) {
+		if (other.fData != NULL && _ReallocateData(dataSize) == B_OK) {
+			memcpy(fData, other.fData, dataSize);
+			fHeader->data_size = dataSize;
+			fDataAvailable -= dataSize;
+		} else {
 			fHeader->field_count = 0;
-			free(fFields);
-			fFields = NULL;
-		} else if (other.fData != NULL)
-			memcpy(fData, other.fData, fHeader->data_size);
+			_FreeFieldsAndData();
+		}
 	}
 
 	fHeader->what = what = other.what;
 	fHeader->message_area = -1;
-	fFieldsAvailable = 0;
-	fDataAvailable = 0;
 
 	return *this;
 }
@@ -371,7 +401,7 @@ BMessage::_InitHeader()
 {
 	DEBUG_FUNCTION_ENTER;
 	if (fHeader == NULL) {
-		fHeader = (message_header*)malloc(sizeof(message_header));
+		fHeader = allocate_message_header();
 		if (fHeader == NULL)
 			return B_NO_MEMORY;
 	}
@@ -409,15 +439,13 @@ BMessage::_Clear()
 
 		if (fHeader->message_area >= 0)
 			_Dereference();
-
-		free(fHeader);
-		fHeader = NULL;
 	}
 
-	free(fFields);
-	fFields = NULL;
-	free(fData);
-	fData = NULL;
+	// The fields and data might live in the header allocation, so they have
+	// to go first.
+	_FreeFieldsAndData();
+	free(fHeader);
+	fHeader = NULL;
 
 	fArchivingPointer = NULL;
 
@@ -1153,7 +1181,7 @@ BMessage::_FlattenToArea(message_header** _header) const
 	char* address = NULL;
 	size_t fieldsSize = header->field_count * sizeof(field_header);
 	size_t size = fieldsSize + header->data_size;
-	size = (size + B_PAGE_SIZE) & ~(B_PAGE_SIZE - 1);
+	size = (size + B_PAGE_SIZE - 1) & ~(B_PAGE_SIZE - 1);
 	area_id area = create_area("BMessage data", (void**)&address,
 		B_ANY_ADDRESS, size, B_NO_LOCK, B_READ_AREA | B_WRITE_AREA);
 
@@ -1318,7 +1346,7 @@ BMessage::Unflatten(BDataIO* stream)
 
 	_Clear();
 
-	fHeader = (message_header*)malloc(sizeof(message_header));
+	fHeader = allocate_message_header();
 	if (fHeader == NULL)
 		return B_NO_MEMORY;
 
@@ -1344,30 +1372,38 @@ BMessage::Unflatten(BDataIO* stream)
 	} else {
 		fHeader->message_area = -1;
 
-		if (fHeader->field_count > 0) {
-			ssize_t fieldsSize = fHeader->field_count * sizeof(field_header);
-			fFields = (field_header*)malloc(fieldsSize);
-			if (fFields == NULL) {
+		uint32 fieldCount = fHeader->field_count;
+		uint32 dataSize = fHeader->data_size;
+		fHeader->field_count = 0;
+		fHeader->data_size = 0;
+
+		if (fieldCount > 0) {
+			if (_ReallocateFields(fieldCount) != B_OK) {
 				_InitHeader();
 				return B_NO_MEMORY;
 			}
 
+			ssize_t fieldsSize = fieldCount * sizeof(field_header);
+			fHeader->field_count = fieldCount;
+			fFieldsAvailable -= fieldCount;
+
 			result = stream->Read(fFields, fieldsSize);
 			if (result != fieldsSize)
 				return result < 0 ? result : B_BAD_VALUE;
 		}
 
-		if (fHeader->data_size > 0) {
-			fData = (uint8*)malloc(fHeader->data_size);
-			if (fData == NULL) {
-				free(fFields);
-				fFields = NULL;
+		if (dataSize > 0) {
+			if (_ReallocateData(dataSize) != B_OK) {
+				_FreeFieldsAndData();
 				_InitHeader();
 				return B_NO_MEMORY;
 			}
 
-			result = stream->Read(fData, fHeader->data_size);
-			if (result != (ssize_t)fHeader->data_size)
+			fHeader->data_size = dataSize;
+			fDataAvailable -= dataSize;
+
+			result = stream->Read(fData, dataSize);
+			if (result != (ssize_t)dataSize)
 				return result < 0 ? result : B_BAD_VALUE;
 		}
 	}
@@ -1582,24 +1618,23 @@ BMessage::_ResizeData(uint32 offset, int32 change)
 			return B_OK;
 		}
 
-		// We need to grow the buffer. We try to optimize reallocations by
-		// preallocating space for more fields.
-		size_t size = fHeader->data_size * 2;
-		size = min_c(size, fHeader->data_size + MAX_DATA_PREALLOCATION);
-		size = max_c(size, fHeader->data_size + change);
+		// We need to grow the buffer. We grow it geometrically, so that
+		// building large messages does not end up copying the data over and
+		// over again.
+		size_t size = fHeader->data_size
+			+ max_c(fHeader->data_size / 2, (uint32)change);
 
-		uint8* newData = (uint8*)realloc(fData, size);
-		if (size > 0 && newData == NULL)
-			return B_NO_MEMORY;
+		status_t result = _ReallocateData(size);
+		if (result != B_OK)
+			return result;
 
-		fData = newData;
 		if (offset < fHeader->data_size) {
 			memmove(fData + offset + change, fData + offset,
 				fHeader->data_size - offset);
 		}
 
 		fHeader->data_size += change;
-		fDataAvailable = size - fHeader->data_size;
+		fDataAvailable -= change;
 	} else {
 		ssize_t length = fHeader->data_size - offset + change;
 		if (length > 0)
@@ -1609,18 +1644,11 @@ BMessage::_ResizeData(uint32 offset, int32 change)
 		fHeader->data_size += change;
 		fDataAvailable -= change;
 
-		if (fDataAvailable > MAX_DATA_PREALLOCATION) {
-			ssize_t available = MAX_DATA_PREALLOCATION / 2;
-			ssize_t size = fHeader->data_size + available;
-			uint8* newData = (uint8*)realloc(fData, size);
-			if (size > 0 && newData == NULL) {
-				// this is strange, but not really fatal
-				_UpdateOffsets(offset, change);
-				return B_OK;
-			}
-
-			fData = newData;
-			fDataAvailable = available;
+		if (fDataAvailable > MAX_DATA_PREALLOCATION
+			&& fDataAvailable > fHeader->data_size) {
+			// If this fails, we just keep the larger buffer; this is strange,
+			// but not really fatal
+			_ReallocateData(fHeader->data_size + MAX_DATA_PREALLOCATION / 2);
 		}
 	}
 
@@ -1629,9 +1657,96 @@ BMessage::_ResizeData(uint32 offset, int32 change)
 }
 
 
+status_t
+BMessage::_ReallocateFields(uint32 count)
+{
+	field_header* inlineFields = inline_fields(fHeader);
+	field_header* newFields;
+
+	if (fFields == NULL || fFields == inlineFields) {
+		if (count <= MESSAGE_INLINE_FIELD_COUNT) {
+			fFields = inlineFields;
+			fFieldsAvailable = MESSAGE_INLINE_FIELD_COUNT
+				- fHeader->field_count;
+			return B_OK;
+		}
+
+		newFields = (field_header*)malloc(count * sizeof(field_header));
+		if (newFields == NULL)
+			return B_NO_MEMORY;
+
+		if (fFields != NULL)
+			memcpy(newFields, fFields,
+				fHeader->field_count * sizeof(field_header));
+	} else {
+		newFields = (field_header*)realloc(fFields,
+			count * sizeof(field_header));
+		if (count > 0 && newFields == NULL)
+			return B_NO_MEMORY;
+	}
+
+	fFields = newFields;
+	fFieldsAvailable = count - fHeader->field_count;
+	return B_OK;
+}
+
+
+status_t
+BMessage::_ReallocateData(size_t size)
+{
+	uint8* inlineData = inline_data(fHeader);
+	uint8* newData;
+
+	if (fData == NULL || fData == inlineData) {
+		if (size <= MESSAGE_INLINE_DATA_SIZE) {
+			fData = inlineData;
+			fDataAvailable = MESSAGE_INLINE_DATA_SIZE - fHeader->data_size;
+			return B_OK;
+		}
+
+		newData = (uint8*)malloc(size);
+		if (newData == NULL)
+			return B_NO_MEMORY;
+
+		if (fData != NULL)
+			memcpy(newData, fData, fHeader->data_size);
+	} else {
+		newData = (uint8*)realloc(fData, size);
+		if (size > 0 && newData == NULL)
+			return B_NO_MEMORY;
+	}
+
+	fData = newData;
+	fDataAvailable = size - fHeader->data_size;
+	return B_OK;
+}
+
+
+void
+BMessage::_FreeFieldsAndData()
+{
+	if (fHeader == NULL || fFields != inline_fields(fHeader))
+		free(fFields);
+	if (fHeader == NULL || fData != inline_data(fHeader))
+		free(fData);
+
+	fFields = NULL;
+	fData = NULL;
+	fFieldsAvailable = 0;
+	fDataAvailable = 0;
+}
+
+
+/*!	Note that the hash function is part of the flattened message format, as
+	the hash table is transferred along with the fields. It must therefore
+	never be changed.
+	As a side effect, the length of the name is returned in \a _length, if
+	given, so that callers do not need another pass over it.
+*/
 uint32
-BMessage::_HashName(const char* name) const
+BMessage::_HashName(const char* name, size_t* _length) const
 {
+	const char* start = name;
 	char ch;
 	uint32 result = 0;
 
@@ -1641,6 +1756,9 @@ BMessage::_HashName(const char* name) const
 	}
 
 	result ^= result << 12;
+
+	if (_length != NULL)
+		*_length = name - start - 1;
 	return result;
 }
 
@@ -1658,7 +1776,8 @@ BMessage::_FindField(const char* name, type_code type, field_header** result)
 	if (fHeader->field_count == 0 || fFields == NULL || fData == NULL)
 		return B_NAME_NOT_FOUND;
 
-	uint32 hash = _HashName(name) % fHeader->hash_table_size;
+	size_t nameLength;
+	uint32 hash = _HashName(name, &nameLength) % fHeader->hash_table_size;
 	int32 nextField = fHeader->hash_table[hash];
 
 	while (nextField >= 0) {
@@ -1666,8 +1785,10 @@ BMessage::_FindField(const char* name, type_code type, field_header** result)
 		if ((field->flags & FIELD_FLAG_VALID) == 0)
 			break;
 
-		if (strncmp((const char*)(fData + field->offset), name,
-			field->name_length) == 0) {
+		// comparing the lengths first spares us looking at most colliding
+		// names
+		if (field->name_length == nameLength + 1
+			&& memcmp(fData + field->offset, name, nameLength) == 0) {
 			if (type != B_ANY_TYPE && field->type != type)
 				return B_BAD_TYPE;
 
@@ -1690,19 +1811,14 @@ BMessage::_AddField(const char* name, type_code type, bool isFixedSize,
 		return B_NO_INIT;
 
 	if (fFieldsAvailable <= 0) {
-		uint32 count = fHeader->field_count * 2 + 1;
-		count = min_c(count, fHeader->field_count + MAX_FIELD_PREALLOCATION);
-
-		field_header* newFields = (field_header*)realloc(fFields,
-			count * sizeof(field_header));
-		if (count > 0 && newFields == NULL)
-			return B_NO_MEMORY;
-
-		fFields = newFields;
-		fFieldsAvailable = count - fHeader->field_count;
+		status_t status = _ReallocateFields(
+			fHeader->field_count + fHeader->field_count / 2 + 1);
+		if (status != B_OK)
+			return status;
 	}
 
-	uint32 hash = _HashName(name) % fHeader->hash_table_size;
+	size_t nameLength;
+	uint32 hash = _HashName(name, &nameLength) % fHeader->hash_table_size;
 	int32* nextField = &fHeader->hash_table[hash];
 	while (*nextField >= 0)
 		nextField = &fFields[*nextField].next_field;
@@ -1714,7 +1830,7 @@ BMessage::_AddField(const char* name, type_code type, bool isFixedSize,
 	field->data_size = 0;
 	field->next_field = -1;
 	field->offset = fHeader->data_size;
-	field->name_length = strlen(name) + 1;
+	field->name_length = nameLength + 1;
 	status_t status = _ResizeData(field->offset, field->name_length);
 	if (status != B_OK)
 		return status;
@@ -1765,17 +1881,11 @@ BMessage::_RemoveField(field_header* field)
 	fHeader->field_count--;
 	fFieldsAvailable++;
 
-	if (fFieldsAvailable > MAX_FIELD_PREALLOCATION) {
-		ssize_t available = MAX_FIELD_PREALLOCATION / 2;
-		size = (fHeader->field_count + available) * sizeof(field_header);
-		field_header* newFields = (field_header*)realloc(fFields, size);
-		if (size > 0 && newFields == NULL) {
-			// this is strange, but not really fatal
-			return B_OK;
-		}
-
-		fFields = newFields;
-		fFieldsAvailable = available;
+	if (fFieldsAvailable > MAX_FIELD_PREALLOCATION
+		&& fFieldsAvailable > fHeader->field_count) {
+		// If this fails, we just keep the larger array; this is strange,
+		// but not really fatal
+		_ReallocateFields(fHeader->field_count + MAX_FIELD_PREALLOCATION / 2);
 	}
 
 	return B_OK;
@@ -2157,8 +2267,7 @@ BMessage::_SendMessage(port_id port, team_id portOwner, int32 token,
 			return result;
 
 		return toMessage.SendTo(port, token);
-	} else if (fHeader->data_size > B_PAGE_SIZE * 10) {
-		// ToDo: bind the above size to the max port message size
+	} else if (fHeader->data_size > MESSAGE_AREA_THRESHOLD) {
 		// use message passing by area for such a large message
 		result = _FlattenToArea(&header);
 		if (result != B_OK)
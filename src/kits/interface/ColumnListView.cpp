@@ -50,6 +50,7 @@ All rights reserved.
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <Application.h>
 #include <Bitmap.h>
@@ -295,6 +296,7 @@ public:
 									float* _top);
 			bool				FindRect(const BRow* row, BRect* _rect);
 			void				ScrollTo(const BRow* row);
+			void				InvalidateVisibleRows();
 
 			void				Clear();
 			void				SetSelectionMode(list_view_type type);
@@ -328,12 +330,32 @@ private:
 			void				InvalidateCachedPositions();
 			bool				FindVisibleRect(BRow* row, BRect* _rect);
 
+			bool				ValidateVisibleRows();
+			bool				AddVisibleRow(BRow* row, int32 level);
+			int32				FindVisibleRowIndex(float ypos) const;
+			int32				VisibleRowIndexOf(const BRow* row) const;
+			bool				IsLastVisibleRow(const BRow* row,
+									int32* _level) const;
+
+			struct VisibleRow {
+				BRow*			row;
+				float			top;
+				int32			level;
+			};
+
 			BList*				fColumns;
 			BList*				fSortColumns;
 			float				fItemsHeight;
 			BRowContainer		fRows;
 			BRect				fVisibleRect;
 
+			VisibleRow*			fVisibleRows;
+			int32				fVisibleRowCount;
+			int32				fVisibleRowCapacity;
+			int32*				fVisibleRowHash;
+			float				fVisibleRowsHeight;
+			bool				fVisibleRowsValid;
+
 #if DOUBLE_BUFFERED_COLUMN_RESIZE
 			ColumnResizeBufferView* fResizeBufferView;
 #endif
@@ -1432,6 +1454,7 @@ BColumnListView::SwapRows(int32 index1, int32 index2, BRow* parentRow1,
 
 	container1->ReplaceItem(index2, row1);
 	container2->ReplaceItem(index1, row2);
+	fOutlineView->InvalidateVisibleRows();
 
 	BRect rect1;
 	BRect rect2;
@@ -3199,6 +3222,12 @@ OutlineView::OutlineView(BRect rect, BList* visibleColumns, BList* sortColumns,
 	fSortColumns(sortColumns),
 	fItemsHeight(0.0),
 	fVisibleRect(rect.OffsetToCopy(0, 0)),
+	fVisibleRows(NULL),
+	fVisibleRowCount(0),
+	fVisibleRowCapacity(0),
+	fVisibleRowHash(NULL),
+	fVisibleRowsHeight(0.0),
+	fVisibleRowsValid(true),
 	fFocusRow(0),
 	fRollOverRow(0),
 	fLastSelectedItem(0),
@@ -3237,6 +3266,9 @@ OutlineView::~OutlineView()
 #endif
 
 	Clear();
+
+	free(fVisibleRows);
+	free(fVisibleRowHash);
 }
 
 
@@ -3246,6 +3278,7 @@ OutlineView::Clear()
 	DeselectAll();
 		// Make sure selection list doesn't point to deleted rows!
 	RecursiveDeleteRows(&fRows, false);
+	InvalidateVisibleRows();
 	fItemsHeight = 0.0;
 	FixScrollBar(true);
 	Invalidate();
@@ -3338,16 +3371,15 @@ OutlineView::RedrawColumn(BColumn* column, float leftEdge, bool isFirstColumn)
 
 	font_height fh;
 	GetFontHeight(&fh);
-	float line = 0.0;
-	bool tintedLine = true;
-	for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
-		line += iterator.CurrentRow()->Height() + 1, iterator.GoToNext()) {
-
-		BRow* row = iterator.CurrentRow();
+	ValidateVisibleRows();
+	for (int32 index = FindVisibleRowIndex(fVisibleRect.top);
+		index < fVisibleRowCount; index++) {
+		BRow* row = fVisibleRows[index].row;
+		float line = fVisibleRows[index].top;
 		float rowHeight = row->Height();
 		if (line > fVisibleRect.bottom)
 			break;
-		tintedLine = !tintedLine;
+		bool tintedLine = (index % 2) != 0;
 
 		if (line + rowHeight >= fVisibleRect.top) {
 #if DOUBLE_BUFFERED_COLUMN_RESIZE
@@ -3388,10 +3420,10 @@ OutlineView::RedrawColumn(BColumn* column, float leftEdge, bool isFirstColumn)
 			if (isFirstColumn) {
 				// If this is the first column, double buffer drawing the latch
 				// too.
-				destRect.left += iterator.CurrentLevel() * kOutlineLevelIndent
-					- fMasterView->LatchWidth();
-				sourceRect.left += iterator.CurrentLevel() * kOutlineLevelIndent
-					- fMasterView->LatchWidth();
+				destRect.left += fVisibleRows[index].level
+					* kOutlineLevelIndent - fMasterView->LatchWidth();
+				sourceRect.left += fVisibleRows[index].level
+					* kOutlineLevelIndent - fMasterView->LatchWidth();
 
 				LatchType pos = B_NO_LATCH;
 				if (row->HasLatch())
@@ -3484,16 +3516,18 @@ OutlineView::Draw(BRect invalidBounds)
 	font_height fh;
 	GetFontHeight(&fh);
 
-	float line = 0.0;
-	bool tintedLine = true;
+	// start with the first row intersecting the invalid rect
+	ValidateVisibleRows();
+	int32 index = FindVisibleRowIndex(invalidBounds.top);
+	float line = index < fVisibleRowCount
+		? fVisibleRows[index].top : fVisibleRowsHeight;
 	int32 numColumns = fColumns->CountItems();
-	for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
-		iterator.GoToNext()) {
-		BRow* row = iterator.CurrentRow();
+	for (; index < fVisibleRowCount; index++) {
+		BRow* row = fVisibleRows[index].row;
 		if (line > invalidBounds.bottom)
 			break;
 
-		tintedLine = !tintedLine;
+		bool tintedLine = (index % 2) != 0;
 		float rowHeight = row->Height();
 
 		if (line >= invalidBounds.top - rowHeight) {
@@ -3537,7 +3571,7 @@ OutlineView::Draw(BRect invalidBounds)
 					BRect destRect(fullRect);
 					if (isFirstColumn) {
 						fullRect.left -= fMasterView->LatchWidth();
-						destRect.left += iterator.CurrentLevel()
+						destRect.left += fVisibleRows[index].level
 							* kOutlineLevelIndent;
 						if (destRect.left >= destRect.right) {
 							// clipped
@@ -3656,23 +3690,12 @@ OutlineView::Draw(BRect invalidBounds)
 BRow*
 OutlineView::FindRow(float ypos, int32* _rowIndent, float* _top)
 {
-	if (_rowIndent && _top) {
-		float line = 0.0;
-		for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
-			iterator.GoToNext()) {
-
-			BRow* row = iterator.CurrentRow();
-			if (line > ypos)
-				break;
-
-			float rowHeight = row->Height();
-			if (ypos <= line + rowHeight) {
-				*_top = line;
-				*_rowIndent = iterator.CurrentLevel();
-				return row;
-			}
-
-			line += rowHeight + 1;
+	if (_rowIndent && _top && ValidateVisibleRows()) {
+		int32 index = FindVisibleRowIndex(ypos);
+		if (index < fVisibleRowCount && fVisibleRows[index].top <= ypos) {
+			*_top = fVisibleRows[index].top;
+			*_rowIndent = fVisibleRows[index].level;
+			return fVisibleRows[index].row;
 		}
 	}
 
@@ -4293,6 +4316,8 @@ OutlineView::ExpandOrCollapse(BRow* parentRow, bool expand)
 		return;
 
 	parentRow->fIsExpanded = expand;
+	if (parentRow->fChildList != NULL && parentRow->fChildList->CountItems() > 0)
+		InvalidateVisibleRows();
 
 	BRect parentRect;
 	if (FindRect(parentRow, &parentRect)) {
@@ -4375,6 +4400,9 @@ OutlineView::RemoveRow(BRow* row)
 		else
 			ScrollBy(0.0, -Bounds().top);
 	}
+	if (parentIsVisible && (parentRow == NULL || parentRow->fIsExpanded))
+		InvalidateVisibleRows();
+
 	if (parentRow != NULL) {
 		parentRow->fChildList->RemoveItem(row);
 		if (parentRow->fChildList->CountItems() == 0) {
@@ -4499,6 +4527,22 @@ OutlineView::AddRow(BRow* row, int32 Index, BRow* parentRow)
 	if (parentRow == 0 || parentRow->fIsExpanded)
 		fItemsHeight += row->Height() + 1;
 
+	// Rows are mostly appended, which doesn't change the position of any
+	// other row. Since that's cheap to keep track of, we also rebuild the
+	// visible rows, if necessary.
+	BRow* parent = NULL;
+	bool parentIsVisible = false;
+	FindParent(row, &parent, &parentIsVisible);
+	if (parentIsVisible) {
+		int32 level;
+		if (!IsLastVisibleRow(row, &level))
+			InvalidateVisibleRows();
+		else if (!fVisibleRowsValid)
+			ValidateVisibleRows();
+		else if (!AddVisibleRow(row, level))
+			InvalidateVisibleRows();
+	}
+
 	FixScrollBar(false);
 
 	BRect newRowRect;
@@ -4692,6 +4736,17 @@ bool
 OutlineView::FindVisibleRect(BRow* row, BRect* _rect)
 {
 	if (row && _rect) {
+		if (fVisibleRowsValid) {
+			int32 index = VisibleRowIndexOf(row);
+			if (index < 0)
+				return false;
+
+			float line = fVisibleRows[index].top;
+			_rect->Set(fVisibleRect.left, line, fVisibleRect.right,
+				line + row->Height());
+			return line <= fVisibleRect.bottom;
+		}
+
 		float line = 0.0;
 		for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
 			iterator.GoToNext()) {
@@ -4712,6 +4767,19 @@ OutlineView::FindVisibleRect(BRow* row, BRect* _rect)
 bool
 OutlineView::FindRect(const BRow* row, BRect* _rect)
 {
+	// Only use the visible rows, if they are up to date -- rebuilding them
+	// for every row added in the middle would be even slower than searching.
+	if (fVisibleRowsValid) {
+		int32 index = VisibleRowIndexOf(row);
+		if (index < 0)
+			return false;
+
+		float line = fVisibleRows[index].top;
+		_rect->Set(fVisibleRect.left, line, fVisibleRect.right,
+			line + row->Height());
+		return true;
+	}
+
 	float line = 0.0;
 	for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
 		iterator.GoToNext()) {
@@ -4831,6 +4899,7 @@ OutlineView::SortList(BRowContainer* list, bool isVisible)
 		}
 
 		if (isVisible) {
+			InvalidateVisibleRows();
 			Invalidate();
 
 			InvalidateCachedPositions();
@@ -5081,6 +5150,164 @@ OutlineView::GetColumnPreferredWidth(BColumn* column)
 }
 
 
+// #pragma mark - visible rows
+
+
+/*!	The rows currently visible, i.e. the ones in expanded branches, are kept
+	in display order in a flat array along with their top coordinate and
+	outline level, and a hash table maps the rows to their array index. So
+	drawing, hit testing, and finding the frame of a row don't need to walk
+	the whole tree up to the row, which made large lists slow.
+
+	Appending a row keeps the array valid, any other change invalidates it,
+	and it is rebuilt when it is needed next.
+*/
+void
+OutlineView::InvalidateVisibleRows()
+{
+	fVisibleRowsValid = false;
+}
+
+
+bool
+OutlineView::ValidateVisibleRows()
+{
+	if (fVisibleRowsValid)
+		return true;
+
+	fVisibleRowCount = 0;
+	fVisibleRowsHeight = 0.0;
+	if (fVisibleRowHash != NULL)
+		memset(fVisibleRowHash, 0, fVisibleRowCapacity * 2 * sizeof(int32));
+
+	for (RecursiveOutlineIterator iterator(&fRows); iterator.CurrentRow();
+		iterator.GoToNext()) {
+		if (!AddVisibleRow(iterator.CurrentRow(), iterator.CurrentLevel())) {
+			fVisibleRowCount = 0;
+			fVisibleRowsHeight = 0.0;
+			return false;
+		}
+	}
+
+	fVisibleRowsValid = true;
+	return true;
+}
+
+
+static inline uint32
+visible_row_hash(const BRow* row)
+{
+	return (uint32)((addr_t)row >> 3) * 2654435761UL;
+}
+
+
+bool
+OutlineView::AddVisibleRow(BRow* row, int32 level)
+{
+	if (fVisibleRowCount == fVisibleRowCapacity) {
+		int32 capacity = max_c(fVisibleRowCapacity * 2, 64);
+		VisibleRow* rows = (VisibleRow*)realloc(fVisibleRows,
+			capacity * sizeof(VisibleRow));
+		if (rows == NULL)
+			return false;
+		fVisibleRows = rows;
+
+		// the hash table is kept at most half full
+		int32* hash = (int32*)calloc(capacity * 2, sizeof(int32));
+		if (hash == NULL)
+			return false;
+		free(fVisibleRowHash);
+		fVisibleRowHash = hash;
+		fVisibleRowCapacity = capacity;
+
+		int32 count = fVisibleRowCount;
+		fVisibleRowCount = 0;
+		fVisibleRowsHeight = 0.0;
+		for (int32 i = 0; i < count; i++)
+			AddVisibleRow(fVisibleRows[i].row, fVisibleRows[i].level);
+	}
+
+	int32 index = fVisibleRowCount++;
+	fVisibleRows[index].row = row;
+	fVisibleRows[index].top = fVisibleRowsHeight;
+	fVisibleRows[index].level = level;
+	fVisibleRowsHeight += row->Height() + 1;
+
+	uint32 mask = fVisibleRowCapacity * 2 - 1;
+	uint32 slot = visible_row_hash(row) & mask;
+	while (fVisibleRowHash[slot] != 0)
+		slot = (slot + 1) & mask;
+	fVisibleRowHash[slot] = index + 1;
+
+	return true;
+}
+
+
+/*!	Returns the index of the first visible row that ends at or below \a ypos,
+	or the number of visible rows, if there is none.
+*/
+int32
+OutlineView::FindVisibleRowIndex(float ypos) const
+{
+	int32 lower = 0;
+	int32 upper = fVisibleRowCount;
+	while (lower < upper) {
+		int32 middle = lower + (upper - lower) / 2;
+		const VisibleRow& visibleRow = fVisibleRows[middle];
+		if (visibleRow.top + visibleRow.row->Height() < ypos)
+			lower = middle + 1;
+		else
+			upper = middle;
+	}
+
+	return lower;
+}
+
+
+int32
+OutlineView::VisibleRowIndexOf(const BRow* row) const
+{
+	if (row == NULL || fVisibleRowCount == 0)
+		return -1;
+
+	uint32 mask = fVisibleRowCapacity * 2 - 1;
+	for (uint32 slot = visible_row_hash(row) & mask;
+			fVisibleRowHash[slot] != 0; slot = (slot + 1) & mask) {
+		int32 index = fVisibleRowHash[slot] - 1;
+		if (fVisibleRows[index].row == row)
+			return index;
+	}
+
+	return -1;
+}
+
+
+/*!	Returns whether the visible \a row is the last one in display order, and
+	its outline level.
+*/
+bool
+OutlineView::IsLastVisibleRow(const BRow* row, int32* _level) const
+{
+	if (row->fIsExpanded && row->fChildList != NULL
+		&& row->fChildList->CountItems() > 0) {
+		return false;
+	}
+
+	int32 level = 0;
+	for (; row != NULL; row = row->fParent) {
+		const BRowContainer* list
+			= row->fParent != NULL ? row->fParent->fChildList : &fRows;
+		if (list->ItemAt(list->CountItems() - 1) != row)
+			return false;
+		if (row->fParent != NULL)
+			level++;
+	}
+
+	*_level = level;
+	return true;
+}
+
+
 // #pragma mark -
 
 
@@ -12,9 +12,13 @@
 
 
 #include <AppServerLink.h>
+#include <ApplicationPrivate.h>
 #include <FontPrivate.h>
 #include <ObjectList.h>
 #include <ServerProtocol.h>
+#include <ServerReadOnlyMemory.h>
+#include <StackOrHeapArray.h>
+#include <StringWidthCache.h>
 #include <truncate_string.h>
 #include <utf8_functions.h>
 
@@ -48,6 +52,32 @@ const BFont* be_bold_font = &sBoldFont;
 const BFont* be_fixed_font = &sFixedFont;
 
 
+// Everything the app_server looks at for AS_GET_STRING_WIDTHS, plus the
+// font generation which changes with the hinting and antialiasing settings.
+struct string_width_key {
+	uint16	familyID;
+	uint16	styleID;
+	float	size;
+	uint8	spacing;
+	int32	generation;
+
+	uint32 Hash() const
+	{
+		return ((uint32)familyID << 16 | styleID) ^ (uint32)(size * 64)
+			^ ((uint32)spacing << 24) ^ (uint32)generation;
+	}
+
+	bool operator==(const string_width_key& other) const
+	{
+		return familyID == other.familyID && styleID == other.styleID
+			&& size == other.size && spacing == other.spacing
+			&& generation == other.generation;
+	}
+};
+
+static StringWidthCache<string_width_key, 256> sStringWidthCache;
+
+
 struct style {
 	BString	name;
 	uint16	face;
@@ -1038,25 +1068,73 @@ BFont::GetStringWidths(const char* stringArray[], const int32 lengthArray[],
 		return;
 	}
 
+	// Short strings like labels and list items are measured over and over
+	// again, so their widths are remembered to save the server round trip.
+	string_width_key key;
+	key.familyID = fFamilyID;
+	key.styleID = fStyleID;
+	key.size = fSize;
+	key.spacing = fSpacing;
+	key.generation = 0;
+	bool useCache = false;
+	if (be_app != NULL) {
+		server_read_only_memory* shared
+			= BApplication::Private::ServerReadOnlyMemory();
+		if (shared != NULL) {
+			key.generation = atomic_get(&shared->font_generation);
+			useCache = true;
+		}
+	}
+
+	BStackOrHeapArray<int32, 64> missing(numStrings);
+	if (!missing.IsValid())
+		useCache = false;
+
+	int32 missingCount = 0;
+	for (int32 i = 0; i < numStrings; i++) {
+		if (!useCache || !sStringWidthCache.Lookup(key, stringArray[i],
+				lengthArray[i], widthArray[i])) {
+			if (useCache)
+				missing[missingCount] = i;
+			missingCount++;
+		}
+	}
+	if (missingCount == 0)
+		return;
+
 	BPrivate::AppServerLink link;
 	link.StartMessage(AS_GET_STRING_WIDTHS);
 	link.Attach<uint16>(fFamilyID);
 	link.Attach<uint16>(fStyleID);
 	link.Attach<float>(fSize);
 	link.Attach<uint8>(fSpacing);
-	link.Attach<int32>(numStrings);
+	link.Attach<int32>(missingCount);
 
 	// TODO: all strings into a single array???
 	// we do have a maximum message length, and it could be easily touched
 	// here...
-	for (int32 i = 0; i < numStrings; i++)
-		link.AttachString(stringArray[i], lengthArray[i]);
+	for (int32 i = 0; i < missingCount; i++) {
+		int32 index = useCache ? missing[i] : i;
+		link.AttachString(stringArray[index], lengthArray[index]);
+	}
 
 	status_t status;
 	if (link.FlushWithReply(status) != B_OK || status != B_OK)
 		return;
 
-	link.Read(widthArray, sizeof(float) * numStrings);
+	if (!useCache) {
+		link.Read(widthArray, sizeof(float) * numStrings);
+		return;
+	}
+
+	for (int32 i = 0; i < missingCount; i++) {
+		int32 index = missing[i];
+		if (link.Read<float>(&widthArray[index]) != B_OK)
+			return;
+
+		sStringWidthCache.Store(key, stringArray[index], lengthArray[index],
+			widthArray[index]);
+	}
 }
 
 
@@ -210,8 +210,20 @@ BListView::Draw(BRect updateRect)
 	if (count == 0)
 		return;
 
-	BRect itemFrame(0, 0, Bounds().right, -1);
-	for (int i = 0; i < count; i++) {
+	// the item tops are always up to date, so we can start right with the
+	// first item in the update rect
+	int32 first = 0;
+	if (updateRect.top > 0) {
+		first = IndexOf(BPoint(0, floorf(updateRect.top)));
+		if (first < 0)
+			return;
+	}
+
+	BRect itemFrame(0, ItemAt(first)->Top(), Bounds().right, -1);
+	for (int32 i = first; i < count; i++) {
+		if (itemFrame.top > updateRect.bottom)
+			break;
+
 		BListItem* item = ItemAt(i);
 		itemFrame.bottom = itemFrame.top + ceilf(item->Height()) - 1;
 
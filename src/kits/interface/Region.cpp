@@ -1,5 +1,5 @@
 /*
- * Copyright 2003-2014 Haiku, Inc. All rights reserved.
+ * Copyright 2003-2026 Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  *
  *	Authors:
@@ -25,20 +25,22 @@ const static int32 kDataBlockSize = 8;
 BRegion::BRegion()
 	:
 	fCount(0),
-	fDataSize(0),
+	fDataSize(1),
 	fBounds((clipping_rect){ 0, 0, 0, 0 }),
-	fData(NULL)
+	fData(&fBounds)
 {
-	_SetSize(kDataBlockSize);
+	// Like single rect regions, empty regions don't need any memory. Many
+	// regions are only ever used for temporary results, they are allocated
+	// once they need to hold more than one rect.
 }
 
 
 BRegion::BRegion(const BRegion& other)
 	:
 	fCount(0),
-	fDataSize(0),
+	fDataSize(1),
 	fBounds((clipping_rect){ 0, 0, 0, 0 }),
-	fData(NULL)
+	fData(&fBounds)
 {
 	*this = other;
 }
@@ -84,8 +86,9 @@ BRegion::operator=(const BRegion& other)
 		return *this;
 
 	// handle reallocation if we're too small to contain the other's data
-	if (_SetSize(other.fDataSize)) {
-		memcpy(fData, other.fData, other.fCount * sizeof(clipping_rect));
+	if (_SetSize(other.fCount)) {
+		if (other.fCount > 0)
+			memcpy(fData, other.fData, other.fCount * sizeof(clipping_rect));
 
 		fBounds = other.fBounds;
 		fCount = other.fCount;
@@ -103,6 +106,8 @@ BRegion::operator==(const BRegion& other) const
 
 	if (fCount != other.fCount)
 		return false;
+	if (fCount == 0)
+		return true;
 
 	return memcmp(fData, other.fData, fCount * sizeof(clipping_rect)) == 0;
 }
@@ -325,6 +330,9 @@ BRegion::Include(clipping_rect clipping)
 	clipping.right++;
 	clipping.bottom++;
 
+	if (Support::IncludeRect(this, clipping))
+		return;
+
 	// use private clipping_rect constructor which avoids malloc()
 	BRegion temp(clipping);
 
@@ -338,6 +346,11 @@ BRegion::Include(clipping_rect clipping)
 void
 BRegion::Include(const BRegion* region)
 {
+	if (region->fCount == 0)
+		return;
+	if (region->fCount == 1 && Support::IncludeRect(this, region->fBounds))
+		return;
+
 	BRegion result;
 	Support::XUnionRegion(this, region, &result);
 
@@ -362,6 +375,9 @@ BRegion::Exclude(clipping_rect clipping)
 	clipping.right++;
 	clipping.bottom++;
 
+	if (Support::ExcludeRect(this, clipping))
+		return;
+
 	// use private clipping_rect constructor which avoids malloc()
 	BRegion temp(clipping);
 
@@ -375,6 +391,11 @@ BRegion::Exclude(clipping_rect clipping)
 void
 BRegion::Exclude(const BRegion* region)
 {
+	if (region->fCount == 0)
+		return;
+	if (region->fCount == 1 && Support::ExcludeRect(this, region->fBounds))
+		return;
+
 	BRegion result;
 	Support::XSubtractRegion(this, region, &result);
 
@@ -385,6 +406,18 @@ BRegion::Exclude(const BRegion* region)
 void
 BRegion::IntersectWith(const BRegion* region)
 {
+	if (region->fCount == 1) {
+		clipping_rect bounds = region->fBounds;
+		Support::IntersectWithRect(this, bounds);
+		return;
+	}
+	if (fCount == 1 && region != this) {
+		clipping_rect bounds = fBounds;
+		*this = *region;
+		Support::IntersectWithRect(this, bounds);
+		return;
+	}
+
 	BRegion result;
 	Support::XIntersectRegion(this, region, &result);
 
@@ -454,7 +487,8 @@ BRegion::_SetSize(int32 newSize)
 	if (newSize > 0) {
 		if (fData == &fBounds) {
 			fData = (clipping_rect*)malloc(newSize * sizeof(clipping_rect));
-			fData[0] = fBounds;
+			if (fData != NULL)
+				fData[0] = fBounds;
 		} else if (fData) {
 			clipping_rect* resizedData = (clipping_rect*)realloc(fData,
 				newSize * sizeof(clipping_rect));
@@ -75,6 +75,7 @@ SOFTWARE.
 #include "RegionSupport.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <new>
 
 using std::nothrow;
@@ -1547,15 +1548,16 @@ BRegion::Support::XPointInRegion(
     const BRegion* pRegion,
     int x, int y)
 {
-	// TODO: binary search by "y"!
     int i;
 
     if (pRegion->fCount == 0)
         return false;
     if (!INBOX(pRegion->fBounds, x, y))
         return false;
-    for (i=0; i<pRegion->fCount; i++)
+    for (i = FindBand(pRegion, y); i < pRegion->fCount; i++)
     {
+        if (pRegion->fData[i].top > y)
+            break;
         if (INBOX (pRegion->fData[i], x, y))
 	    return true;
     }
@@ -1582,8 +1584,11 @@ BRegion::Support::XRectInRegion(
     partOut = false;
     partIn = false;
 
-    /* can stop when both partOut and partIn are true, or we reach prect->bottom */
-    for (pbox = region->fData, pboxEnd = pbox + region->fCount;
+    /* can stop when both partOut and partIn are true, or we reach
+     * prect->bottom, and can start right at the first band reaching into the
+     * rectangle */
+    for (pbox = region->fData + FindBand(region, ry),
+		pboxEnd = region->fData + region->fCount;
 	 pbox < pboxEnd;
 	 pbox++)
     {
@@ -1639,3 +1644,258 @@ BRegion::Support::XRectInRegion(
     return(partIn ? ((ry < prect->bottom) ? RectanglePart : RectangleIn) :
 		RectangleOut);
 }
+
+
+//	#pragma mark - in place operations
+
+
+/*!	Returns the index of the first rectangle whose bottom is below \a y, or
+	the number of rectangles if there is none. Since the bands are sorted and
+	do not overlap, the bottoms of all rectangles are sorted as well.
+*/
+int
+BRegion::Support::FindBand(const BRegion* region, int y)
+{
+	int lower = 0;
+	int upper = region->fCount;
+	while (lower < upper) {
+		int mid = (lower + upper) / 2;
+		if (region->fData[mid].bottom <= y)
+			lower = mid + 1;
+		else
+			upper = mid;
+	}
+	return lower;
+}
+
+
+/*!	Adds \a rect to \a region without going through miRegionOp() when that
+	is possible: when the region is empty or covered by the rect, when the
+	rect is already part of the region, or when it lies completely above or
+	below the region, or to the right of the last band, which is the usual
+	case when building a region from sorted rects. \a rect must be in the
+	internal format, and not be empty.
+	Returns \c false if the caller needs to fall back to XUnionRegion().
+*/
+bool
+BRegion::Support::IncludeRect(BRegion* region, const clipping_rect& rect)
+{
+	if (region->fCount == 0 || (rect.left <= region->fBounds.left
+			&& rect.top <= region->fBounds.top
+			&& rect.right >= region->fBounds.right
+			&& rect.bottom >= region->fBounds.bottom)) {
+		if (!region->_SetSize(1))
+			return true;
+		region->fData[0] = region->fBounds = rect;
+		region->fCount = 1;
+		return true;
+	}
+
+	if (rect.top >= region->fBounds.bottom)
+		return _AppendBand(region, rect);
+	if (rect.bottom <= region->fBounds.top)
+		return _PrependBand(region, rect);
+
+	const clipping_rect& last = region->fData[region->fCount - 1];
+	if (rect.top == last.top && rect.bottom == last.bottom
+		&& rect.left >= last.right) {
+		return _AppendToLastBand(region, rect);
+	}
+
+	return XRectInRegion(region, rect) == RectangleIn;
+}
+
+
+/*!	Handles the cases of removing \a rect from \a region that leave it
+	either untouched or empty. \a rect must be in the internal format.
+	Returns \c false if the caller needs to fall back to XSubtractRegion().
+*/
+bool
+BRegion::Support::ExcludeRect(BRegion* region, const clipping_rect& rect)
+{
+	if (region->fCount == 0 || !EXTENTCHECK(&region->fBounds, &rect))
+		return true;
+
+	if (rect.left <= region->fBounds.left && rect.top <= region->fBounds.top
+		&& rect.right >= region->fBounds.right
+		&& rect.bottom >= region->fBounds.bottom) {
+		region->MakeEmpty();
+		return true;
+	}
+
+	return XRectInRegion(region, rect) == RectangleOut;
+}
+
+
+/*!	Clips \a region to \a rect in place. Clipping keeps the rectangles of
+	a band sorted and apart from each other, so only the bands that became
+	identical to their predecessor need to be coalesced. \a rect must be in
+	the internal format.
+*/
+void
+BRegion::Support::IntersectWithRect(BRegion* region, const clipping_rect& rect)
+{
+	if (region->fCount == 0 || !EXTENTCHECK(&region->fBounds, &rect)) {
+		region->MakeEmpty();
+		return;
+	}
+
+	clipping_rect* data = region->fData;
+	int count = region->fCount;
+	int target = 0;
+	int previousBand = -1;
+
+	for (int i = FindBand(region, rect.top); i < count;) {
+		int top = data[i].top;
+		if (top >= rect.bottom)
+			break;
+
+		int bottom = data[i].bottom;
+		int bandStart = target;
+		for (; i < count && data[i].top == top; i++) {
+			if (data[i].right <= rect.left || data[i].left >= rect.right)
+				continue;
+
+			clipping_rect& clipped = data[target++];
+			clipped.left = max_c(data[i].left, rect.left);
+			clipped.top = max_c(top, rect.top);
+			clipped.right = min_c(data[i].right, rect.right);
+			clipped.bottom = min_c(bottom, rect.bottom);
+		}
+
+		if (target == bandStart)
+			continue;
+
+		if (previousBand >= 0
+			&& _BandsCoalesce(data, previousBand, bandStart, target)) {
+			int newBottom = data[bandStart].bottom;
+			for (int j = previousBand; j < bandStart; j++)
+				data[j].bottom = newBottom;
+			target = bandStart;
+		} else
+			previousBand = bandStart;
+	}
+
+	region->fCount = target;
+	miSetExtents(region);
+}
+
+
+/*!	Returns whether the band starting at \a bandStart and ending before
+	\a bandEnd can be merged into the band starting at \a previousBand.
+*/
+bool
+BRegion::Support::_BandsCoalesce(const clipping_rect* data, int previousBand,
+	int bandStart, int bandEnd)
+{
+	if (bandEnd - bandStart != bandStart - previousBand
+		|| data[previousBand].bottom != data[bandStart].top)
+		return false;
+
+	for (int i = 0; i < bandEnd - bandStart; i++) {
+		if (data[previousBand + i].left != data[bandStart + i].left
+			|| data[previousBand + i].right != data[bandStart + i].right)
+			return false;
+	}
+	return true;
+}
+
+
+bool
+BRegion::Support::_AppendBand(BRegion* region, const clipping_rect& rect)
+{
+	int count = region->fCount;
+	clipping_rect& last = region->fData[count - 1];
+
+	if (last.bottom == rect.top && last.left == rect.left
+		&& last.right == rect.right
+		&& (count == 1 || region->fData[count - 2].top != last.top)) {
+		// the last band is this rect only, just make it taller
+		last.bottom = rect.bottom;
+		region->fBounds.bottom = rect.bottom;
+		return true;
+	}
+
+	if (count == region->fDataSize
+		&& !region->_SetSize(region->fDataSize * 2)) {
+		return true;
+	}
+
+	region->fData[count] = rect;
+	region->fCount++;
+	region->fBounds.left = min_c(region->fBounds.left, rect.left);
+	region->fBounds.right = max_c(region->fBounds.right, rect.right);
+	region->fBounds.bottom = rect.bottom;
+	return true;
+}
+
+
+bool
+BRegion::Support::_AppendToLastBand(BRegion* region, const clipping_rect& rect)
+{
+	int count = region->fCount;
+	if (region->fData[count - 1].right == rect.left) {
+		// touching the last rect, just make it wider
+		region->fData[count - 1].right = rect.right;
+	} else {
+		if (count == region->fDataSize
+			&& !region->_SetSize(region->fDataSize * 2)) {
+			return true;
+		}
+
+		region->fData[count] = rect;
+		region->fCount = ++count;
+	}
+	region->fBounds.right = max_c(region->fBounds.right, rect.right);
+
+	// the band may now look like the one above it
+	int bandStart = count - 1;
+	while (bandStart > 0 && region->fData[bandStart - 1].top == rect.top)
+		bandStart--;
+	if (bandStart == 0)
+		return true;
+
+	int previousBand = bandStart - 1;
+	int previousTop = region->fData[previousBand].top;
+	while (previousBand > 0
+		&& region->fData[previousBand - 1].top == previousTop) {
+		previousBand--;
+	}
+
+	if (_BandsCoalesce(region->fData, previousBand, bandStart, count)) {
+		for (int i = previousBand; i < bandStart; i++)
+			region->fData[i].bottom = rect.bottom;
+		region->fCount = bandStart;
+	}
+	return true;
+}
+
+
+bool
+BRegion::Support::_PrependBand(BRegion* region, const clipping_rect& rect)
+{
+	int count = region->fCount;
+	clipping_rect& first = region->fData[0];
+
+	if (first.top == rect.bottom && first.left == rect.left
+		&& first.right == rect.right
+		&& (count == 1 || region->fData[1].top != first.top)) {
+		// the first band is this rect only, just make it taller
+		first.top = rect.top;
+		region->fBounds.top = rect.top;
+		return true;
+	}
+
+	if (count == region->fDataSize
+		&& !region->_SetSize(region->fDataSize * 2)) {
+		return true;
+	}
+
+	memmove(region->fData + 1, region->fData, count * sizeof(clipping_rect));
+	region->fData[0] = rect;
+	region->fCount++;
+	region->fBounds.left = min_c(region->fBounds.left, rect.left);
+	region->fBounds.right = max_c(region->fBounds.right, rect.right);
+	region->fBounds.top = rect.top;
+	return true;
+}
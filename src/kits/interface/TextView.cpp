@@ -3876,7 +3876,7 @@ BTextView::_RecalculateLineBreaks(int32* startLine, int32* endLine)
 		int32 toOffset = _FindLineBreak(fromOffset, &ascent, &descent, &width);
 
 		curLine->ascent = ascent;
-		curLine->width = width;
+		fLines->SetWidth(lineIndex, width);
 
 		// we want to advance at least by one character
 		int32 nextOffset = _NextInitialByte(fromOffset);
@@ -3891,6 +3891,7 @@ BTextView::_RecalculateLineBreaks(int32* startLine, int32* endLine)
 			newLine.offset = toOffset;
 			newLine.origin = ceilf(curLine->origin + ascent + descent) + 1;
 			newLine.ascent = 0;
+			newLine.width = 0;
 			fLines->InsertLine(&newLine, lineIndex);
 		} else {
 			// update the existing line
@@ -3923,7 +3924,7 @@ BTextView::_RecalculateLineBreaks(int32* startLine, int32* endLine)
 
 	// make sure that the sentinel line (which starts at the end of the buffer)
 	// has always a width of 0
-	(*fLines)[fLines->NumLines()]->width = 0;
+	fLines->SetWidth(fLines->NumLines(), 0);
 
 	// update text rect
 	fTextRect.left = Bounds().left + fLayoutData->leftInset;
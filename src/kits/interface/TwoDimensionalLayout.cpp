@@ -84,6 +84,7 @@ protected:
 									BLayoutContext* context);
 
 			Layouter*			fLayouter;
+			Layouter*			fPreviousLayouter;
 			LayoutInfo*			fLayoutInfo;
 			orientation			fOrientation;
 			BList				fLocalLayouters;
@@ -604,6 +605,7 @@ BTwoDimensionalLayout::CompoundLayouter::CompoundLayouter(
 	orientation orientation)
 	:
 	fLayouter(NULL),
+	fPreviousLayouter(NULL),
 	fLayoutInfo(NULL),
 	fOrientation(orientation),
 	fLocalLayouters(10),
@@ -616,6 +618,7 @@ BTwoDimensionalLayout::CompoundLayouter::CompoundLayouter(
 BTwoDimensionalLayout::CompoundLayouter::~CompoundLayouter()
 {
 	delete fLayouter;
+	delete fPreviousLayouter;
 	delete fLayoutInfo;
 }
 
@@ -710,7 +713,10 @@ BTwoDimensionalLayout::CompoundLayouter::InvalidateLayout()
 	if (!fLayouter)
 		return;
 
-	delete fLayouter;
+	// Keep the layouter until the new one has been created, so the latter
+	// can take over the old solution. Usually only a few constraints change.
+	delete fPreviousLayouter;
+	fPreviousLayouter = fLayouter;
 	delete fLayoutInfo;
 
 	fLayouter = NULL;
@@ -755,6 +761,12 @@ BTwoDimensionalLayout::CompoundLayouter::ValidateMinMax()
 	// hidden relative to a common parent.
 	_AddConstraints(fLayouter);
 
+	if (fPreviousLayouter != NULL) {
+		fLayouter->InheritSolution(fPreviousLayouter);
+		delete fPreviousLayouter;
+		fPreviousLayouter = NULL;
+	}
+
 	fLayoutInfo = fLayouter->CreateLayoutInfo();
 }
 
@@ -246,6 +246,29 @@ CollapsingLayouter::CloneLayouter()
 }
 
 
+bool
+CollapsingLayouter::InheritSolution(Layouter* _previous)
+{
+	CollapsingLayouter* previous = dynamic_cast<CollapsingLayouter*>(_previous);
+	if (previous == NULL || previous->fLayouter == NULL
+		|| previous->fElementCount != fElementCount) {
+		return false;
+	}
+
+	_ValidateLayouter();
+	if (fLayouter == NULL)
+		return false;
+
+	// the solution only fits, if the same elements have been collapsed
+	for (int32 i = 0; i < fElementCount; i++) {
+		if (fElements[i].position != previous->fElements[i].position)
+			return false;
+	}
+
+	return fLayouter->InheritSolution(previous->fLayouter);
+}
+
+
 void
 CollapsingLayouter::_ValidateLayouter()
 {
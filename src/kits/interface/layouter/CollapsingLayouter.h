@@ -38,6 +38,8 @@ public:
 
 	virtual	Layouter*			CloneLayouter();
 
+	virtual	bool				InheritSolution(Layouter* previous);
+
 
 private:
 	class	ProxyLayoutInfo;
@@ -127,7 +127,7 @@ struct ComplexLayouter::Constraint {
 
 	bool IsSatisfied(int32* sumValues) const
 	{
-		int32 value = sumValues[end] - sumValues[start - 1];
+		int32 value = sumValues[end + 1] - sumValues[start];
 		return (value >= min && value <= max);
 	}
 
@@ -168,9 +168,11 @@ ComplexLayouter::ComplexLayouter(int32 elementCount, float spacing)
 	  fSums(new(nothrow) SumItem[elementCount + 1]),
 	  fSumBackups(new(nothrow) SumItemBackup[elementCount + 1]),
 	  fOptimizer(new(nothrow) LayoutOptimizer(elementCount)),
+	  fLastSolution(new(nothrow) double[elementCount]),
 	  fUnlimited((int32)B_SIZE_UNLIMITED / (elementCount == 0 ? 1 : elementCount)),
 	  fMinMaxValid(false),
-	  fOptimizerConstraintsAdded(false)
+	  fOptimizerConstraintsAdded(false),
+	  fHaveLastSolution(false)
 {
 	if (fConstraints)
 		memset(fConstraints, 0, sizeof(Constraint*) * fElementCount);
@@ -199,6 +201,7 @@ ComplexLayouter::~ComplexLayouter()
 	delete[] fWeights;
 	delete[] fSums;
 	delete[] fSumBackups;
+	delete[] fLastSolution;
   	delete fOptimizer;
 }
 
@@ -207,8 +210,10 @@ ComplexLayouter::~ComplexLayouter()
 status_t
 ComplexLayouter::InitCheck() const
 {
-	if (!fConstraints || !fWeights || !fSums || !fSumBackups || !fOptimizer)
+	if (!fConstraints || !fWeights || !fSums || !fSumBackups || !fOptimizer
+		|| !fLastSolution) {
 		return B_NO_MEMORY;
+	}
 	return fOptimizer->InitCheck();
 }
 
@@ -288,6 +293,7 @@ ComplexLayouter::MaxSize()
 float
 ComplexLayouter::PreferredSize()
 {
+	_ValidateLayout();
 	return fMin;
 }
 
@@ -392,11 +398,32 @@ ComplexLayouter::CloneLayouter()
 	layouter->fMin = fMin;
 	layouter->fMax = fMax;
 	layouter->fMinMaxValid = fMinMaxValid;
+	layouter->fOptimizerConstraintsAdded = fOptimizerConstraintsAdded;
+	layouter->InheritSolution(this);
 
 	return layouterDeleter.Detach();
 }
 
 
+// InheritSolution
+bool
+ComplexLayouter::InheritSolution(Layouter* _previous)
+{
+	ComplexLayouter* previous = dynamic_cast<ComplexLayouter*>(_previous);
+	if (previous == NULL || previous->fElementCount != fElementCount
+		|| !previous->fHaveLastSolution || fLastSolution == NULL) {
+		return false;
+	}
+
+	// The solution might not be feasible with our constraints.
+	// _InitFromLastSolution() checks that before using it.
+	memcpy(fLastSolution, previous->fLastSolution,
+		fElementCount * sizeof(double));
+	fHaveLastSolution = true;
+	return true;
+}
+
+
 // _Layout
 bool
 ComplexLayouter::_Layout(int32 size, SumItem* sums, int32* sizes)
@@ -415,11 +442,13 @@ ComplexLayouter::_Layout(int32 size, SumItem* sums, int32* sizes)
 	if (!_AddOptimizerConstraints())
 		return false;
 
-
-	// prepare a feasible solution (the minimum)
+	// prepare a feasible solution -- preferably one derived from the last
+	// solution, which is usually close to the optimum, otherwise the minimum
 	double values[fElementCount];
-	for (int32 i = 0; i < fElementCount; i++)
-		values[i] = sums[i + 1].min - sums[i].min;
+	if (!_InitFromLastSolution(size, sums, values)) {
+		for (int32 i = 0; i < fElementCount; i++)
+			values[i] = sums[i + 1].min - sums[i].min;
+	}
 
 #if TRACE_COMPLEX_LAYOUTER
 	TRACE("feasible solution vs. desired solution:\n");
@@ -433,21 +462,24 @@ ComplexLayouter::_Layout(int32 size, SumItem* sums, int32* sizes)
 		return false;
 	TRACE_ONLY(time = system_time() - time;)
 
+	_SetLastSolution(values);
+
 	// compute integer solution
 	// The basic strategy is to floor() the sums. This guarantees that the
 	// difference between two rounded sums remains in the range of floor()
 	// and ceil() of their real value difference. Since the constraints have
 	// integer values, the integer solution will therefore satisfy all
 	// constraints the real solution satisfied.
+	// Sums a rounding error below an integer are rounded up, though, so the
+	// result doesn't depend on the path the optimizer took. Since all sums are
+	// shifted by the same epsilon, the above still holds.
 	TRACE("computed solution in %lld us:\n", time);
 
 	double realSum = 0;
 	double previousSum = 0;
 	for (int32 i = 0; i < fElementCount; i++) {
 		realSum += values[i];
-		double roundedRealSum = floor(realSum);
-		if (fuzzy_equals(realSum, roundedRealSum + 1))
-			realSum = roundedRealSum + 1;
+		double roundedRealSum = floor(realSum + kEqualsEpsilon);
 		sizes[i] = int32(roundedRealSum - previousSum);
 		previousSum = roundedRealSum;
 
@@ -516,6 +548,74 @@ ComplexLayouter::_AddOptimizerConstraints()
 }
 
 
+// _InitFromLastSolution
+/*!	Derives a feasible solution for \a size from the last computed solution.
+
+	In terms of the sums c[i] (cf. _ValidateLayout()) all constraints but the
+	one for the total size are of the form c[j] - c[i] >= value, and the
+	component-wise maximum and minimum of two tuples satisfying such
+	constraints satisfy them as well. So if the last solution still satisfies
+	the constraints, its maximum respectively minimum (depending on whether
+	the size grew or shrank) with the minimum solution for \a size is a
+	feasible solution for \a size, too. For small size changes it is close to
+	the last optimum, and the optimizer starts out with (mostly) the same
+	active set and needs only a few iterations.
+*/
+bool
+ComplexLayouter::_InitFromLastSolution(int32 size, const SumItem* sums,
+	double* values) const
+{
+	if (!fHaveLastSolution)
+		return false;
+
+	bool grow = size >= fLastSolution[fElementCount - 1];
+
+	double locations[fElementCount + 1];
+	locations[0] = 0;
+	for (int32 i = 0; i < fElementCount; i++) {
+		double minLocation = sums[i + 1].min;
+		locations[i + 1] = grow ? max_c(fLastSolution[i], minLocation)
+			: min_c(fLastSolution[i], minLocation);
+	}
+
+	// check the constraints -- they might have changed since
+	for (int32 i = 0; i < fElementCount; i++) {
+		Constraint* constraint = fConstraints[i];
+		while (constraint != NULL) {
+			double value = locations[constraint->end + 1]
+				- locations[constraint->start];
+			if (value < constraint->min - kEqualsEpsilon
+				|| value > constraint->effectiveMax + kEqualsEpsilon) {
+				return false;
+			}
+
+			constraint = constraint->next;
+		}
+	}
+
+	for (int32 i = 0; i < fElementCount; i++)
+		values[i] = locations[i + 1] - locations[i];
+
+	TRACE("using last solution (size %ld) as feasible solution\n",
+		(int32)fLastSolution[fElementCount - 1]);
+	return true;
+}
+
+
+// _SetLastSolution
+void
+ComplexLayouter::_SetLastSolution(const double* values)
+{
+	double sum = 0;
+	for (int32 i = 0; i < fElementCount; i++) {
+		sum += values[i];
+		fLastSolution[i] = sum;
+	}
+
+	fHaveLastSolution = true;
+}
+
+
 // _SatisfiesConstraints
 bool
 ComplexLayouter::_SatisfiesConstraints(int32* sizes) const
@@ -39,6 +39,8 @@ public:
 
 	virtual	Layouter*			CloneLayouter();
 
+	virtual	bool				InheritSolution(Layouter* previous);
+
 private:
 			class MyLayoutInfo;
 			struct Constraint;
@@ -48,6 +50,9 @@ private:
 			bool				_Layout(int32 size, SumItem* sums,
 									int32* sizes);
 			bool				_AddOptimizerConstraints();
+			bool				_InitFromLastSolution(int32 size,
+									const SumItem* sums, double* values) const;
+			void				_SetLastSolution(const double* values);
 			bool				_SatisfiesConstraints(int32* sizes) const;
 			bool				_SatisfiesConstraintsSums(int32* sums) const;
 
@@ -71,11 +76,13 @@ private:
 			SumItem*			fSums;
 			SumItemBackup*		fSumBackups;
 			LayoutOptimizer*	fOptimizer;
+			double*				fLastSolution;
 			float				fMin;
 			float				fMax;
 			int32				fUnlimited;
 			bool				fMinMaxValid;
 			bool				fOptimizerConstraintsAdded;
+			bool				fHaveLastSolution;
 };
 
 }	// namespace Layout
@@ -479,16 +479,6 @@ qr_decomposition(double** a, int m, int n, double* d, double** q)
 }
 
 
-// MatrixDeleter
-struct MatrixDelete {
-	inline void operator()(double** matrix)
-	{
-		free_matrix(matrix);
-	}
-};
-typedef BPrivate::AutoDeleter<double*, MatrixDelete> MatrixDeleter;
-
-
 // Constraint
 struct LayoutOptimizer::Constraint {
 	Constraint(int32 left, int32 right, double value, bool equality,
@@ -532,7 +522,10 @@ struct LayoutOptimizer::Constraint {
 LayoutOptimizer::LayoutOptimizer(int32 variableCount)
 	: fVariableCount(variableCount),
 	  fConstraints(),
-	  fVariables(new (nothrow) double[variableCount])
+	  fVariables(new (nothrow) double[variableCount]),
+	  fActiveMatrix(NULL),
+	  fActiveMatrixTemp(NULL),
+	  fActiveMatrixCapacity(0)
 {
 	fTemp1 = allocate_matrix(fVariableCount, fVariableCount);
 	fTemp2 = allocate_matrix(fVariableCount, fVariableCount);
@@ -548,6 +541,8 @@ LayoutOptimizer::~LayoutOptimizer()
 	free_matrix(fTemp2);
 	free_matrix(fZtrans);
 	free_matrix(fQ);
+	free_matrix(fActiveMatrix);
+	free_matrix(fActiveMatrixTemp);
 
 	delete[] fVariables;
 
@@ -615,7 +610,7 @@ LayoutOptimizer::AddConstraintsFrom(const LayoutOptimizer* other)
 	if (!other || other->fVariableCount != fVariableCount)
 		return false;
 
-	int32 count = fConstraints.CountItems();
+	int32 count = other->fConstraints.CountItems();
 	for (int32 i = 0; i < count; i++) {
 		Constraint* constraint = (Constraint*)other->fConstraints.ItemAt(i);
 		if (!AddConstraint(constraint->left, constraint->right,
@@ -657,12 +652,10 @@ LayoutOptimizer::Solve(const double* desired, double size, double* values)
 
 	int32 constraintCount = fConstraints.CountItems() + 1;
 
-	// allocate the active constraint matrix and its transposed matrix
-	fActiveMatrix = allocate_matrix(constraintCount, fVariableCount);
-	fActiveMatrixTemp = allocate_matrix(constraintCount, fVariableCount);
-	MatrixDeleter _(fActiveMatrix);
-	MatrixDeleter _2(fActiveMatrixTemp);
-	if (!fActiveMatrix || !fActiveMatrixTemp)
+	// The active constraint matrices are kept around between calls, since
+	// a layout is usually solved for many sizes in a row (e.g. while the
+	// window is being resized).
+	if (!_EnsureActiveMatrixCapacity(constraintCount))
 		return false;
 
 	// add sum constraint
@@ -714,14 +707,19 @@ TRACE_ONLY(
 	d[fVariableCount - 1] = -desired[fVariableCount - 1];
 
 	// init active set
+	// If the given solution is the one computed for a previous, similar
+	// problem (cf. ComplexLayouter), this is mostly the previous active set,
+	// and we are done after a few iterations.
 	BList activeConstraints(constraintCount);
+	bool isActive[constraintCount];
 
 	for (int32 i = 0; i < constraintCount; i++) {
 		Constraint* constraint = (Constraint*)fConstraints.ItemAt(i);
 		double actualValue = constraint->ActualValue(x);
 		TRACE("constraint %ld: actual: %f  constraint: %f\n", i, actualValue,
 			constraint->value);
-		if (fuzzy_equals(actualValue, constraint->value))
+		isActive[i] = fuzzy_equals(actualValue, constraint->value);
+		if (isActive[i])
 			activeConstraints.AddItem(constraint);
 	}
 
@@ -848,7 +846,9 @@ TRACE_ONLY(
 			}
 
 			// remove i from the active set
-			activeConstraints.RemoveItem(minIndex);
+			Constraint* constraint
+				= (Constraint*)activeConstraints.RemoveItem(minIndex);
+			isActive[constraint->index] = false;
 
 		} else {
 			// compute alpha_k
@@ -856,10 +856,11 @@ TRACE_ONLY(
 			int barrier = -1;
 			// if alpha_k < 1, add a barrier constraint to W^k
 			for (int32 i = 0; i < constraintCount; i++) {
-				Constraint* constraint = (Constraint*)fConstraints.ItemAt(i);
-				if (activeConstraints.HasItem(constraint))
+				if (isActive[i])
 					continue;
 
+				Constraint* constraint = (Constraint*)fConstraints.ItemAt(i);
+
 				double divider = constraint->ActualValue(p);
 				if (divider > 0 || fuzzy_equals(divider, 0))
 					continue;
@@ -875,8 +876,10 @@ TRACE_ONLY(
 			}
 			TRACE("alpha: %f, barrier: %d\n", alpha, barrier);
 
-			if (alpha < 1)
+			if (alpha < 1) {
 				activeConstraints.AddItem(fConstraints.ItemAt(barrier));
+				isActive[barrier] = true;
+			}
 
 			// x += p * alpha;
 			add_vectors_scaled(x, p, alpha, fVariableCount);
@@ -955,3 +958,29 @@ LayoutOptimizer::_SetResult(const double* x, double* values)
 	for (int i = 1; i < fVariableCount; i++)
 		values[i] = x[i] - x[i - 1];
 }
+
+
+// _EnsureActiveMatrixCapacity
+bool
+LayoutOptimizer::_EnsureActiveMatrixCapacity(int32 rows)
+{
+	if (rows <= fActiveMatrixCapacity)
+		return true;
+
+	free_matrix(fActiveMatrix);
+	free_matrix(fActiveMatrixTemp);
+	fActiveMatrixCapacity = 0;
+
+	fActiveMatrix = allocate_matrix(rows, fVariableCount);
+	fActiveMatrixTemp = allocate_matrix(rows, fVariableCount);
+	if (fActiveMatrix == NULL || fActiveMatrixTemp == NULL) {
+		free_matrix(fActiveMatrix);
+		free_matrix(fActiveMatrixTemp);
+		fActiveMatrix = NULL;
+		fActiveMatrixTemp = NULL;
+		return false;
+	}
+
+	fActiveMatrixCapacity = rows;
+	return true;
+}
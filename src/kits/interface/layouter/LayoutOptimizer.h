@@ -37,6 +37,7 @@ private:
 			bool				_SolveSubProblem(const double* d, int am,
 									double* p);
 			void				_SetResult(const double* x, double* values);
+			bool				_EnsureActiveMatrixCapacity(int32 rows);
 
 
 			struct Constraint;
@@ -50,6 +51,7 @@ private:
 			double**			fQ;
 			double**			fActiveMatrix;
 			double**			fActiveMatrixTemp;
+			int32				fActiveMatrixCapacity;
 };
 
 }	// namespace Layout
@@ -41,3 +41,15 @@ Layouter::Layouter()
 Layouter::~Layouter()
 {
 }
+
+// InheritSolution
+/*!	Gives the layouter the chance to take over what \a previous, a layouter
+	for the same elements, but possibly different constraints, has computed,
+	so that the next Layout() doesn't have to start from scratch.
+	Returns whether anything has been taken over.
+*/
+bool
+Layouter::InheritSolution(Layouter* previous)
+{
+	return false;
+}
@@ -40,6 +40,8 @@ public:
 	virtual	void				Layout(LayoutInfo* layoutInfo, float size) = 0;
 
 	virtual	Layouter*			CloneLayouter() = 0;
+
+	virtual	bool				InheritSolution(Layouter* previous);
 };
 
 
@@ -11,7 +11,9 @@
 
 
 BTextView::LineBuffer::LineBuffer()
-	:	_BTextViewSupportBuffer_<STELine>(20, 2)
+	:	_BTextViewSupportBuffer_<STELine>(20, 2),
+	fMaxWidth(0),
+	fMaxWidthValid(true)
 {
 }
 
@@ -25,12 +27,24 @@ void
 BTextView::LineBuffer::InsertLine(STELine* inLine, int32 index)
 {
 	InsertItemsAt(1, index, inLine);
+
+	if (fMaxWidthValid && inLine->width > fMaxWidth)
+		fMaxWidth = inLine->width;
 }
 
 
 void
 BTextView::LineBuffer::RemoveLines(int32 index, int32 count)
 {
+	if (fMaxWidthValid) {
+		for (int32 i = index; i < index + count && i < fItemCount; i++) {
+			if (fBuffer[i].width >= fMaxWidth) {
+				fMaxWidthValid = false;
+				break;
+			}
+		}
+	}
+
 	RemoveItemsAt(count, index);
 }
 
@@ -109,11 +123,31 @@ BTextView::LineBuffer::BumpOffset(int32 delta, int32 index)
 }
 
 
+/*!	Sets the width of the line at \a index. The widest line is tracked along,
+	so that MaxWidth() only has to look at all lines again when the widest
+	line became narrower, or was removed.
+*/
+void
+BTextView::LineBuffer::SetWidth(int32 index, float width)
+{
+	float oldWidth = fBuffer[index].width;
+	fBuffer[index].width = width;
+
+	if (!fMaxWidthValid)
+		return;
+
+	if (width >= fMaxWidth)
+		fMaxWidth = width;
+	else if (oldWidth >= fMaxWidth)
+		fMaxWidthValid = false;
+}
+
+
 float
 BTextView::LineBuffer::MaxWidth() const
 {
-	if (fItemCount == 0)
-		return 0;
+	if (fMaxWidthValid)
+		return fMaxWidth;
 
 	float maxWidth = 0;
 	STELine* line = &fBuffer[0];
@@ -122,5 +156,8 @@ BTextView::LineBuffer::MaxWidth() const
 			maxWidth = line->width;
 		line++;
 	}
+
+	fMaxWidth = maxWidth;
+	fMaxWidthValid = true;
 	return maxWidth;
 }
@@ -39,9 +39,15 @@ public:
 			void				BumpOrigin(float delta, int32 index);
 			void				BumpOffset(int32 delta, int32 index);
 
+			void				SetWidth(int32 index, float width);
+
 			int32				NumLines() const;
 			float				MaxWidth() const;
 			STELine*			operator[](int32 index) const;
+
+private:
+	mutable	float				fMaxWidth;
+	mutable	bool				fMaxWidthValid;
 };
 
 
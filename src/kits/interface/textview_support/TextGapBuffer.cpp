@@ -12,6 +12,8 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+
 #include <utf8_functions.h>
 
 #include <File.h>
@@ -26,6 +28,17 @@ namespace BPrivate {
 static const int32 kTextGapBufferBlockSize = 2048;
 
 
+/*!	Returns the gap size to use for a buffer holding \a textLength bytes.
+	The gap grows with the text, so that typing into a large document does not
+	move the whole text after the gap every few thousand characters.
+*/
+static inline int32
+gap_size_for(int32 textLength)
+{
+	return std::max(kTextGapBufferBlockSize, textLength / 16);
+}
+
+
 TextGapBuffer::TextGapBuffer()
 	:
 	fItemCount(0),
@@ -62,7 +75,7 @@ TextGapBuffer::InsertText(const char* inText, int32 inNumItems, int32 inAtIndex)
 		_MoveGapTo(inAtIndex);
 
 	if (fGapCount < inNumItems)
-		_EnlargeGapTo(inNumItems + kTextGapBufferBlockSize);
+		_EnlargeGapTo(inNumItems + gap_size_for(fItemCount + inNumItems));
 
 	memcpy(fBuffer + fGapIndex, inText, inNumItems);
 
@@ -98,7 +111,7 @@ TextGapBuffer::InsertText(BFile* file, int32 fileOffset, int32 inNumItems,
 		_MoveGapTo(inAtIndex);
 
 	if (fGapCount < inNumItems)
-		_EnlargeGapTo(inNumItems + kTextGapBufferBlockSize);
+		_EnlargeGapTo(inNumItems + gap_size_for(fItemCount + inNumItems));
 
 	// Finally, read the data and put it into the buffer
 	if (file->ReadAt(fileOffset, fBuffer + fGapIndex, inNumItems) > 0) {
@@ -128,8 +141,10 @@ TextGapBuffer::RemoveRange(int32 start, int32 end)
 	fGapCount += inNumItems;
 	fItemCount -= inNumItems;
 
-	if (fGapCount > kTextGapBufferBlockSize)
-		_ShrinkGapTo(kTextGapBufferBlockSize / 2);
+	// only shrink when the gap has become a lot larger than needed, so that
+	// deleting single characters does not move the text around every time
+	if (fGapCount > 4 * gap_size_for(fItemCount))
+		_ShrinkGapTo(gap_size_for(fItemCount));
 }
 
 
@@ -193,6 +208,33 @@ bool
 TextGapBuffer::FindChar(char inChar, int32 fromIndex, int32* ioDelta)
 {
 	int32 numChars = *ioDelta;
+	if ((inChar & 0x80) == 0) {
+		// An ASCII character can never be part of a multibyte character, so
+		// the parts before and after the gap can be searched directly.
+		int32 index = fromIndex;
+		int32 end = fromIndex + numChars;
+		while (index < end) {
+			const char* start;
+			int32 count;
+			if (index < fGapIndex) {
+				start = fBuffer + index;
+				count = std::min(end, fGapIndex) - index;
+			} else {
+				start = fBuffer + index + fGapCount;
+				count = end - index;
+			}
+
+			const char* found = (const char*)memchr(start, inChar, count);
+			if (found != NULL) {
+				*ioDelta = index + (found - start) - fromIndex;
+				return true;
+			}
+			index += count;
+		}
+
+		return false;
+	}
+
 	for (int32 i = 0; i < numChars; i++) {
 		char realChar = RealCharAt(fromIndex + i);
 		if ((realChar & 0xc0) == 0x80)
@@ -17,6 +17,7 @@
 #include <Debug.h>
 #include <Font.h>
 #include <Locker.h>
+#include <StackOrHeapArray.h>
 
 #include <stdio.h>
 
@@ -30,6 +31,14 @@ namespace BPrivate {
 
 const static uint32 kTableCount = 128;
 const static uint32 kInvalidCode = 0xFFFFFFFF;
+
+// When a character is missing, the widths of all characters in its block of
+// kBlockSize code points are fetched with it, for at most kMaxPrefetchBlocks
+// blocks at a time. Text in a script usually sticks to very few blocks, so
+// this saves most round trips to the app_server.
+const static uint32 kBlockShift = 7;
+const static uint32 kBlockSize = 1 << kBlockShift;
+const static int32 kMaxPrefetchBlocks = 8;
 WidthBuffer* gWidthBuffer = NULL;
 	// initialized in InterfaceDefs.cpp
 
@@ -65,12 +74,64 @@ CharToCode(const char* text, const int32 charLen)
 }
 
 
+/*!	Encodes \a code as UTF-8 into \a buffer, which must have room for four
+	bytes. Returns the length of the encoded character.
+*/
+static inline int32
+CodeToUTF8(uint32 code, char* buffer)
+{
+	if (code < 0x80) {
+		buffer[0] = code;
+		return 1;
+	}
+	if (code < 0x800) {
+		buffer[0] = 0xc0 | (code >> 6);
+		buffer[1] = 0x80 | (code & 0x3f);
+		return 2;
+	}
+	if (code < 0x10000) {
+		buffer[0] = 0xe0 | (code >> 12);
+		buffer[1] = 0x80 | ((code >> 6) & 0x3f);
+		buffer[2] = 0x80 | (code & 0x3f);
+		return 3;
+	}
+	buffer[0] = 0xf0 | (code >> 18);
+	buffer[1] = 0x80 | ((code >> 12) & 0x3f);
+	buffer[2] = 0x80 | ((code >> 6) & 0x3f);
+	buffer[3] = 0x80 | (code & 0x3f);
+	return 4;
+}
+
+
+/*!	Returns the block of the given UTF-8 character, or -1 if the character
+	cannot be prefetched with its block, because it is not encoded the way
+	CodeToUTF8() would encode it.
+*/
+static inline int32
+CharToBlock(const char* text, int32 charLen)
+{
+	const char* bytes = text;
+	uint32 code = UTF8ToCharCode(&bytes);
+	if (code == 0 || code > 0x10ffff || (code >= 0xd800 && code <= 0xdfff))
+		return -1;
+
+	char encoded[4];
+	if (CodeToUTF8(code, encoded) != charLen
+		|| memcmp(encoded, text, charLen) != 0) {
+		return -1;
+	}
+
+	return code >> kBlockShift;
+}
+
+
 /*! \brief Initializes the object.
 */
 WidthBuffer::WidthBuffer()
 	:
 	_BTextViewSupportBuffer_<_width_table_>(1, 0),
-	fLock("width buffer")
+	fLock("width buffer"),
+	fLastTableIndex(-1)
 {
 }
 
@@ -98,13 +159,17 @@ WidthBuffer::StringWidth(const char* inText, int32 fromOffset, int32 length,
 	if (inText == NULL || length <= 0)
 		return 0;
 
-	BAutolock _(fLock);
+	BAutolock locker(fLock);
 
 	int32 index = 0;
 	if (!FindTable(inStyle, &index))
 		index = InsertTable(inStyle);
 
-	char* text = NULL;
+	// the characters that aren't in the table can't be more than the string
+	BStackOrHeapArray<char, 256> text(length + 1);
+	if (!text.IsValid())
+		return 0;
+
 	int32 numChars = 0;
 	int32 textLen = 0;
 
@@ -130,26 +195,20 @@ WidthBuffer::StringWidth(const char* inText, int32 fromOffset, int32 length,
 		} else {
 			// Store this character into an array, which we'll
 			// pass to HashEscapements() later
-			int32 offset = textLen;
+			memcpy(&text[textLen], sourceText, charLen);
 			textLen += charLen;
 			numChars++;
-			char* newText = (char*)realloc(text, textLen + 1);
-			if (newText == NULL) {
-				free(text);
-				return 0;
-			}
-
-			text = newText;
-			memcpy(&text[offset], sourceText, charLen);
 		}
 	}
 
-	if (text != NULL) {
+	if (numChars > 0) {
 		// We've found some characters which aren't yet in the hash table.
-		// Get their width via HashEscapements()
+		// Get their width via HashEscapements(), which doesn't need the lock
+		// while it is waiting for the app_server.
 		text[textLen] = 0;
-		stringWidth += HashEscapements(text, numChars, textLen, index, inStyle);
-		free(text);
+		locker.Unlock();
+		stringWidth += HashEscapements(text, numChars, textLen, index,
+			inStyle);
 	}
 
 	return stringWidth * fontSize;
@@ -186,6 +245,14 @@ WidthBuffer::FindTable(const BFont* inStyle, int32* outIndex)
 	if (inStyle == NULL)
 		return false;
 
+	// most of the time, the same font is used over and over again
+	if (fLastTableIndex >= 0 && fLastTableIndex < fItemCount
+		&& *inStyle == fBuffer[fLastTableIndex].font) {
+		if (outIndex != NULL)
+			*outIndex = fLastTableIndex;
+		return true;
+	}
+
 	int32 tableIndex = -1;
 
 	for (int32 i = 0; i < fItemCount; i++) {
@@ -196,6 +263,8 @@ WidthBuffer::FindTable(const BFont* inStyle, int32* outIndex)
 	}
 	if (outIndex != NULL)
 		*outIndex = tableIndex;
+	if (tableIndex != -1)
+		fLastTableIndex = tableIndex;
 
 	return tableIndex != -1;
 }
@@ -217,6 +286,7 @@ WidthBuffer::InsertTable(const BFont* font)
 
 	uint32 position = fItemCount;
 	InsertItemsAt(1, position, &table);
+	fLastTableIndex = position;
 
 	return position;
 }
@@ -272,6 +342,10 @@ WidthBuffer::Hash(uint32 val)
 
 /*! \brief Gets the escapements for the given string, and put them into
 	the hash table.
+	The escapements of all characters in the Unicode blocks of the given
+	characters are fetched as well, so that the following strings are not
+	likely to need another trip to the app_server.
+	Must be called without holding the lock.
 	\param inText The string to be examined.
 	\param numChars The amount of characters contained in the string.
 	\param textLen the amount of bytes contained in the string.
@@ -289,84 +363,170 @@ WidthBuffer::HashEscapements(const char* inText, int32 numChars, int32 textLen,
 	ASSERT(numChars > 0);
 	ASSERT(textLen > 0);
 
-	float* escapements = new float[numChars];
-	inStyle->GetEscapements(inText, numChars, escapements);
-
-	_width_table_ &table = fBuffer[tableIndex];
-	hashed_escapement* widths = static_cast<hashed_escapement*>(table.widths);
-
-	int32 charCount = 0;
-	char* text = (char*)inText;
+	// Collect the blocks to prefetch
+	int32 blocks[kMaxPrefetchBlocks];
+	int32 blockCount = 0;
+	const char* text = inText;
 	const char* textEnd = inText + textLen;
-	// Insert the escapements into the hash table
-	do {
-		// Using this variant is safe as the handed in string is guaranteed to
-		// be 0 terminated.
+	while (text < textEnd && blockCount < kMaxPrefetchBlocks) {
 		const int32 charLen = UTF8NextCharLen(text);
 		if (charLen == 0)
 			break;
 
-		const uint32 value = CharToCode(text, charLen);
+		int32 block = CharToBlock(text, charLen);
+		bool known = block < 0;
+		for (int32 i = 0; i < blockCount && !known; i++)
+			known = blocks[i] == block;
+		if (!known)
+			blocks[blockCount++] = block;
+
+		text += charLen;
+	}
+
+	// Build the request: all characters of the blocks, and the characters
+	// that are not part of any of them
+	BStackOrHeapArray<char, 1024> request(
+		blockCount * kBlockSize * 4 + textLen + 1);
+	if (!request.IsValid())
+		return 0;
+
+	int32 requestLen = 0;
+	int32 requestChars = 0;
+	for (int32 i = 0; i < blockCount; i++) {
+		uint32 code = blocks[i] << kBlockShift;
+		for (uint32 end = code + kBlockSize; code < end; code++) {
+			if (code == 0 || (code >= 0xd800 && code <= 0xdfff))
+				continue;
 
-		uint32 hashed = Hash(value) & (table.tableCount - 1);
-		uint32 found;
-		while ((found = widths[hashed].code) != kInvalidCode) {
-			if (found == value)
-				break;
-			if (++hashed >= (uint32)table.tableCount)
-				hashed = 0;
+			requestLen += CodeToUTF8(code, &request[requestLen]);
+			requestChars++;
 		}
+	}
 
-		if (found == kInvalidCode) {
-			// The value is not in the table. Add it.
-			widths[hashed].code = value;
-			widths[hashed].escapement = escapements[charCount];
-			table.hashCount++;
-
-			// We always keep some free space in the hash table:
-			// we double the current size when hashCount is 2/3 of
-			// the total size.
-			if (table.tableCount * 2 / 3 <= table.hashCount) {
-				const int32 newSize = table.tableCount * 2;
-
-				// Create and initialize a new hash table
-				hashed_escapement* newWidths = new hashed_escapement[newSize];
-
-				// Rehash the values, and put them into the new table
-				for (uint32 oldPos = 0; oldPos < (uint32)table.tableCount;
-						oldPos++) {
-					if (widths[oldPos].code != kInvalidCode) {
-						uint32 newPos
-							= Hash(widths[oldPos].code) & (newSize - 1);
-						while (newWidths[newPos].code != kInvalidCode) {
-							if (++newPos >= (uint32)newSize)
-								newPos = 0;
-						}
-						newWidths[newPos] = widths[oldPos];
-					}
-				}
+	text = inText;
+	while (text < textEnd) {
+		const int32 charLen = UTF8NextCharLen(text);
+		if (charLen == 0)
+			break;
 
-				// Delete the old table, and put the new pointer into the
-				// _width_table_
-				delete[] widths;
-				table.tableCount = newSize;
-				table.widths = widths = newWidths;
-			}
+		int32 block = CharToBlock(text, charLen);
+		bool prefetched = false;
+		for (int32 i = 0; i < blockCount && !prefetched && block >= 0; i++)
+			prefetched = blocks[i] == block;
+		if (!prefetched) {
+			memcpy(&request[requestLen], text, charLen);
+			requestLen += charLen;
+			requestChars++;
 		}
+
+		text += charLen;
+	}
+	request[requestLen] = 0;
+
+	BStackOrHeapArray<float, 256> escapements(requestChars);
+	if (!escapements.IsValid())
+		return 0;
+
+	inStyle->GetEscapements(request, requestChars, escapements);
+
+	BAutolock _(fLock);
+
+	// Insert the escapements into the hash table
+	int32 charCount = 0;
+	text = request;
+	textEnd = request + requestLen;
+	while (text < textEnd && charCount < requestChars) {
+		// Using this variant is safe as the request is guaranteed to
+		// be 0 terminated.
+		const int32 charLen = UTF8NextCharLen(text);
+		if (charLen == 0)
+			break;
+
+		InsertEscapement(CharToCode(text, charLen), escapements[charCount],
+			tableIndex);
+
 		charCount++;
 		text += charLen;
-	} while (text < textEnd);
+	}
 
 	// Calculate the width of the string
 	float width = 0;
-	for (int32 x = 0; x < numChars; x++)
-		width += escapements[x];
+	text = inText;
+	textEnd = inText + textLen;
+	while (text < textEnd) {
+		const int32 charLen = UTF8NextCharLen(text);
+		if (charLen == 0)
+			break;
 
-	delete[] escapements;
+		float escapement;
+		if (GetEscapement(CharToCode(text, charLen), tableIndex, &escapement))
+			width += escapement;
+
+		text += charLen;
+	}
 
 	return width;
 }
 
+
+/*!	\brief Puts the escapement of a character into a table, unless the table
+	already knows it.
+	\param value An integer which uniquely identifies a character.
+	\param escapement The escapement of the character.
+	\param tableIndex the index of the table where the escapement
+		should be put.
+*/
+void
+WidthBuffer::InsertEscapement(uint32 value, float escapement, int32 tableIndex)
+{
+	_width_table_ &table = fBuffer[tableIndex];
+	hashed_escapement* widths = static_cast<hashed_escapement*>(table.widths);
+
+	uint32 hashed = Hash(value) & (table.tableCount - 1);
+	uint32 found;
+	while ((found = widths[hashed].code) != kInvalidCode) {
+		if (found == value)
+			return;
+		if (++hashed >= (uint32)table.tableCount)
+			hashed = 0;
+	}
+
+	// The value is not in the table. Add it.
+	widths[hashed].code = value;
+	widths[hashed].escapement = escapement;
+	table.hashCount++;
+
+	// We always keep some free space in the hash table:
+	// we double the current size when hashCount is 2/3 of
+	// the total size.
+	if (table.tableCount * 2 / 3 <= table.hashCount) {
+		const int32 newSize = table.tableCount * 2;
+
+		// Create and initialize a new hash table
+		hashed_escapement* newWidths = new hashed_escapement[newSize];
+
+		// Rehash the values, and put them into the new table
+		for (uint32 oldPos = 0; oldPos < (uint32)table.tableCount;
+				oldPos++) {
+			if (widths[oldPos].code != kInvalidCode) {
+				uint32 newPos
+					= Hash(widths[oldPos].code) & (newSize - 1);
+				while (newWidths[newPos].code != kInvalidCode) {
+					if (++newPos >= (uint32)newSize)
+						newPos = 0;
+				}
+				newWidths[newPos] = widths[oldPos];
+			}
+		}
+
+		// Delete the old table, and put the new pointer into the
+		// _width_table_
+		delete[] widths;
+		table.tableCount = newSize;
+		table.widths = newWidths;
+	}
+}
+
 } // namespace BPrivate
 
 
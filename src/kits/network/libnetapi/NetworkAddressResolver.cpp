@@ -1,6 +1,7 @@
 /*
  * Copyright 2010-2011, Axel Dörfler, axeld@pinc-software.de.
  * Copyright 2015-2017, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Copyright 2026, Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  */
 
@@ -11,7 +12,24 @@
 #include <netdb.h>
 
 #include <Autolock.h>
+#include <Message.h>
+#include <Messenger.h>
 #include <NetworkAddress.h>
+#include <OS.h>
+
+
+//! Resolved addresses are looked up again after this time
+static const bigtime_t kCacheTimeout = 60000000LL;
+
+
+struct resolve_request {
+	int			family;
+	BString		address;
+	BString		service;
+	uint32		flags;
+	BMessenger	target;
+	uint32		what;
+};
 
 
 static bool
@@ -305,12 +323,17 @@ BNetworkAddressResolver::Resolve(int family, const char* address,
 	// a doubly-linked list is better. We should have these two share the same
 	// items, so it's easy to remove the LRU from the map, or insert a new
 	// item in both structures.
+	bigtime_t now = system_time();
 	for (int i = 0; i < sCacheMap.CountItems(); i++) {
 		CacheEntry* entry = sCacheMap.ItemAt(i);
 		if (entry->Matches(family, address, service, flags)) {
+			if (now - entry->fCreated > kCacheTimeout) {
+				// The entry is too old, drop it and make a new request
+				delete sCacheMap.RemoveItemAt(i);
+				break;
+			}
+
 			// This entry is now the MRU, move to end of list.
-			// TODO if the item is old (more than 1 minute), it should be
-			// dropped and a new request made.
 			sCacheMap.MoveItem(i, sCacheMap.CountItems());
 			return entry->fResolver;
 		}
@@ -325,11 +348,10 @@ BNetworkAddressResolver::Resolve(int family, const char* address,
 
 	if (resolver != NULL && resolver->InitCheck() == B_OK) {
 		CacheEntry* entry = new(std::nothrow) CacheEntry(family, address,
-			service, flags, resolver);
+			service, flags, resolver, now);
 
 		locker.Lock();
-		// TODO adjust capacity. Chrome uses 256 entries with a timeout of
-		// 1 minute, IE uses 1000 entries with a timeout of 30 seconds.
+		// Like Chrome, we use 256 entries with a timeout of 1 minute.
 		if (sCacheMap.CountItems() > 255)
 			delete sCacheMap.RemoveItemAt(0);
 
@@ -340,6 +362,89 @@ BNetworkAddressResolver::Resolve(int family, const char* address,
 	return BReference<const BNetworkAddressResolver>(resolver, true);
 }
 
+
+/*!	Resolves the address in a thread of its own, and sends the result to
+	\a target in a message with the \a what code.
+
+	The message contains the "status" of the resolution, the "name" and
+	"service" that were asked for, and when successful, one "address" field
+	of type B_NETWORK_ADDRESS_TYPE for each address found, in the order
+	they should be tried.
+*/
+/*static*/ status_t
+BNetworkAddressResolver::ResolveAsync(int family, const char* address,
+	const char* service, uint32 flags, const BMessenger& target, uint32 what)
+{
+	if (!target.IsValid())
+		return B_BAD_VALUE;
+
+	resolve_request* request = new(std::nothrow) resolve_request;
+	if (request == NULL)
+		return B_NO_MEMORY;
+
+	request->family = family;
+	request->address = address;
+	request->service = service;
+	request->flags = flags;
+	request->target = target;
+	request->what = what;
+
+	thread_id thread = spawn_thread(&_ResolveThread, "resolve address",
+		B_NORMAL_PRIORITY, request);
+	if (thread < 0) {
+		delete request;
+		return thread;
+	}
+
+	resume_thread(thread);
+	return B_OK;
+}
+
+
+/*static*/ status_t
+BNetworkAddressResolver::ResolveAsync(int family, const char* address,
+	uint16 port, uint32 flags, const BMessenger& target, uint32 what)
+{
+	BString service;
+	service << port;
+
+	return ResolveAsync(family, address, port == 0 ? NULL : service.String(),
+		flags, target, what);
+}
+
+
+/*static*/ status_t
+BNetworkAddressResolver::_ResolveThread(void* data)
+{
+	resolve_request* request = (resolve_request*)data;
+
+	BReference<const BNetworkAddressResolver> resolver = Resolve(
+		request->family, request->address.IsEmpty()
+			? NULL : request->address.String(),
+		request->service.IsEmpty() ? NULL : request->service.String(),
+		request->flags);
+
+	status_t status = resolver.IsSet() ? resolver->InitCheck() : B_NO_MEMORY;
+
+	BMessage message(request->what);
+	message.AddInt32("status", status);
+	message.AddString("name", request->address);
+	message.AddString("service", request->service);
+
+	if (status == B_OK) {
+		BNetworkAddress address;
+		uint32 cookie = 0;
+		while (resolver->GetNextAddress(&cookie, address) == B_OK)
+			message.AddFlat("address", &address);
+	}
+
+	request->target.SendMessage(&message);
+
+	delete request;
+	return B_OK;
+}
+
+
 BLocker BNetworkAddressResolver::sCacheLock("DNS cache");
 BObjectList<BNetworkAddressResolver::CacheEntry>
 	BNetworkAddressResolver::sCacheMap;
@@ -8,6 +8,8 @@
 
 #include "HttpBuffer.h"
 
+#include <string.h>
+
 #include <DataIO.h>
 #include <NetServicesDefs.h>
 #include <String.h>
@@ -20,15 +22,19 @@ using namespace BPrivate::Network;
 
 	As per the RFC, defined as \r\n
 */
-static constexpr std::array<std::byte, 2> kNewLine = {std::byte('\r'), std::byte('\n')};
+static constexpr std::string_view kNewLine = "\r\n";
 
 
 /*!
 	\brief Create a new HTTP buffer with \a capacity.
+
+	The storage is allocated once; the data is kept between an offset and a size within it, so
+	that reading and consuming data does not need to touch any of the other bytes.
 */
 HttpBuffer::HttpBuffer(size_t capacity)
+	:
+	fBuffer(capacity)
 {
-	fBuffer.reserve(capacity);
 };
 
 
@@ -43,32 +49,29 @@ HttpBuffer::HttpBuffer(size_t capacity)
 ssize_t
 HttpBuffer::ReadFrom(BDataIO* source, std::optional<size_t> maxSize)
 {
-	// Remove any unused bytes at the beginning of the buffer
-	Flush();
-
-	auto currentSize = fBuffer.size();
-	auto remainingBufferSize = fBuffer.capacity() - currentSize;
+	// Remove the unused bytes at the beginning of the buffer when that frees more space than is
+	// left at the end; an empty buffer starts over without moving anything
+	if (RemainingBytes() == 0)
+		Clear();
+	else if (fBuffer.size() - fCurrentSize < fCurrentOffset)
+		Flush();
 
+	auto remainingBufferSize = fBuffer.size() - fCurrentSize;
 	if (maxSize && maxSize.value() < remainingBufferSize)
 		remainingBufferSize = maxSize.value();
 
-	// Adjust the buffer to the maximum size
-	fBuffer.resize(fBuffer.capacity());
-
 	ssize_t bytesRead = B_INTERRUPTED;
 	while (bytesRead == B_INTERRUPTED)
-		bytesRead = source->Read(fBuffer.data() + currentSize, remainingBufferSize);
+		bytesRead = source->Read(fBuffer.data() + fCurrentSize, remainingBufferSize);
 
 	if (bytesRead == B_WOULD_BLOCK || bytesRead == 0) {
-		fBuffer.resize(currentSize);
 		return bytesRead;
 	} else if (bytesRead < 0) {
 		throw BNetworkRequestError(
 			"BDataIO::Read()", BNetworkRequestError::NetworkError, bytesRead);
 	}
 
-	// Adjust the buffer to the current size
-	fBuffer.resize(currentSize + bytesRead);
+	fCurrentSize += bytesRead;
 
 	return bytesRead;
 }
@@ -116,14 +119,32 @@ HttpBuffer::WriteTo(HttpTransferFunction func, std::optional<size_t> maxSize)
 std::optional<BString>
 HttpBuffer::GetNextLine()
 {
-	auto offset = fBuffer.cbegin() + fCurrentOffset;
-	auto result = std::search(offset, fBuffer.cend(), kNewLine.cbegin(), kNewLine.cend());
-	if (result == fBuffer.cend())
+	auto line = GetNextLineView();
+	if (!line)
+		return std::nullopt;
+
+	return BString(line->data(), line->size());
+}
+
+
+/*!
+	\brief Get the next line from this buffer, without copying it.
+
+	This works like GetNextLine(), but the returned view points into the buffer. It is only valid
+	until the next call to a method that changes the buffer, like ReadFrom() or Flush().
+
+	\retval std::nullopt There are no more lines in the buffer.
+	\retval std::string_view The next line, without the newline sequence.
+*/
+std::optional<std::string_view>
+HttpBuffer::GetNextLineView()
+{
+	auto lineEnd = _FindLineEnd();
+	if (!lineEnd)
 		return std::nullopt;
 
-	BString line(
-		reinterpret_cast<const char*>(std::addressof(*offset)), std::distance(offset, result));
-	fCurrentOffset = std::distance(fBuffer.cbegin(), result) + 2;
+	auto line = Data().substr(0, *lineEnd);
+	fCurrentOffset += *lineEnd + kNewLine.size();
 	return line;
 }
 
@@ -134,7 +155,7 @@ HttpBuffer::GetNextLine()
 size_t
 HttpBuffer::RemainingBytes() const noexcept
 {
-	return fBuffer.size() - fCurrentOffset;
+	return fCurrentSize - fCurrentOffset;
 }
 
 
@@ -149,8 +170,8 @@ void
 HttpBuffer::Flush() noexcept
 {
 	if (fCurrentOffset > 0) {
-		auto end = fBuffer.cbegin() + fCurrentOffset;
-		fBuffer.erase(fBuffer.cbegin(), end);
+		memmove(fBuffer.data(), fBuffer.data() + fCurrentOffset, RemainingBytes());
+		fCurrentSize -= fCurrentOffset;
 		fCurrentOffset = 0;
 	}
 }
@@ -162,7 +183,7 @@ HttpBuffer::Flush() noexcept
 void
 HttpBuffer::Clear() noexcept
 {
-	fBuffer.clear();
+	fCurrentSize = 0;
 	fCurrentOffset = 0;
 }
 
@@ -189,13 +210,29 @@ HttpBuffer::Data() const noexcept
 HttpBuffer&
 HttpBuffer::operator<<(const std::string_view& data)
 {
-	if (data.size() > (fBuffer.capacity() - fBuffer.size())) {
+	if (data.size() > (fBuffer.size() - fCurrentSize)) {
 		throw BNetworkRequestError(__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError,
 			"No capacity left in buffer to append data.");
 	}
 
-	for (const auto& character: data)
-		fBuffer.push_back(static_cast<const std::byte>(character));
+	memcpy(fBuffer.data() + fCurrentSize, data.data(), data.size());
+	fCurrentSize += data.size();
 
 	return *this;
 }
+
+
+/*!
+	\brief Find the end of the next line in the remaining data.
+
+	\returns The length of the line without the newline sequence, or \c std::nullopt when the data
+		does not contain a complete line.
+*/
+std::optional<size_t>
+HttpBuffer::_FindLineEnd() const noexcept
+{
+	auto lineEnd = Data().find(kNewLine);
+	if (lineEnd == std::string_view::npos)
+		return std::nullopt;
+	return lineEnd;
+}
@@ -34,6 +34,7 @@ public:
 			void				WriteExactlyTo(HttpTransferFunction func,
 									std::optional<size_t> maxSize = std::nullopt);
 			std::optional<BString> GetNextLine();
+			std::optional<std::string_view> GetNextLineView();
 
 			size_t				RemainingBytes() const noexcept;
 
@@ -45,9 +46,13 @@ public:
 	// load data into the buffer
 			HttpBuffer&			operator<<(const std::string_view& data);
 
+private:
+			std::optional<size_t> _FindLineEnd() const noexcept;
+
 private:
 			std::vector<std::byte> fBuffer;
 			size_t				fCurrentOffset = 0;
+			size_t				fCurrentSize = 0;
 };
 
 
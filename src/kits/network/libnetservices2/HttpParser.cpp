@@ -8,8 +8,10 @@
 
 #include "HttpParser.h"
 
+#include <charconv>
 #include <stdexcept>
 #include <string>
+#include <strings.h>
 
 #include <HttpFields.h>
 #include <NetServicesDefs.h>
@@ -19,6 +21,31 @@ using namespace std::literals;
 using namespace BPrivate::Network;
 
 
+/*!
+	\brief Check if the comma separated list in \a value contains \a token, ignoring case.
+*/
+static bool
+contains_token(std::string_view value, std::string_view token)
+{
+	while (!value.empty()) {
+		auto end = value.find(',');
+		auto item = value.substr(0, end);
+		while (!item.empty() && (item.front() == ' ' || item.front() == '\t'))
+			item.remove_prefix(1);
+		while (!item.empty() && (item.back() == ' ' || item.back() == '\t'))
+			item.remove_suffix(1);
+
+		if (item.size() == token.size() && strncasecmp(item.data(), token.data(), token.size()) == 0)
+			return true;
+
+		if (end == std::string_view::npos)
+			break;
+		value.remove_prefix(end + 1);
+	}
+	return false;
+}
+
+
 // #pragma mark -- HttpParser
 
 
@@ -73,6 +100,9 @@ HttpParser::ParseStatus(HttpBuffer& buffer, BHttpStatus& status)
 		throw BNetworkRequestError(__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError);
 	}
 
+	// HTTP/1.1 connections are persistent by default, earlier versions are not
+	fKeepAlive = !statusLine->StartsWith("HTTP/1.0");
+
 	status.text = std::move(statusLine.value());
 	fStatus.code = status.code; // cache the status code
 	fStreamState = HttpInputStreamState::Fields;
@@ -114,6 +144,16 @@ HttpParser::ParseFields(HttpBuffer& buffer, BHttpFields& fields)
 		return false;
 	}
 
+	// The Connection field overrides the default persistence of the HTTP version
+	for (const auto& field: fields) {
+		if (field.Name() == "Connection"sv) {
+			if (contains_token(field.Value(), "close"sv))
+				fKeepAlive = false;
+			else if (contains_token(field.Value(), "keep-alive"sv))
+				fKeepAlive = true;
+		}
+	}
+
 	// Determine the properties for the body
 	// RFC 7230 section 3.3.3 has a prioritized list of 7 rules around determining the body:
 	std::optional<off_t> bodyBytesTotal = std::nullopt;
@@ -213,6 +253,50 @@ HttpParser::ParseBody(HttpBuffer& buffer, HttpTransferFunction writeToBody, bool
 }
 
 
+/*!
+	\brief Get how many bytes of the body can be received directly into the target.
+
+	This is possible when the body is not chunked or compressed, and when the buffer does not
+	contain any data anymore. Those bytes do not need to go through a HttpBuffer; the caller reads
+	them straight into the target and reports them with ParseDirectBody().
+
+	\returns The number of bytes, at most \a maxSize, or \c std::nullopt when the body needs to be
+		parsed with ParseBody().
+*/
+std::optional<size_t>
+HttpParser::DirectBodySize(size_t maxSize) const noexcept
+{
+	if (fStreamState != HttpInputStreamState::Body)
+		return std::nullopt;
+
+	return fBodyParser->DirectBodySize(maxSize);
+}
+
+
+/*!
+	\brief Account for \a bytesReceived body bytes that were received directly into the target.
+
+	The \a readEnd parameter indicates to the parser that there will be no more data.
+
+	\exception BNetworkRequestError In case the data ended before the body was complete.
+
+	\returns The number of body bytes parsed.
+*/
+size_t
+HttpParser::ParseDirectBody(size_t bytesReceived, bool readEnd)
+{
+	if (fStreamState != HttpInputStreamState::Body)
+		debugger("The parser is not in the correct state to parse a body");
+
+	auto parseResult = fBodyParser->ParseDirectBody(bytesReceived, readEnd);
+
+	if (parseResult.complete)
+		fStreamState = HttpInputStreamState::Done;
+
+	return parseResult.bytesParsed;
+}
+
+
 /*!
 	\brief Return if the body is currently expecting to having content.
 
@@ -260,6 +344,20 @@ HttpParser::Complete() const noexcept
 }
 
 
+/*!
+	\brief Check if the connection can be used for another request after this response.
+
+	This is only the case when the response has been completely received, and when its end was
+	not marked by closing the connection.
+*/
+bool
+HttpParser::KeepAlive() const noexcept
+{
+	return fKeepAlive && fBodyType != HttpBodyType::VariableSize
+		&& fStreamState == HttpInputStreamState::Done;
+}
+
+
 // #pragma mark -- HttpBodyParser
 
 
@@ -273,6 +371,26 @@ HttpBodyParser::TotalBodySize() const noexcept
 }
 
 
+/*!
+	\brief Default implementation to return std::nullopt; the body must be parsed from a buffer.
+*/
+std::optional<size_t>
+HttpBodyParser::DirectBodySize(size_t maxSize) const noexcept
+{
+	return std::nullopt;
+}
+
+
+/*!
+	\brief Default implementation that fails, as the body cannot be received directly.
+*/
+BodyParseResult
+HttpBodyParser::ParseDirectBody(size_t bytesReceived, bool readEnd)
+{
+	throw BRuntimeError(__PRETTY_FUNCTION__, "The body cannot be received directly");
+}
+
+
 /*!
 	\brief Return the number of body bytes read from the stream so far.
 
@@ -368,6 +486,48 @@ HttpRawBodyParser::TotalBodySize() const noexcept
 }
 
 
+/*!
+	\brief Override default implementation; a raw body can be received as it is.
+
+	\returns \a maxSize, or the remaining size of the body if that is known and smaller.
+*/
+std::optional<size_t>
+HttpRawBodyParser::DirectBodySize(size_t maxSize) const noexcept
+{
+	if (fBodyBytesTotal) {
+		auto expectedRemainingBytes = *fBodyBytesTotal - fTransferredBodySize;
+		if (expectedRemainingBytes <= 0)
+			return std::nullopt;
+		if (expectedRemainingBytes < static_cast<off_t>(maxSize))
+			return expectedRemainingBytes;
+	}
+	return maxSize;
+}
+
+
+/*!
+	\brief Account for \a bytesReceived bytes that were received directly into the target.
+
+	\exception BNetworkRequestError In case the data ended before the body was complete.
+*/
+BodyParseResult
+HttpRawBodyParser::ParseDirectBody(size_t bytesReceived, bool readEnd)
+{
+	fTransferredBodySize += bytesReceived;
+
+	if (fBodyBytesTotal) {
+		if (*fBodyBytesTotal == fTransferredBodySize)
+			return {bytesReceived, bytesReceived, true};
+		else if (readEnd) {
+			throw BNetworkRequestError(__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError,
+				"Message body is incomplete; less data received than expected");
+		}
+		return {bytesReceived, bytesReceived, false};
+	} else
+		return {bytesReceived, bytesReceived, readEnd};
+}
+
+
 // #pragma mark -- HttpChunkedBodyParser
 /*!
 	\brief Parse a chunked body from a buffer.
@@ -394,21 +554,14 @@ HttpChunkedBodyParser::ParseBody(HttpBuffer& buffer, HttpTransferFunction writeT
 			case ChunkSize:
 			{
 				// Read the next chunk size from the buffer; if unsuccesful wait for more data
-				auto chunkSizeString = buffer.GetNextLine();
+				auto chunkSizeString = buffer.GetNextLineView();
 				if (!chunkSizeString)
 					return {totalBytesRead, totalBytesRead, false};
-				auto chunkSizeStr = std::string(chunkSizeString.value().String());
-				try {
-					size_t pos = 0;
-					fRemainingChunkSize = std::stoll(chunkSizeStr, &pos, 16);
-					if (pos < chunkSizeStr.size() && chunkSizeStr[pos] != ';') {
-						throw BNetworkRequestError(
-							__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError);
-					}
-				} catch (const std::invalid_argument&) {
-					throw BNetworkRequestError(
-						__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError);
-				} catch (const std::out_of_range&) {
+				auto chunkSizeEnd = chunkSizeString->data() + chunkSizeString->size();
+				auto [end, error]
+					= std::from_chars(chunkSizeString->data(), chunkSizeEnd, fRemainingChunkSize, 16);
+				if (error != std::errc() || end == chunkSizeString->data() || fRemainingChunkSize < 0
+					|| (end != chunkSizeEnd && *end != ';')) {
 					throw BNetworkRequestError(
 						__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError);
 				}
@@ -450,8 +603,8 @@ HttpChunkedBodyParser::ParseBody(HttpBuffer& buffer, HttpTransferFunction writeT
 					// not enough data in the buffer to finish the chunk
 					return {totalBytesRead, totalBytesRead, false};
 				}
-				auto chunkEndString = buffer.GetNextLine();
-				if (!chunkEndString || chunkEndString.value().Length() != 0) {
+				auto chunkEndString = buffer.GetNextLineView();
+				if (!chunkEndString || !chunkEndString->empty()) {
 					// There should have been an empty chunk
 					throw BNetworkRequestError(
 						__PRETTY_FUNCTION__, BNetworkRequestError::ProtocolError);
@@ -463,13 +616,13 @@ HttpChunkedBodyParser::ParseBody(HttpBuffer& buffer, HttpTransferFunction writeT
 
 			case Trailers:
 			{
-				auto trailerString = buffer.GetNextLine();
+				auto trailerString = buffer.GetNextLineView();
 				if (!trailerString) {
 					// More data to come
 					return {totalBytesRead, totalBytesRead, false};
 				}
 
-				if (trailerString.value().Length() > 0) {
+				if (!trailerString->empty()) {
 					// Ignore empty trailers for now
 					// TODO: review if the API should support trailing headers
 				} else {
@@ -54,16 +54,24 @@ public:
 									bool readEnd);
 			HttpInputStreamState State() const noexcept { return fStreamState; }
 
+	// Receive body data that does not need parsing straight into the target
+			std::optional<size_t> DirectBodySize(size_t maxSize) const noexcept;
+			size_t				ParseDirectBody(size_t bytesReceived, bool readEnd);
+
 	// Details on the body status
 			bool				HasContent() const noexcept;
 			std::optional<off_t> BodyBytesTotal() const noexcept;
 			off_t				BodyBytesTransferred() const noexcept;
 			bool				Complete() const noexcept;
 
+	// Details on the connection
+			bool				KeepAlive() const noexcept;
+
 private:
 			off_t				fHeaderBytes = 0;
 			BHttpStatus			fStatus;
 			HttpInputStreamState fStreamState = HttpInputStreamState::StatusLine;
+			bool				fKeepAlive = true;
 
 	// Body
 			HttpBodyType		fBodyType = HttpBodyType::VariableSize;
@@ -79,6 +87,9 @@ public:
 
 	virtual	std::optional<off_t> TotalBodySize() const noexcept;
 
+	virtual	std::optional<size_t> DirectBodySize(size_t maxSize) const noexcept;
+	virtual	BodyParseResult		ParseDirectBody(size_t bytesReceived, bool readEnd);
+
 			off_t				TransferredBodySize() const noexcept;
 
 protected:
@@ -95,6 +106,9 @@ public:
 									bool readEnd) override;
 	virtual	std::optional<off_t> TotalBodySize() const noexcept override;
 
+	virtual	std::optional<size_t> DirectBodySize(size_t maxSize) const noexcept override;
+	virtual	BodyParseResult		ParseDirectBody(size_t bytesReceived, bool readEnd) override;
+
 private:
 			std::optional<off_t> fBodyBytesTotal;
 };
@@ -461,9 +461,11 @@ BHttpRequest::RewindBody() noexcept
 /*!
 	\brief Private method used by HttpSerializer::SetTo() to serialize the header data into a
 		buffer.
+
+	The Connection field asks the server to keep the connection open if \a keepAlive is set.
 */
 void
-BHttpRequest::SerializeHeaderTo(HttpBuffer& buffer) const
+BHttpRequest::SerializeHeaderTo(HttpBuffer& buffer, bool keepAlive) const
 {
 	// Method & URL
 	//	TODO: proxy
@@ -493,9 +495,9 @@ BHttpRequest::SerializeHeaderTo(HttpBuffer& buffer) const
 			// of what it means (the RFC and Microsoft products), and we don't
 			// want to handle this. Very few websites support only deflate,
 			// and most of them will send gzip, or at worst, uncompressed data.
-			{"Connection"sv, "close"sv}
-			// Let the remote server close the connection after response since
-			// we don't handle multiple request on a single connection
+			{"Connection"sv, keepAlive ? "keep-alive"sv : "close"sv}
+			// Unless the session can reuse the connection for another request, let the remote
+			// server close it after the response
 		});
 	}
 
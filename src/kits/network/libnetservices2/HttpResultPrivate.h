@@ -10,10 +10,13 @@
 #define _HTTP_RESULT_PRIVATE_H_
 
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
 
+#include <string.h>
+
 #include <DataIO.h>
 #include <ExclusiveBorrow.h>
 #include <OS.h>
@@ -44,6 +47,12 @@ struct HttpResultPrivate {
 			BString				bodyString;
 			BBorrow<BDataIO>	bodyTarget;
 
+	// The bodyString stays locked while it is being filled, so that the body can be received into
+	// it directly
+			char*				bodyStringBuffer = nullptr;
+			size_t				bodyStringSize = 0;
+			size_t				bodyStringCapacity = 0;
+
 	// Utility functions
 								HttpResultPrivate(int32 identifier);
 			int32				GetStatusAtomic();
@@ -54,6 +63,9 @@ struct HttpResultPrivate {
 			void				SetFields(BHttpFields&& f);
 			void				SetBody();
 			size_t				WriteToBody(const void* buffer, size_t size);
+			void				ReserveBody(size_t size);
+			void*				BodyBuffer(size_t size);
+			void				BodyBufferWritten(size_t size) noexcept;
 };
 
 
@@ -125,8 +137,14 @@ HttpResultPrivate::SetBody()
 	if (bodyTarget.HasValue()) {
 		body = BHttpBody{};
 		bodyTarget.Return();
-	} else
+	} else {
+		if (bodyStringBuffer != nullptr) {
+			bodyStringBuffer[bodyStringSize] = '\0';
+			bodyString.UnlockBuffer(bodyStringSize);
+			bodyStringBuffer = nullptr;
+		}
 		body = BHttpBody{std::move(bodyString)};
+	}
 
 	atomic_set(&requestStatus, kBodyReady);
 	release_sem(data_wait);
@@ -144,12 +162,55 @@ HttpResultPrivate::WriteToBody(const void* buffer, size_t size)
 			throw BSystemError("BDataIO::Write()", result);
 		return result;
 	} else {
-		bodyString.Append(reinterpret_cast<const char*>(buffer), size);
+		memcpy(BodyBuffer(size), buffer, size);
+		BodyBufferWritten(size);
 		return size;
 	}
 }
 
 
+inline void
+HttpResultPrivate::ReserveBody(size_t size)
+{
+	if (size > bodyStringSize)
+		BodyBuffer(size - bodyStringSize);
+}
+
+
+/*!
+	\brief Get the memory the next \a size bytes of the body can be stored in directly.
+
+	Call BodyBufferWritten() with the number of bytes that were actually stored.
+
+	\returns \c nullptr when there is a body target; WriteToBody() has to be used then.
+*/
+inline void*
+HttpResultPrivate::BodyBuffer(size_t size)
+{
+	if (bodyTarget.HasValue())
+		return nullptr;
+
+	if (bodyStringSize + size > bodyStringCapacity) {
+		auto capacity = std::max(bodyStringSize + size, bodyStringCapacity * 2);
+		if (capacity > INT32_MAX)
+			throw BRuntimeError(__PRETTY_FUNCTION__, "The body is too large to be stored");
+
+		bodyStringBuffer = bodyString.LockBuffer(capacity);
+		if (bodyStringBuffer == nullptr)
+			throw BSystemError("BString::LockBuffer()", B_NO_MEMORY);
+		bodyStringCapacity = capacity;
+	}
+	return bodyStringBuffer + bodyStringSize;
+}
+
+
+inline void
+HttpResultPrivate::BodyBufferWritten(size_t size) noexcept
+{
+	bodyStringSize += size;
+}
+
+
 } // namespace Network
 
 } // namespace BPrivate
@@ -20,12 +20,14 @@ using namespace BPrivate::Network;
 
 /*!
 	\brief Set the \a request to serialize, and load the initial data into the \a buffer.
+
+	When \a keepAlive is set, the server is asked to keep the connection open after the response.
 */
 void
-HttpSerializer::SetTo(HttpBuffer& buffer, const BHttpRequest& request)
+HttpSerializer::SetTo(HttpBuffer& buffer, const BHttpRequest& request, bool keepAlive)
 {
 	buffer.Clear();
-	request.SerializeHeaderTo(buffer);
+	request.SerializeHeaderTo(buffer, keepAlive);
 	fState = HttpSerializerState::Header;
 
 	if (auto requestBody = request.RequestBody()) {
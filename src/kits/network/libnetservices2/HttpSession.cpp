@@ -12,8 +12,11 @@
 #include <list>
 #include <map>
 #include <optional>
+#include <utility>
 #include <vector>
 
+#include <poll.h>
+
 #include <AutoLocker.h>
 #include <DataIO.h>
 #include <ErrorsExt.h>
@@ -50,6 +53,28 @@ using namespace BPrivate::Network;
 static constexpr ssize_t kMaxHeaderLineSize = 64 * 1024;
 
 
+/*!
+	\brief Maximum number of body bytes that are received in one go, when they are read straight
+		into the result.
+*/
+static constexpr size_t kMaxDirectBodyReadSize = 64 * 1024;
+
+
+/*!
+	\brief Maximum number of bytes that are set aside for a body upfront, based on its announced
+		size.
+*/
+static constexpr off_t kMaxBodyReservation = 16 * 1024 * 1024;
+
+
+/*!
+	\brief Tag to create a request that is sent again, after the reused connection it was sent on
+		turned out to be closed by the server.
+*/
+struct ConnectionRetry {
+};
+
+
 struct CounterDeleter {
 	void operator()(int32* counter) const noexcept { atomic_add(counter, -1); }
 };
@@ -62,6 +87,8 @@ public:
 
 	Request(Request& original, const Redirect& redirect);
 
+	Request(Request& original, const ConnectionRetry& retry);
+
 	// States
 	enum RequestState { InitialState, Connected, RequestSent, ContentReceived };
 	RequestState State() const noexcept { return fRequestStatus; }
@@ -73,6 +100,16 @@ public:
 	// Helpers for maintaining the connection count
 	std::pair<BString, int> GetHost() const;
 	void SetCounter(int32* counter) noexcept;
+	bool MarkQueued() noexcept { return !std::exchange(fQueued, true); }
+
+	// Helpers for reusing connections
+	BString ConnectionKey() const;
+	void SetKeepAlive(bool keepAlive) noexcept { fKeepAlive = keepAlive; }
+	bool CanUseIdleConnection() const noexcept { return fAllowReuse; }
+	void UseConnection(std::unique_ptr<BSocket> socket);
+	bool CanKeepAlive() const noexcept;
+	std::unique_ptr<BSocket> ReleaseConnection() noexcept { return std::move(fSocket); }
+	bool CanRetry();
 
 	// Operational methods
 	void ResolveHostName();
@@ -118,6 +155,12 @@ private:
 
 	// Connection counter
 	std::unique_ptr<int32, CounterDeleter> fConnectionCounter;
+	bool fQueued = false;
+
+	// Connection reuse
+	bool fKeepAlive = false;
+	bool fAllowReuse = true;
+	bool fReusedConnection = false;
 };
 
 
@@ -131,6 +174,9 @@ public:
 	void Cancel(int32 identifier);
 	void SetMaxConnectionsPerHost(size_t maxConnections);
 	void SetMaxHosts(size_t maxConnections);
+	void SetMaxIdleConnectionsPerHost(size_t maxConnections);
+	void SetIdleConnectionTimeout(bigtime_t timeout);
+	BHttpSession::Statistics GetStatistics() const;
 
 private:
 		// Thread functions
@@ -139,6 +185,10 @@ private:
 
 	// Helper functions
 	std::vector<BHttpSession::Request> GetRequestsForControlThread();
+	bool TakeIdleConnection(BHttpSession::Request& request);
+	bool ReturnIdleConnection(BHttpSession::Request& request);
+	bigtime_t ExpireIdleConnections();
+	bool RetryRequest(BHttpSession::Request& request);
 
 private:
 		// constants (can be accessed unlocked)
@@ -160,9 +210,26 @@ private:
 	using Host = std::pair<BString, int>;
 	std::map<Host, int32> fConnectionCount;
 
+	// idle connections that can be reused, by ConnectionKey(); the oldest ones are in front
+	struct IdleConnection {
+		std::unique_ptr<BSocket> socket;
+		bigtime_t since;
+	};
+	std::map<BString, std::vector<IdleConnection>> fIdleConnections;
+
 	// data that can only be accessed atomically
 	std::atomic<size_t> fMaxConnectionsPerHost = 2;
 	std::atomic<size_t> fMaxHosts = 10;
+	std::atomic<size_t> fMaxIdleConnectionsPerHost = 2;
+	std::atomic<bigtime_t> fIdleConnectionTimeout = 10000000;
+
+	// statistics
+	std::atomic<size_t> fRequestCount = 0;
+	std::atomic<size_t> fConnectionsOpened = 0;
+	std::atomic<size_t> fConnectionsReused = 0;
+	std::atomic<size_t> fRequestsQueued = 0;
+	std::atomic<size_t> fRequestsRetried = 0;
+	std::atomic<size_t> fIdleConnectionCount = 0;
 
 	// data owned by the dataThread
 	std::map<int, BHttpSession::Request> connectionMap;
@@ -224,6 +291,7 @@ BHttpSession::Impl::Execute(BHttpRequest&& request, BBorrow<BDataIO> target, BMe
 	auto retval = BHttpResult(wRequest.Result());
 	auto lock = AutoLocker<BLocker>(fLock);
 	fControlQueue.push_back(std::move(wRequest));
+	fRequestCount++;
 	release_sem(fControlQueueSem);
 	return retval;
 }
@@ -272,14 +340,51 @@ BHttpSession::Impl::SetMaxHosts(size_t maxConnections)
 }
 
 
+void
+BHttpSession::Impl::SetMaxIdleConnectionsPerHost(size_t maxConnections)
+{
+	fMaxIdleConnectionsPerHost.store(maxConnections, std::memory_order_relaxed);
+
+	// wake up the control thread, so that it closes the connections that are no longer wanted
+	release_sem(fControlQueueSem);
+}
+
+
+void
+BHttpSession::Impl::SetIdleConnectionTimeout(bigtime_t timeout)
+{
+	if (timeout < 0)
+		throw BRuntimeError(__PRETTY_FUNCTION__, "IdleConnectionTimeout cannot be negative");
+	fIdleConnectionTimeout.store(timeout, std::memory_order_relaxed);
+	release_sem(fControlQueueSem);
+}
+
+
+BHttpSession::Statistics
+BHttpSession::Impl::GetStatistics() const
+{
+	BHttpSession::Statistics statistics;
+	statistics.requests = fRequestCount.load();
+	statistics.connectionsOpened = fConnectionsOpened.load();
+	statistics.connectionsReused = fConnectionsReused.load();
+	statistics.requestsQueued = fRequestsQueued.load();
+	statistics.requestsRetried = fRequestsRetried.load();
+	statistics.idleConnections = fIdleConnectionCount.load();
+	return statistics;
+}
+
+
 /*static*/ status_t
 BHttpSession::Impl::ControlThreadFunc(void* arg)
 {
 	BHttpSession::Impl* impl = static_cast<BHttpSession::Impl*>(arg);
 
-	// Outer loop to use the fControlQueueSem when new items have entered the queue
+	// Outer loop to use the fControlQueueSem when new items have entered the queue, or to close
+	// idle connections once they timed out
 	while (true) {
-		if (auto status = acquire_sem(impl->fControlQueueSem); status == B_INTERRUPTED)
+		auto timeout = impl->ExpireIdleConnections();
+		if (auto status = acquire_sem_etc(impl->fControlQueueSem, 1, B_RELATIVE_TIMEOUT, timeout);
+			status == B_INTERRUPTED || status == B_TIMED_OUT)
 			continue;
 		else if (status != B_OK) {
 			// Most likely B_BAD_SEM_ID indicating that the sem was deleted; go to cleanup
@@ -298,8 +403,11 @@ BHttpSession::Impl::ControlThreadFunc(void* arg)
 		for (auto& request: requests) {
 			bool hasError = false;
 			try {
-				request.ResolveHostName();
-				request.OpenConnection();
+				if (!impl->TakeIdleConnection(request)) {
+					request.ResolveHostName();
+					request.OpenConnection();
+					impl->fConnectionsOpened++;
+				}
 			} catch (...) {
 				request.SetError(std::current_exception());
 				hasError = true;
@@ -423,7 +531,8 @@ BHttpSession::Impl::DataThreadFunc(void* arg)
 				try {
 					request.TransferRequest();
 				} catch (...) {
-					request.SetError(std::current_exception());
+					if (!data->RetryRequest(request))
+						request.SetError(std::current_exception());
 					error = true;
 				}
 
@@ -452,13 +561,17 @@ BHttpSession::Impl::DataThreadFunc(void* arg)
 
 					finished = true;
 				} catch (...) {
-					request.SetError(std::current_exception());
+					if (!data->RetryRequest(request))
+						request.SetError(std::current_exception());
 					finished = true;
 				}
 
 				if (finished) {
-					// Clean up finished requests; including redirected requests
-					request.Disconnect();
+					// Clean up finished requests; including redirected requests. The connection
+					// is kept for another request if possible, before the request is erased, so
+					// that the control thread finds it before the connection count goes down.
+					if (!request.CanKeepAlive() || !data->ReturnIdleConnection(request))
+						request.Disconnect();
 					data->connectionMap.erase(item.object);
 					release_sem(data->fControlQueueSem);
 						// wake up control thread; there may queued requests unblocked.
@@ -466,11 +579,13 @@ BHttpSession::Impl::DataThreadFunc(void* arg)
 				}
 			} else if ((item.events & B_EVENT_DISCONNECTED) == B_EVENT_DISCONNECTED) {
 				auto& request = data->connectionMap.find(item.object)->second;
-				try {
-					throw BNetworkRequestError(
-						__PRETTY_FUNCTION__, BNetworkRequestError::NetworkError);
-				} catch (...) {
-					request.SetError(std::current_exception());
+				if (!data->RetryRequest(request)) {
+					try {
+						throw BNetworkRequestError(
+							__PRETTY_FUNCTION__, BNetworkRequestError::NetworkError);
+					} catch (...) {
+						request.SetError(std::current_exception());
+					}
 				}
 				data->connectionMap.erase(item.object);
 				resizeObjectList = true;
@@ -566,6 +681,8 @@ BHttpSession::Impl::GetRequestsForControlThread()
 		if (it != fConnectionCount.end()) {
 			if (static_cast<size_t>(atomic_get(std::addressof(it->second)))
 				>= fMaxConnectionsPerHost.load(std::memory_order_relaxed)) {
+				if (request.MarkQueued())
+					fRequestsQueued++;
 				request.SendMessage(UrlEvent::DebugMessage, [](BMessage& msg) {
 					msg.AddUInt32(UrlEventData::DebugType, UrlEventData::DebugWarning);
 					msg.AddString(UrlEventData::DebugMessage,
@@ -578,6 +695,8 @@ BHttpSession::Impl::GetRequestsForControlThread()
 			}
 		} else {
 			if (fConnectionCount.size() == fMaxHosts.load()) {
+				if (request.MarkQueued())
+					fRequestsQueued++;
 				request.SendMessage(UrlEvent::DebugMessage, [](BMessage& msg) {
 					msg.AddUInt32(UrlEventData::DebugType, UrlEventData::DebugWarning);
 					msg.AddString(UrlEventData::DebugMessage,
@@ -591,6 +710,7 @@ BHttpSession::Impl::GetRequestsForControlThread()
 			}
 			request.SetCounter(std::addressof(newIt->second));
 		}
+		request.SetKeepAlive(fMaxIdleConnectionsPerHost.load(std::memory_order_relaxed) > 0);
 		requests.emplace_back(std::move(request));
 		return true;
 	});
@@ -598,6 +718,137 @@ BHttpSession::Impl::GetRequestsForControlThread()
 }
 
 
+/*!
+	\brief Internal helper that hands an idle connection to the same server to \a request.
+
+	Connections that the server closed in the meantime are discarded; they become readable.
+	This method will do the locking of the internal structure.
+
+	\returns \c true if the request got a connection, or \c false if a new one must be opened.
+*/
+bool
+BHttpSession::Impl::TakeIdleConnection(BHttpSession::Request& request)
+{
+	if (!request.CanUseIdleConnection())
+		return false;
+
+	auto lock = AutoLocker<BLocker>(fLock);
+	auto it = fIdleConnections.find(request.ConnectionKey());
+	if (it == fIdleConnections.end())
+		return false;
+
+	auto& connections = it->second;
+	std::unique_ptr<BSocket> socket;
+	while (!connections.empty() && !socket) {
+		socket = std::move(connections.back().socket);
+		connections.pop_back();
+		fIdleConnectionCount--;
+
+		struct pollfd pollInfo = {socket->Socket(), POLLIN, 0};
+		if (poll(&pollInfo, 1, 0) != 0)
+			socket.reset();
+	}
+
+	if (connections.empty())
+		fIdleConnections.erase(it);
+	lock.Unlock();
+
+	if (!socket)
+		return false;
+
+	request.UseConnection(std::move(socket));
+	fConnectionsReused++;
+	return true;
+}
+
+
+/*!
+	\brief Internal helper that keeps the connection of the finished \a request for reuse.
+
+	This method will do the locking of the internal structure.
+
+	\returns \c false if there are enough idle connections to the server already.
+*/
+bool
+BHttpSession::Impl::ReturnIdleConnection(BHttpSession::Request& request)
+{
+	auto lock = AutoLocker<BLocker>(fLock);
+	auto& connections = fIdleConnections[request.ConnectionKey()];
+	if (connections.size() >= fMaxIdleConnectionsPerHost.load(std::memory_order_relaxed)) {
+		if (connections.empty())
+			fIdleConnections.erase(request.ConnectionKey());
+		return false;
+	}
+
+	connections.push_back(IdleConnection{request.ReleaseConnection(), system_time()});
+	fIdleConnectionCount++;
+	return true;
+}
+
+
+/*!
+	\brief Internal helper that closes the idle connections that timed out, or are over the
+		limit.
+
+	This method will do the locking of the internal structure.
+
+	\returns The time until the next idle connection times out.
+*/
+bigtime_t
+BHttpSession::Impl::ExpireIdleConnections()
+{
+	auto timeout = fIdleConnectionTimeout.load(std::memory_order_relaxed);
+	auto maxConnections = fMaxIdleConnectionsPerHost.load(std::memory_order_relaxed);
+	auto now = system_time();
+	bigtime_t nextTimeout = B_INFINITE_TIMEOUT;
+
+	auto lock = AutoLocker<BLocker>(fLock);
+	for (auto it = fIdleConnections.begin(); it != fIdleConnections.end();) {
+		auto& connections = it->second;
+		auto expired = std::find_if(connections.begin(), connections.end(),
+			[now, timeout](const IdleConnection& connection) {
+				return now - connection.since < timeout;
+			});
+		if (static_cast<size_t>(connections.end() - expired) > maxConnections)
+			expired = connections.end() - maxConnections;
+
+		fIdleConnectionCount -= expired - connections.begin();
+		connections.erase(connections.begin(), expired);
+
+		if (connections.empty()) {
+			it = fIdleConnections.erase(it);
+		} else {
+			nextTimeout = std::min(nextTimeout, connections.front().since + timeout - now);
+			it++;
+		}
+	}
+
+	return nextTimeout;
+}
+
+
+/*!
+	\brief Internal helper that sends \a request again on a new connection, when the idle
+		connection it was sent on had been closed by the server.
+
+	\returns \c true if the request will be retried, \c false if it failed.
+*/
+bool
+BHttpSession::Impl::RetryRequest(BHttpSession::Request& request)
+{
+	if (!request.CanRetry())
+		return false;
+
+	request.Disconnect();
+
+	auto lock = AutoLocker<BLocker>(fLock);
+	fControlQueue.emplace_back(request, ConnectionRetry{});
+	fRequestsRetried++;
+	release_sem(fControlQueueSem);
+	return true;
+}
+
+
 // #pragma mark -- BHttpSession (public interface)
 
 
@@ -651,6 +902,39 @@ BHttpSession::SetMaxHosts(size_t maxConnections)
 }
 
 
+/*!
+	\brief Set how many idle connections to the same server are kept open for reuse.
+
+	Setting it to 0 turns off reusing connections; the server is then asked to close the
+	connection after each response. The default is 2.
+*/
+void
+BHttpSession::SetMaxIdleConnectionsPerHost(size_t maxConnections)
+{
+	fImpl->SetMaxIdleConnectionsPerHost(maxConnections);
+}
+
+
+/*!
+	\brief Set how long an idle connection is kept open for reuse. The default is 10 seconds.
+*/
+void
+BHttpSession::SetIdleConnectionTimeout(bigtime_t timeout)
+{
+	fImpl->SetIdleConnectionTimeout(timeout);
+}
+
+
+/*!
+	\brief Get the counters of the requests and connections of this session.
+*/
+BHttpSession::Statistics
+BHttpSession::GetStatistics() const
+{
+	return fImpl->GetStatistics();
+}
+
+
 // #pragma mark -- BHttpSession::Request (helpers)
 BHttpSession::Request::Request(BHttpRequest&& request, BBorrow<BDataIO> target, BMessenger observer)
 	:
@@ -698,6 +982,20 @@ BHttpSession::Request::Request(Request& original, const BHttpSession::Redirect&
 }
 
 
+BHttpSession::Request::Request(Request& original, const ConnectionRetry&)
+	:
+	fRequest(std::move(original.fRequest)),
+	fObserver(original.fObserver),
+	fResult(original.fResult),
+	fRemainingRedirects(original.fRemainingRedirects),
+	fAllowReuse(false)
+{
+	// inform the parser when we do a HEAD request, so not to expect content
+	if (fRequest.Method() == BHttpMethod::Head)
+		fParser.SetNoContent();
+}
+
+
 /*!
 	\brief Helper that sets the error in the result to \a e and notifies the listeners.
 */
@@ -736,19 +1034,87 @@ BHttpSession::Request::SetCounter(int32* counter) noexcept
 }
 
 
+static int
+url_port(const BUrl& url)
+{
+	if (url.HasPort())
+		return url.Port();
+	else if (url.Protocol() == "https")
+		return 443;
+	else
+		return 80;
+}
+
+
+/*!
+	\brief Get the key that identifies connections that can be used for this request.
+*/
+BString
+BHttpSession::Request::ConnectionKey() const
+{
+	BString key;
+	key << fRequest.Url().Protocol() << "://" << fRequest.Url().Host() << ':'
+		<< url_port(fRequest.Url());
+	return key;
+}
+
+
+/*!
+	\brief Use the idle \a socket of a previous request to the same server.
+*/
+void
+BHttpSession::Request::UseConnection(std::unique_ptr<BSocket> socket)
+{
+	fSocket = std::move(socket);
+	fSocket->SetTimeout(fRequest.Timeout());
+	fReusedConnection = true;
+	fRequestStatus = Connected;
+}
+
+
+/*!
+	\brief Check if the connection can be used for another request.
+*/
+bool
+BHttpSession::Request::CanKeepAlive() const noexcept
+{
+	return fKeepAlive && fSocket && fRequestStatus == ContentReceived && fParser.KeepAlive()
+		&& fBuffer.RemainingBytes() == 0;
+}
+
+
+/*!
+	\brief Check if the request can be sent again on a new connection.
+
+	This is the case when it was sent on a reused connection, which was closed before any part of
+	the response was received. As the request might have reached the server anyway, only
+	idempotent requests are repeated.
+*/
+bool
+BHttpSession::Request::CanRetry()
+{
+	if (!fReusedConnection || fParser.State() != HttpInputStreamState::StatusLine)
+		return false;
+	if (fRequestStatus == RequestSent && fBuffer.RemainingBytes() != 0)
+		return false;
+
+	const auto& method = fRequest.Method();
+	if (method != BHttpMethod::Get && method != BHttpMethod::Head && method != BHttpMethod::Put
+		&& method != BHttpMethod::Delete && method != BHttpMethod::Options
+		&& method != BHttpMethod::Trace)
+		return false;
+
+	return fRequest.RewindBody();
+}
+
+
 /*!
 	\brief Resolve the hostname for a request
 */
 void
 BHttpSession::Request::ResolveHostName()
 {
-	int port;
-	if (fRequest.Url().HasPort())
-		port = fRequest.Url().Port();
-	else if (fRequest.Url().Protocol() == "https")
-		port = 443;
-	else
-		port = 80;
+	int port = url_port(fRequest.Url());
 
 	// TODO: proxy
 	if (auto status = fRemoteAddress.SetTo(fRequest.Url().Host(), port); status != B_OK) {
@@ -812,7 +1178,7 @@ BHttpSession::Request::TransferRequest()
 			__PRETTY_FUNCTION__, "Write request for object that is not in the Connected state");
 
 	if (!fSerializer.IsInitialized())
-		fSerializer.SetTo(fBuffer, fRequest);
+		fSerializer.SetTo(fBuffer, fRequest, fKeepAlive);
 
 	auto currentBytesWritten = fSerializer.Serialize(fBuffer, fSocket.get());
 
@@ -837,8 +1203,29 @@ BHttpSession::Request::TransferRequest()
 bool
 BHttpSession::Request::ReceiveResult()
 {
-	// First: stream data from the socket
-	auto bytesRead = fBuffer.ReadFrom(fSocket.get());
+	// First: stream data from the socket. Once the rest of the body can be stored as it is, it is
+	// read straight into the result instead of being copied there from the buffer.
+	void* bodyBuffer = nullptr;
+	size_t directBodySize = 0;
+	if (fBuffer.RemainingBytes() == 0) {
+		if (auto size = fParser.DirectBodySize(kMaxDirectBodyReadSize); size) {
+			directBodySize = *size;
+			bodyBuffer = fResult->BodyBuffer(directBodySize);
+		}
+	}
+
+	ssize_t bytesRead;
+	if (bodyBuffer != nullptr) {
+		bytesRead = B_INTERRUPTED;
+		while (bytesRead == B_INTERRUPTED)
+			bytesRead = fSocket->Read(bodyBuffer, directBodySize);
+
+		if (bytesRead < 0 && bytesRead != B_WOULD_BLOCK) {
+			throw BNetworkRequestError(
+				"BSocket::Read()", BNetworkRequestError::NetworkError, bytesRead);
+		}
+	} else
+		bytesRead = fBuffer.ReadFrom(fSocket.get());
 
 	if (bytesRead == B_WOULD_BLOCK || bytesRead == B_INTERRUPTED)
 		return false;
@@ -985,20 +1372,31 @@ BHttpSession::Request::ReceiveResult()
 				fRequestStatus = ContentReceived;
 				return true;
 			}
+
+			// Set aside the memory for a body of known size
+			if (auto bodySize = fParser.BodyBytesTotal(); bodySize)
+				fResult->ReserveBody(std::min(*bodySize, kMaxBodyReservation));
 			[[fallthrough]];
 		}
 		case HttpInputStreamState::Body:
 		{
-			size_t bytesWrittenToBody;
+			size_t bytesWrittenToBody = 0;
 				// The bytesWrittenToBody may differ from the bytes parsed from the buffer when
 				// there is compression on the incoming stream.
-			bytesRead = fParser.ParseBody(
-				fBuffer,
-				[this, &bytesWrittenToBody](const std::byte* buffer, size_t size) {
-					bytesWrittenToBody = fResult->WriteToBody(buffer, size);
-					return bytesWrittenToBody;
-				},
-				readEnd);
+			if (bodyBuffer != nullptr) {
+				// The data was received into the body directly
+				fResult->BodyBufferWritten(bytesRead);
+				bytesRead = fParser.ParseDirectBody(bytesRead, readEnd);
+				bytesWrittenToBody = bytesRead;
+			} else {
+				bytesRead = fParser.ParseBody(
+					fBuffer,
+					[this, &bytesWrittenToBody](const std::byte* buffer, size_t size) {
+						bytesWrittenToBody = fResult->WriteToBody(buffer, size);
+						return bytesWrittenToBody;
+					},
+					readEnd);
+			}
 
 			SendMessage(UrlEvent::DownloadProgress, [this, bytesRead](BMessage& msg) {
 				msg.AddInt64(UrlEventData::NumBytes, bytesRead);
@@ -1041,7 +1439,8 @@ BHttpSession::Request::ReceiveResult()
 void
 BHttpSession::Request::Disconnect() noexcept
 {
-	fSocket->Disconnect();
+	if (fSocket)
+		fSocket->Disconnect();
 }
 
 
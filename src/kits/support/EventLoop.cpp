@@ -0,0 +1,301 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include <EventLoop.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <Errors.h>
+
+
+static const int32 kEventBatchSize = 128;
+
+
+namespace BSupportKit {
+
+
+BEventListener::~BEventListener()
+{
+}
+
+
+//	#pragma mark -
+
+
+/*!	An event loop waits for events on file descriptors, ports, semaphores,
+	and threads, and passes them on to the BEventListener that was registered
+	with each object.
+
+	The objects stay registered with a kernel event queue, so that waiting
+	costs the same no matter how many objects are watched. Events are
+	edge-triggered unless B_EVENT_LEVEL_TRIGGERED is part of the events
+	passed to Watch(): a listener is only called again once the object's
+	state changed, so it should for example read a socket until it would
+	block.
+
+	Changes to the watched objects are collected, and passed to the kernel
+	all at once before the next wait. Except for Quit(), the loop may only
+	be used from the thread that runs it.
+*/
+BEventLoop::BEventLoop()
+	:
+	fQueue(-1),
+	fQuitSemaphore(-1),
+	fQuitting(false),
+	fChanges(NULL),
+	fChangeCount(0),
+	fChangeCapacity(0),
+	fEventCount(0),
+	fEventIndex(0)
+{
+	fEvents = (event_wait_info*)malloc(
+		kEventBatchSize * sizeof(event_wait_info));
+	if (fEvents == NULL)
+		return;
+
+	fQueue = create_event_queue(O_CLOEXEC);
+	if (fQueue < 0)
+		return;
+
+	fQuitSemaphore = create_sem(0, "event loop quit");
+	if (fQuitSemaphore < 0)
+		return;
+
+	// a NULL listener marks the objects used by the loop itself
+	if (_AddChange(fQuitSemaphore, B_OBJECT_TYPE_SEMAPHORE,
+			B_EVENT_ACQUIRE_SEMAPHORE, NULL) != B_OK) {
+		close(fQueue);
+		fQueue = B_NO_MEMORY;
+	}
+}
+
+
+BEventLoop::~BEventLoop()
+{
+	if (fQueue >= 0)
+		close(fQueue);
+	if (fQuitSemaphore >= 0)
+		delete_sem(fQuitSemaphore);
+
+	free(fChanges);
+	free(fEvents);
+}
+
+
+status_t
+BEventLoop::InitCheck() const
+{
+	if (fEvents == NULL)
+		return B_NO_MEMORY;
+	if (fQueue < 0)
+		return fQueue;
+	if (fQuitSemaphore < 0)
+		return fQuitSemaphore;
+
+	return B_OK;
+}
+
+
+/*!	Starts watching \a object for \a events, or changes the events or the
+	listener if it is already watched. The change takes effect with the next
+	ApplyChanges() or Dispatch().
+	If the object cannot be watched, \a listener is called with
+	B_EVENT_INVALID then.
+*/
+status_t
+BEventLoop::Watch(int32 object, uint16 type, int32 events,
+	BEventListener* listener)
+{
+	if (events <= 0 || listener == NULL)
+		return B_BAD_VALUE;
+
+	return _AddChange(object, type, events, listener);
+}
+
+
+status_t
+BEventLoop::WatchFile(int fd, int32 events, BEventListener* listener)
+{
+	return Watch(fd, B_OBJECT_TYPE_FD, events, listener);
+}
+
+
+/*!	Stops watching \a object. Its listener won't be called anymore, not even
+	for events that have already been retrieved, so it may be deleted right
+	away.
+	Objects that are closed or deleted are removed from the loop
+	automatically, after their listener received B_EVENT_INVALID.
+*/
+status_t
+BEventLoop::Unwatch(int32 object, uint16 type)
+{
+	for (int32 i = fEventIndex; i < fEventCount; i++) {
+		if (fEvents[i].object == object && fEvents[i].type == type)
+			fEvents[i].user_data = NULL;
+	}
+	for (int32 i = 0; i < fChangeCount; i++) {
+		if (fChanges[i].object == object && fChanges[i].type == type)
+			fChanges[i].user_data = NULL;
+	}
+
+	return _AddChange(object, type, 0, NULL);
+}
+
+
+status_t
+BEventLoop::UnwatchFile(int fd)
+{
+	return Unwatch(fd, B_OBJECT_TYPE_FD);
+}
+
+
+/*!	Passes the pending changes to the kernel. Returns B_ERROR if any of
+	them failed; their listeners have been called with B_EVENT_INVALID
+	then. On any other error, none of the changes has been applied, and
+	they are kept for the next try.
+*/
+status_t
+BEventLoop::ApplyChanges()
+{
+	if (fChangeCount == 0)
+		return B_OK;
+
+	status_t status = event_queue_select(fQueue, fChanges, fChangeCount);
+	if (status == B_OK) {
+		fChangeCount = 0;
+		return B_OK;
+	}
+	if (status != B_ERROR)
+		return status;
+
+	// The listeners may add new changes while being called, so they get
+	// their own list.
+	event_wait_info* changes = fChanges;
+	int32 count = fChangeCount;
+	int32 capacity = fChangeCapacity;
+	fChanges = NULL;
+	fChangeCount = 0;
+	fChangeCapacity = 0;
+
+	// the events of the failed changes have been replaced by an error code,
+	// removing an object that is already gone is not reported
+	for (int32 i = 0; i < count; i++) {
+		BEventListener* listener = (BEventListener*)changes[i].user_data;
+		if (changes[i].events < 0 && listener != NULL) {
+			listener->EventsReceived(this, changes[i].object, changes[i].type,
+				B_EVENT_INVALID);
+		}
+	}
+
+	if (fChanges == NULL) {
+		fChanges = changes;
+		fChangeCapacity = capacity;
+	} else
+		free(changes);
+
+	return status;
+}
+
+
+/*!	Applies the pending changes, waits up to \a timeout for events, and
+	calls the listeners. Returns the number of events dispatched, or an
+	error code.
+*/
+ssize_t
+BEventLoop::Dispatch(bigtime_t timeout)
+{
+	if (fQueue < 0)
+		return B_NO_INIT;
+
+	ApplyChanges();
+
+	ssize_t count = event_queue_wait(fQueue, fEvents, kEventBatchSize,
+		timeout == B_INFINITE_TIMEOUT ? 0 : B_RELATIVE_TIMEOUT, timeout);
+	if (count == B_TIMED_OUT || count == B_WOULD_BLOCK
+		|| count == B_INTERRUPTED)
+		return 0;
+	if (count < 0)
+		return count;
+
+	fEventCount = count;
+	for (fEventIndex = 0; fEventIndex < fEventCount; fEventIndex++) {
+		const event_wait_info& info = fEvents[fEventIndex];
+		BEventListener* listener = (BEventListener*)info.user_data;
+
+		if (listener != NULL) {
+			listener->EventsReceived(this, info.object, info.type,
+				info.events);
+		} else if (info.object == fQuitSemaphore
+			&& info.type == B_OBJECT_TYPE_SEMAPHORE) {
+			while (acquire_sem_etc(fQuitSemaphore, 1, B_RELATIVE_TIMEOUT, 0)
+					== B_OK) {
+			}
+			fQuitting = true;
+		}
+	}
+
+	fEventCount = 0;
+	fEventIndex = 0;
+	return count;
+}
+
+
+/*!	Dispatches events until Quit() is called, or an error occurs.
+*/
+status_t
+BEventLoop::Run()
+{
+	status_t status = B_OK;
+	fQuitting = false;
+	while (!fQuitting) {
+		ssize_t result = Dispatch();
+		if (result < 0) {
+			status = result;
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+/*!	Makes Run() return after the current round of events. May be called
+	from any thread.
+*/
+void
+BEventLoop::Quit()
+{
+	release_sem_etc(fQuitSemaphore, 1, B_DO_NOT_RESCHEDULE);
+}
+
+
+status_t
+BEventLoop::_AddChange(int32 object, uint16 type, int32 events,
+	BEventListener* listener)
+{
+	if (fChangeCount == fChangeCapacity) {
+		int32 capacity = max_c(16, fChangeCapacity * 2);
+		event_wait_info* changes = (event_wait_info*)realloc(fChanges,
+			capacity * sizeof(event_wait_info));
+		if (changes == NULL)
+			return B_NO_MEMORY;
+
+		fChanges = changes;
+		fChangeCapacity = capacity;
+	}
+
+	event_wait_info& change = fChanges[fChangeCount++];
+	change.object = object;
+	change.type = type;
+	change.events = events;
+	change.user_data = listener;
+	return B_OK;
+}
+
+
+}	// namespace BSupportKit
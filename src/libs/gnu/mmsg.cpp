@@ -0,0 +1,41 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include <sys/socket.h>
+
+#include <errno.h>
+#include <pthread.h>
+
+#include <syscall_utils.h>
+#include <syscalls.h>
+
+
+int
+recvmmsg(int socket, struct mmsghdr* messages, unsigned int count, int flags,
+	struct timespec* timeout)
+{
+	bigtime_t timeoutMicros = B_INFINITE_TIMEOUT;
+	if (timeout != NULL) {
+		if (timeout->tv_sec < 0 || timeout->tv_nsec < 0
+			|| timeout->tv_nsec >= 1000000000) {
+			errno = EINVAL;
+			return -1;
+		}
+		timeoutMicros = (bigtime_t)timeout->tv_sec * 1000000
+			+ (timeout->tv_nsec + 999) / 1000;
+	}
+
+	RETURN_AND_SET_ERRNO_TEST_CANCEL(
+		_kern_recvmmsg(socket, messages, count, flags, timeoutMicros));
+}
+
+
+int
+sendmmsg(int socket, struct mmsghdr* messages, unsigned int count, int flags)
+{
+	RETURN_AND_SET_ERRNO_TEST_CANCEL(
+		_kern_sendmmsg(socket, messages, count, flags));
+}
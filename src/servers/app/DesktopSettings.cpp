@@ -741,6 +741,7 @@ void
 DesktopSettingsPrivate::SetSubpixelAntialiasing(bool subpix)
 {
 	gSubpixelAntialiasing = subpix;
+	_FontMetricsChanged();
 	Save(kAppearanceSettings);
 }
 
@@ -756,6 +757,7 @@ void
 DesktopSettingsPrivate::SetHinting(uint8 hinting)
 {
 	gDefaultHintingMode = hinting;
+	_FontMetricsChanged();
 	Save(kFontSettings);
 }
 
@@ -771,6 +773,7 @@ void
 DesktopSettingsPrivate::SetSubpixelAverageWeight(uint8 averageWeight)
 {
 	gSubpixelAverageWeight = averageWeight;
+	_FontMetricsChanged();
 	Save(kAppearanceSettings);
 }
 
@@ -829,6 +832,14 @@ DesktopSettingsPrivate::_ValidateWorkspacesLayout(int32& columns,
 }
 
 
+void
+DesktopSettingsPrivate::_FontMetricsChanged()
+{
+	// lets clients drop their cached string widths
+	atomic_add(&fShared.font_generation, 1);
+}
+
+
 //	#pragma mark - read access
 
 
@@ -103,6 +103,7 @@ private:
 			status_t			_GetPath(BPath& path);
 			void				_ValidateWorkspacesLayout(int32& columns,
 									int32& rows) const;
+			void				_FontMetricsChanged();
 
 			status_t			fFontSettingsLoadStatus;
 
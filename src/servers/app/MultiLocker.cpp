@@ -130,6 +130,15 @@ MultiLocker::IsWriteLocked() const
 }
 
 
+bool
+MultiLocker::HasWaitingWriters() const
+{
+	// writer_count includes the current writer, but that doesn't matter
+	// for readers; the value is read without holding the lock's mutex
+	return fInit == B_OK && fLock.writer_count > 0;
+}
+
+
 bool
 MultiLocker::ReadLock()
 {
@@ -347,6 +356,14 @@ MultiLocker::WriteUnlock()
 }
 
 
+bool
+MultiLocker::HasWaitingWriters() const
+{
+	// not tracked in debug mode
+	return false;
+}
+
+
 bool
 MultiLocker::IsReadLocked() const
 {
@@ -60,6 +60,10 @@ public:
 			// does the current thread hold a write lock?
 			bool				IsWriteLocked() const;
 
+			// is a thread waiting for the write lock? This is only a hint
+			// for readers that might want to give up their lock early.
+			bool				HasWaitingWriters() const;
+
 #if MULTI_LOCKER_DEBUG
 			// in DEBUG mode returns whether the lock is held
 			// in non-debug mode returns true
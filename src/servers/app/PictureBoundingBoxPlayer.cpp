@@ -11,6 +11,7 @@
 
 #include "PictureBoundingBoxPlayer.h"
 
+#include <math.h>
 #include <new>
 #include <stdio.h>
 
@@ -54,7 +55,8 @@ public:
 	State(const DrawState* drawState, BRect* boundingBox)
 		:
 		fDrawState(drawState->Squash()),
-		fBoundingBox(boundingBox)
+		fBoundingBox(boundingBox),
+		fIncomplete(false)
 	{
 		fBoundingBox->Set(INT_MAX, INT_MAX, INT_MIN, INT_MIN);
 	}
@@ -97,6 +99,16 @@ public:
 		*fBoundingBox = (*fBoundingBox) | rect;
 	}
 
+	void MarkIncomplete()
+	{
+		fIncomplete = true;
+	}
+
+	bool IsIncomplete() const
+	{
+		return fIncomplete;
+	}
+
 private:
 	void _AffineTransformRect(BRect& rect)
 	{
@@ -136,6 +148,7 @@ private:
 	ObjectDeleter<DrawState>
 				fDrawState;
 	BRect*		fBoundingBox;
+	bool		fIncomplete;
 };
 
 
@@ -171,11 +184,49 @@ get_polygon_frame(const BPoint* points, int32 numPoints, BRect* frame)
 }
 
 
+class ArcFinder : public BShapeIterator {
+public:
+	ArcFinder()
+		:
+		fHasArcs(false)
+	{
+	}
+
+	bool HasArcs(const BShape& shape)
+	{
+		// this class doesn't modify the shape data
+		Iterate(const_cast<BShape*>(&shape));
+		return fHasArcs;
+	}
+
+	virtual status_t IterateArcTo(float&, float&, float&, bool, bool, BPoint&)
+	{
+		fHasArcs = true;
+		return B_OK;
+	}
+
+private:
+	bool fHasArcs;
+};
+
+
+/*!	Grows \a rect by the area a stroke with the current pen may cover
+	beyond its path. Paths with corners (\a hasJoins) may additionally
+	extend by the miter length.
+*/
 template<class RectType>
 static void
-expand_rect_for_pen_size(BoundingBoxState* state, RectType& rect)
+expand_rect_for_pen_size(BoundingBoxState* state, RectType& rect,
+	bool hasJoins = false)
 {
-	float penInset = -((state->GetDrawState()->PenSize() / 2.0f) + 1.0f);
+	const DrawState* drawState = state->GetDrawState();
+	float extent = drawState->PenSize() / 2.0f;
+	if (hasJoins && drawState->LineJoinMode() == B_MITER_JOIN)
+		extent *= max_c(drawState->MiterLimit(), 1.0f);
+	else if (drawState->LineCapMode() == B_SQUARE_CAP)
+		extent *= M_SQRT2;
+
+	float penInset = -(extent + 1.0f);
 	rect.InsetBy(penInset, penInset);
 }
 
@@ -267,16 +318,7 @@ determine_bounds_bezier(BoundingBoxState* state, const BPoint* viewPoints,
 	// performance here.
 	BPoint points[4];
 	state->PenToLocalTransform().Apply(points, viewPoints, 4);
-	BPoint topLeft = points[0];
-	BPoint bottomRight = points[0];
-	for (uint32 index = 1; index < 4; index++) {
-		if (points[index].x < topLeft.x || points[index].y < topLeft.y)
-			topLeft = points[index];
-		if (points[index].x > topLeft.x || points[index].y > topLeft.y)
-			bottomRight = points[index];
-	}
-	outRect.SetLeftTop(topLeft);
-	outRect.SetRightBottom(bottomRight);
+	get_polygon_frame(points, 4, &outRect);
 }
 
 
@@ -296,13 +338,15 @@ determine_bounds_draw_bezier(void* _state, size_t numPoints,
 		reinterpret_cast<BoundingBoxState*>(_state);
 
 	const size_t kSupportedPoints = 4;
-	if (numPoints != kSupportedPoints)
+	if (numPoints != kSupportedPoints) {
+		state->MarkIncomplete();
 		return;
+	}
 
 	BRect rect;
 	determine_bounds_bezier(state, viewPoints, rect);
 	if (!fill)
-		expand_rect_for_pen_size(state, rect);
+		expand_rect_for_pen_size(state, rect, true);
 	state->IncludeRect(rect);
 }
 
@@ -372,10 +416,13 @@ determine_bounds_draw_polygon(void* _state, size_t numPoints,
 	BoundingBoxState* const state =
 		reinterpret_cast<BoundingBoxState*>(_state);
 
+	if (numPoints == 0)
+		return;
+
 	BRect rect;
 	determine_bounds_polygon(state, numPoints, viewPoints, rect);
 	if (!fill)
-		expand_rect_for_pen_size(state, rect);
+		expand_rect_for_pen_size(state, rect, true);
 	state->IncludeRect(rect);
 }
 
@@ -390,9 +437,19 @@ determine_bounds_draw_shape(void* _state, const BShape& shape, bool fill)
 	BoundingBoxState* const state =
 		reinterpret_cast<BoundingBoxState*>(_state);
 
+	// The bounds of shapes with arcs contain the arc parameters rather than
+	// the area the arcs cover.
+	ArcFinder arcFinder;
+	if (arcFinder.HasArcs(shape)) {
+		state->MarkIncomplete();
+		return;
+	}
+
+	// Like in ShapePainter, shapes are offset by the pen location
+	rect.OffsetBy(state->GetDrawState()->PenLocation());
 	state->PenToLocalTransform().Apply(&rect);
 	if (!fill)
-		expand_rect_for_pen_size(state, rect);
+		expand_rect_for_pen_size(state, rect, true);
 	state->IncludeRect(rect);
 }
 
@@ -438,13 +495,113 @@ determine_bounds_draw_pixels(void* _state, const BRect&, const BRect& _dest,
 }
 
 
+static void
+determine_bounds_draw_string_locations(void* _state, const char* string,
+	size_t length, const BPoint locations[], size_t locationCount)
+{
+	TRACE_BB("%p string '%s' at %ld locations\n", _state, string,
+		locationCount);
+	BoundingBoxState* const state =
+		reinterpret_cast<BoundingBoxState*>(_state);
+
+	if (locationCount == 0)
+		return;
+
+	ServerFont font = state->GetDrawState()->Font();
+
+	BRect stringBounds;
+	font.GetBoundingBoxesForStrings((char**)&string, &length, 1,
+		&stringBounds, B_SCREEN_METRIC, NULL);
+
+	const SimpleTransform transform = state->PenToLocalTransform();
+	BPoint location = locations[0];
+	transform.Apply(&location);
+	BRect rect(location, location);
+	for (size_t i = 1; i < locationCount; i++) {
+		location = locations[i];
+		transform.Apply(&location);
+		rect = rect | BRect(location, location);
+	}
+
+	// Each glyph lies within the bounds of the whole string, moved back by
+	// at most the width of the string.
+	rect.left += stringBounds.left - stringBounds.Width();
+	rect.top += stringBounds.top;
+	rect.right += stringBounds.right;
+	rect.bottom += stringBounds.bottom;
+	state->IncludeRect(rect);
+}
+
+
+static void
+determine_bounds_draw_rect_gradient(void* _state, const BRect& rect,
+	BGradient&, bool fill)
+{
+	determine_bounds_draw_rect(_state, rect, fill);
+}
+
+
+static void
+determine_bounds_draw_round_rect_gradient(void* _state, const BRect& rect,
+	const BPoint& radii, BGradient&, bool fill)
+{
+	determine_bounds_draw_round_rect(_state, rect, radii, fill);
+}
+
+
+static void
+determine_bounds_draw_bezier_gradient(void* _state, size_t numPoints,
+	const BPoint viewPoints[], BGradient&, bool fill)
+{
+	determine_bounds_draw_bezier(_state, numPoints, viewPoints, fill);
+}
+
+
+static void
+determine_bounds_draw_arc_gradient(void* _state, const BPoint& center,
+	const BPoint& radii, float startTheta, float arcTheta, BGradient&,
+	bool fill)
+{
+	determine_bounds_draw_arc(_state, center, radii, startTheta, arcTheta,
+		fill);
+}
+
+
+static void
+determine_bounds_draw_ellipse_gradient(void* _state, const BRect& rect,
+	BGradient&, bool fill)
+{
+	determine_bounds_draw_ellipse(_state, rect, fill);
+}
+
+
+static void
+determine_bounds_draw_polygon_gradient(void* _state, size_t numPoints,
+	const BPoint viewPoints[], bool isClosed, BGradient&, bool fill)
+{
+	determine_bounds_draw_polygon(_state, numPoints, viewPoints, isClosed,
+		fill);
+}
+
+
+static void
+determine_bounds_draw_shape_gradient(void* _state, const BShape& shape,
+	BGradient&, bool fill)
+{
+	determine_bounds_draw_shape(_state, shape, fill);
+}
+
+
 static void
 draw_picture(void* _state, const BPoint& where, int32 token)
 {
 	TRACE_BB("%p picture (unimplemented)\n", _state);
+	BoundingBoxState* const state =
+		reinterpret_cast<BoundingBoxState*>(_state);
 
-	// TODO
-	(void)_state;
+	// TODO: the token refers to a picture of the drawing client, which
+	// we cannot resolve here
+	state->MarkIncomplete();
 	(void)where;
 	(void)token;
 }
@@ -781,12 +938,33 @@ determine_bounds_nested_layer(void* _state, Layer* layer)
 		reinterpret_cast<BoundingBoxState*>(_state);
 
 	BRect boundingBox;
-	PictureBoundingBoxPlayer::Play(layer, state->GetDrawState(), &boundingBox);
+	if (!PictureBoundingBoxPlayer::Play(layer, state->GetDrawState(),
+			&boundingBox)) {
+		state->MarkIncomplete();
+	}
 	if (boundingBox.IsValid())
 		state->IncludeRect(boundingBox);
 }
 
 
+static void
+clip_to_rect(void*, const BRect&, bool)
+{
+}
+
+
+static void
+clip_to_shape(void*, int32, const uint32[], int32, const BPoint[], bool)
+{
+}
+
+
+static void
+set_fill_rule(void*, int32)
+{
+}
+
+
 static const BPrivate::picture_player_callbacks
 	kPictureBoundingBoxPlayerCallbacks = {
 	move_pen_by,
@@ -832,14 +1010,30 @@ static const BPrivate::picture_player_callbacks
 	translate_by,
 	scale_by,
 	rotate_by,
-	determine_bounds_nested_layer
+	determine_bounds_nested_layer,
+	clip_to_rect,
+	clip_to_shape,
+	determine_bounds_draw_string_locations,
+	determine_bounds_draw_rect_gradient,
+	determine_bounds_draw_round_rect_gradient,
+	determine_bounds_draw_bezier_gradient,
+	determine_bounds_draw_arc_gradient,
+	determine_bounds_draw_ellipse_gradient,
+	determine_bounds_draw_polygon_gradient,
+	determine_bounds_draw_shape_gradient,
+	set_fill_rule
 };
 
 
 // #pragma mark - PictureBoundingBoxPlayer
 
 
-/* static */ void
+/*!	Determines the bounding box of everything \a picture draws, in the local
+	coordinates of \a drawState.
+	Returns \c false if the picture contains operations whose bounds could
+	not be determined, in which case the box may be too small.
+*/
+/* static */ bool
 PictureBoundingBoxPlayer::Play(ServerPicture* picture,
 	const DrawState* drawState, BRect* outBoundingBox)
 {
@@ -847,11 +1041,15 @@ PictureBoundingBoxPlayer::Play(ServerPicture* picture,
 
 	BMallocIO* mallocIO = dynamic_cast<BMallocIO*>(picture->fData.Get());
 	if (mallocIO == NULL)
-		return;
+		return false;
 
 	BPrivate::PicturePlayer player(mallocIO->Buffer(),
 		mallocIO->BufferLength(), ServerPicture::PictureList::Private(
 			picture->fPictures.Get()).AsBList());
-	player.Play(kPictureBoundingBoxPlayerCallbacks,
-		sizeof(kPictureBoundingBoxPlayerCallbacks), &state);
+	if (player.Play(kPictureBoundingBoxPlayerCallbacks,
+			sizeof(kPictureBoundingBoxPlayerCallbacks), &state) != B_OK) {
+		return false;
+	}
+
+	return !state.IsIncomplete();
 }
@@ -19,7 +19,7 @@ public:
 	class State;
 
 public:
-	static	void				Play(ServerPicture* picture,
+	static	bool				Play(ServerPicture* picture,
 									const DrawState* drawState,
 									BRect* outBoundingBox);
 };
@@ -1087,12 +1087,29 @@ ServerFont::StringWidth(const char *string, int32 numBytes,
 	if (!string || numBytes <= 0)
 		return 0.0;
 
+	FontCacheEntry* entry = GlyphLayoutEngine::FontCacheEntryFor(*this, false);
+	if (entry == NULL)
+		return 0.0;
+
+	FontCacheReference cacheReference;
+	cacheReference.SetTo(entry);
+
+	// Custom escapements are rare, only plain widths are cached
+	float width;
+	if (deltaArray == NULL
+		&& entry->CachedStringWidth(string, numBytes, fSpacing, &width)) {
+		return width;
+	}
+
 	StringWidthConsumer consumer;
 	if (!GlyphLayoutEngine::LayoutGlyphs(consumer, *this, string, numBytes,
-			INT32_MAX, deltaArray, fSpacing)) {
+			INT32_MAX, deltaArray, fSpacing, NULL, &cacheReference)) {
 		return 0.0;
 	}
 
+	if (deltaArray == NULL)
+		entry->CacheStringWidth(string, numBytes, fSpacing, consumer.width);
+
 	return consumer.width;
 }
 
@@ -14,13 +14,13 @@
 
 #include <new>
 #include <stdio.h>
-#include <stack>
 
 #include "AlphaMask.h"
 #include "DrawingEngine.h"
 #include "DrawState.h"
 #include "GlobalFontManager.h"
 #include "Layer.h"
+#include "PictureBoundingBoxPlayer.h"
 #include "ServerApp.h"
 #include "ServerBitmap.h"
 #include "ServerFont.h"
@@ -28,6 +28,7 @@
 #include "View.h"
 #include "Window.h"
 
+#include <Array.h>
 #include <LinkReceiver.h>
 #include <OffsetFile.h>
 #include <ObjectListPrivate.h>
@@ -44,9 +45,6 @@
 #include <Shape.h>
 
 
-using std::stack;
-
-
 class ShapePainter : public BShapeIterator {
 public:
 	ShapePainter(Canvas* canvas, BGradient* gradient);
@@ -63,11 +61,14 @@ public:
 
 	void Draw(BRect frame, bool filled);
 
+private:
+	status_t _AddPoints(uint32 op, const BPoint* points, int32 count);
+
 private:
 	Canvas*	fCanvas;
 	BGradient* fGradient;
-	stack<uint32>	fOpStack;
-	stack<BPoint>	fPtStack;
+	Array<uint32>	fOps;
+	Array<BPoint>	fPoints;
 };
 
 
@@ -95,12 +96,8 @@ ShapePainter::Iterate(const BShape* shape)
 status_t
 ShapePainter::IterateMoveTo(BPoint* point)
 {
-	try {
-		fOpStack.push(OP_MOVETO);
-		fPtStack.push(*point);
-	} catch (std::bad_alloc&) {
+	if (!fOps.Add(OP_MOVETO) || !fPoints.Add(*point))
 		return B_NO_MEMORY;
-	}
 
 	return B_OK;
 }
@@ -109,15 +106,7 @@ ShapePainter::IterateMoveTo(BPoint* point)
 status_t
 ShapePainter::IterateLineTo(int32 lineCount, BPoint* linePts)
 {
-	try {
-		fOpStack.push(OP_LINETO | lineCount);
-		for (int32 i = 0; i < lineCount; i++)
-			fPtStack.push(linePts[i]);
-	} catch (std::bad_alloc&) {
-		return B_NO_MEMORY;
-	}
-
-	return B_OK;
+	return _AddPoints(OP_LINETO | lineCount, linePts, lineCount);
 }
 
 
@@ -125,15 +114,7 @@ status_t
 ShapePainter::IterateBezierTo(int32 bezierCount, BPoint* bezierPts)
 {
 	bezierCount *= 3;
-	try {
-		fOpStack.push(OP_BEZIERTO | bezierCount);
-		for (int32 i = 0; i < bezierCount; i++)
-			fPtStack.push(bezierPts[i]);
-	} catch (std::bad_alloc&) {
-		return B_NO_MEMORY;
-	}
-
-	return B_OK;
+	return _AddPoints(OP_BEZIERTO | bezierCount, bezierPts, bezierCount);
 }
 
 
@@ -154,27 +135,16 @@ ShapePainter::IterateArcTo(float& rx, float& ry,
 			op = OP_SMALL_ARC_TO_CW;
 	}
 
-	try {
-		fOpStack.push(op | 3);
-		fPtStack.push(BPoint(rx, ry));
-		fPtStack.push(BPoint(angle, 0));
-		fPtStack.push(point);
-	} catch (std::bad_alloc&) {
-		return B_NO_MEMORY;
-	}
-
-	return B_OK;
+	BPoint points[3] = { BPoint(rx, ry), BPoint(angle, 0), point };
+	return _AddPoints(op | 3, points, 3);
 }
 
 
 status_t
 ShapePainter::IterateClose()
 {
-	try {
-		fOpStack.push(OP_CLOSE);
-	} catch (std::bad_alloc&) {
+	if (!fOps.Add(OP_CLOSE))
 		return B_NO_MEMORY;
-	}
 
 	return B_OK;
 }
@@ -184,32 +154,10 @@ void
 ShapePainter::Draw(BRect frame, bool filled)
 {
 	// We're going to draw the currently iterated shape.
-	// TODO: This can be more efficient by skipping the conversion.
-	int32 opCount = fOpStack.size();
-	int32 ptCount = fPtStack.size();
+	int32 opCount = fOps.Count();
+	int32 ptCount = fPoints.Count();
 
 	if (opCount > 0 && ptCount > 0) {
-		int32 i;
-		uint32* opList = new(std::nothrow) uint32[opCount];
-		if (opList == NULL)
-			return;
-
-		BPoint* ptList = new(std::nothrow) BPoint[ptCount];
-		if (ptList == NULL) {
-			delete[] opList;
-			return;
-		}
-
-		for (i = opCount - 1; i >= 0; i--) {
-			opList[i] = fOpStack.top();
-			fOpStack.pop();
-		}
-
-		for (i = ptCount - 1; i >= 0; i--) {
-			ptList[i] = fPtStack.top();
-			fPtStack.pop();
-		}
-
 		// this might seem a bit weird, but under R5, the shapes
 		// are always offset by the current pen location
 		BPoint screenOffset = fCanvas->CurrentState()->PenLocation();
@@ -221,16 +169,30 @@ ShapePainter::Draw(BRect frame, bool filled)
 
 		/* stroked gradients are not yet supported */
 		if (fGradient != NULL && filled) {
-			fCanvas->GetDrawingEngine()->FillShape(frame, opCount, opList,
-				ptCount, ptList, *fGradient, screenOffset, fCanvas->Scale());
+			fCanvas->GetDrawingEngine()->FillShape(frame, opCount,
+				fOps.Elements(), ptCount, fPoints.Elements(), *fGradient,
+				screenOffset, fCanvas->Scale());
 		} else {
-			fCanvas->GetDrawingEngine()->DrawShape(frame, opCount, opList,
-				ptCount, ptList, filled, screenOffset, fCanvas->Scale());
+			fCanvas->GetDrawingEngine()->DrawShape(frame, opCount,
+				fOps.Elements(), ptCount, fPoints.Elements(), filled,
+				screenOffset, fCanvas->Scale());
 		}
-
-		delete[] opList;
-		delete[] ptList;
 	}
+
+	fOps.MakeEmpty();
+	fPoints.MakeEmpty();
+}
+
+
+status_t
+ShapePainter::_AddPoints(uint32 op, const BPoint* points, int32 count)
+{
+	int32 index = fPoints.Count();
+	if (!fOps.Add(op) || !fPoints.AddUninitialized(count))
+		return B_NO_MEMORY;
+
+	memcpy(&fPoints[index], points, count * sizeof(BPoint));
+	return B_OK;
 }
 
 
@@ -596,7 +558,8 @@ draw_picture(void* _canvas, const BPoint& where, int32 token)
 		canvas->SetDrawingOrigin(where);
 
 		canvas->PushState();
-		picture->Play(canvas);
+		if (!picture->IsClippedOut(canvas))
+			picture->Play(canvas);
 		canvas->PopState();
 
 		canvas->PopState();
@@ -1074,10 +1037,58 @@ static const BPrivate::picture_player_callbacks kPicturePlayerCallbacks = {
 // #pragma mark - ServerPicture
 
 
+/*!	The bounding box of a picture for the drawing state it was last played
+	with, together with everything from that state the box depends on.
+	The box is stored relative to the combined origin of the state, as it
+	just moves along with it.
+*/
+struct ServerPicture::BoundsCache {
+	bool Matches(const DrawState* state, off_t length, int32 generation) const
+	{
+		return dataLength == length && dataGeneration == generation
+			&& scale == state->CombinedScale()
+			&& penLocation == state->PenLocation()
+			&& penSize == state->PenSize()
+			&& capMode == state->LineCapMode()
+			&& joinMode == state->LineJoinMode()
+			&& miterLimit == state->MiterLimit()
+			&& font == state->Font();
+	}
+
+	void SetTo(const DrawState* state, off_t length, int32 generation)
+	{
+		dataLength = length;
+		dataGeneration = generation;
+		scale = state->CombinedScale();
+		penLocation = state->PenLocation();
+		penSize = state->PenSize();
+		capMode = state->LineCapMode();
+		joinMode = state->LineJoinMode();
+		miterLimit = state->MiterLimit();
+		font = state->Font();
+	}
+
+	off_t		dataLength;
+	int32		dataGeneration;
+	float		scale;
+	BPoint		penLocation;
+	float		penSize;
+	cap_mode	capMode;
+	join_mode	joinMode;
+	float		miterLimit;
+	ServerFont	font;
+
+	BRect		bounds;
+	bool		complete;
+};
+
+
 ServerPicture::ServerPicture()
 	:
 	fFile(NULL),
-	fOwner(NULL)
+	fOwner(NULL),
+	fDataGeneration(0),
+	fBoundsBusy(0)
 {
 	fToken = gTokenSpace.NewToken(kPictureToken, this);
 	fData.SetTo(new(std::nothrow) BMallocIO());
@@ -1090,7 +1101,9 @@ ServerPicture::ServerPicture(const ServerPicture& picture)
 	:
 	fFile(NULL),
 	fData(NULL),
-	fOwner(NULL)
+	fOwner(NULL),
+	fDataGeneration(0),
+	fBoundsBusy(0)
 {
 	fToken = gTokenSpace.NewToken(kPictureToken, this);
 
@@ -1115,7 +1128,9 @@ ServerPicture::ServerPicture(const char* fileName, int32 offset)
 	:
 	fFile(NULL),
 	fData(NULL),
-	fOwner(NULL)
+	fOwner(NULL),
+	fDataGeneration(0),
+	fBoundsBusy(0)
 {
 	fToken = gTokenSpace.NewToken(kPictureToken, this);
 
@@ -1282,6 +1297,70 @@ ServerPicture::Play(Canvas* target)
 }
 
 
+/*!	Returns whether nothing the picture draws could be visible within the
+	current clipping region of \a target, so that playing it can be skipped.
+	The caller must make sure that any state changes done by the picture are
+	discarded afterwards anyway.
+
+	The bounding box of the picture is only determined again when the picture
+	data or the parts of the drawing state it depends on have changed.
+*/
+bool
+ServerPicture::IsClippedOut(Canvas* target)
+{
+	const BRegion* clipping = target->GetDrawingEngine()->ClippingRegion();
+	if (clipping == NULL)
+		return false;
+
+	// The Painter applies affine transformations relative to the view, which
+	// the bounding box does not know about
+	const DrawState* state = target->CurrentState();
+	if (!state->CombinedTransform().IsIdentity())
+		return false;
+
+	// Pictures can be played from several windows at once; rather than
+	// waiting for the other thread, just play the picture
+	if (atomic_test_and_set(&fBoundsBusy, 1, 0) != 0)
+		return false;
+
+	const off_t length = DataLength();
+	const int32 generation = atomic_get(&fDataGeneration);
+
+	if (!fBoundsCache.IsSet())
+		fBoundsCache.SetTo(new(std::nothrow) BoundsCache);
+
+	BoundsCache* cache = fBoundsCache.Get();
+	if (cache != NULL && !cache->Matches(state, length, generation)) {
+		BRect bounds;
+		cache->complete = PictureBoundingBoxPlayer::Play(this, state,
+			&bounds);
+		cache->bounds = bounds.OffsetByCopy(-state->CombinedOrigin());
+		cache->SetTo(state, length, generation);
+	}
+
+	bool complete = cache != NULL && cache->complete;
+	BRect bounds;
+	if (complete)
+		bounds = cache->bounds;
+
+	atomic_set(&fBoundsBusy, 0);
+
+	if (!complete)
+		return false;
+	if (!bounds.IsValid()) {
+		// the picture doesn't draw anything
+		return true;
+	}
+
+	bounds.OffsetBy(state->CombinedOrigin());
+	target->LocalToScreenTransform().Apply(&bounds);
+	// account for anti-aliasing and rounding to pixels
+	bounds.InsetBy(-2, -2);
+
+	return !clipping->Intersects(bounds);
+}
+
+
 /*!	Acquires a reference to the pushed picture.
 */
 void
@@ -1342,6 +1421,9 @@ ServerPicture::ImportData(BPrivate::LinkReceiver& link)
 	int32 size = 0;
 	link.Read<int32>(&size);
 
+	// the data might keep its size, but the cached bounds are stale
+	atomic_add(&fDataGeneration, 1);
+
 	off_t oldPosition = fData->Position();
 	fData->Seek(0, SEEK_SET);
 
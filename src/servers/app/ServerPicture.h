@@ -55,6 +55,7 @@ public:
 									uint16 mask);
 
 			void				Play(Canvas* target);
+			bool				IsClippedOut(Canvas* target);
 
 			void 				PushPicture(ServerPicture* picture);
 			ServerPicture*		PopPicture();
@@ -71,6 +72,7 @@ private:
 	friend class PictureBoundingBoxPlayer;
 
 			typedef BObjectList<ServerPicture> PictureList;
+			struct BoundsCache;
 
 			int32				fToken;
 			ObjectDeleter<BFile>
@@ -82,6 +84,11 @@ private:
 			BReference<ServerPicture>
 								fPushed;
 			ServerApp*			fOwner;
+
+			int32				fDataGeneration;
+			int32				fBoundsBusy;
+			ObjectDeleter<BoundsCache>
+								fBoundsCache;
 };
 
 
@@ -3175,7 +3175,8 @@ ServerWindow::_DispatchViewDrawingMessage(int32 code,
 					fCurrentView->SetDrawingOrigin(where);
 
 					fCurrentView->PushState();
-					picture->Play(fCurrentView);
+					if (!picture->IsClippedOut(fCurrentView))
+						picture->Play(fCurrentView);
 					fCurrentView->PopState();
 
 					fCurrentView->PopState();
@@ -4270,9 +4271,14 @@ ServerWindow::_MessageLooper()
 				fDesktop->UnlockAllWindows();
 
 			// Only process up to 70 waiting messages at once (we have the
-			// Desktop locked), but don't hold the lock longer than 10 ms
+			// Desktop locked), but don't hold the lock longer than 10 ms.
+			// Also give it up as soon as someone waits for the write lock,
+			// so that a window that is busy drawing does not hold back
+			// moving or resizing windows.
 			if (!receiver.HasMessages() || ++messagesProcessed > 70
-				|| system_time() - processingStart > 10000) {
+				|| system_time() - processingStart > 10000
+				|| (lockedDesktopSingleWindow
+					&& fDesktop->WindowLocker().HasWaitingWriters())) {
 				if (lockedDesktopSingleWindow)
 					fDesktop->UnlockSingleWindow();
 				break;
@@ -309,6 +309,16 @@ DrawingEngine::ConstrainClippingRegion(const BRegion* region)
 }
 
 
+/*!	Returns the current clipping region in screen coordinates, or \c NULL
+	if drawing is not clipped.
+*/
+const BRegion*
+DrawingEngine::ClippingRegion() const
+{
+	return fPainter->ClippingRegion();
+}
+
+
 void
 DrawingEngine::SetDrawState(const DrawState* state, int32 xOffset,
 	int32 yOffset)
@@ -69,6 +69,7 @@ public:
 	// clipping for all drawing functions, passing a NULL region
 	// will remove any clipping (drawing allowed everywhere)
 	virtual	void			ConstrainClippingRegion(const BRegion* region);
+			const BRegion*	ClippingRegion() const;
 
 	virtual	void			SetDrawState(const DrawState* state,
 								int32 xOffset = 0, int32 yOffset = 0);
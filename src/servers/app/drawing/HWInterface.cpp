@@ -16,6 +16,10 @@
 
 #include <vesa/vesa_info.h>
 
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
 #include "drawing_support.h"
 
 #include "DrawingEngine.h"
@@ -310,6 +314,11 @@ HWInterface::SetAsyncDoubleBuffered(bool doubleBuffered)
 status_t
 HWInterface::InvalidateRegion(const BRegion& region)
 {
+	// Transfer the whole region at once, instead of locking and compositing
+	// the cursor for every single rect.
+	if (IsDoubleBuffered())
+		return CopyRegionBackToFront(region);
+
 	int32 count = region.CountRects();
 	for (int32 i = 0; i < count; i++) {
 		status_t result = Invalidate(region.RectAt(i));
@@ -386,6 +395,52 @@ HWInterface::CopyBackToFront(const BRect& frame)
 }
 
 
+/*!	Like CopyBackToFront(), but for a whole region. The region is only ever
+	reduced, copying parts outside of it could make drawing in progress
+	visible. The object must already be locked!
+*/
+status_t
+HWInterface::CopyRegionBackToFront(const BRegion& region)
+{
+	RenderingBuffer* frontBuffer = FrontBuffer();
+	RenderingBuffer* backBuffer = BackBuffer();
+
+	if (!backBuffer || !frontBuffer)
+		return B_NO_INIT;
+
+	// make sure we don't copy out of bounds
+	BRegion clipped(region);
+	BRegion bufferClip((BRect)backBuffer->Bounds());
+	clipped.IntersectWith(&bufferClip);
+	int32 count = clipped.CountRects();
+	if (count == 0)
+		return B_BAD_VALUE;
+
+	bool cursorLocked = fFloatingOverlaysLock.Lock();
+
+	IntRect cursorFrame = _CursorFrame();
+	if (!cursorFrame.IsValid() || !cursorFrame.Intersects(clipped.Frame())) {
+		_CopyBackToFront(clipped);
+	} else {
+		BRegion withoutCursor(clipped);
+		withoutCursor.Exclude((clipping_rect)cursorFrame);
+		_CopyBackToFront(withoutCursor);
+
+		for (int32 i = 0; i < count; i++) {
+			clipping_rect rect = clipped.RectAtInt(i);
+			IntRect area(rect.left, rect.top, rect.right, rect.bottom);
+			if (area.Intersects(cursorFrame))
+				_DrawCursor(area);
+		}
+	}
+
+	if (cursorLocked)
+		fFloatingOverlaysLock.Unlock();
+
+	return B_OK;
+}
+
+
 void
 HWInterface::_CopyBackToFront(/*const*/ BRegion& region)
 {
@@ -649,6 +704,84 @@ HWInterface::_DrawCursor(IntRect area) const
 }
 
 
+#ifdef __SSE2__
+static inline __m128i
+pack_32_to_16(__m128i low, __m128i high)
+{
+	// _mm_packs_epi32() saturates, so sign extend the values first
+	low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+	high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+	return _mm_packs_epi32(low, high);
+}
+#endif
+
+
+/*!	Converts a row of B_RGBA32 pixels to B_RGB16.
+*/
+static inline void
+convert_row_to_rgb16(const uint8* src, uint16* dst, int32 count)
+{
+#ifdef __SSE2__
+	const __m128i redMask = _mm_set1_epi32(0xf800);
+	const __m128i greenMask = _mm_set1_epi32(0x07e0);
+	const __m128i blueMask = _mm_set1_epi32(0x001f);
+
+	for (; count >= 8; count -= 8) {
+		__m128i pixels[2];
+		for (int32 i = 0; i < 2; i++) {
+			__m128i p = _mm_loadu_si128((const __m128i*)src + i);
+			pixels[i] = _mm_or_si128(_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(p, 8), redMask),
+				_mm_and_si128(_mm_srli_epi32(p, 5), greenMask)),
+				_mm_and_si128(_mm_srli_epi32(p, 3), blueMask));
+		}
+		_mm_storeu_si128((__m128i*)dst, pack_32_to_16(pixels[0], pixels[1]));
+		src += 32;
+		dst += 8;
+	}
+#endif
+
+	for (; count > 0; count--) {
+		*dst++ = (uint16)(((src[2] & 0xf8) << 8) | ((src[1] & 0xfc) << 3)
+			| (src[0] >> 3));
+		src += 4;
+	}
+}
+
+
+/*!	Converts a row of B_RGBA32 pixels to B_RGB15.
+*/
+static inline void
+convert_row_to_rgb15(const uint8* src, uint16* dst, int32 count)
+{
+#ifdef __SSE2__
+	const __m128i redMask = _mm_set1_epi32(0x7c00);
+	const __m128i greenMask = _mm_set1_epi32(0x03e0);
+	const __m128i blueMask = _mm_set1_epi32(0x001f);
+
+	for (; count >= 8; count -= 8) {
+		__m128i pixels[2];
+		for (int32 i = 0; i < 2; i++) {
+			__m128i p = _mm_loadu_si128((const __m128i*)src + i);
+			pixels[i] = _mm_or_si128(_mm_or_si128(
+				_mm_and_si128(_mm_srli_epi32(p, 9), redMask),
+				_mm_and_si128(_mm_srli_epi32(p, 6), greenMask)),
+				_mm_and_si128(_mm_srli_epi32(p, 3), blueMask));
+		}
+		_mm_storeu_si128((__m128i*)dst, pack_32_to_16(pixels[0], pixels[1]));
+		src += 32;
+		dst += 8;
+	}
+#endif
+
+	for (; count > 0; count--) {
+		*dst++ = (uint16)(((src[2] & 0xf8) << 7) | ((src[1] & 0xf8) << 2)
+			| (src[0] >> 3));
+		src += 4;
+	}
+}
+
+
 /*!	- source is assumed to be already at the right offset
 	- source is assumed to be in B_RGBA32 format
 	- location in front buffer is calculated
@@ -710,18 +843,11 @@ HWInterface::_CopyToFront(uint8* src, uint32 srcBPR, int32 x, int32 y,
 		{
 			// offset to left top pixel in dest buffer
 			dst += y * dstBPR + x * 2;
-			int32 left = x;
+			int32 count = right - x + 1;
 			// copy
 			// TODO: assumes BGR order, does this work on big endian as well?
 			for (; y <= bottom; y++) {
-				uint8* srcHandle = src;
-				uint16* dstHandle = (uint16*)dst;
-				for (x = left; x <= right; x++) {
-					*dstHandle = (uint16)(((srcHandle[2] & 0xf8) << 8)
-						| ((srcHandle[1] & 0xfc) << 3) | (srcHandle[0] >> 3));
-					dstHandle ++;
-					srcHandle += 4;
-				}
+				convert_row_to_rgb16(src, (uint16*)dst, count);
 				dst += dstBPR;
 				src += srcBPR;
 			}
@@ -733,18 +859,11 @@ HWInterface::_CopyToFront(uint8* src, uint32 srcBPR, int32 x, int32 y,
 		{
 			// offset to left top pixel in dest buffer
 			dst += y * dstBPR + x * 2;
-			int32 left = x;
+			int32 count = right - x + 1;
 			// copy
 			// TODO: assumes BGR order, does this work on big endian as well?
 			for (; y <= bottom; y++) {
-				uint8* srcHandle = src;
-				uint16* dstHandle = (uint16*)dst;
-				for (x = left; x <= right; x++) {
-					*dstHandle = (uint16)(((srcHandle[2] & 0xf8) << 7)
-						| ((srcHandle[1] & 0xf8) << 2) | (srcHandle[0] >> 3));
-					dstHandle ++;
-					srcHandle += 4;
-				}
+				convert_row_to_rgb15(src, (uint16*)dst, count);
 				dst += dstBPR;
 				src += srcBPR;
 			}
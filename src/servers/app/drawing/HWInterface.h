@@ -172,6 +172,7 @@ public:
 	// while as CopyBackToFront() actually performs the operation
 	// either directly or asynchronously by the UpdateQueue thread
 	virtual	status_t			CopyBackToFront(const BRect& frame);
+	virtual	status_t			CopyRegionBackToFront(const BRegion& region);
 
 protected:
 	virtual	void				_CopyBackToFront(/*const*/ BRegion& region);
@@ -58,6 +58,7 @@
 #include "GlobalSubpixelSettings.h"
 #include "PatternHandler.h"
 #include "RenderingBuffer.h"
+#include "RenderWorkerPool.h"
 #include "ServerBitmap.h"
 #include "ServerFont.h"
 #include "SystemPalette.h"
@@ -162,6 +163,8 @@ detect_simd()
 				cpuSIMD |= APPSERVER_SIMD_MMX;
 			if (edx & (1 << 25))
 				cpuSIMD |= APPSERVER_SIMD_SSE;
+			if (edx & (1 << 26))
+				cpuSIMD |= APPSERVER_SIMD_SSE2;
 		} else {
 			// no flags can be identified
 			cpuSIMD = 0;
@@ -169,7 +172,11 @@ detect_simd()
 		systemSIMD &= cpuSIMD;
 	}
 	return systemSIMD;
-#else	// !__i386__
+#elif __x86_64__
+	// SSE2 is part of the base instruction set. The MMX/SSE flags stay off,
+	// since they select 32 bit assembler routines.
+	return APPSERVER_SIMD_SSE2;
+#else
 	return 0;
 #endif
 }
@@ -199,6 +206,47 @@ private:
 };
 
 
+// Parameters for filling a rectangle in bands, see fill_rect_band().
+struct fill_rect_job {
+	const BRegion*	clipping;
+	uint8*			bits;
+	uint32			bytesPerRow;
+	int32			left;
+	int32			right;
+	int32			top;
+	const uint32*	colors;
+		// one color per row starting at top, or NULL to use color
+	uint32			color;
+};
+
+
+static void
+fill_rect_band(void* cookie, int32 top, int32 bottom)
+{
+	const fill_rect_job& job = *(const fill_rect_job*)cookie;
+
+	// iterate over the clipping boxes ourselves, the renderer's
+	// iteration state must not be shared between threads
+	int32 count = job.clipping->CountRects();
+	for (int32 i = 0; i < count; i++) {
+		clipping_rect box = job.clipping->RectAtInt(i);
+		int32 x1 = max_c(box.left, job.left);
+		int32 x2 = min_c(box.right, job.right);
+		if (x1 > x2)
+			continue;
+
+		int32 y1 = max_c(box.top, top);
+		int32 y2 = min_c(box.bottom, bottom);
+		uint8* offset = job.bits + x1 * 4;
+		for (; y1 <= y2; y1++) {
+			uint32 color = job.colors != NULL
+				? job.colors[y1 - job.top] : job.color;
+			gfxset32(offset + y1 * job.bytesPerRow, color, (x2 - x1 + 1) * 4);
+		}
+	}
+}
+
+
 // #pragma mark -
 
 
@@ -995,36 +1043,33 @@ Painter::FillRect(const BRect& r, const rgb_color& c) const
 	if (!fValidClipping)
 		return;
 
-	uint8* dst = fBuffer.row_ptr(0);
-	uint32 bpr = fBuffer.stride();
-	int32 left = (int32)r.left;
-	int32 top = (int32)r.top;
-	int32 right = (int32)r.right;
-	int32 bottom = (int32)r.bottom;
 	// get a 32 bit pixel ready with the color
 	pixel32 color;
 	color.data8[0] = c.blue;
 	color.data8[1] = c.green;
 	color.data8[2] = c.red;
 	color.data8[3] = c.alpha;
-	// fill rects, iterate over clipping boxes
-	fBaseRenderer.first_clip_box();
-	do {
-		int32 x1 = max_c(fBaseRenderer.xmin(), left);
-		int32 x2 = min_c(fBaseRenderer.xmax(), right);
-		if (x1 <= x2) {
-			int32 y1 = max_c(fBaseRenderer.ymin(), top);
-			int32 y2 = min_c(fBaseRenderer.ymax(), bottom);
-			uint8* offset = dst + x1 * 4;
-			for (; y1 <= y2; y1++) {
-//					uint32* handle = (uint32*)(offset + y1 * bpr);
-//					for (int32 x = x1; x <= x2; x++) {
-//						*handle++ = color.data32;
-//					}
-				gfxset32(offset + y1 * bpr, color.data32, (x2 - x1 + 1) * 4);
-			}
-		}
-	} while (fBaseRenderer.next_clip_box());
+
+	fill_rect_job job;
+	job.clipping = fClippingRegion;
+	job.bits = fBuffer.row_ptr(0);
+	job.bytesPerRow = fBuffer.stride();
+	job.left = (int32)r.left;
+	job.right = (int32)r.right;
+	job.top = (int32)r.top;
+	job.colors = NULL;
+	job.color = color.data32;
+
+	// fill rects in bands, large fills are spread over all CPUs
+	clipping_rect frame = fClippingRegion->FrameInt();
+	int32 left = max_c(frame.left, job.left);
+	int32 right = min_c(frame.right, job.right);
+	if (left > right)
+		return;
+
+	RenderWorkerPool::RenderBands(&fill_rect_band, &job,
+		max_c(frame.top, job.top), min_c(frame.bottom, (int32)r.bottom),
+		right - left + 1);
 }
 
 
@@ -1053,31 +1098,19 @@ Painter::FillRectVerticalGradient(BRect r,
 	_MakeGradient(gradient, colorCount, gradientArray,
 		gradientTop - (int32)r.top, gradientArraySize);
 
-	uint8* dst = fBuffer.row_ptr(0);
-	uint32 bpr = fBuffer.stride();
-	int32 left = (int32)r.left;
-	int32 top = (int32)r.top;
-	int32 right = (int32)r.right;
-	int32 bottom = (int32)r.bottom;
-	// fill rects, iterate over clipping boxes
-	fBaseRenderer.first_clip_box();
-	do {
-		int32 x1 = max_c(fBaseRenderer.xmin(), left);
-		int32 x2 = min_c(fBaseRenderer.xmax(), right);
-		if (x1 <= x2) {
-			int32 y1 = max_c(fBaseRenderer.ymin(), top);
-			int32 y2 = min_c(fBaseRenderer.ymax(), bottom);
-			uint8* offset = dst + x1 * 4;
-			for (; y1 <= y2; y1++) {
-//					uint32* handle = (uint32*)(offset + y1 * bpr);
-//					for (int32 x = x1; x <= x2; x++) {
-//						*handle++ = gradientArray[y1 - top];
-//					}
-				gfxset32(offset + y1 * bpr, gradientArray[y1 - top],
-					(x2 - x1 + 1) * 4);
-			}
-		}
-	} while (fBaseRenderer.next_clip_box());
+	fill_rect_job job;
+	job.clipping = fClippingRegion;
+	job.bits = fBuffer.row_ptr(0);
+	job.bytesPerRow = fBuffer.stride();
+	job.left = (int32)r.left;
+	job.right = (int32)r.right;
+	job.top = (int32)r.top;
+	job.colors = gradientArray;
+	job.color = 0;
+
+	// r is already constrained to the clipping frame
+	RenderWorkerPool::RenderBands(&fill_rect_band, &job, job.top,
+		(int32)r.bottom, job.right - job.left + 1);
 }
 
 
@@ -46,6 +46,7 @@ class ServerFont;
 // Defines for SIMD support.
 #define APPSERVER_SIMD_MMX	(1 << 0)
 #define APPSERVER_SIMD_SSE	(1 << 1)
+#define APPSERVER_SIMD_SSE2	(1 << 2)
 
 
 class Painter {
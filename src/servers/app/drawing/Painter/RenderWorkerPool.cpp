@@ -0,0 +1,186 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "RenderWorkerPool.h"
+
+#include <new>
+
+#include <pthread.h>
+
+#include "defines.h"
+
+
+static const int32 kMaxWorkerCount = 8;
+static const int32 kMinBandHeight = 32;
+static const int64 kMinParallelPixels = 128 * 1024;
+	// below this, waking up the workers costs more than it saves
+
+static pthread_once_t sDefaultInitOnce = PTHREAD_ONCE_INIT;
+
+RenderWorkerPool* RenderWorkerPool::sDefault = NULL;
+
+
+RenderWorkerPool::RenderWorkerPool(int32 workerCount)
+	:
+	fLock("render worker pool"),
+	fStartSemaphore(create_sem(0, "render workers start")),
+	fDoneSemaphore(create_sem(0, "render workers done")),
+	fWorkerCount(0),
+	fFunction(NULL),
+	fCookie(NULL),
+	fTop(0),
+	fBottom(-1),
+	fBandHeight(0),
+	fBandCount(0),
+	fNextBand(0)
+{
+	if (fStartSemaphore < 0 || fDoneSemaphore < 0)
+		return;
+
+	for (int32 i = 0; i < workerCount; i++) {
+		thread_id thread = spawn_thread(&_WorkerThread, "render worker",
+			B_DISPLAY_PRIORITY, this);
+		if (thread < 0)
+			break;
+
+		resume_thread(thread);
+		fWorkerCount++;
+	}
+}
+
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+	// The workers quit once their semaphore is gone
+	delete_sem(fStartSemaphore);
+	delete_sem(fDoneSemaphore);
+}
+
+
+/*!	Returns the global pool, or \c NULL if parallel rendering is disabled or
+	there is only a single CPU.
+*/
+/*static*/ RenderWorkerPool*
+RenderWorkerPool::Default()
+{
+	pthread_once(&sDefaultInitOnce, &_Init);
+	return sDefault;
+}
+
+
+/*!	Calls \a function for the rows \a top to \a bottom, split into bands
+	that are rendered in parallel. If the area is too small, or the pool is
+	currently busy with another primitive, the whole range is rendered in the
+	calling thread instead. In any case, rendering is complete once this
+	method returns.
+*/
+void
+RenderWorkerPool::Render(band_function function, void* cookie, int32 top,
+	int32 bottom, int32 width)
+{
+	int32 height = bottom - top + 1;
+	if (height < 2 * kMinBandHeight
+		|| (int64)height * width < kMinParallelPixels
+		|| fLock.LockWithTimeout(0) != B_OK) {
+		function(cookie, top, bottom);
+		return;
+	}
+
+	fBandCount = min_c(fWorkerCount + 1, height / kMinBandHeight);
+	fBandHeight = (height + fBandCount - 1) / fBandCount;
+	fFunction = function;
+	fCookie = cookie;
+	fTop = top;
+	fBottom = bottom;
+	fNextBand = 0;
+
+	int32 workers = fBandCount - 1;
+	release_sem_etc(fStartSemaphore, workers, B_DO_NOT_RESCHEDULE);
+
+	_RenderBands();
+
+	while (acquire_sem_etc(fDoneSemaphore, workers, 0, 0) == B_INTERRUPTED)
+		;
+
+	fLock.Unlock();
+}
+
+
+/*!	Convenience method that uses the default pool if there is one, and
+	renders in the calling thread otherwise.
+*/
+/*static*/ void
+RenderWorkerPool::RenderBands(band_function function, void* cookie,
+	int32 top, int32 bottom, int32 width)
+{
+	if (top > bottom)
+		return;
+
+	RenderWorkerPool* pool = Default();
+	if (pool != NULL)
+		pool->Render(function, cookie, top, bottom, width);
+	else
+		function(cookie, top, bottom);
+}
+
+
+/*static*/ void
+RenderWorkerPool::_Init()
+{
+#if PARALLEL_RENDERING
+	system_info info;
+	if (get_system_info(&info) != B_OK || info.cpu_count < 2)
+		return;
+
+	int32 workerCount = min_c((int32)info.cpu_count - 1, kMaxWorkerCount);
+	RenderWorkerPool* pool = new(std::nothrow) RenderWorkerPool(workerCount);
+	if (pool == NULL)
+		return;
+
+	if (pool->fWorkerCount == 0) {
+		delete pool;
+		return;
+	}
+
+	sDefault = pool;
+#endif
+}
+
+
+/*static*/ status_t
+RenderWorkerPool::_WorkerThread(void* data)
+{
+	RenderWorkerPool* pool = (RenderWorkerPool*)data;
+
+	while (true) {
+		status_t status = acquire_sem(pool->fStartSemaphore);
+		if (status == B_INTERRUPTED)
+			continue;
+		if (status != B_OK)
+			break;
+
+		pool->_RenderBands();
+		release_sem_etc(pool->fDoneSemaphore, 1, B_DO_NOT_RESCHEDULE);
+	}
+
+	return B_OK;
+}
+
+
+void
+RenderWorkerPool::_RenderBands()
+{
+	while (true) {
+		int32 band = atomic_add(&fNextBand, 1);
+		if (band >= fBandCount)
+			return;
+
+		int32 top = fTop + band * fBandHeight;
+		int32 bottom = min_c(top + fBandHeight - 1, fBottom);
+		if (top <= bottom)
+			fFunction(fCookie, top, bottom);
+	}
+}
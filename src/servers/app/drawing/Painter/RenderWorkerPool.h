@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef RENDER_WORKER_POOL_H
+#define RENDER_WORKER_POOL_H
+
+
+#include <Locker.h>
+#include <OS.h>
+
+
+class BRegion;
+
+
+/*!	A small pool of threads that Painter uses to split expensive primitives
+	into horizontal bands and render them on all CPUs. Band functions may only
+	touch the rows of their own band, and must not use any AGG renderer state,
+	as the clipping box iteration of the renderer is not thread safe.
+*/
+class RenderWorkerPool {
+public:
+	typedef void (*band_function)(void* cookie, int32 top, int32 bottom);
+
+	static	RenderWorkerPool*	Default();
+
+			void				Render(band_function function, void* cookie,
+									int32 top, int32 bottom, int32 width);
+
+	static	void				RenderBands(band_function function,
+									void* cookie, int32 top, int32 bottom,
+									int32 width);
+
+private:
+								RenderWorkerPool(int32 workerCount);
+								~RenderWorkerPool();
+
+	static	void				_Init();
+	static	status_t			_WorkerThread(void* data);
+			void				_RenderBands();
+
+private:
+			BLocker				fLock;
+			sem_id				fStartSemaphore;
+			sem_id				fDoneSemaphore;
+			int32				fWorkerCount;
+
+			band_function		fFunction;
+			void*				fCookie;
+			int32				fTop;
+			int32				fBottom;
+			int32				fBandHeight;
+			int32				fBandCount;
+			int32				fNextBand;
+
+	static	RenderWorkerPool*	sDefault;
+};
+
+
+#endif	// RENDER_WORKER_POOL_H
@@ -9,6 +9,7 @@
 #define DRAW_BITMAP_BILINEAR_H
 
 #include "Painter.h"
+#include "RenderWorkerPool.h"
 
 #include <typeinfo>
 
@@ -42,62 +43,96 @@ struct FilterData {
 
 template<class OptimizedVersion>
 struct DrawBitmapBilinearOptimized {
-	void Draw(PainterAggInterface& aggInterface, const BRect& destinationRect,
-		agg::rendering_buffer* bitmap, const FilterData& filterData)
+	void Draw(PainterAggInterface& aggInterface, const BRegion* clippingRegion,
+		const BRect& destinationRect, agg::rendering_buffer* bitmap,
+		const FilterData& filterData)
 	{
 		fSource = bitmap;
 		fSourceBytesPerRow = bitmap->stride();
 		fDestination = NULL;
+		fDestinationBuffer = &aggInterface.fBuffer;
 		fDestinationBytesPerRow = aggInterface.fBuffer.stride();
 		fWeightsX = filterData.fWeightsX;
 		fWeightsY = filterData.fWeightsY;
+		fIndexOffsetX = filterData.fIndexOffsetX;
+		fIndexOffsetY = filterData.fIndexOffsetY;
+		fClippingRegion = clippingRegion;
 
-		const int32 left = (int32)destinationRect.left;
-		const int32 top = (int32)destinationRect.top;
-		const int32 right = (int32)destinationRect.right;
+		fLeft = (int32)destinationRect.left;
+		fTop = (int32)destinationRect.top;
+		fRight = (int32)destinationRect.right;
 		const int32 bottom = (int32)destinationRect.bottom;
 
-		renderer_base& baseRenderer = aggInterface.fBaseRenderer;
+		// filtering is expensive, so large bitmaps are drawn in bands
+		// on all CPUs
+		clipping_rect frame = clippingRegion->FrameInt();
+		const int32 x1 = max_c(frame.left, fLeft);
+		const int32 x2 = min_c(frame.right, fRight);
+		if (x1 > x2)
+			return;
+
+		RenderWorkerPool::RenderBands(&_DrawBand, this, max_c(frame.top, fTop),
+			min_c(frame.bottom, bottom), x2 - x1 + 1);
+	}
+
+protected:
+	static void _DrawBand(void* cookie, int32 top, int32 bottom)
+	{
+		// every band needs its own destination pointer
+		OptimizedVersion painter = *static_cast<OptimizedVersion*>(
+			static_cast<DrawBitmapBilinearOptimized*>(cookie));
+		painter._DrawBandToClipRects(top, bottom);
+	}
 
-		// iterate over clipping boxes
-		baseRenderer.first_clip_box();
-		do {
-			const int32 x1 = max_c(baseRenderer.xmin(), left);
-			const int32 x2 = min_c(baseRenderer.xmax(), right);
+	void _DrawBandToClipRects(int32 top, int32 bottom)
+	{
+		// iterate over clipping boxes; the renderer's iteration state must
+		// not be shared between the bands
+		const int32 count = fClippingRegion->CountRects();
+		for (int32 i = 0; i < count; i++) {
+			clipping_rect box = fClippingRegion->RectAtInt(i);
+			const int32 x1 = max_c(box.left, fLeft);
+			const int32 x2 = min_c(box.right, fRight);
 			if (x1 > x2)
 				continue;
 
-			int32 y1 = max_c(baseRenderer.ymin(), top);
-			int32 y2 = min_c(baseRenderer.ymax(), bottom);
+			int32 y1 = max_c(box.top, top);
+			int32 y2 = min_c(box.bottom, bottom);
 			if (y1 > y2)
 				continue;
 
 			// buffer offset into destination
-			fDestination = aggInterface.fBuffer.row_ptr(y1) + x1 * 4;
+			fDestination = fDestinationBuffer->row_ptr(y1) + x1 * 4;
 
 			// x and y are needed as indices into the weight arrays, so the
 			// offset into the target buffer needs to be compensated
-			const int32 xIndexL = x1 - left - filterData.fIndexOffsetX;
-			const int32 xIndexR = x2 - left - filterData.fIndexOffsetX;
-			y1 -= top + filterData.fIndexOffsetY;
-			y2 -= top + filterData.fIndexOffsetY;
+			const int32 xIndexL = x1 - fLeft - fIndexOffsetX;
+			const int32 xIndexR = x2 - fLeft - fIndexOffsetX;
+			y1 -= fTop + fIndexOffsetY;
+			y2 -= fTop + fIndexOffsetY;
 
 			//printf("x: %ld - %ld\n", xIndexL, xIndexR);
 			//printf("y: %ld - %ld\n", y1, y2);
 
 			static_cast<OptimizedVersion*>(this)->DrawToClipRect(
 				xIndexL, xIndexR, y1, y2);
-
-		} while (baseRenderer.next_clip_box());
+		}
 	}
 
 protected:
 	agg::rendering_buffer*	fSource;
 	uint32					fSourceBytesPerRow;
 	uint8*					fDestination;
+	agg::rendering_buffer*	fDestinationBuffer;
 	uint32					fDestinationBytesPerRow;
 	FilterInfo*				fWeightsX;
 	FilterInfo*				fWeightsY;
+	uint32					fIndexOffsetX;
+	uint32					fIndexOffsetY;
+	const BRegion*			fClippingRegion;
+	int32					fLeft;
+	int32					fTop;
+	int32					fRight;
 };
 
 
@@ -613,16 +648,16 @@ struct DrawBitmapBilinear {
 			case kUseDefaultVersion:
 			{
 				BilinearDefault<ColorType, DrawMode> bilinearPainter;
-				bilinearPainter.Draw(aggInterface, destinationRect, &bitmap,
-					filterData);
+				bilinearPainter.Draw(aggInterface, &clippingRegion,
+					destinationRect, &bitmap, filterData);
 				break;
 			}
 
 			case kOptimizeForLowFilterRatio:
 			{
 				BilinearLowFilterRatio bilinearPainter;
-				bilinearPainter.Draw(aggInterface, destinationRect,
-					&bitmap, filterData);
+				bilinearPainter.Draw(aggInterface, &clippingRegion,
+					destinationRect, &bitmap, filterData);
 				break;
 			}
 
@@ -630,8 +665,8 @@ struct DrawBitmapBilinear {
 			case kUseSIMDVersion:
 			{
 				BilinearSimd bilinearPainter;
-				bilinearPainter.Draw(aggInterface, destinationRect, &bitmap,
-					filterData);
+				bilinearPainter.Draw(aggInterface, &clippingRegion,
+					destinationRect, &bitmap, filterData);
 				break;
 			}
 #endif	// __i386__
@@ -8,9 +8,13 @@
 #ifndef DRAW_BITMAP_NEAREST_NEIGHBOR_H
 #define DRAW_BITMAP_NEAREST_NEIGHBOR_H
 
+#include "DrawBitmapSSE2.h"
 #include "Painter.h"
 
 
+extern uint32 gSIMDFlags;
+
+
 struct DrawBitmapNearestNeighborCopy {
 	static void
 	Draw(const Painter* painter, PainterAggInterface& aggInterface,
@@ -91,6 +95,10 @@ struct DrawBitmapNearestNeighborCopy {
 
 		const uint32 dstBPR = aggInterface.fBuffer.stride();
 
+#ifdef PAINTER_SSE2_KERNELS
+		const bool useSSE2 = (gSIMDFlags & APPSERVER_SIMD_SSE2) != 0;
+#endif
+
 		renderer_base& baseRenderer = aggInterface.fBaseRenderer;
 
 		// iterate over clipping boxes
@@ -125,6 +133,14 @@ struct DrawBitmapNearestNeighborCopy {
 				// buffer handle for destination to be incremented per pixel
 				uint32* d = (uint32*)dst;
 
+#ifdef PAINTER_SSE2_KERNELS
+				if (useSSE2) {
+					bgr32_nearest_neighbor_row_sse2(d, src,
+						xIndices + xIndexL, xIndexR - xIndexL + 1);
+					dst += dstBPR;
+					continue;
+				}
+#endif
 				for (int32 x = xIndexL; x <= xIndexR; x++) {
 					*d = *(uint32*)(src + xIndices[x]);
 					d++;
@@ -8,12 +8,16 @@
 #ifndef DRAW_BITMAP_NO_SCALE_H
 #define DRAW_BITMAP_NO_SCALE_H
 
+#include "DrawBitmapSSE2.h"
 #include "IntPoint.h"
 #include "IntRect.h"
 #include "Painter.h"
 #include "SystemPalette.h"
 
 
+extern uint32 gSIMDFlags;
+
+
 template<class BlendType>
 struct DrawBitmapNoScale {
 public:
@@ -134,6 +138,12 @@ struct Bgr32Over : public DrawBitmapNoScale<Bgr32Over>
 {
 	void BlendRow(uint8* dst, const uint8* src, int32 numPixels)
 	{
+#ifdef PAINTER_SSE2_KERNELS
+		if ((gSIMDFlags & APPSERVER_SIMD_SSE2) != 0) {
+			bgr32_over_row_sse2(dst, src, numPixels);
+			return;
+		}
+#endif
 		uint32* d = (uint32*)dst;
 		uint32* s = (uint32*)src;
 		while (numPixels--) {
@@ -150,6 +160,12 @@ struct Bgr32Alpha : public DrawBitmapNoScale<Bgr32Alpha>
 {
 	void BlendRow(uint8* dst, const uint8* src, int32 numPixels)
 	{
+#ifdef PAINTER_SSE2_KERNELS
+		if ((gSIMDFlags & APPSERVER_SIMD_SSE2) != 0) {
+			bgr32_alpha_row_sse2(dst, src, numPixels);
+			return;
+		}
+#endif
 		uint32* d = (uint32*)dst;
 		int32 bytes = numPixels * 4;
 		uint8 buffer[bytes];
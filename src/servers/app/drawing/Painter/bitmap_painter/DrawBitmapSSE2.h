@@ -0,0 +1,25 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef DRAW_BITMAP_SSE2_H
+#define DRAW_BITMAP_SSE2_H
+
+
+#include <SupportDefs.h>
+
+
+// The SSE2 row kernels are only built on x86 compilers that support the
+// intrinsics, the Jamfile defines PAINTER_SSE2_KERNELS in that case. Callers
+// must also check for APPSERVER_SIMD_SSE2 in gSIMDFlags at runtime.
+#ifdef PAINTER_SSE2_KERNELS
+
+void bgr32_alpha_row_sse2(uint8* dst, const uint8* src, int32 numPixels);
+void bgr32_over_row_sse2(uint8* dst, const uint8* src, int32 numPixels);
+void bgr32_nearest_neighbor_row_sse2(uint32* dst, const uint8* src,
+	const uint16* xIndices, int32 numPixels);
+
+#endif	// PAINTER_SSE2_KERNELS
+
+
+#endif	// DRAW_BITMAP_SSE2_H
@@ -41,6 +41,9 @@
 
 
 #define ALIASED_DRAWING 0
+#define PARALLEL_RENDERING 1
+	// render large fills and scaled bitmaps in bands on all CPUs, see
+	// RenderWorkerPool
 
 	typedef PixelFormat											pixfmt;
 	typedef agg::renderer_region<pixfmt>						renderer_base;
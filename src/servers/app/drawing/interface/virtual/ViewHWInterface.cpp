@@ -818,3 +818,14 @@ ViewHWInterface::CopyBackToFront(const BRect& frame)
 		fWindow->Invalidate(frame);
 	return ret;
 }
+
+
+status_t
+ViewHWInterface::CopyRegionBackToFront(const BRegion& region)
+{
+	status_t ret = HWInterface::CopyRegionBackToFront(region);
+
+	if (ret >= B_OK && fWindow)
+		fWindow->Invalidate(region.Frame());
+	return ret;
+}
@@ -62,6 +62,7 @@ public:
 
 	virtual	status_t			Invalidate(const BRect& frame);
 	virtual	status_t			CopyBackToFront(const BRect& frame);
+	virtual	status_t			CopyRegionBackToFront(const BRegion& region);
 
 private:
 			ObjectDeleter<BBitmapBuffer>
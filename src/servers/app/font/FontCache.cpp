@@ -30,6 +30,7 @@ FontCache::sDefaultInstance;
 FontCache::FontCache()
 	: MultiLocker("FontCache lock")
 	, fFontCacheEntries()
+	, fLastConstrainTime(0)
 {
 }
 
@@ -94,6 +95,11 @@ FontCache::FontCacheEntryFor(const ServerFont& font, bool forceVector)
 	return entry.Detach();
 }
 
+static const int32 kMaxEntryCount = 30;
+static const int64 kMaxMemoryUsage = 16 * 1024 * 1024;
+	// limit for the glyphs of all entries together
+static const bigtime_t kConstrainInterval = 1000000;
+
 // Recycle
 void
 FontCache::Recycle(FontCacheEntry* entry)
@@ -103,9 +109,16 @@ FontCache::Recycle(FontCacheEntry* entry)
 		return;
 	entry->UpdateUsage();
 	entry->ReleaseReference();
-}
 
-static const int32 kMaxEntryCount = 30;
+	// Glyphs are added to existing entries all the time, so the memory
+	// limit is also enforced here, but not more often than necessary.
+	if (FontCacheEntry::TotalMemoryUsage() > kMaxMemoryUsage
+		&& system_time() - fLastConstrainTime > kConstrainInterval) {
+		AutoWriteLocker locker(this);
+		if (locker.IsLocked())
+			_ConstrainEntryCount();
+	}
+}
 
 static inline double
 usage_index(uint64 useCount, bigtime_t age)
@@ -118,14 +131,38 @@ void
 FontCache::_ConstrainEntryCount()
 {
 	// this function is only ever called with the WriteLock held
-	if (fFontCacheEntries.Size() < kMaxEntryCount)
-		return;
+	fLastConstrainTime = system_time();
+
+	// Entries that are still in use stay alive until they are released, so
+	// only count what is left in the map for the memory limit.
+	int64 memoryUsage = 0;
+	FontMap::Iterator iterator = fFontCacheEntries.GetIterator();
+	while (iterator.HasNext())
+		memoryUsage += iterator.Next().value->MemoryUsage();
+
+	while (fFontCacheEntries.Size() >= kMaxEntryCount
+		|| (memoryUsage > kMaxMemoryUsage && fFontCacheEntries.Size() > 0)) {
 //printf("FontCache::_ConstrainEntryCount()\n");
+		FontCacheEntry* leastUsedEntry = _LeastUsedEntry();
+		memoryUsage -= leastUsedEntry->MemoryUsage();
+
+		iterator = fFontCacheEntries.GetIterator();
+		while (iterator.HasNext()) {
+			if (iterator.Next().value.Get() == leastUsedEntry) {
+				fFontCacheEntries.Remove(iterator);
+				break;
+			}
+		}
+	}
+}
 
+// _LeastUsedEntry
+FontCacheEntry*
+FontCache::_LeastUsedEntry()
+{
 	FontMap::Iterator iterator = fFontCacheEntries.GetIterator();
 
-	// NOTE: if kMaxEntryCount has a sane value, there has got to be
-	// some entries, so using the iterator like that should be ok
+	// NOTE: the map must not be empty
 	FontCacheEntry* leastUsedEntry = iterator.Next().value;
 	bigtime_t now = system_time();
 	bigtime_t age = now - leastUsedEntry->LastUsed();
@@ -145,11 +182,5 @@ FontCache::_ConstrainEntryCount()
 		}
 	}
 
-	iterator = fFontCacheEntries.GetIterator();
-	while (iterator.HasNext()) {
-		if (iterator.Next().value.Get() == leastUsedEntry) {
-			fFontCacheEntries.Remove(iterator);
-			break;
-		}
-	}
+	return leastUsedEntry;
 }
@@ -30,12 +30,14 @@ class FontCache : public MultiLocker {
 
  private:
 			void				_ConstrainEntryCount();
+			FontCacheEntry*		_LeastUsedEntry();
 
 	static	FontCache			sDefaultInstance;
 
 	typedef HashMap<HashString, BReference<FontCacheEntry> > FontMap;
 
 			FontMap				fFontCacheEntries;
+			bigtime_t			fLastConstrainTime;
 };
 
 #endif // FONT_CACHE_H
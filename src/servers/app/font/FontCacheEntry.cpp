@@ -34,7 +34,6 @@
 
 #include <agg_array.h>
 #include <utf8_functions.h>
-#include <util/OpenHashTable.h>
 
 #include "GlobalSubpixelSettings.h"
 
@@ -42,87 +41,217 @@
 BLocker FontCacheEntry::sUsageUpdateLock("FontCacheEntry usage lock");
 
 
+int64 FontCacheEntry::sTotalMemoryUsage = 0;
+
+
+template<typename Type>
+static inline Type*
+load_published(Type* const* pointer)
+{
+#ifdef B_HAIKU_32_BIT
+	return (Type*)atomic_get((int32*)pointer);
+#else
+	return (Type*)atomic_get64((int64*)pointer);
+#endif
+}
+
+
+template<typename Type>
+static inline void
+publish(Type** pointer, Type* value)
+{
+#ifdef B_HAIKU_32_BIT
+	atomic_set((int32*)pointer, (int32)value);
+#else
+	atomic_set64((int64*)pointer, (int64)value);
+#endif
+}
+
+
+/*!	Stores the glyphs of one FontCacheEntry.
+
+	Glyphs are found through a three level table indexed by the glyph code
+	(plane, page, glyph), which covers every code UTF8ToCharCode() can
+	return. Tables and glyphs are only ever added while the entry is write
+	locked, and are published with atomic stores once they are completely
+	initialized. FindGlyph() therefore needs no lock at all, and a glyph
+	stays valid for as long as the entry exists.
+
+	The glyphs and their rasterized data are packed into large chunks,
+	instead of using two heap allocations per glyph.
+*/
 class FontCacheEntry::GlyphCachePool {
 	// This class needs to be defined before any inline functions, as otherwise
 	// gcc2 will barf in debug mode.
-	struct GlyphHashTableDefinition {
-		typedef uint32		KeyType;
-		typedef	GlyphCache	ValueType;
-
-		size_t HashKey(uint32 key) const
-		{
-			return key;
-		}
-
-		size_t Hash(GlyphCache* value) const
-		{
-			return value->glyph_index;
-		}
+	enum {
+		kPlaneCount		= 32,
+		kTableSize		= 256,
+		kChunkSize		= 16 * 1024,
+		kAlignment		= 8
+	};
 
-		bool Compare(uint32 key, GlyphCache* value) const
-		{
-			return value->glyph_index == key;
-		}
+	typedef GlyphCache* GlyphPage[kTableSize];
+	typedef GlyphPage* PlaneTable[kTableSize];
 
-		GlyphCache*& GetLink(GlyphCache* value) const
-		{
-			return value->hash_link;
-		}
+	struct Chunk {
+		Chunk*	next;
+		size_t	size;
+		size_t	used;
 	};
+
 public:
 	GlyphCachePool()
+		:
+		fChunks(NULL),
+		fMemoryUsage(0)
 	{
+		memset(fPlanes, 0, sizeof(fPlanes));
 	}
 
 	~GlyphCachePool()
 	{
-		GlyphCache* glyph = fGlyphTable.Clear(true);
-		while (glyph != NULL) {
-			GlyphCache* next = glyph->hash_link;
-			delete glyph;
-			glyph = next;
+		for (int32 plane = 0; plane < kPlaneCount; plane++) {
+			if (fPlanes[plane] == NULL)
+				continue;
+			for (int32 page = 0; page < kTableSize; page++)
+				free((*fPlanes[plane])[page]);
+			free(fPlanes[plane]);
 		}
+
+		while (fChunks != NULL) {
+			Chunk* next = fChunks->next;
+			free(fChunks);
+			fChunks = next;
+		}
+
+		atomic_add64(&sTotalMemoryUsage, -(int64)fMemoryUsage);
 	}
 
 	status_t Init()
 	{
-		return fGlyphTable.Init();
+		return B_OK;
 	}
 
-	const GlyphCache* FindGlyph(uint32 glyphIndex) const
+	const GlyphCache* FindGlyph(uint32 glyphCode) const
 	{
-		return fGlyphTable.Lookup(glyphIndex);
+		if (glyphCode >= (uint32)kPlaneCount << 16)
+			return NULL;
+
+		PlaneTable* plane = load_published(&fPlanes[glyphCode >> 16]);
+		if (plane == NULL)
+			return NULL;
+
+		GlyphPage* page = load_published(&(*plane)[(glyphCode >> 8) & 0xff]);
+		if (page == NULL)
+			return NULL;
+
+		return load_published(&(*page)[glyphCode & 0xff]);
 	}
 
-	GlyphCache* CacheGlyph(uint32 glyphIndex,
+	/*!	Allocates a new glyph for \a glyphCode. The glyph is not visible to
+		FindGlyph() until it has been passed to PublishGlyph(), so that its
+		data can still be written.
+	*/
+	GlyphCache* CacheGlyph(uint32 glyphCode,
 		uint32 dataSize, glyph_data_type dataType, const agg::rect_i& bounds,
 		float advanceX, float advanceY, float preciseAdvanceX,
 		float preciseAdvanceY, float insetLeft, float insetRight)
 	{
-		GlyphCache* glyph = fGlyphTable.Lookup(glyphIndex);
-		if (glyph != NULL)
+		if (FindGlyph(glyphCode) != NULL || _Slot(glyphCode) == NULL)
 			return NULL;
 
-		glyph = new(std::nothrow) GlyphCache(glyphIndex, dataSize, dataType,
+		uint8* memory = _Allocate(sizeof(GlyphCache) + dataSize);
+		if (memory == NULL)
+			return NULL;
+
+		uint8* data = dataSize > 0 ? memory + sizeof(GlyphCache) : NULL;
+		return new(memory) GlyphCache(glyphCode, data, dataSize, dataType,
 			bounds, advanceX, advanceY, preciseAdvanceX, preciseAdvanceY,
 			insetLeft, insetRight);
-		if (glyph == NULL || glyph->data == NULL) {
-			delete glyph;
+	}
+
+	void PublishGlyph(GlyphCache* glyph)
+	{
+		// CacheGlyph() already made sure the slot exists
+		publish(_Slot(glyph->glyph_index), glyph);
+	}
+
+	size_t MemoryUsage() const
+	{
+		return fMemoryUsage;
+	}
+
+private:
+	GlyphCache** _Slot(uint32 glyphCode)
+	{
+		if (glyphCode >= (uint32)kPlaneCount << 16)
 			return NULL;
+
+		PlaneTable*& plane = fPlanes[glyphCode >> 16];
+		if (plane == NULL) {
+			PlaneTable* newPlane = (PlaneTable*)calloc(1, sizeof(PlaneTable));
+			if (newPlane == NULL)
+				return NULL;
+			_AccountMemory(sizeof(PlaneTable));
+			publish(&plane, newPlane);
 		}
 
-		// TODO: The HashTable grows without bounds. We should cleanup
-		// older entries from time to time.
+		GlyphPage*& page = (*plane)[(glyphCode >> 8) & 0xff];
+		if (page == NULL) {
+			GlyphPage* newPage = (GlyphPage*)calloc(1, sizeof(GlyphPage));
+			if (newPage == NULL)
+				return NULL;
+			_AccountMemory(sizeof(GlyphPage));
+			publish(&page, newPage);
+		}
 
-		fGlyphTable.Insert(glyph);
+		return &(*page)[glyphCode & 0xff];
+	}
 
-		return glyph;
+	uint8* _Allocate(size_t size)
+	{
+		size = (size + kAlignment - 1) & ~(size_t)(kAlignment - 1);
+		const size_t headerSize = (sizeof(Chunk) + kAlignment - 1)
+			& ~(size_t)(kAlignment - 1);
+
+		if (fChunks == NULL || fChunks->size - fChunks->used < size) {
+			// Large glyphs get a chunk of their own, which is put behind
+			// the current one so that its free space is not lost.
+			size_t chunkSize = size > kChunkSize / 4 ? size : kChunkSize;
+			Chunk* chunk = (Chunk*)malloc(headerSize + chunkSize);
+			if (chunk == NULL)
+				return NULL;
+			_AccountMemory(headerSize + chunkSize);
+
+			chunk->size = chunkSize;
+			chunk->used = 0;
+			if (size > kChunkSize / 4 && fChunks != NULL) {
+				chunk->next = fChunks->next;
+				fChunks->next = chunk;
+			} else {
+				chunk->next = fChunks;
+				fChunks = chunk;
+			}
+
+			chunk->used = size;
+			return (uint8*)chunk + headerSize;
+		}
+
+		uint8* memory = (uint8*)fChunks + headerSize + fChunks->used;
+		fChunks->used += size;
+		return memory;
 	}
 
-private:
-	typedef BOpenHashTable<GlyphHashTableDefinition> GlyphTable;
+	void _AccountMemory(size_t size)
+	{
+		fMemoryUsage += size;
+		atomic_add64(&sTotalMemoryUsage, size);
+	}
 
-	GlyphTable	fGlyphTable;
+private:
+	PlaneTable*	fPlanes[kPlaneCount];
+	Chunk*		fChunks;
+	size_t		fMemoryUsage;
 };
 
 
@@ -276,9 +405,9 @@ render_as_zero_width(uint32 glyphCode)
 
 
 const GlyphCache*
-FontCacheEntry::CachedGlyph(uint32 glyphCode)
+FontCacheEntry::CachedGlyph(uint32 glyphCode) const
 {
-	// Only requires a read lock.
+	// Does not require any lock.
 	return fGlyphCache->FindGlyph(glyphCode);
 }
 
@@ -321,8 +450,11 @@ FontCacheEntry::CreateGlyph(uint32 glyphCode, FontCacheEntry* fallbackEntry)
 	if (glyphIndex == 0) {
 		if (render_as_zero_width(glyphCode)) {
 			// cache and return a zero width glyph
-			return fGlyphCache->CacheGlyph(glyphCode, 0, glyph_data_invalid,
-				agg::rect_i(0, 0, -1, -1), 0, 0, 0, 0, 0, 0);
+			GlyphCache* zeroWidthGlyph = fGlyphCache->CacheGlyph(glyphCode, 0,
+				glyph_data_invalid, agg::rect_i(0, 0, -1, -1), 0, 0, 0, 0, 0, 0);
+			if (zeroWidthGlyph != NULL)
+				fGlyphCache->PublishGlyph(zeroWidthGlyph);
+			return zeroWidthGlyph;
 		}
 
 		// reset to our engine
@@ -334,14 +466,18 @@ FontCacheEntry::CreateGlyph(uint32 glyphCode, FontCacheEntry* fallbackEntry)
 	}
 
 	if (engine->PrepareGlyph(glyphIndex)) {
-		glyph = fGlyphCache->CacheGlyph(glyphCode,
+		GlyphCache* newGlyph = fGlyphCache->CacheGlyph(glyphCode,
 			engine->DataSize(), engine->DataType(), engine->Bounds(),
 			engine->AdvanceX(), engine->AdvanceY(),
 			engine->PreciseAdvanceX(), engine->PreciseAdvanceY(),
 			engine->InsetLeft(), engine->InsetRight());
 
-		if (glyph != NULL)
-			engine->WriteGlyphTo(glyph->data);
+		if (newGlyph != NULL) {
+			if (newGlyph->data != NULL)
+				engine->WriteGlyphTo(newGlyph->data);
+			fGlyphCache->PublishGlyph(newGlyph);
+		}
+		glyph = newGlyph;
 	}
 
 	return glyph;
@@ -388,6 +524,30 @@ FontCacheEntry::GetKerning(uint32 glyphCode1, uint32 glyphCode2,
 }
 
 
+/*!	Widths of short strings are cached, since the same labels are measured
+	over and over again. The glyphs of an entry never change, so neither
+	do the widths.
+*/
+bool
+FontCacheEntry::CachedStringWidth(const char* string, int32 length,
+	uint8 spacing, float* _width)
+{
+	StringWidthKey key;
+	key.spacing = spacing;
+	return fStringWidths.Lookup(key, string, length, *_width);
+}
+
+
+void
+FontCacheEntry::CacheStringWidth(const char* string, int32 length,
+	uint8 spacing, float width)
+{
+	StringWidthKey key;
+	key.spacing = spacing;
+	fStringWidths.Store(key, string, length, width);
+}
+
+
 /*static*/ void
 FontCacheEntry::GenerateSignature(char* signature, size_t signatureSize,
 	const ServerFont& font, bool forceVector)
@@ -420,6 +580,21 @@ FontCacheEntry::UpdateUsage()
 }
 
 
+size_t
+FontCacheEntry::MemoryUsage() const
+{
+	return sizeof(FontCacheEntry)
+		+ (fGlyphCache.IsSet() ? fGlyphCache->MemoryUsage() : 0);
+}
+
+
+/*static*/ int64
+FontCacheEntry::TotalMemoryUsage()
+{
+	return atomic_get64(&sTotalMemoryUsage);
+}
+
+
 /*static*/ glyph_rendering
 FontCacheEntry::_RenderTypeFor(const ServerFont& font, bool forceVector)
 {
@@ -29,6 +29,7 @@
 
 #include <AutoDeleter.h>
 #include <Locker.h>
+#include <StringWidthCache.h>
 
 #include <agg_conv_curve.h>
 #include <agg_conv_contour.h>
@@ -42,13 +43,14 @@
 
 
 struct GlyphCache {
-	GlyphCache(uint32 glyphIndex, uint32 dataSize, glyph_data_type dataType,
-			const agg::rect_i& bounds, float advanceX, float advanceY,
+	GlyphCache(uint32 glyphIndex, uint8* data, uint32 dataSize,
+			glyph_data_type dataType, const agg::rect_i& bounds,
+			float advanceX, float advanceY,
 			float preciseAdvanceX, float preciseAdvanceY,
 			float insetLeft, float insetRight)
 		:
 		glyph_index(glyphIndex),
-		data((uint8*)malloc(dataSize)),
+		data(data),
 		data_size(dataSize),
 		data_type(dataType),
 		bounds(bounds),
@@ -57,18 +59,13 @@ struct GlyphCache {
 		precise_advance_x(preciseAdvanceX),
 		precise_advance_y(preciseAdvanceY),
 		inset_left(insetLeft),
-		inset_right(insetRight),
-		hash_link(NULL)
+		inset_right(insetRight)
 	{
 	}
 
-	~GlyphCache()
-	{
-		free(data);
-	}
-
 	uint32			glyph_index;
 	uint8*			data;
+		// points into the glyph pool of the owning FontCacheEntry
 	uint32			data_size;
 	glyph_data_type	data_type;
 	agg::rect_i		bounds;
@@ -78,8 +75,6 @@ struct GlyphCache {
 	float			precise_advance_y;
 	float			inset_left;
 	float			inset_right;
-
-	GlyphCache*		hash_link;
 };
 
 class FontCache;
@@ -110,7 +105,7 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 			bool				HasGlyphs(const char* utf8String,
 									ssize_t glyphCount) const;
 
-			const GlyphCache*	CachedGlyph(uint32 glyphCode);
+			const GlyphCache*	CachedGlyph(uint32 glyphCode) const;
 			const GlyphCache*	CreateGlyph(uint32 glyphCode,
 									FontCacheEntry* fallbackEntry = NULL);
 			bool				CanCreateGlyph(uint32 glyphCode);
@@ -125,6 +120,12 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 			bool				GetKerning(uint32 glyphCode1,
 									uint32 glyphCode2, double* x, double* y);
 
+			bool				CachedStringWidth(const char* string,
+									int32 length, uint8 spacing,
+									float* _width);
+			void				CacheStringWidth(const char* string,
+									int32 length, uint8 spacing, float width);
+
 	static	void				GenerateSignature(char* signature,
 									size_t signatureSize,
 									const ServerFont& font, bool forceVector);
@@ -135,6 +136,8 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 									{ return fLastUsedTime; }
 			uint64				UsedCount() const
 									{ return fUseCounter; }
+			size_t				MemoryUsage() const;
+	static	int64				TotalMemoryUsage();
 
  private:
 								FontCacheEntry(const FontCacheEntry&);
@@ -145,11 +148,23 @@ class FontCacheEntry : public MultiLocker, public BReferenceable {
 
 			class GlyphCachePool;
 
+			struct StringWidthKey {
+				uint8			spacing;
+
+				uint32 Hash() const
+					{ return spacing; }
+				bool operator==(const StringWidthKey& other) const
+					{ return spacing == other.spacing; }
+			};
+
 			ObjectDeleter<GlyphCachePool>
 								fGlyphCache;
 			FontEngine			fEngine;
+			StringWidthCache<StringWidthKey, 128>
+								fStringWidths;
 
 	static	BLocker				sUsageUpdateLock;
+	static	int64				sTotalMemoryUsage;
 			bigtime_t			fLastUsedTime;
 			uint64				fUseCounter;
 };
@@ -285,9 +285,15 @@ GlyphLayoutEngine::LayoutGlyphs(GlyphConsumer& consumer,
 		if (entry == NULL)
 			return false;
 		pCacheReference->SetTo(entry);
-		if (!pCacheReference->ReadLock())
-			return false;
-	} // else the entry was already used and is still locked
+	} // else the entry was already used and may still be locked
+
+	// Looking up cached glyphs does not need a lock, the entry is only
+	// locked when its font engine has to be used. For kerning, this is
+	// the case for every glyph, missing glyphs are created write locked.
+	if (spacing == B_STRING_SPACING && offsets == NULL
+		&& !pCacheReference->WriteLocked() && !pCacheReference->ReadLock()) {
+		return false;
+	}
 
 	consumer.Start();
 
@@ -379,12 +385,14 @@ GlyphLayoutEngine::_CreateGlyph(FontCacheReference& cacheReference,
 {
 	FontCacheEntry* entry = cacheReference.Entry();
 
-	// Avoid loading the fallbacks if our font can create the glyph.
-	if (entry->CanCreateGlyph(charCode)) {
-		if (cacheReference.WriteLock())
-			return entry->CreateGlyph(charCode);
+	// The font engine may only be used with the entry locked, and the
+	// glyph will need the write lock anyway.
+	if (!cacheReference.WriteLock())
 		return NULL;
-	}
+
+	// Avoid loading the fallbacks if our font can create the glyph.
+	if (entry->CanCreateGlyph(charCode))
+		return entry->CreateGlyph(charCode);
 
 	if (fallbacks.IsEmpty())
 		PopulateFallbacks(fallbacks, font, forceVector);
@@ -216,8 +216,10 @@ EventQueue::Select(int32 object, uint16 type, uint32 events, void* userData)
 	select_event* event = _GetEvent(object, type);
 	if (event != NULL) {
 		if ((event->selected_events | event->behavior)
-				== (USER_EVENTS(events) | B_EVENT_NON_MASKABLE))
+				== (USER_EVENTS(events) | B_EVENT_NON_MASKABLE)) {
+			event->user_data = userData;
 			return B_OK;
+		}
 
 		// Rather than try to reuse the event object, which would be complicated
 		// and error-prone, perform a full de-selection and then re-selection.
@@ -685,7 +687,7 @@ _user_event_queue_select(int queue, event_wait_info* userInfos, int numInfos)
 		}
 
 		if (error != B_OK) {
-			user_memcpy(&userInfos[i].events, &error, sizeof(&userInfos[i].events));
+			user_memcpy(&userInfos[i].events, &error, sizeof(userInfos[i].events));
 			result = B_ERROR;
 		}
 	}
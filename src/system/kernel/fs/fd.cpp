@@ -39,6 +39,7 @@
 
 
 static const size_t kMaxReadDirBufferSize = 64 * 1024;
+static const size_t kSendFileBufferSize = 64 * 1024;
 
 extern object_cache* sFileDescriptorCache;
 
@@ -848,6 +849,113 @@ _user_writev(int fd, off_t pos, const iovec* userVecs, size_t count)
 }
 
 
+/*!	Copies up to \a count bytes from the file \a inFD to \a outFD, usually
+	a socket, without copying the data to userland and back.
+	If \a userOffset is \c NULL, the file is read from its current position,
+	which is then advanced. Otherwise, the file is read from \a userOffset,
+	which is updated, and its position stays unchanged.
+	Returns the number of bytes written, and 0 at the end of the file.
+*/
+ssize_t
+_user_sendfile(int outFD, int inFD, off_t* userOffset, size_t count)
+{
+	off_t offset = -1;
+	if (userOffset != NULL) {
+		if (!IS_USER_ADDRESS(userOffset)
+			|| user_memcpy(&offset, userOffset, sizeof(off_t)) != B_OK) {
+			return B_BAD_ADDRESS;
+		}
+		if (offset < 0)
+			return B_BAD_VALUE;
+	}
+
+	io_context* context = get_current_io_context(false);
+	FileDescriptorPutter input(get_fd(context, inFD));
+	FileDescriptorPutter output(get_fd(context, outFD));
+	if (!input.IsSet() || !output.IsSet())
+		return B_FILE_ERROR;
+
+	if ((input->open_mode & O_RWMASK) == O_WRONLY)
+		return B_FILE_ERROR;
+	// only regular files can be read from, like on other systems
+	if (input->type != FDTYPE_FILE || input->ops->fd_read == NULL)
+		return B_BAD_VALUE;
+	if (output->ops->fd_write == NULL)
+		return B_BAD_VALUE;
+	if ((output->open_mode & O_RWMASK) == O_RDONLY)
+		return B_FILE_ERROR;
+
+	if (count == 0)
+		return 0;
+	if (count > SSIZE_MAX)
+		count = SSIZE_MAX;
+
+	off_t inputPos = offset;
+	if (userOffset == NULL)
+		inputPos = input->pos;
+
+	off_t outputPos = output->pos;
+	bool outputAppend = (output->open_mode & O_APPEND) != 0;
+
+	MemoryDeleter buffer(malloc(min_c(count, kSendFileBufferSize)));
+	if (!buffer.IsSet())
+		return B_NO_MEMORY;
+
+	size_t bufferSize = min_c(count, kSendFileBufferSize);
+	SyscallRestartWrapper<status_t> status;
+	size_t bytesSent = 0;
+
+	{
+		// the buffer is a kernel buffer
+		SyscallFlagUnsetter _;
+
+		while (bytesSent < count) {
+			size_t length = min_c(count - bytesSent, bufferSize);
+			status = input->ops->fd_read(input.Get(), inputPos, buffer.Get(),
+				&length);
+			if (status != B_OK || length == 0)
+				break;
+
+			size_t written = 0;
+			while (written < length) {
+				size_t toWrite = length - written;
+				status = output->ops->fd_write(output.Get(), outputPos,
+					(uint8*)buffer.Get() + written, &toWrite);
+				if (status != B_OK || toWrite == 0)
+					break;
+
+				written += toWrite;
+				if (outputPos != -1)
+					outputPos += toWrite;
+			}
+
+			inputPos += written;
+			bytesSent += written;
+			if (written < length)
+				break;
+		}
+	}
+
+	if (bytesSent == 0 && status != B_OK)
+		return status;
+
+	// once something has been sent, the syscall must not be restarted
+	status = B_OK;
+
+	if (userOffset == NULL)
+		input->pos = inputPos;
+	else if (user_memcpy(userOffset, &inputPos, sizeof(off_t)) != B_OK)
+		return B_BAD_ADDRESS;
+
+	if (output->pos != -1) {
+		output->pos = outputAppend
+			? output->ops->fd_seek(output.Get(), 0, SEEK_END) : outputPos;
+	}
+
+	return bytesSent;
+}
+
+
 off_t
 _user_seek(int fd, off_t pos, int seekType)
 {
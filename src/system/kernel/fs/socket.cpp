@@ -934,8 +934,8 @@ _user_recvfrom(int socket, void *data, size_t length, int flags,
 }
 
 
-ssize_t
-_user_recvmsg(int socket, struct msghdr *userMessage, int flags)
+static ssize_t
+user_recvmsg(int socket, struct msghdr *userMessage, int flags)
 {
 	// copy message from userland
 	msghdr message;
@@ -969,9 +969,7 @@ _user_recvmsg(int socket, struct msghdr *userMessage, int flags)
 	}
 
 	// recvmsg()
-	SyscallRestartWrapper<ssize_t> result;
-
-	result = common_recvmsg(socket, &message, flags, false);
+	ssize_t result = common_recvmsg(socket, &message, flags, false);
 	if (result < 0)
 		return result;
 
@@ -992,6 +990,69 @@ _user_recvmsg(int socket, struct msghdr *userMessage, int flags)
 }
 
 
+ssize_t
+_user_recvmsg(int socket, struct msghdr *userMessage, int flags)
+{
+	SyscallRestartWrapper<ssize_t> result;
+	return result = user_recvmsg(socket, userMessage, flags);
+}
+
+
+/*!	Receives up to \a count messages, and stores the length of each one in
+	its msg_len field. It stops at the first error, which is only reported
+	if no message could be received at all. With MSG_WAITFORONE, only the
+	first message is waited for. The \a timeout is checked after each
+	message only, like on Linux.
+*/
+ssize_t
+_user_recvmmsg(int socket, struct mmsghdr *userMessages, uint32 count,
+	int flags, bigtime_t timeout)
+{
+	if (count == 0)
+		return 0;
+	if (userMessages == NULL)
+		return B_BAD_VALUE;
+	if (count > IOV_MAX)
+		count = IOV_MAX;
+	if (!is_user_address_range(userMessages, count * sizeof(mmsghdr)))
+		return B_BAD_ADDRESS;
+
+	bigtime_t deadline = B_INFINITE_TIMEOUT;
+	if (timeout >= 0 && timeout < B_INFINITE_TIMEOUT - system_time())
+		deadline = system_time() + timeout;
+
+	bool waitForOne = (flags & MSG_WAITFORONE) != 0;
+	flags &= ~MSG_WAITFORONE;
+
+	SyscallRestartWrapper<ssize_t> result;
+
+	uint32 received = 0;
+	while (received < count) {
+		ssize_t bytesReceived = user_recvmsg(socket,
+			&userMessages[received].msg_hdr, flags);
+		if (bytesReceived < 0) {
+			if (received == 0)
+				return result = bytesReceived;
+			break;
+		}
+
+		unsigned int length = bytesReceived;
+		if (user_memcpy(&userMessages[received].msg_len, &length,
+				sizeof(length)) != B_OK) {
+			return result = B_BAD_ADDRESS;
+		}
+
+		received++;
+		if (waitForOne)
+			flags |= MSG_DONTWAIT;
+		if (deadline != B_INFINITE_TIMEOUT && system_time() >= deadline)
+			break;
+	}
+
+	return result = received;
+}
+
+
 ssize_t
 _user_send(int socket, const void *data, size_t length, int flags)
 {
@@ -1034,8 +1095,8 @@ _user_sendto(int socket, const void *data, size_t length, int flags,
 }
 
 
-ssize_t
-_user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
+static ssize_t
+user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
 {
 	// copy message from userland
 	msghdr message;
@@ -1077,10 +1138,57 @@ _user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
 		}
 	}
 
-	// sendmsg()
+	return common_sendmsg(socket, &message, flags, false);
+}
+
+
+ssize_t
+_user_sendmsg(int socket, const struct msghdr *userMessage, int flags)
+{
 	SyscallRestartWrapper<ssize_t> result;
+	return result = user_sendmsg(socket, userMessage, flags);
+}
+
+
+/*!	Sends up to \a count messages, and stores the number of bytes sent for
+	each one in its msg_len field. It stops at the first error, which is only
+	reported if no message could be sent at all.
+*/
+ssize_t
+_user_sendmmsg(int socket, struct mmsghdr *userMessages, uint32 count,
+	int flags)
+{
+	if (count == 0)
+		return 0;
+	if (userMessages == NULL)
+		return B_BAD_VALUE;
+	if (count > IOV_MAX)
+		count = IOV_MAX;
+	if (!is_user_address_range(userMessages, count * sizeof(mmsghdr)))
+		return B_BAD_ADDRESS;
+
+	SyscallRestartWrapper<ssize_t> result;
+
+	uint32 sent = 0;
+	while (sent < count) {
+		ssize_t bytesSent = user_sendmsg(socket, &userMessages[sent].msg_hdr,
+			flags);
+		if (bytesSent < 0) {
+			if (sent == 0)
+				return result = bytesSent;
+			break;
+		}
+
+		unsigned int length = bytesSent;
+		if (user_memcpy(&userMessages[sent].msg_len, &length,
+				sizeof(length)) != B_OK) {
+			return result = B_BAD_ADDRESS;
+		}
+
+		sent++;
+	}
 
-	return result = common_sendmsg(socket, &message, flags, false);
+	return result = sent;
 }
 
 
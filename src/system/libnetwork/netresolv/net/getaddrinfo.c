@@ -76,6 +76,7 @@ __RCSID("$NetBSD: getaddrinfo.c,v 1.119.2.1 2020/11/29 11:25:31 martin Exp $");
 #include <string.h>
 #include <unistd.h>
 #include <ifaddrs.h>
+#include <pthread.h>
 
 #include <syslog.h>
 #include <stdarg.h>
@@ -209,6 +210,7 @@ static const ns_src default_dns_files[] = {
 };
 
 #define MAXPACKET	(64*1024)
+#define MAXRESQUERYN	4	/* targets that are queried in parallel */
 
 typedef union {
 	HEADER hdr;
@@ -2562,6 +2564,127 @@ _yp_getaddrinfo(void *rv, void *cb_data, va_list ap)
 
 /* resolver logic */
 
+/*
+ * Formulate a normal query for a single target, send, and await answer.
+ * Returns the size of the response, or -1 if the query could not be sent.
+ * If the query could not even be formulated, *mkerror is set.
+ */
+static int
+res_queryN_one(const char *name, struct res_target *t, res_state statp,
+    int *mkerror)
+{
+	u_char buf[MAXPACKET];
+	HEADER *hp;
+	int n;
+	u_char *rdata;
+	int class, type;
+	u_char *answer;
+	int anslen;
+	u_int oflags;
+
+	hp = (HEADER *)(void *)t->answer;
+	oflags = statp->_flags;
+	*mkerror = 0;
+
+again:
+	hp->rcode = NOERROR;	/* default */
+
+	/* make it easier... */
+	class = t->qclass;
+	type = t->qtype;
+	answer = t->answer;
+	anslen = t->anslen;
+#ifdef DEBUG
+	if (statp->options & RES_DEBUG)
+		printf(";; res_nquery(%s, %d, %d)\n", name, class, type);
+#endif
+
+	n = res_nmkquery(statp, QUERY, name, class, type, NULL, 0, NULL,
+	    buf, (int)sizeof(buf));
+#ifdef RES_USE_EDNS0
+	if (n > 0 && (statp->_flags & RES_F_EDNS0ERR) == 0 &&
+	    (statp->options & (RES_USE_EDNS0|RES_USE_DNSSEC)) != 0) {
+		n = res_nopt(statp, n, buf, (int)sizeof(buf), anslen);
+		rdata = &buf[n];
+		if (n > 0 && (statp->options & RES_NSID) != 0U) {
+			n = res_nopt_rdata(statp, n, buf,
+			    (int)sizeof(buf),
+			    rdata, NS_OPT_NSID, 0, NULL);
+		}
+	}
+#endif
+	if (n <= 0) {
+#ifdef DEBUG
+		if (statp->options & RES_DEBUG)
+			printf(";; res_nquery: mkquery failed\n");
+#endif
+		*mkerror = 1;
+		return n;
+	}
+	n = res_nsend(statp, buf, n, answer, anslen);
+	if (n < 0) {
+#ifdef RES_USE_EDNS0
+		/* if the query choked with EDNS0, retry without EDNS0 */
+		if ((statp->options & (RES_USE_EDNS0|RES_USE_DNSSEC)) != 0U &&
+		    ((oflags ^ statp->_flags) & RES_F_EDNS0ERR) != 0) {
+			statp->_flags |= RES_F_EDNS0ERR;
+			if (statp->options & RES_DEBUG)
+				printf(";; res_nquery: retry without EDNS0\n");
+			goto again;
+		}
+#endif
+	}
+	return n;
+}
+
+struct res_queryN_job {
+	const char *name;
+	struct res_target *target;
+	res_state statp;
+	pthread_t thread;
+	int started;
+	int n;
+	int mkerror;
+};
+
+static void *
+res_queryN_thread(void *arg)
+{
+	struct res_queryN_job *job = arg;
+
+	job->n = res_queryN_one(job->name, job->target, job->statp,
+	    &job->mkerror);
+	return NULL;
+}
+
+/*
+ * Sends the query for target on a resolver state of its own, so that it can
+ * run in parallel with the other targets.  Returns 0 on success.
+ */
+static int
+res_queryN_start(struct res_queryN_job *job, res_state statp)
+{
+	union res_sockaddr_union servers[MAXNS];
+	int nservers;
+
+	job->statp = __res_get_state();
+	if (job->statp == NULL)
+		return -1;
+
+	nservers = res_getservers(statp, servers, MAXNS);
+	res_setservers(job->statp, servers, nservers);
+	job->statp->options = statp->options;
+	job->statp->retrans = statp->retrans;
+	job->statp->retry = statp->retry;
+
+	if (pthread_create(&job->thread, NULL, res_queryN_thread, job) != 0) {
+		__res_put_state(job->statp);
+		return -1;
+	}
+	job->started = 1;
+	return 0;
+}
+
 /*
  * Formulate a normal query, send, and await answer.
  * Returned answer is placed in supplied buffer "answer".
@@ -2570,90 +2693,68 @@ _yp_getaddrinfo(void *rv, void *cb_data, va_list ap)
  * Return the size of the response on success, -1 on error.
  * Error number is left in h_errno.
  *
+ * When there are several targets (ie. AAAA and A records), all but the first
+ * one are queried in helper threads, so that the answers arrive in the time
+ * of the slowest query rather than the sum of all of them.
+ *
  * Caller must parse answer and determine whether it answers the question.
  */
 static int
 res_queryN(const char *name, /* domain name */ struct res_target *target,
     res_state statp)
 {
-	u_char buf[MAXPACKET];
-	HEADER *hp;
-	int n;
+	struct res_queryN_job jobs[MAXRESQUERYN];
 	struct res_target *t;
+	HEADER *hp;
 	int rcode;
-	u_char *rdata;
 	int ancount;
+	int mkerror;
+	int njobs;
+	int i, n;
 
 	_DIAGASSERT(name != NULL);
 	/* XXX: target may be NULL??? */
 
 	rcode = NOERROR;
 	ancount = 0;
+	mkerror = 0;
+
+	/* keep the debug output in order */
+	njobs = 0;
+	if ((statp->options & RES_DEBUG) == 0) {
+		for (t = target != NULL ? target->next : NULL;
+		    t != NULL && njobs < MAXRESQUERYN; t = t->next) {
+			struct res_queryN_job *job = &jobs[njobs++];
+
+			memset(job, 0, sizeof(*job));
+			job->name = name;
+			job->target = t;
+			if (res_queryN_start(job, statp) != 0)
+				job->statp = NULL;
+		}
+	}
 
+	i = 0;
 	for (t = target; t; t = t->next) {
-		int class, type;
-		u_char *answer;
-		int anslen;
-		u_int oflags;
-
 		hp = (HEADER *)(void *)t->answer;
-		oflags = statp->_flags;
 
-again:
-		hp->rcode = NOERROR;	/* default */
+		if (t != target && i < njobs && jobs[i].target == t) {
+			struct res_queryN_job *job = &jobs[i++];
 
-		/* make it easier... */
-		class = t->qclass;
-		type = t->qtype;
-		answer = t->answer;
-		anslen = t->anslen;
-#ifdef DEBUG
-		if (statp->options & RES_DEBUG)
-			printf(";; res_nquery(%s, %d, %d)\n", name, class, type);
-#endif
+			if (job->started) {
+				pthread_join(job->thread, NULL);
+				__res_put_state(job->statp);
+				n = job->n;
+				if (job->mkerror)
+					mkerror = 1;
+			} else
+				n = res_queryN_one(name, t, statp, &mkerror);
+		} else
+			n = res_queryN_one(name, t, statp, &mkerror);
 
-		n = res_nmkquery(statp, QUERY, name, class, type, NULL, 0, NULL,
-		    buf, (int)sizeof(buf));
-#ifdef RES_USE_EDNS0
-		if (n > 0 && (statp->_flags & RES_F_EDNS0ERR) == 0 &&
-		    (statp->options & (RES_USE_EDNS0|RES_USE_DNSSEC)) != 0) {
-			n = res_nopt(statp, n, buf, (int)sizeof(buf), anslen);
-			rdata = &buf[n];
-			if (n > 0 && (statp->options & RES_NSID) != 0U) {
-				n = res_nopt_rdata(statp, n, buf,
-				    (int)sizeof(buf),
-				    rdata, NS_OPT_NSID, 0, NULL);
-			}
-		}
-#endif
-		if (n <= 0) {
-#ifdef DEBUG
-			if (statp->options & RES_DEBUG)
-				printf(";; res_nquery: mkquery failed\n");
-#endif
-			h_errno = NO_RECOVERY;
-			return n;
-		}
-		n = res_nsend(statp, buf, n, answer, anslen);
-		if (n < 0) {
-#ifdef RES_USE_EDNS0
-			/* if the query choked with EDNS0, retry without EDNS0 */
-			if ((statp->options & (RES_USE_EDNS0|RES_USE_DNSSEC)) != 0U &&
-			    ((oflags ^ statp->_flags) & RES_F_EDNS0ERR) != 0) {
-				statp->_flags |= RES_F_EDNS0ERR;
-				if (statp->options & RES_DEBUG)
-					printf(";; res_nquery: retry without EDNS0\n");
-				goto again;
-			}
-#endif
-#if 0
-#ifdef DEBUG
-			if (statp->options & RES_DEBUG)
-				printf(";; res_query: send error\n");
-#endif
-			h_errno = TRY_AGAIN;
-			return n;
-#endif
+		if (mkerror) {
+			/* still wait for the other queries to finish */
+			continue;
 		}
 
 		if (n < 0 || hp->rcode != NOERROR || ntohs(hp->ancount) == 0) {
@@ -2674,6 +2775,11 @@ again:
 		t->n = n;
 	}
 
+	if (mkerror) {
+		h_errno = NO_RECOVERY;
+		return -1;
+	}
+
 	if (ancount == 0) {
 		switch (rcode) {
 		case NXDOMAIN:
@@ -0,0 +1,377 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*! \file
+ * \brief
+ * Process wide cache of name server answers, used by res_nsend().
+ *
+ * Positive answers are kept for the lowest TTL of their answer records.
+ * Negative answers (NXDOMAIN, or no data) are kept as long as the SOA record
+ * in their authority section allows, as described in RFC 2308; without one,
+ * they are not cached. The TTLs in a cached answer are lowered by the time it
+ * spent in the cache before it is handed out again.
+ *
+ * Answers are only shared between queries sent to the same set of name
+ * servers. The order of the servers does not matter, so that the answers are
+ * still found when the list is rotated.
+ */
+
+#include "port_before.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <netinet/in.h>
+#include <arpa/nameser.h>
+
+#include <ctype.h>
+#include <pthread.h>
+#include <resolv.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+
+#include "port_after.h"
+
+#include "res_private.h"
+
+
+#define CACHE_SIZE			128
+#define MAX_TTL				(24 * 60 * 60)
+#define MAX_NEGATIVE_TTL	(3 * 60 * 60)
+
+
+struct cache_entry {
+	char						name[MAXDNAME];
+	int							type;
+	int							class;
+	union res_sockaddr_union	servers[MAXNS];
+	int							server_count;
+	u_char*						answer;
+	int							length;
+	bigtime_t					added;
+	bigtime_t					expires;
+};
+
+
+static struct cache_entry sCache[CACHE_SIZE];
+static pthread_mutex_t sCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*!	Retrieves the lower-cased name, type, and class of the single question
+	in \a query.
+*/
+static int
+get_question(const u_char* query, int length, char* name, int* type,
+	int* class)
+{
+	const u_char* end = query + length;
+	const u_char* cp;
+	int n;
+
+	if (length < HFIXEDSZ
+		|| ntohs(((const HEADER*)(const void*)query)->qdcount) != 1)
+		return -1;
+
+	cp = query + HFIXEDSZ;
+	n = dn_expand(query, end, cp, name, MAXDNAME);
+	if (n < 0)
+		return -1;
+	cp += n;
+	if (cp + 2 * NS_INT16SZ > end)
+		return -1;
+
+	*type = ns_get16(cp);
+	*class = ns_get16(cp + NS_INT16SZ);
+
+	for (; *name != '\0'; name++)
+		*name = tolower((unsigned char)*name);
+	return 0;
+}
+
+
+static int
+same_server(const union res_sockaddr_union* a,
+	const union res_sockaddr_union* b)
+{
+	if (a->sin.sin_family != b->sin.sin_family)
+		return 0;
+
+	switch (a->sin.sin_family) {
+		case AF_INET:
+			return a->sin.sin_port == b->sin.sin_port
+				&& a->sin.sin_addr.s_addr == b->sin.sin_addr.s_addr;
+		case AF_INET6:
+			return a->sin6.sin6_port == b->sin6.sin6_port
+				&& memcmp(&a->sin6.sin6_addr, &b->sin6.sin6_addr,
+					sizeof(struct in6_addr)) == 0;
+		default:
+			return 1;
+	}
+}
+
+
+static int
+contains_server(const union res_sockaddr_union* servers, int count,
+	const union res_sockaddr_union* server)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (same_server(&servers[i], server))
+			return 1;
+	}
+	return 0;
+}
+
+
+/*!	Returns whether the name server sets \a a and \a b are the same,
+	regardless of their order.
+*/
+static int
+same_servers(const union res_sockaddr_union* a, int aCount,
+	const union res_sockaddr_union* b, int bCount)
+{
+	int i;
+
+	if (aCount != bCount)
+		return 0;
+
+	for (i = 0; i < aCount; i++) {
+		if (!contains_server(b, bCount, &a[i])
+			|| !contains_server(a, aCount, &b[i]))
+			return 0;
+	}
+	return 1;
+}
+
+
+/*!	Returns how many seconds \a answer may be cached, or 0 if it must not be.
+*/
+static u_int32_t
+answer_ttl(const u_char* answer, int length)
+{
+	ns_msg message;
+	ns_rr rr;
+	u_int32_t ttl = MAX_TTL;
+	int count;
+	int i;
+
+	if (ns_initparse(answer, length, &message) < 0
+		|| ns_msg_getflag(message, ns_f_tc))
+		return 0;
+
+	switch (ns_msg_getflag(message, ns_f_rcode)) {
+		case ns_r_noerror:
+			count = ns_msg_count(message, ns_s_an);
+			if (count > 0) {
+				for (i = 0; i < count; i++) {
+					if (ns_parserr(&message, ns_s_an, i, &rr) < 0)
+						return 0;
+					if (ns_rr_ttl(rr) < ttl)
+						ttl = ns_rr_ttl(rr);
+				}
+				return ttl;
+			}
+			// no data
+			break;
+
+		case ns_r_nxdomain:
+			break;
+
+		default:
+			return 0;
+	}
+
+	// negative answers are cached as told by the SOA record
+	count = ns_msg_count(message, ns_s_ns);
+	for (i = 0; i < count; i++) {
+		u_int32_t minimum;
+
+		if (ns_parserr(&message, ns_s_ns, i, &rr) < 0)
+			return 0;
+		if (ns_rr_type(rr) != ns_t_soa || ns_rr_rdlen(rr) < NS_INT32SZ)
+			continue;
+
+		minimum = ns_get32(ns_rr_rdata(rr) + ns_rr_rdlen(rr) - NS_INT32SZ);
+		ttl = min_c(ns_rr_ttl(rr), minimum);
+		return min_c(ttl, MAX_NEGATIVE_TTL);
+	}
+
+	return 0;
+}
+
+
+/*!	Lowers the TTLs of the answer and authority records in \a answer by
+	\a elapsed seconds.
+*/
+static void
+age_answer(u_char* answer, int length, u_int32_t elapsed)
+{
+	ns_msg message;
+	ns_rr rr;
+	ns_sect section;
+	int i;
+
+	if (elapsed == 0 || ns_initparse(answer, length, &message) < 0)
+		return;
+
+	for (section = ns_s_an; section <= ns_s_ns; section++) {
+		int count = ns_msg_count(message, section);
+		for (i = 0; i < count; i++) {
+			u_char* ttl;
+
+			if (ns_parserr(&message, section, i, &rr) < 0)
+				return;
+
+			// the TTL directly precedes the length of the data
+			ttl = (u_char*)ns_rr_rdata(rr) - NS_INT16SZ - NS_INT32SZ;
+			ns_put32(ns_rr_ttl(rr) > elapsed ? ns_rr_ttl(rr) - elapsed : 0,
+				ttl);
+		}
+	}
+}
+
+
+static void
+free_entry(struct cache_entry* entry)
+{
+	free(entry->answer);
+	entry->answer = NULL;
+	entry->expires = 0;
+}
+
+
+static struct cache_entry*
+find_entry(const char* name, int type, int class,
+	const union res_sockaddr_union* servers, int serverCount)
+{
+	int i;
+
+	for (i = 0; i < CACHE_SIZE; i++) {
+		struct cache_entry* entry = &sCache[i];
+		if (entry->answer != NULL && entry->type == type
+			&& entry->class == class && strcmp(entry->name, name) == 0
+			&& same_servers(entry->servers, entry->server_count, servers,
+				serverCount))
+			return entry;
+	}
+	return NULL;
+}
+
+
+/*!	Copies the cached answer of the name servers \a servers to \a query
+	into \a answer.
+	Returns the length of the answer, or -1 if there is none.
+*/
+int
+__res_cache_lookup(const union res_sockaddr_union* servers, int serverCount,
+	const u_char* query, int queryLength, u_char* answer, int answerSize)
+{
+	struct cache_entry* entry;
+	char name[MAXDNAME];
+	int type, class;
+	int length = -1;
+	bigtime_t now;
+
+	if (serverCount > MAXNS
+		|| get_question(query, queryLength, name, &type, &class) < 0)
+		return -1;
+
+	now = system_time();
+
+	pthread_mutex_lock(&sCacheLock);
+
+	entry = find_entry(name, type, class, servers, serverCount);
+	if (entry != NULL && entry->expires <= now) {
+		free_entry(entry);
+		entry = NULL;
+	}
+	if (entry != NULL && entry->length <= answerSize) {
+		length = entry->length;
+		memcpy(answer, entry->answer, length);
+		age_answer(answer, length, (now - entry->added) / 1000000);
+
+		// the answer has to match the ID of the query
+		((HEADER*)(void*)answer)->id = ((const HEADER*)(const void*)query)->id;
+	}
+
+	pthread_mutex_unlock(&sCacheLock);
+	return length;
+}
+
+
+/*!	Stores the \a answer of the name servers \a servers to \a query, if it
+	may be cached.
+*/
+void
+__res_cache_add(const union res_sockaddr_union* servers, int serverCount,
+	const u_char* query, int queryLength, const u_char* answer,
+	int answerLength)
+{
+	struct cache_entry* entry;
+	char name[MAXDNAME];
+	int type, class;
+	u_int32_t ttl;
+	u_char* copy;
+	bigtime_t now;
+	int i;
+
+	if (serverCount > MAXNS
+		|| get_question(query, queryLength, name, &type, &class) < 0)
+		return;
+
+	ttl = answer_ttl(answer, answerLength);
+	if (ttl == 0)
+		return;
+
+	copy = malloc(answerLength);
+	if (copy == NULL)
+		return;
+	memcpy(copy, answer, answerLength);
+
+	now = system_time();
+
+	pthread_mutex_lock(&sCacheLock);
+
+	// replace an older answer, or else the entry that expires first
+	entry = find_entry(name, type, class, servers, serverCount);
+	if (entry == NULL) {
+		entry = &sCache[0];
+		for (i = 0; i < CACHE_SIZE && entry->answer != NULL; i++) {
+			if (sCache[i].answer == NULL
+				|| sCache[i].expires < entry->expires)
+				entry = &sCache[i];
+		}
+	}
+	free_entry(entry);
+
+	strlcpy(entry->name, name, sizeof(entry->name));
+	entry->type = type;
+	entry->class = class;
+	memcpy(entry->servers, servers, serverCount * sizeof(servers[0]));
+	entry->server_count = serverCount;
+	entry->answer = copy;
+	entry->length = answerLength;
+	entry->added = now;
+	entry->expires = now + (bigtime_t)ttl * 1000000;
+
+	pthread_mutex_unlock(&sCacheLock);
+}
+
+
+/*!	Removes all answers from the cache.
+*/
+void
+__res_cache_flush(void)
+{
+	int i;
+
+	pthread_mutex_lock(&sCacheLock);
+	for (i = 0; i < CACHE_SIZE; i++)
+		free_entry(&sCache[i]);
+	pthread_mutex_unlock(&sCacheLock);
+}
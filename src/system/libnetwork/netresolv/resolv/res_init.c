@@ -618,6 +618,8 @@ res_setoptions(res_state statp, const char *options, const char *source)
 #endif
 		} else if (!strncmp(cp, "rotate", sizeof("rotate") - 1)) {
 			statp->options |= RES_ROTATE;
+		} else if (!strncmp(cp, "no-cache", sizeof("no-cache") - 1)) {
+			statp->options |= RES_NOCACHE;
 		} else if (!strncmp(cp, "no-check-names",
 				    sizeof("no-check-names") - 1)) {
 			statp->options |= RES_NOCHECKNAME;
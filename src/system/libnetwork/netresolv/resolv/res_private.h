@@ -21,6 +21,12 @@ struct __res_state_ext {
 extern int res_ourserver_p(const res_state, const struct sockaddr *);
 extern int __res_vinit(res_state, int);
 
+extern int __res_cache_lookup(const union res_sockaddr_union *, int,
+    const u_char *, int, u_char *, int);
+extern void __res_cache_add(const union res_sockaddr_union *, int,
+    const u_char *, int, const u_char *, int);
+extern void __res_cache_flush(void);
+
 #endif
 
 /*! \file */
@@ -409,6 +409,21 @@ res_nsend(res_state statp,
 		EXT(statp).nscount = statp->nscount;
 	}
 
+	/*
+	 * Answer from the cache, if we can.  Answers are cached per set of
+	 * name servers, regardless of their order.
+	 */
+	if ((statp->options & RES_NOCACHE) == 0U) {
+		resplen = __res_cache_lookup(EXT(statp).ext->nsaddrs,
+		    statp->nscount, buf, buflen, ans, anssiz);
+		if (resplen >= 0) {
+#ifdef USE_KQUEUE
+			close(kq);
+#endif
+			return (resplen);
+		}
+	}
+
 	/*
 	 * Some resolvers want to even out the load on their nameservers.
 	 * Note that RES_BLAST overrides RES_ROTATE.
@@ -571,6 +586,9 @@ res_nsend(res_state statp,
 #ifdef USE_KQUEUE
 		close(kq);
 #endif
+		if ((statp->options & RES_NOCACHE) == 0U && resplen <= anssiz)
+			__res_cache_add(EXT(statp).ext->nsaddrs,
+			    statp->nscount, buf, buflen, ans, resplen);
 		return (resplen);
  next_ns: ;
 	   } /*foreach ns*/
@@ -1,5 +1,6 @@
 /*
  * Copyright 2007, Ingo Weinhold, bonefish@cs.tu-berlin.de. All rights reserved.
+ * Copyright 2026, Haiku, Inc. All rights reserved.
  * Distributed under the terms of the MIT License.
  */
 
@@ -21,3 +22,25 @@ wait_for_objects_etc(object_wait_info* infos, int numInfos, uint32 flags,
 {
 	return _kern_wait_for_objects(infos, numInfos, flags, timeout);
 }
+
+
+int
+create_event_queue(uint32 openFlags)
+{
+	return _kern_event_queue_create(openFlags);
+}
+
+
+status_t
+event_queue_select(int queue, event_wait_info* infos, int numInfos)
+{
+	return _kern_event_queue_select(queue, infos, numInfos);
+}
+
+
+ssize_t
+event_queue_wait(int queue, event_wait_info* infos, int numInfos,
+	uint32 flags, bigtime_t timeout)
+{
+	return _kern_event_queue_wait(queue, infos, numInfos, flags, timeout);
+}
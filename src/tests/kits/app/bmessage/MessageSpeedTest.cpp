@@ -10,14 +10,22 @@
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include <Entry.h>
 #include <File.h>
 #include <Message.h>
+#include <Messenger.h>
+#include <MessagePrivate.h>
+#include <OS.h>
+#include <Point.h>
 #include <String.h>
+#include <TestShell.h>
+#include <TestUtils.h>
 
 #include "MessageSpeedTest.h"
+#include "MessageSpeedTestTarget.h"
 
 
 using namespace std;
@@ -35,6 +43,61 @@ using namespace std;
 #define LOG(function, time) /* empty */
 #endif
 
+// messages are never passed by area with libbe_test
+#ifdef HAIKU_TARGET_PLATFORM_LIBBE_TEST
+static const bool kPassByArea = false;
+#else
+static const bool kPassByArea = true;
+#endif
+
+
+/*!	Runs MessageSpeedTestTarget in a team of its own. Messages to a looper
+	of the same team are handed over directly, so they would not measure the
+	actual message transport.
+*/
+class RemoteTarget {
+public:
+	RemoteTarget()
+	{
+		static int32 sID = 0;
+		BString portName("MessageSpeedTestTarget");
+		portName << atomic_add(&sID, 1);
+		fPort = create_port(1, portName.String());
+		CHK(fPort >= 0);
+
+		BString command(BTestShell::GlobalTestDir());
+		command.CharacterEscape(" \t\n!\"'`$&()?*+{}[]<>|", '\\');
+		command << "/MessageSpeedTestTarget " << portName << " &";
+		system(command.String());
+
+		mstt_init init;
+		int32 code;
+		CHK(read_port_etc(fPort, &code, &init, sizeof(init), B_RELATIVE_TIMEOUT,
+			10000000) == sizeof(init));
+		CHK(code == MSTT_INIT);
+		fTarget = init.messenger;
+
+		thread_info info;
+		get_thread_info(find_thread(NULL), &info);
+		CHK(fTarget.Team() != info.team);
+	}
+
+	~RemoteTarget()
+	{
+		fTarget.SendMessage(B_QUIT_REQUESTED);
+		delete_port(fPort);
+	}
+
+	BMessenger Messenger() const
+	{
+		return fTarget;
+	}
+
+private:
+	port_id		fPort;
+	BMessenger	fTarget;
+};
+
 
 #define MESSAGE_SPEED_TEST_CREATE(count, type, typeName, createValue)		\
 void																		\
@@ -309,6 +372,109 @@ MESSAGE_SPEED_TEST_UNFLATTEN_INDIVIDUAL(5000, String, "BString");
 #undef MESSAGE_SPEED_TEST_UNFLATTEN_INDIVIDUAL
 
 
+#define MESSAGE_SPEED_TEST_SMALL(count)										\
+void																		\
+TMessageSpeedTest::MessageSpeedTestSmall##count()							\
+{																			\
+	bigtime_t stamp = real_time_clock_usecs();								\
+	for (int32 i = 0; i < count; i++) {										\
+		BMessage message('smal');											\
+		message.AddInt32("index", i);										\
+		message.AddString("name", "item");									\
+		message.AddPoint("where", BPoint(i, i));							\
+																			\
+		int32 value;														\
+		message.FindInt32("index", &value);									\
+		BPoint point;														\
+		message.FindPoint("where", &point);									\
+	}																		\
+	bigtime_t length = real_time_clock_usecs() - stamp;						\
+																			\
+	cout << "Time to create, fill and query " << count						\
+		<< " small messages = " << length << "usec. Giving "				\
+		<< length / count << "usec per message." << endl;					\
+	LOG(__PRETTY_FUNCTION__, length);										\
+}
+
+MESSAGE_SPEED_TEST_SMALL(5000);
+MESSAGE_SPEED_TEST_SMALL(50000);
+
+#undef MESSAGE_SPEED_TEST_SMALL
+
+
+#define MESSAGE_SPEED_TEST_SEND(count, items)								\
+void																		\
+TMessageSpeedTest::MessageSpeedTestSend##count##x##items()					\
+{																			\
+	RemoteTarget remote;													\
+	BMessenger target = remote.Messenger();									\
+																			\
+	BMessage message(MSTT_SEND);											\
+	for (int32 i = 0; i < items; i++)										\
+		message.AddInt32("data", i);										\
+																			\
+	bigtime_t stamp = real_time_clock_usecs();								\
+	for (int32 i = 0; i < count; i++) {										\
+		BMessage reply;														\
+		CHK(target.SendMessage(&message, &reply) == B_OK);					\
+		CHK(reply.what == MSTT_SEND);										\
+	}																		\
+	bigtime_t length = real_time_clock_usecs() - stamp;						\
+																			\
+	cout << "Time to send " << count << " messages containing " << items	\
+		<< " int32 and wait for the reply = " << length << "usec. Giving "	\
+		<< length / count << "usec per round trip." << endl;				\
+	LOG(__PRETTY_FUNCTION__, length);										\
+}
+
+MESSAGE_SPEED_TEST_SEND(1000, 5);
+MESSAGE_SPEED_TEST_SEND(1000, 500);
+MESSAGE_SPEED_TEST_SEND(100, 50000);
+
+#undef MESSAGE_SPEED_TEST_SEND
+
+
+#define MESSAGE_SPEED_TEST_THROUGHPUT(count, size, sizeName)				\
+void																		\
+TMessageSpeedTest::MessageSpeedTestThroughput##sizeName()					\
+{																			\
+	RemoteTarget remote;													\
+	BMessenger target = remote.Messenger();									\
+																			\
+	char* buffer = (char*)malloc(size);										\
+	memset(buffer, 'x', size);												\
+	BMessage message(MSTT_THROUGHPUT);										\
+	message.AddData("data", B_RAW_TYPE, buffer, size);						\
+	free(buffer);															\
+																			\
+	bigtime_t stamp = real_time_clock_usecs();								\
+	for (int32 i = 0; i < count; i++)										\
+		CHK(target.SendMessage(&message) == B_OK);							\
+																			\
+	/* wait until the target has processed all messages */					\
+	BMessage reply;															\
+	CHK(target.SendMessage(MSTT_SYNC, &reply) == B_OK);						\
+	bigtime_t length = real_time_clock_usecs() - stamp;						\
+																			\
+	CHK(reply.GetInt32("received", 0) == count);							\
+	int32 byArea = reply.GetInt32("received by area", 0);					\
+	CHK(byArea == (kPassByArea && size > MESSAGE_AREA_THRESHOLD				\
+		? count : 0));														\
+																			\
+	cout << "Time to send " << count << " messages of " << #sizeName		\
+		<< (byArea > 0 ? " by area" : " through the port")					\
+		<< " = " << length << "usec. Giving "								\
+		<< (double)count * size / max_c(length, 1) << "MB/s." << endl;		\
+	LOG(__PRETTY_FUNCTION__, length);										\
+}
+
+MESSAGE_SPEED_TEST_THROUGHPUT(10000, 1024, 1kB);
+MESSAGE_SPEED_TEST_THROUGHPUT(1000, 64 * 1024, 64kB);
+MESSAGE_SPEED_TEST_THROUGHPUT(50, 4 * 1024 * 1024, 4MB);
+
+#undef MESSAGE_SPEED_TEST_THROUGHPUT
+
+
 TestSuite* TMessageSpeedTest::Suite()
 {
 	TestSuite* suite = new TestSuite("BMessage::Test of Performance");
@@ -378,5 +544,16 @@ TestSuite* TMessageSpeedTest::Suite()
 	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestUnflattenIndividual500String);	
 	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestUnflattenIndividual5000String);	
 
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestSmall5000);
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestSmall50000);
+
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestSend1000x5);
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestSend1000x500);
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestSend100x50000);
+
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestThroughput1kB);
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestThroughput64kB);
+	ADD_TEST4(BMessage, suite, TMessageSpeedTest, MessageSpeedTestThroughput4MB);
+
 	return suite;
 }
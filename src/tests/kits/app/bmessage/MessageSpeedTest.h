@@ -85,6 +85,17 @@ public:
 		void		MessageSpeedTestUnflattenIndividual500String();
 		void		MessageSpeedTestUnflattenIndividual5000String();
 
+		void		MessageSpeedTestSmall5000();
+		void		MessageSpeedTestSmall50000();
+
+		void		MessageSpeedTestSend1000x5();
+		void		MessageSpeedTestSend1000x500();
+		void		MessageSpeedTestSend100x50000();
+
+		void		MessageSpeedTestThroughput1kB();
+		void		MessageSpeedTestThroughput64kB();
+		void		MessageSpeedTestThroughput4MB();
+
 static	TestSuite	*Suite();
 };
 
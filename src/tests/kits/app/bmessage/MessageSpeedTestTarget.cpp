@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Message target for TMessageSpeedTest, run in a team of its own, so that
+	messages sent to it go through its port rather than being handed over
+	directly, as it happens within the same team.
+
+	Usage: MessageSpeedTestTarget <port name>
+*/
+
+
+#include <stdio.h>
+
+#include <Looper.h>
+#include <Message.h>
+#include <OS.h>
+
+#include <MessagePrivate.h>
+
+#include "MessageSpeedTestTarget.h"
+
+
+class TargetLooper : public BLooper {
+public:
+	TargetLooper()
+		:
+		BLooper("speed test target"),
+		fReceived(0),
+		fReceivedByArea(0)
+	{
+	}
+
+	virtual void MessageReceived(BMessage* message)
+	{
+		switch (message->what) {
+			case MSTT_SEND:
+				message->SendReply(MSTT_SEND);
+				break;
+
+			case MSTT_THROUGHPUT:
+			{
+				// a message passed by area still refers to it
+				BMessage::Private messagePrivate(message);
+				if (messagePrivate.GetMessageHeader()->message_area >= 0)
+					fReceivedByArea++;
+				fReceived++;
+				break;
+			}
+
+			case MSTT_SYNC:
+			{
+				BMessage reply(MSTT_SYNC);
+				reply.AddInt32("received", fReceived);
+				reply.AddInt32("received by area", fReceivedByArea);
+				message->SendReply(&reply);
+
+				fReceived = 0;
+				fReceivedByArea = 0;
+				break;
+			}
+
+			default:
+				BLooper::MessageReceived(message);
+				break;
+		}
+	}
+
+private:
+	int32	fReceived;
+	int32	fReceivedByArea;
+};
+
+
+int
+main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <port name>\n", argv[0]);
+		return 1;
+	}
+
+	port_id port = find_port(argv[1]);
+	if (port < 0) {
+		fprintf(stderr, "%s: could not find port \"%s\"\n", argv[0], argv[1]);
+		return 1;
+	}
+
+	TargetLooper* looper = new TargetLooper;
+	thread_id thread = looper->Run();
+
+	mstt_init init;
+	init.messenger = BMessenger(NULL, looper);
+	if (write_port(port, MSTT_INIT, &init, sizeof(init)) != B_OK) {
+		looper->Lock();
+		looper->Quit();
+		return 1;
+	}
+
+	// the test tells the looper to quit when it is done
+	status_t result;
+	wait_for_thread(thread, &result);
+	return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef MESSAGE_SPEED_TEST_TARGET_H
+#define MESSAGE_SPEED_TEST_TARGET_H
+
+
+#include <Messenger.h>
+
+
+enum {
+	MSTT_INIT		= 'init',
+
+	MSTT_SEND		= 'send',
+	MSTT_THROUGHPUT	= 'thru',
+	MSTT_SYNC		= 'sync'
+};
+
+
+struct mstt_init {
+	BMessenger	messenger;
+};
+
+
+#endif	// MESSAGE_SPEED_TEST_TARGET_H
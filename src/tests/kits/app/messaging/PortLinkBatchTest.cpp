@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Reports how many link messages LinkSender puts into a port message,
+	once for drawing commands that come in a burst, and once for commands
+	that come in slowly, as well as the number of port messages per frame.
+
+	Usage: PortLinkBatchTest [frames] [commands per frame]
+*/
+
+
+#include <PortLink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OS.h>
+
+
+static const int32 kDrawCode = 'draw';
+static const int32 kQuitCode = 'quit';
+
+static const int32 kPacedFrames = 20;
+static const int32 kPacedCount = 50;
+static const bigtime_t kPacedDelay = 3000;
+
+struct draw_command {
+	float	left;
+	float	top;
+	float	right;
+	float	bottom;
+};
+
+
+static status_t
+receiver_thread(void* data)
+{
+	BPrivate::PortLink receiver(-1, (port_id)(addr_t)data);
+	int32 received = 0;
+
+	while (true) {
+		int32 code;
+		if (receiver.GetNextMessage(code) != B_OK)
+			return -1;
+		if (code == kQuitCode)
+			return received;
+
+		draw_command command;
+		if (code != kDrawCode || receiver.Read(&command) != B_OK)
+			return -1;
+		received++;
+	}
+}
+
+
+static status_t
+send_command(BPrivate::PortLink& sender, int32 index)
+{
+	draw_command command = { (float)index, 0, (float)index + 10, 10 };
+	sender.StartMessage(kDrawCode);
+	return sender.Attach(command);
+}
+
+
+/*!	Sends \a frames frames of \a count commands each, and flushes at the
+	end of every frame, like a window does when it is done drawing. With a
+	\a delay, the commands are sent that much time apart.
+*/
+static bool
+run(BPrivate::PortLink& link, const char* name, int32 frames, int32 count,
+	bigtime_t delay)
+{
+	BPrivate::LinkSender& sender = link.Sender();
+	uint32 messageCount = sender.MessageCount();
+	uint32 flushCount = sender.FlushCount();
+
+	bigtime_t start = system_time();
+	for (int32 frame = 0; frame < frames; frame++) {
+		for (int32 i = 0; i < count; i++) {
+			if (send_command(link, i) != B_OK) {
+				fprintf(stderr, "%s: sending command failed!\n", name);
+				return false;
+			}
+			if (delay > 0)
+				snooze(delay);
+		}
+		if (link.Flush() != B_OK) {
+			fprintf(stderr, "%s: flushing failed!\n", name);
+			return false;
+		}
+	}
+	bigtime_t time = system_time() - start;
+
+	messageCount = sender.MessageCount() - messageCount;
+	flushCount = sender.FlushCount() - flushCount;
+
+	printf("%-8s %8" B_PRIu32 " messages in %6" B_PRIu32 " port messages: "
+		"%6.1f per port message, %5.1f port messages per frame, "
+		"%9.0f messages/s\n", name, messageCount, flushCount,
+		(double)messageCount / flushCount, (double)flushCount / frames,
+		messageCount * 1000000.0 / time);
+	return true;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 frames = 1000;
+	if (argc > 1)
+		frames = atol(argv[1]);
+	int32 count = 500;
+	if (argc > 2)
+		count = atol(argv[2]);
+
+	port_id port = create_port(100, "portlink batch");
+	if (port < 0) {
+		fprintf(stderr, "creating port failed: %s!\n", strerror(port));
+		return -1;
+	}
+
+	thread_id thread = spawn_thread(receiver_thread, "receiver",
+		B_NORMAL_PRIORITY, (void*)(addr_t)port);
+	resume_thread(thread);
+
+	BPrivate::PortLink sender(port, -1);
+
+	if (!run(sender, "burst", frames, count, 0)
+		|| !run(sender, "paced", kPacedFrames, kPacedCount, kPacedDelay))
+		return -1;
+
+	sender.StartMessage(kQuitCode);
+	sender.Flush();
+
+	status_t received;
+	wait_for_thread(thread, &received);
+	delete_port(port);
+
+	uint32 sent = sender.Sender().MessageCount() - 1;
+	if (received < 0 || (uint32)received != sent) {
+		fprintf(stderr, "received %" B_PRId32 " of %" B_PRIu32 " messages!\n",
+			received, sent);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Times adding many rows to a BColumnListView, and finding rows by position
+	and the positions of rows, as done for drawing, mouse clicks, and
+	keyboard navigation.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <ColumnListView.h>
+#include <ColumnTypes.h>
+#include <OS.h>
+#include <String.h>
+#include <Window.h>
+
+
+static const int32 kLookupCount = 10000;
+
+
+static void
+print_result(const char* name, bigtime_t time, int32 count)
+{
+	printf("  %-32s %12.1f us\n", name, (double)time / count);
+}
+
+
+static void
+run_benchmark(int32 rowCount, bool tree)
+{
+	BWindow* window = new BWindow(BRect(100, 100, 699, 499), "Benchmark",
+		B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+	BColumnListView* listView = new BColumnListView(window->Bounds(), "list",
+		B_FOLLOW_ALL, B_WILL_DRAW);
+	listView->AddColumn(new BStringColumn("Name", 200, 50, 500,
+		B_TRUNCATE_END), 0);
+	listView->SetSortingEnabled(false);
+	window->AddChild(listView);
+	window->Lock();
+
+	printf("%" B_PRId32 " rows, %s:\n", rowCount, tree ? "tree" : "flat");
+
+	// in the tree, every 10th row is an expanded parent of the next nine
+	BRow** rows = new BRow*[rowCount];
+	BRow* parent = NULL;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < rowCount; i++) {
+		BRow* row = new BRow();
+		BString name;
+		name.SetToFormat("Row %" B_PRId32, i);
+		row->SetField(new BStringField(name), 0);
+
+		if (tree && i % 10 != 0)
+			listView->AddRow(row, parent);
+		else {
+			listView->AddRow(row);
+			if (tree) {
+				parent = row;
+				listView->ExpandOrCollapse(parent, true);
+			}
+		}
+		rows[i] = row;
+	}
+	print_result("Add row", system_time() - start, rowCount);
+
+	BRect rect;
+	listView->GetRowRect(rows[rowCount - 1], &rect);
+	float height = rect.bottom;
+
+	srand(1);
+	start = system_time();
+	for (int32 i = 0; i < kLookupCount; i++)
+		listView->RowAt(BPoint(10, rand() % (int32)height));
+	print_result("Row at point", system_time() - start, kLookupCount);
+
+	start = system_time();
+	for (int32 i = 0; i < kLookupCount; i++)
+		listView->GetRowRect(rows[rand() % rowCount], &rect);
+	print_result("Row rect", system_time() - start, kLookupCount);
+
+	start = system_time();
+	for (int32 i = 0; i < 100; i++)
+		listView->ScrollTo(rows[rand() % rowCount]);
+	print_result("Scroll to row", system_time() - start, 100);
+
+	// removing a row changes the position of all rows below it
+	start = system_time();
+	for (int32 i = 0; i < 100; i++) {
+		int32 index = rand() % rowCount;
+		if (rows[index] == NULL || (tree && index % 10 == 0))
+			continue;
+
+		listView->RemoveRow(rows[index]);
+		delete rows[index];
+		rows[index] = NULL;
+		listView->RowAt(BPoint(10, rand() % (int32)height));
+	}
+	print_result("Remove row and find row", system_time() - start, 100);
+
+	delete[] rows;
+	window->Quit();
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// the row counts can be given, the default is 10000 and 100000
+	int32 counts[16] = { 10000, 100000 };
+	int32 countCount = 2;
+	if (argc > 1) {
+		countCount = 0;
+		for (int32 i = 1; i < argc && countCount < 16; i++)
+			counts[countCount++] = atol(argv[i]);
+	}
+
+	BApplication app("application/x-vnd.Haiku-ColumnListViewBenchmark");
+
+	for (int32 i = 0; i < countCount; i++) {
+		run_benchmark(counts[i], false);
+		run_benchmark(counts[i], true);
+	}
+
+	return 0;
+}
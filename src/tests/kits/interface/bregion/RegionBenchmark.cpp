@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Times the BRegion operations that dominate rebuilding the clipping of
+	windows and views in the app_server.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OS.h>
+#include <Region.h>
+
+
+static const int32 kRounds = 2000;
+
+
+static void
+print_result(const char* name, bigtime_t time, int32 rounds)
+{
+	printf("%-40s %10.3f us\n", name, (double)time / rounds);
+}
+
+
+static void
+build_random_region(BRegion& region, int32 count)
+{
+	srand(42);
+	for (int32 i = 0; i < count; i++) {
+		int32 x = rand() % 1200;
+		int32 y = rand() % 900;
+		region.Include(BRect(x, y, x + rand() % 200, y + rand() % 200));
+	}
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 checksum = 0;
+
+	bigtime_t start = system_time();
+	for (int32 round = 0; round < kRounds; round++) {
+		// many small sorted rects, like a view with lots of children
+		BRegion region;
+		for (int32 y = 0; y < 1024; y += 32) {
+			for (int32 x = (y / 32 % 2) * 32; x < 1280; x += 64)
+				region.Include(BRect(x, y, x + 31, y + 31));
+		}
+		checksum += region.CountRects();
+	}
+	print_result("Build checkerboard", system_time() - start, kRounds);
+
+	BRegion random;
+	build_random_region(random, 300);
+	printf("Random region has %" B_PRId32 " rects\n", random.CountRects());
+
+	BRegion clipRect(BRect(100, 100, 700, 600));
+	start = system_time();
+	for (int32 round = 0; round < kRounds; round++) {
+		BRegion region(random);
+		region.IntersectWith(&clipRect);
+		checksum += region.CountRects();
+	}
+	print_result("Copy, intersect with rect", system_time() - start,
+		kRounds);
+
+	start = system_time();
+	for (int32 round = 0; round < kRounds; round++) {
+		BRegion region(random);
+		region.Exclude(BRect(2000, 2000, 2100, 2100));
+		region.Include(BRect(300, 300, 300, 300));
+		checksum += region.CountRects();
+	}
+	print_result("Copy, include/exclude without effect",
+		system_time() - start, kRounds);
+
+	start = system_time();
+	for (int32 round = 0; round < kRounds; round++) {
+		BRegion region(random);
+		region.Exclude(BRect(500, 500, 600, 600));
+		checksum += region.CountRects();
+	}
+	print_result("Copy, exclude rect", system_time() - start, kRounds);
+
+	start = system_time();
+	for (int32 round = 0; round < kRounds * 100; round++)
+		checksum += random.Contains(rand() % 1300, rand() % 1100);
+	print_result("Contains point", system_time() - start, kRounds * 100);
+
+	start = system_time();
+	for (int32 round = 0; round < kRounds * 100; round++) {
+		int32 x = rand() % 1300;
+		int32 y = rand() % 1100;
+		checksum += random.Intersects(BRect(x, y, x + 20, y + 20));
+	}
+	print_result("Intersects rect", system_time() - start, kRounds * 100);
+
+	printf("(checksum %" B_PRId32 ")\n", checksum);
+	return 0;
+}
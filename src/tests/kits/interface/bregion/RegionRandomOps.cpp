@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "RegionRandomOps.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <Region.h>
+
+
+static const int32 kGridSize = 48;
+static const int32 kIterations = 20000;
+
+
+struct PixelGrid {
+	bool	pixels[kGridSize][kGridSize];
+
+	void SetTo(const BRegion& region)
+	{
+		for (int32 y = 0; y < kGridSize; y++) {
+			for (int32 x = 0; x < kGridSize; x++)
+				pixels[y][x] = region.Contains(x, y);
+		}
+	}
+
+	void Fill(const clipping_rect& rect, bool value)
+	{
+		for (int32 y = max_c(rect.top, 0);
+				y <= min_c(rect.bottom, kGridSize - 1); y++) {
+			for (int32 x = max_c(rect.left, 0);
+					x <= min_c(rect.right, kGridSize - 1); x++) {
+				pixels[y][x] = value;
+			}
+		}
+	}
+
+	bool operator==(const PixelGrid& other) const
+	{
+		return memcmp(pixels, other.pixels, sizeof(pixels)) == 0;
+	}
+};
+
+
+static clipping_rect
+random_rect()
+{
+	clipping_rect rect;
+	rect.left = rand() % kGridSize;
+	rect.top = rand() % kGridSize;
+	// may also result in invalid rects
+	rect.right = rect.left + rand() % (kGridSize / 2) - 2;
+	rect.bottom = rect.top + rand() % (kGridSize / 2) - 2;
+	return rect;
+}
+
+
+static void
+random_region(BRegion& region)
+{
+	region.MakeEmpty();
+
+	if (rand() % 2 == 0) {
+		int32 count = rand() % 6;
+		for (int32 i = 0; i < count; i++)
+			region.Include(random_rect());
+		return;
+	}
+
+	// Sorted rects, like they are added when building a clipping region,
+	// either from top to bottom, or bottom to top
+	bool upwards = rand() % 4 == 0;
+	for (int32 y = rand() % 4; y < kGridSize;) {
+		int32 height = rand() % 3 + 1;
+		for (int32 x = rand() % 4; x < kGridSize;) {
+			int32 width = rand() % 6 + 1;
+			clipping_rect rect = { x, y, x + width - 1, y + height - 1 };
+			if (upwards) {
+				rect.top = kGridSize - 1 - (y + height - 1);
+				rect.bottom = kGridSize - 1 - y;
+			}
+			region.Include(rect);
+			x += width + (rand() % 3 == 0 ? 0 : rand() % 4 + 1);
+		}
+		y += height + (rand() % 3 == 0 ? rand() % 3 : 0);
+	}
+}
+
+
+static bool
+is_canonical(const BRegion& region)
+{
+	int32 count = region.CountRects();
+	if (count == 0)
+		return true;
+
+	clipping_rect frame = region.RectAtInt(0);
+	int32 previousBand = -1;
+	int32 bandStart = 0;
+
+	for (int32 i = 0; i <= count; i++) {
+		if (i < count) {
+			clipping_rect rect = region.RectAtInt(i);
+			if (rect.left > rect.right || rect.top > rect.bottom)
+				return false;
+
+			frame.left = min_c(frame.left, rect.left);
+			frame.right = max_c(frame.right, rect.right);
+			frame.bottom = max_c(frame.bottom, rect.bottom);
+
+			if (i == bandStart)
+				continue;
+
+			clipping_rect previous = region.RectAtInt(i - 1);
+			if (rect.top == previous.top) {
+				// rects in a band must have the same height, and must not
+				// touch each other
+				if (rect.bottom != previous.bottom
+					|| previous.right + 1 >= rect.left)
+					return false;
+				continue;
+			}
+			if (rect.top <= previous.bottom)
+				return false;
+		}
+
+		// a band is complete, it must not be mergeable with the one before
+		if (previousBand >= 0 && i - bandStart == bandStart - previousBand
+			&& region.RectAtInt(previousBand).bottom + 1
+				== region.RectAtInt(bandStart).top) {
+			bool identical = true;
+			for (int32 j = 0; j < i - bandStart; j++) {
+				clipping_rect a = region.RectAtInt(previousBand + j);
+				clipping_rect b = region.RectAtInt(bandStart + j);
+				if (a.left != b.left || a.right != b.right)
+					identical = false;
+			}
+			if (identical)
+				return false;
+		}
+		previousBand = bandStart;
+		bandStart = i;
+	}
+
+	clipping_rect regionFrame = region.FrameInt();
+	return regionFrame.left == frame.left && regionFrame.top == frame.top
+		&& regionFrame.right == frame.right
+		&& regionFrame.bottom == frame.bottom;
+}
+
+
+RegionRandomOps::RegionRandomOps(std::string name)
+	:
+	TestCase(name)
+{
+}
+
+
+RegionRandomOps::~RegionRandomOps()
+{
+}
+
+
+void
+RegionRandomOps::PerformTest()
+{
+	srand(42);
+
+	for (int32 i = 0; i < kIterations; i++) {
+		BRegion region;
+		random_region(region);
+		BRegion other;
+		random_region(other);
+		if (rand() % 3 == 0)
+			other.Set(random_rect());
+
+		PixelGrid expected;
+		expected.SetTo(region);
+		PixelGrid otherPixels;
+		otherPixels.SetTo(other);
+
+		clipping_rect rect = random_rect();
+		bool validRect = rect.left <= rect.right && rect.top <= rect.bottom;
+
+		switch (rand() % 7) {
+			case 0:
+				region.Include(rect);
+				if (validRect)
+					expected.Fill(rect, true);
+				break;
+			case 1:
+				region.Exclude(rect);
+				if (validRect)
+					expected.Fill(rect, false);
+				break;
+			case 2:
+				region.Include(&other);
+				for (int32 y = 0; y < kGridSize; y++) {
+					for (int32 x = 0; x < kGridSize; x++)
+						expected.pixels[y][x] |= otherPixels.pixels[y][x];
+				}
+				break;
+			case 3:
+				region.Exclude(&other);
+				for (int32 y = 0; y < kGridSize; y++) {
+					for (int32 x = 0; x < kGridSize; x++) {
+						if (otherPixels.pixels[y][x])
+							expected.pixels[y][x] = false;
+					}
+				}
+				break;
+			case 4:
+				region.IntersectWith(&other);
+				for (int32 y = 0; y < kGridSize; y++) {
+					for (int32 x = 0; x < kGridSize; x++)
+						expected.pixels[y][x] &= otherPixels.pixels[y][x];
+				}
+				break;
+			case 5:
+				region.IntersectWith(&region);
+				break;
+			case 6:
+				region.Include(&region);
+				break;
+		}
+
+		PixelGrid result;
+		result.SetTo(region);
+		CPPUNIT_ASSERT(result == expected);
+		CPPUNIT_ASSERT(is_canonical(region));
+
+		BRegion copy(region);
+		CPPUNIT_ASSERT(copy == region);
+		CPPUNIT_ASSERT(is_canonical(copy));
+	}
+}
+
+
+/*static*/ Test*
+RegionRandomOps::suite()
+{
+	typedef CppUnit::TestCaller<RegionRandomOps> RegionRandomOpsCaller;
+
+	return new RegionRandomOpsCaller("BRegion::Random Operations Test",
+		&RegionRandomOps::PerformTest);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef REGION_RANDOM_OPS_H
+#define REGION_RANDOM_OPS_H
+
+
+#include "../common.h"
+
+
+class BRegion;
+
+
+/*!	Applies random operations to random regions, and compares the results
+	against a bitmap of the covered pixels. Also verifies that the results
+	are properly banded and coalesced, since that is what makes two regions
+	covering the same area compare equal.
+*/
+class RegionRandomOps : public TestCase {
+public:
+								RegionRandomOps(std::string name = "");
+	virtual						~RegionRandomOps();
+
+			void				PerformTest();
+
+	static	Test*				suite();
+};
+
+
+#endif	// REGION_RANDOM_OPS_H
@@ -4,6 +4,7 @@
 #include "RegionInclude.h"
 #include "RegionIntersect.h"
 #include "RegionOffsetBy.h"
+#include "RegionRandomOps.h"
 
 Test *RegionTestSuite()
 {
@@ -14,6 +15,7 @@ Test *RegionTestSuite()
 	testSuite->addTest(RegionInclude::suite());
 	testSuite->addTest(RegionIntersect::suite());
 	testSuite->addTest(RegionOffsetBy::suite());
+	testSuite->addTest(RegionRandomOps::suite());
 	
 	return(testSuite);
 }
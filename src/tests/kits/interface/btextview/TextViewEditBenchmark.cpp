@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Times loading large documents into a BTextView, and the latency of single
+	character edits in them, with and without word wrapping.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Application.h>
+#include <OS.h>
+#include <TextView.h>
+
+
+static const int32 kEditCount = 200;
+
+
+static char*
+create_document(int32 size)
+{
+	static const char* kWords[] = {
+		"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+		"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "elit",
+		"sed", "do", "eiusmod", "tempor", "incididunt", "labore"
+	};
+	static const int32 kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+	char* text = (char*)malloc(size + 1);
+	if (text == NULL)
+		return NULL;
+
+	srand(42);
+	int32 offset = 0;
+	int32 lineLength = 0;
+	while (offset < size) {
+		const char* word = kWords[rand() % kWordCount];
+		int32 length = strlen(word);
+		if (offset + length + 1 > size)
+			break;
+
+		memcpy(text + offset, word, length);
+		offset += length;
+		lineLength += length + 1;
+
+		// lines of roughly 40 to 120 characters, like a log file
+		if (lineLength > 40 + rand() % 80) {
+			text[offset++] = '\n';
+			lineLength = 0;
+		} else
+			text[offset++] = ' ';
+	}
+	while (offset < size)
+		text[offset++] = '\n';
+	text[size] = '\0';
+
+	return text;
+}
+
+
+static void
+print_result(const char* name, bigtime_t time, int32 count)
+{
+	printf("  %-32s %12.1f us\n", name, (double)time / count);
+}
+
+
+static void
+run_benchmark(const char* document, int32 size, bool wrap)
+{
+	BRect frame(0, 0, 799, 599);
+	BTextView* textView = new BTextView(frame, "text", frame, B_FOLLOW_NONE,
+		B_WILL_DRAW);
+	textView->SetWordWrap(wrap);
+
+	printf("%" B_PRId32 " MB, %s:\n", size / (1024 * 1024),
+		wrap ? "word wrap" : "no word wrap");
+
+	bigtime_t start = system_time();
+	textView->SetText(document, size);
+	print_result("Load", system_time() - start, 1);
+	printf("  %-32s %12" B_PRId32 "\n", "Lines", textView->CountLines());
+
+	srand(1);
+	bigtime_t insertTime = 0;
+	bigtime_t newlineTime = 0;
+	bigtime_t deleteTime = 0;
+	for (int32 i = 0; i < kEditCount; i++) {
+		int32 offset = rand() % textView->TextLength();
+
+		start = system_time();
+		textView->Insert(offset, "x", 1);
+		insertTime += system_time() - start;
+
+		start = system_time();
+		textView->Insert(offset, "\n", 1);
+		newlineTime += system_time() - start;
+
+		start = system_time();
+		textView->Delete(offset, offset + 2);
+		deleteTime += system_time() - start;
+	}
+	print_result("Insert character", insertTime, kEditCount);
+	print_result("Insert line break", newlineTime, kEditCount);
+	print_result("Delete characters", deleteTime, kEditCount);
+
+	// typing at one place, the common case for an editor
+	int32 offset = textView->TextLength() / 2;
+	start = system_time();
+	for (int32 i = 0; i < kEditCount; i++)
+		textView->Insert(offset + i, "y", 1);
+	print_result("Type character", system_time() - start, kEditCount);
+
+	start = system_time();
+	for (int32 i = kEditCount; i-- > 0;)
+		textView->Delete(offset + i, offset + i + 1);
+	print_result("Backspace", system_time() - start, kEditCount);
+
+	delete textView;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// the document sizes can be given in MB, the default is 1, 10 and 100
+	int32 sizes[16] = { 1, 10, 100 };
+	int32 sizeCount = 3;
+	if (argc > 1) {
+		sizeCount = 0;
+		for (int32 i = 1; i < argc && sizeCount < 16; i++)
+			sizes[sizeCount++] = atol(argv[i]);
+	}
+
+	BApplication app("application/x-vnd.Haiku-TextViewEditBenchmark");
+
+	for (int32 i = 0; i < sizeCount; i++) {
+		int32 size = sizes[i] * 1024 * 1024;
+		char* document = create_document(size);
+		if (document == NULL) {
+			fprintf(stderr, "Not enough memory for %" B_PRId32 " MB\n",
+				sizes[i]);
+			continue;
+		}
+
+		run_benchmark(document, size, false);
+		run_benchmark(document, size, true);
+		free(document);
+	}
+
+	return 0;
+}
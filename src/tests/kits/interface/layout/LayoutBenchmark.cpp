@@ -0,0 +1,172 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Times laying out synthetic deep trees of nested grid and group layouts:
+	the initial layout, relayouts while the root is being resized, and
+	relayouts after a single leaf changed its size constraints.
+	The grids contain items spanning several cells, so that the complex
+	layouter and its optimizer are used.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <GridLayout.h>
+#include <GroupLayout.h>
+#include <OS.h>
+#include <Size.h>
+#include <View.h>
+
+
+static const int32 kResizeCount = 400;
+static const int32 kChangeCount = 200;
+
+
+struct Tree {
+	BView*	root;
+	BView**	leaves;
+	int32	leafCount;
+	int32	viewCount;
+};
+
+
+static BView*
+create_leaf(Tree& tree)
+{
+	BView* view = new BView("leaf", 0);
+
+	float width = 20 + rand() % 80;
+	float height = 10 + rand() % 20;
+	view->SetExplicitMinSize(BSize(width, height));
+	view->SetExplicitPreferredSize(BSize(width * 2, height));
+	if (rand() % 3 == 0)
+		view->SetExplicitMaxSize(BSize(width * 3, height * 2));
+	else
+		view->SetExplicitMaxSize(BSize(B_SIZE_UNLIMITED, B_SIZE_UNLIMITED));
+
+	tree.leaves[tree.leafCount++] = view;
+	tree.viewCount++;
+	return view;
+}
+
+
+static BView*
+create_subtree(Tree& tree, int32 depth)
+{
+	if (depth == 0)
+		return create_leaf(tree);
+
+	tree.viewCount++;
+
+	if (depth % 2 == 0) {
+		// a 3x3 grid: the first row spans two columns, the last cell of the
+		// second row spans two rows
+		BGridLayout* grid = new BGridLayout(5, 5);
+		BView* view = new BView("grid", 0, grid);
+		grid->AddView(create_subtree(tree, depth - 1), 0, 0, 2, 1);
+		grid->AddView(create_subtree(tree, depth - 1), 2, 0);
+		grid->AddView(create_subtree(tree, depth - 1), 0, 1);
+		grid->AddView(create_subtree(tree, depth - 1), 1, 1);
+		grid->AddView(create_subtree(tree, depth - 1), 2, 1, 1, 2);
+		grid->AddView(create_subtree(tree, depth - 1), 0, 2, 2, 1);
+		return view;
+	}
+
+	BGroupLayout* group = new BGroupLayout(
+		depth % 4 == 1 ? B_HORIZONTAL : B_VERTICAL, 5);
+	BView* view = new BView("group", 0, group);
+	for (int32 i = 0; i < 3; i++)
+		group->AddView(create_subtree(tree, depth - 1), 1 + rand() % 3);
+	return view;
+}
+
+
+static int32
+leaf_count(int32 depth)
+{
+	if (depth == 0)
+		return 1;
+	return (depth % 2 == 0 ? 6 : 3) * leaf_count(depth - 1);
+}
+
+
+static void
+print_result(const char* name, bigtime_t time, int32 count)
+{
+	printf("  %-32s %12.1f us\n", name, (double)time / count);
+}
+
+
+static void
+run_benchmark(int32 depth)
+{
+	srand(depth);
+
+	Tree tree;
+	tree.leaves = new BView*[leaf_count(depth)];
+	tree.leafCount = 0;
+	tree.viewCount = 0;
+
+	bigtime_t start = system_time();
+	tree.root = create_subtree(tree, depth);
+	bigtime_t buildTime = system_time() - start;
+
+	printf("depth %" B_PRId32 ", %" B_PRId32 " views:\n", depth,
+		tree.viewCount);
+	print_result("Build", buildTime, 1);
+
+	BSize size = tree.root->PreferredSize();
+	start = system_time();
+	tree.root->ResizeTo(size.width, size.height);
+	tree.root->Layout(false);
+	print_result("Initial layout", system_time() - start, 1);
+
+	// resizing the window, the width changes by a few pixels at a time
+	start = system_time();
+	for (int32 i = 0; i < kResizeCount; i++) {
+		tree.root->ResizeTo(size.width + 2 * (i % (kResizeCount / 2)),
+			size.height + i % 7);
+		tree.root->Layout(false);
+	}
+	print_result("Resize", system_time() - start, kResizeCount);
+
+	// a single item changes its size, like a label getting a new text
+	start = system_time();
+	for (int32 i = 0; i < kChangeCount; i++) {
+		BView* leaf = tree.leaves[rand() % tree.leafCount];
+		BSize minSize = leaf->ExplicitMinSize();
+		minSize.width += minSize.width > 60 ? -40 : 40;
+		leaf->SetExplicitMinSize(minSize);
+		tree.root->Layout(false);
+	}
+	print_result("Change one item", system_time() - start, kChangeCount);
+
+	delete tree.root;
+	delete[] tree.leaves;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// the tree depths can be given, the default is 2 to 6
+	int32 depths[16] = { 2, 3, 4, 5, 6 };
+	int32 depthCount = 5;
+	if (argc > 1) {
+		depthCount = 0;
+		for (int32 i = 1; i < argc && depthCount < 16; i++)
+			depths[depthCount++] = atol(argv[i]);
+	}
+
+	BApplication app("application/x-vnd.Haiku-LayoutBenchmark");
+
+	for (int32 i = 0; i < depthCount; i++)
+		run_benchmark(depths[i]);
+
+	return 0;
+}
@@ -391,9 +391,9 @@ public:
 // HttpIntegrationTest
 
 
-HttpIntegrationTest::HttpIntegrationTest(TestServerMode mode)
+HttpIntegrationTest::HttpIntegrationTest(TestServerMode mode, bool keepAlive)
 	:
-	fTestServer(mode)
+	fTestServer(mode, keepAlive)
 {
 	// increase number of concurrent connections to 4 (from 2)
 	fSession.SetMaxConnectionsPerHost(4);
@@ -482,6 +482,21 @@ HttpIntegrationTest::AddTests(BTestSuite& parent)
 		suite.addTest(testCaller);
 		parent.addTest("HttpsIntegrationTest", &suite);
 	}
+
+	// Http with a server that keeps connections open
+	{
+		CppUnit::TestSuite& suite = *new CppUnit::TestSuite("HttpKeepAliveTest");
+
+		HttpIntegrationTest* keepAliveTest = new HttpIntegrationTest(TestServerMode::Http, true);
+		BThreadedTestCaller<HttpIntegrationTest>* testCaller
+			= new BThreadedTestCaller<HttpIntegrationTest>("HttpKeepAliveTest::", keepAliveTest);
+
+		testCaller->addThread("GetTest", &HttpIntegrationTest::GetTest);
+		testCaller->addThread("KeepAliveTest", &HttpIntegrationTest::KeepAliveTest);
+
+		suite.addTest(testCaller);
+		parent.addTest("HttpKeepAliveTest", &suite);
+	}
 }
 
 
@@ -530,7 +545,7 @@ constexpr std::string_view kExpectedGetBody = {"Path: /\r\n"
 											   "--------\r\n"
 											   "Host: 127.0.0.1:PORT\r\n"
 											   "Accept-Encoding: gzip\r\n"
-											   "Connection: close\r\n"};
+											   "Connection: keep-alive\r\n"};
 
 
 void
@@ -713,6 +728,55 @@ HttpIntegrationTest::RequestCancelTest()
 }
 
 
+void
+HttpIntegrationTest::KeepAliveTest()
+{
+	// Use a session of its own, so that the statistics only cover this test
+	BHttpSession session;
+	session.SetMaxConnectionsPerHost(2);
+
+	// Sequential requests share a single connection
+	static constexpr size_t kSequentialRequests = 4;
+	for (size_t i = 0; i < kSequentialRequests; i++) {
+		auto request = BHttpRequest(BUrl(fTestServer.BaseUrl(), "/"));
+		auto result = session.Execute(std::move(request), nullptr, fLoggerMessenger);
+		CPPUNIT_ASSERT_EQUAL(kExpectedGetBody, result.Body().text.value().String());
+
+		// The connection is handed back shortly after the result is available
+		for (int wait = 0; session.GetStatistics().idleConnections == 0 && wait < 100; wait++)
+			usleep(1000);
+	}
+
+	auto statistics = session.GetStatistics();
+	CPPUNIT_ASSERT_EQUAL(kSequentialRequests, statistics.requests);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), statistics.connectionsOpened);
+	CPPUNIT_ASSERT_EQUAL(kSequentialRequests - 1, statistics.connectionsReused);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), statistics.idleConnections);
+
+	// Concurrent requests do not open more connections than allowed
+	static constexpr size_t kConcurrentRequests = 8;
+	std::vector<BHttpResult> results;
+	for (size_t i = 0; i < kConcurrentRequests; i++) {
+		auto request = BHttpRequest(BUrl(fTestServer.BaseUrl(), "/"));
+		results.push_back(session.Execute(std::move(request), nullptr, fLoggerMessenger));
+	}
+	for (auto& result: results)
+		CPPUNIT_ASSERT_EQUAL(kExpectedGetBody, result.Body().text.value().String());
+
+	statistics = session.GetStatistics();
+	CPPUNIT_ASSERT_EQUAL(kSequentialRequests + kConcurrentRequests, statistics.requests);
+	CPPUNIT_ASSERT(statistics.connectionsOpened <= 2);
+	CPPUNIT_ASSERT_EQUAL(statistics.requests,
+		statistics.connectionsOpened + statistics.connectionsReused);
+
+	// Turning it off closes the idle connections
+	session.SetMaxIdleConnectionsPerHost(0);
+	for (int wait = 0; session.GetStatistics().idleConnections != 0 && wait < 100; wait++)
+		usleep(1000);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), session.GetStatistics().idleConnections);
+}
+
+
 static const BString kPostText
 	= "The MIT License\n"
 	  "\n"
@@ -744,7 +808,7 @@ static BString kExpectedPostBody = BString().SetToFormat("Path: /post\r\n"
 														 "--------\r\n"
 														 "Host: 127.0.0.1:PORT\r\n"
 														 "Accept-Encoding: gzip\r\n"
-														 "Connection: close\r\n"
+														 "Connection: keep-alive\r\n"
 														 "Content-Type: text/plain\r\n"
 														 "Content-Length: 1083\r\n"
 														 "\r\n"
@@ -34,7 +34,8 @@ public:
 class HttpIntegrationTest : public BThreadedTestCase
 {
 public:
-								HttpIntegrationTest(TestServerMode mode);
+								HttpIntegrationTest(TestServerMode mode,
+									bool keepAlive = false);
 
 	virtual	void				setUp() override;
 	virtual	void				tearDown() override;
@@ -49,6 +50,7 @@ public:
 			void				StopOnErrorTest();
 			void				RequestCancelTest();
 			void				PostTest();
+			void				KeepAliveTest();
 
 	static	void				AddTests(BTestSuite& suite);
 
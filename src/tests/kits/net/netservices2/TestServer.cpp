@@ -208,9 +208,10 @@ ChildProcess::Start(const std::vector<std::string>& args)
 }
 
 
-TestServer::TestServer(TestServerMode mode)
+TestServer::TestServer(TestServerMode mode, bool keepAlive)
 	:
-	fMode(mode)
+	fMode(mode),
+	fKeepAlive(keepAlive)
 {
 }
 
@@ -243,6 +244,9 @@ TestServer::Start()
 		child_process_args.push_back("--use-tls");
 	}
 
+	if (fKeepAlive)
+		child_process_args.push_back("--keep-alive");
+
 	// After this the child process has started. It may take a short amount of
 	// time before the child process is ready to call accept(), but that's OK.
 	//
@@ -55,13 +55,14 @@ enum class TestServerMode {
 class TestServer
 {
 public:
-	TestServer(TestServerMode mode);
+	TestServer(TestServerMode mode, bool keepAlive = false);
 
 	status_t Start();
 	BUrl BaseUrl() const;
 
 private:
 	TestServerMode fMode;
+	bool fKeepAlive;
 	ChildProcess fChildProcess;
 	RandomTCPServerPort fPort;
 };
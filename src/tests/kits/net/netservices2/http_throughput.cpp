@@ -0,0 +1,245 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how fast BHttpSession receives large bodies from a server on the
+	loopback interface, both into the result and into a BMallocIO target, and
+	with a chunked transfer encoding.
+
+	Usage: http_throughput [size in MB] [rounds]
+*/
+
+
+#undef NDEBUG
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <DataIO.h>
+#include <ExclusiveBorrow.h>
+#include <HttpRequest.h>
+#include <HttpResult.h>
+#include <HttpSession.h>
+#include <NetServicesDefs.h>
+#include <OS.h>
+#include <String.h>
+#include <Url.h>
+
+using namespace BPrivate::Network;
+
+
+static const size_t kChunkSize = 64 * 1024;
+
+
+struct Server {
+	int		listener;
+	uint16	port;
+	off_t	size;
+	char*	data;
+};
+
+
+static bool
+write_all(int socket, const void* data, size_t size)
+{
+	const char* buffer = (const char*)data;
+	while (size > 0) {
+		ssize_t bytesWritten = send(socket, buffer, size, 0);
+		if (bytesWritten <= 0)
+			return false;
+		buffer += bytesWritten;
+		size -= bytesWritten;
+	}
+	return true;
+}
+
+
+/*!	Answers each request with a body of the configured size, that is filled
+	with a repeating pattern. Requests for "/chunked" get the body in chunks
+	of kChunkSize bytes.
+*/
+static void
+serve(Server* server, int socket)
+{
+	char request[4096];
+	request[0] = '\0';
+	size_t length = 0;
+	while (strstr(request, "\r\n\r\n") == NULL) {
+		ssize_t bytesRead = recv(socket, request + length,
+			sizeof(request) - length - 1, 0);
+		if (bytesRead <= 0)
+			return;
+		length += bytesRead;
+		request[length] = '\0';
+	}
+
+	bool chunked = strncmp(request, "GET /chunked ", 13) == 0;
+
+	char header[256];
+	if (chunked) {
+		snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\n"
+			"Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n");
+	} else {
+		snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\n"
+			"Content-Length: %" B_PRIdOFF "\r\nConnection: close\r\n\r\n",
+			server->size);
+	}
+	if (!write_all(socket, header, strlen(header)))
+		return;
+
+	for (off_t sent = 0; sent < server->size; ) {
+		size_t size = min_c(server->size - sent, (off_t)kChunkSize);
+		if (chunked) {
+			snprintf(header, sizeof(header), "%zx\r\n", size);
+			if (!write_all(socket, header, strlen(header)))
+				return;
+		}
+		if (!write_all(socket, server->data + sent % kChunkSize, size))
+			return;
+		if (chunked && !write_all(socket, "\r\n", 2))
+			return;
+		sent += size;
+	}
+
+	if (chunked)
+		write_all(socket, "0\r\n\r\n", 5);
+}
+
+
+static void*
+server_thread(void* data)
+{
+	Server* server = (Server*)data;
+	while (true) {
+		int socket = accept(server->listener, NULL, NULL);
+		if (socket < 0)
+			break;
+
+		serve(server, socket);
+		shutdown(socket, SHUT_WR);
+		close(socket);
+	}
+	return NULL;
+}
+
+
+static bool
+check_body(const Server& server, const void* data, size_t size)
+{
+	if ((off_t)size != server.size)
+		return false;
+
+	const char* body = (const char*)data;
+	for (size_t offset = 0; offset < size; offset += kChunkSize) {
+		size_t length = min_c(size - offset, kChunkSize);
+		if (memcmp(body + offset, server.data, length) != 0)
+			return false;
+	}
+	return true;
+}
+
+
+/*!	Runs \a rounds requests for \a path, and returns the throughput in MB/s.
+	The body is received into the result, or into a BMallocIO if \a target
+	is set.
+*/
+static double
+run(BHttpSession& session, const Server& server, const char* path,
+	bool target, int32 rounds)
+{
+	BString url;
+	url.SetToFormat("http://127.0.0.1:%u%s", server.port, path);
+
+	bigtime_t time = 0;
+	for (int32 round = 0; round < rounds; round++) {
+		auto request = BHttpRequest(BUrl(url));
+		auto body = make_exclusive_borrow<BMallocIO>();
+
+		bigtime_t start = system_time();
+		try {
+			if (target) {
+				auto result = session.Execute(std::move(request),
+					BBorrow<BDataIO>(body));
+				result.Body();
+				time += system_time() - start;
+				assert(check_body(server, body->Buffer(),
+					body->BufferLength()));
+			} else {
+				auto result = session.Execute(std::move(request));
+				const auto& text = result.Body().text;
+				time += system_time() - start;
+				assert(text.has_value()
+					&& check_body(server, text->String(), text->Length()));
+			}
+		} catch (const BError& error) {
+			fprintf(stderr, "%s: %s\n", path, error.DebugMessage().String());
+			exit(1);
+		}
+	}
+
+	return server.size / (1024.0 * 1024) * rounds * 1000000 / time;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Server server;
+	server.size = 64;
+	if (argc > 1)
+		server.size = atol(argv[1]);
+	server.size *= 1024 * 1024;
+	int32 rounds = 10;
+	if (argc > 2)
+		rounds = atol(argv[2]);
+
+	server.data = (char*)malloc(kChunkSize);
+	for (size_t i = 0; i < kChunkSize; i++)
+		server.data[i] = 'a' + i % 26;
+
+	server.listener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addressLength = sizeof(address);
+	if (bind(server.listener, (sockaddr*)&address, sizeof(address)) != 0
+		|| listen(server.listener, 4) != 0
+		|| getsockname(server.listener, (sockaddr*)&address,
+			&addressLength) != 0) {
+		perror("Could not set up the server");
+		return 1;
+	}
+	server.port = ntohs(address.sin_port);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &server_thread, &server);
+
+	BHttpSession session;
+
+	printf("%" B_PRIdOFF " MB bodies, %" B_PRId32 " rounds:\n",
+		server.size / (1024 * 1024), rounds);
+	printf("  into the result    %8.1f MB/s\n",
+		run(session, server, "/", false, rounds));
+	printf("  into a BMallocIO   %8.1f MB/s\n",
+		run(session, server, "/", true, rounds));
+	printf("  chunked            %8.1f MB/s\n",
+		run(session, server, "/chunked", false, rounds));
+
+	shutdown(server.listener, SHUT_RDWR);
+	close(server.listener);
+	pthread_join(thread, NULL);
+	free(server.data);
+
+	return 0;
+}
@@ -194,10 +194,12 @@ class RequestHandler(http.server.BaseHTTPRequestHandler):
         return encoding, output_stream.get_bytes()
 
     def _not_supported(self):
+        response_body = '{} not supported\r\n'.format(
+            self.command).encode('utf-8')
         self.send_response(405, '{} not supported'.format(self.command))
+        self.send_header('Content-Length', str(len(response_body)))
         self.end_headers()
-        self.wfile.write(
-            '{} not supported\r\n'.format(self.command).encode('utf-8'))
+        self.wfile.write(response_body)
 
     def _authorize(self):
         """
@@ -247,6 +249,7 @@ class RequestHandler(http.server.BaseHTTPRequestHandler):
                 or password != expected_password:
             self.send_response(401, 'Not authorized')
             self.send_header('Www-Authenticate', 'Basic realm="Fake Realm"')
+            self.send_header('Content-Length', '0')
             self.end_headers()
             return False, []
 
@@ -293,6 +296,7 @@ class RequestHandler(http.server.BaseHTTPRequestHandler):
                 ' stale=FALSE'.format(NONCE, OPAQUE))
             self.send_header('Set-Cookie', 'stale_after=never; Path=/')
             self.send_header('Set-Cookie', 'fake=fake_value; Path=/')
+            self.send_header('Content-Length', '0')
             self.end_headers()
             return False, extra_headers
 
@@ -455,7 +459,15 @@ def main():
         options.bind_addr,
         0 if options.port is None else options.port)
 
-    server = http.server.HTTPServer(
+    if options.keep_alive:
+        # HTTP/1.1 keeps the connection open after each response, which
+        # needs a thread per connection to serve more than one client.
+        RequestHandler.protocol_version = 'HTTP/1.1'
+        server_class = http.server.ThreadingHTTPServer
+    else:
+        server_class = http.server.HTTPServer
+
+    server = server_class(
         bind_addr,
         RequestHandler,
         bind_and_activate=False)
@@ -531,6 +543,13 @@ def parse_args(argv):
         default=None,
         type='int',
         help='A socket FD to use for accept() instead of binding a new one.')
+    parser.add_option(
+        '--keep-alive',
+        dest='keep_alive',
+        default=False,
+        action='store_true',
+        help='If set, the server speaks HTTP/1.1 and keeps connections open'
+        ' between requests.')
     options, args = parser.parse_args(argv)
     if len(args) > 1:
         parser.error('Unexpected arguments: {}'.format(', '.join(args[1:])))
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks that sendfile() sends the right data and handles the file
+	position like on Linux, then compares the throughput of sendfile() with
+	a read() and send() loop over a loopback TCP connection.
+
+	Usage: sendfile_test [file size in MB]
+*/
+
+
+#undef NDEBUG
+
+#include <sys/sendfile.h>
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+
+static const char* kFileName = "/tmp/sendfile_test";
+static const size_t kChunkSize = 64 * 1024;
+static const int32 kRounds = 5;
+
+
+static uint8
+pattern(off_t offset)
+{
+	return (uint8)(offset * 7 + (offset >> 12));
+}
+
+
+static bool
+create_file(off_t size)
+{
+	int fd = open(kFileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	uint8* buffer = (uint8*)malloc(kChunkSize);
+	for (off_t offset = 0; offset < size; offset += kChunkSize) {
+		size_t length = min_c(size - offset, (off_t)kChunkSize);
+		for (size_t i = 0; i < length; i++)
+			buffer[i] = pattern(offset + i);
+		write(fd, buffer, length);
+	}
+
+	free(buffer);
+	close(fd);
+	return true;
+}
+
+
+static bool
+receive_and_compare(int socket, off_t offset, size_t size)
+{
+	uint8 buffer[4096];
+	while (size > 0) {
+		ssize_t bytesRead = recv(socket, buffer, min_c(size, sizeof(buffer)),
+			0);
+		if (bytesRead <= 0)
+			return false;
+
+		for (ssize_t i = 0; i < bytesRead; i++) {
+			if (buffer[i] != pattern(offset + i))
+				return false;
+		}
+		offset += bytesRead;
+		size -= bytesRead;
+	}
+	return true;
+}
+
+
+static void
+test_semantics()
+{
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		perror("socketpair");
+		exit(1);
+	}
+
+	int fd = open(kFileName, O_RDONLY);
+	assert(fd >= 0);
+
+	// with an offset, the file position stays the same
+	off_t offset = 1000;
+	assert(sendfile(sockets[0], fd, &offset, 5000) == 5000);
+	assert(offset == 6000);
+	assert(lseek(fd, 0, SEEK_CUR) == 0);
+	assert(receive_and_compare(sockets[1], 1000, 5000));
+
+	// without an offset, the file position is used and advanced
+	lseek(fd, 300, SEEK_SET);
+	assert(sendfile(sockets[0], fd, NULL, 700) == 700);
+	assert(lseek(fd, 0, SEEK_CUR) == 1000);
+	assert(receive_and_compare(sockets[1], 300, 700));
+
+	// at the end of the file, nothing is sent
+	off_t size = lseek(fd, 0, SEEK_END);
+	offset = size - 10;
+	assert(sendfile(sockets[0], fd, &offset, 100) == 10);
+	assert(offset == size);
+	assert(receive_and_compare(sockets[1], size - 10, 10));
+	assert(sendfile(sockets[0], fd, &offset, 100) == 0);
+
+	// errors
+	offset = -1;
+	assert(sendfile(sockets[0], fd, &offset, 100) < 0 && errno == EINVAL);
+	assert(sendfile(sockets[0], -1, NULL, 100) < 0 && errno == EBADF);
+	assert(sendfile(sockets[0], sockets[1], NULL, 100) < 0
+		&& errno == EINVAL);
+
+	int writeOnly = open(kFileName, O_WRONLY);
+	assert(writeOnly >= 0);
+	assert(sendfile(sockets[0], writeOnly, NULL, 100) < 0 && errno == EBADF);
+	close(writeOnly);
+
+	close(fd);
+	close(sockets[0]);
+	close(sockets[1]);
+}
+
+
+static void*
+drain(void* data)
+{
+	int socket = *(int*)data;
+	char* buffer = (char*)malloc(kChunkSize);
+	while (recv(socket, buffer, kChunkSize, 0) > 0)
+		;
+	free(buffer);
+	return NULL;
+}
+
+
+static void*
+drain_later(void* data)
+{
+	snooze(300000);
+	return drain(data);
+}
+
+
+static void
+handle_signal(int signal)
+{
+}
+
+
+/*!	A signal that interrupts sendfile() before it could send anything
+	restarts it, when the handler asks for it.
+*/
+static void
+test_restart()
+{
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		perror("socketpair");
+		exit(1);
+	}
+
+	// fill up the socket, so that sendfile() has to wait
+	char buffer[4096];
+	memset(buffer, 0, sizeof(buffer));
+	fcntl(sockets[0], F_SETFL, O_NONBLOCK);
+	while (send(sockets[0], buffer, sizeof(buffer), 0) > 0)
+		;
+	fcntl(sockets[0], F_SETFL, 0);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handle_signal;
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &action, NULL);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &drain_later, &sockets[1]);
+	set_alarm(100000, B_ONE_SHOT_RELATIVE_ALARM);
+
+	int fd = open(kFileName, O_RDONLY);
+	assert(sendfile(sockets[0], fd, NULL, 1000) == 1000);
+
+	shutdown(sockets[0], SHUT_WR);
+	pthread_join(thread, NULL);
+
+	signal(SIGALRM, SIG_DFL);
+	close(fd);
+	close(sockets[0]);
+	close(sockets[1]);
+}
+
+
+static bigtime_t
+send_over_loopback(bool useSendFile, off_t size)
+{
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(listener, (sockaddr*)&address, sizeof(address));
+	listen(listener, 1);
+
+	socklen_t addressLength = sizeof(address);
+	getsockname(listener, (sockaddr*)&address, &addressLength);
+
+	int client = socket(AF_INET, SOCK_STREAM, 0);
+	if (connect(client, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("connect");
+		exit(1);
+	}
+	int server = accept(listener, NULL, NULL);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &drain, &server);
+
+	int fd = open(kFileName, O_RDONLY);
+	char* buffer = (char*)malloc(kChunkSize);
+
+	bigtime_t start = system_time();
+	if (useSendFile) {
+		off_t offset = 0;
+		while (offset < size) {
+			if (sendfile(client, fd, &offset, size - offset) <= 0)
+				break;
+		}
+	} else {
+		ssize_t bytesRead;
+		while ((bytesRead = read(fd, buffer, kChunkSize)) > 0)
+			send(client, buffer, bytesRead, 0);
+	}
+	shutdown(client, SHUT_WR);
+	pthread_join(thread, NULL);
+	bigtime_t time = system_time() - start;
+
+	free(buffer);
+	close(fd);
+	close(client);
+	close(server);
+	close(listener);
+	return time;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	off_t size = 64;
+	if (argc > 1)
+		size = atol(argv[1]);
+	size *= 1024 * 1024;
+
+	if (!create_file(size)) {
+		fprintf(stderr, "Could not create %s: %s\n", kFileName,
+			strerror(errno));
+		return 1;
+	}
+
+	test_semantics();
+	test_restart();
+
+	// warm up the file cache
+	send_over_loopback(false, size);
+
+	bigtime_t copyTime = 0;
+	bigtime_t sendFileTime = 0;
+	for (int32 i = 0; i < kRounds; i++) {
+		copyTime += send_over_loopback(false, size);
+		sendFileTime += send_over_loopback(true, size);
+	}
+
+	double megabytes = (double)size * kRounds / (1024 * 1024);
+	printf("read() and send(): %8.1f MB/s\n", megabytes * 1000000 / copyTime);
+	printf("sendfile():        %8.1f MB/s\n",
+		megabytes * 1000000 / sendFileTime);
+
+	unlink(kFileName);
+
+	return 0;
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks that sendmmsg(), recvmmsg(), and the UDP_SEGMENT option transfer
+	the right datagrams, then measures how many UDP packets per second can
+	be sent over the loopback interface with one send() per packet, with
+	sendmmsg(), and with UDP_SEGMENT.
+
+	Usage: udp_mmsg_pps [packet size] [seconds per run]
+*/
+
+
+#undef NDEBUG
+
+#include <sys/socket.h>
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+
+static const uint32 kBatchSize = 32;
+static const size_t kMaxPacketSize = 1472;
+
+static volatile bool sStop;
+static int64 sReceived;
+
+
+enum send_mode {
+	SEND_SINGLE,
+	SEND_MMSG,
+	SEND_SEGMENT
+};
+
+
+static void
+open_sockets(int& sendSocket, int& receiveSocket)
+{
+	receiveSocket = socket(AF_INET, SOCK_DGRAM, 0);
+	sendSocket = socket(AF_INET, SOCK_DGRAM, 0);
+	if (receiveSocket < 0 || sendSocket < 0) {
+		perror("socket");
+		exit(1);
+	}
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(receiveSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("bind");
+		exit(1);
+	}
+
+	socklen_t addressLength = sizeof(address);
+	getsockname(receiveSocket, (sockaddr*)&address, &addressLength);
+	if (connect(sendSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("connect");
+		exit(1);
+	}
+
+	// don't let the receiver block forever once we stop sending
+	struct timeval timeout = { 0, 100000 };
+	setsockopt(receiveSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+		sizeof(timeout));
+
+	int bufferSize = 1024 * 1024;
+	setsockopt(receiveSocket, SOL_SOCKET, SO_RCVBUF, &bufferSize,
+		sizeof(bufferSize));
+	setsockopt(sendSocket, SOL_SOCKET, SO_SNDBUF, &bufferSize,
+		sizeof(bufferSize));
+}
+
+
+static void
+prepare_messages(mmsghdr* messages, iovec* vecs, char* buffers,
+	size_t bufferSize)
+{
+	memset(messages, 0, sizeof(mmsghdr) * kBatchSize);
+	for (uint32 i = 0; i < kBatchSize; i++) {
+		vecs[i].iov_base = buffers + i * bufferSize;
+		vecs[i].iov_len = bufferSize;
+		messages[i].msg_hdr.msg_iov = &vecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+
+static void
+test_semantics()
+{
+	int sendSocket;
+	int receiveSocket;
+	open_sockets(sendSocket, receiveSocket);
+
+	mmsghdr messages[kBatchSize];
+	iovec vecs[kBatchSize];
+	char buffers[kBatchSize * kMaxPacketSize];
+
+	// every message is sent as its own datagram
+	prepare_messages(messages, vecs, buffers, kMaxPacketSize);
+	for (uint32 i = 0; i < 4; i++) {
+		memset(buffers + i * kMaxPacketSize, 'a' + i, kMaxPacketSize);
+		vecs[i].iov_len = 100 + i;
+	}
+	assert(sendmmsg(sendSocket, messages, 4, 0) == 4);
+	for (uint32 i = 0; i < 4; i++)
+		assert(messages[i].msg_len == 100 + i);
+
+	prepare_messages(messages, vecs, buffers, kMaxPacketSize);
+	memset(buffers, 0, sizeof(buffers));
+	assert(recvmmsg(receiveSocket, messages, 4, 0, NULL) == 4);
+	for (uint32 i = 0; i < 4; i++) {
+		assert(messages[i].msg_len == 100 + i);
+		assert(buffers[i * kMaxPacketSize] == char('a' + i));
+		assert(buffers[i * kMaxPacketSize + 99 + i] == char('a' + i));
+	}
+
+	// nothing left to receive
+	assert(recvmmsg(receiveSocket, messages, kBatchSize, MSG_DONTWAIT, NULL)
+			< 0 && errno == EWOULDBLOCK);
+
+	// one send is split into datagrams of the segment size
+	int segmentSize = 100;
+	assert(setsockopt(sendSocket, IPPROTO_UDP, UDP_SEGMENT, &segmentSize,
+		sizeof(segmentSize)) == 0);
+	int value = 0;
+	socklen_t length = sizeof(value);
+	assert(getsockopt(sendSocket, IPPROTO_UDP, UDP_SEGMENT, &value, &length)
+		== 0 && value == 100);
+
+	for (int32 i = 0; i < 250; i++)
+		buffers[i] = (char)i;
+	assert(send(sendSocket, buffers, 250, 0) == 250);
+
+	char* received = buffers + kMaxPacketSize;
+	prepare_messages(messages, vecs, received, kMaxPacketSize);
+	assert(recvmmsg(receiveSocket, messages, 3, 0, NULL) == 3);
+	assert(messages[0].msg_len == 100);
+	assert(messages[1].msg_len == 100);
+	assert(messages[2].msg_len == 50);
+	assert(received[0] == 0 && received[99] == 99);
+	assert(received[kMaxPacketSize] == 100);
+	assert(received[2 * kMaxPacketSize + 49] == (char)249);
+
+	// a short send is not split at all
+	assert(send(sendSocket, buffers, 80, 0) == 80);
+	assert(recv(receiveSocket, received, kMaxPacketSize, 0) == 80);
+
+	close(sendSocket);
+	close(receiveSocket);
+}
+
+
+static void*
+receiver(void* data)
+{
+	int socket = *(int*)data;
+
+	mmsghdr messages[kBatchSize];
+	iovec vecs[kBatchSize];
+	char* buffers = (char*)malloc(kBatchSize * kMaxPacketSize);
+	prepare_messages(messages, vecs, buffers, kMaxPacketSize);
+
+	while (!sStop) {
+		int count = recvmmsg(socket, messages, kBatchSize, MSG_WAITFORONE,
+			NULL);
+		if (count < 0) {
+			if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+				continue;
+			break;
+		}
+		atomic_add64(&sReceived, count);
+	}
+
+	free(buffers);
+	return NULL;
+}
+
+
+static void
+run(send_mode mode, size_t packetSize, bigtime_t duration)
+{
+	int sendSocket;
+	int receiveSocket;
+	open_sockets(sendSocket, receiveSocket);
+
+	if (mode == SEND_SEGMENT) {
+		int segmentSize = packetSize;
+		setsockopt(sendSocket, IPPROTO_UDP, UDP_SEGMENT, &segmentSize,
+			sizeof(segmentSize));
+	}
+
+	sStop = false;
+	sReceived = 0;
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &receiver, &receiveSocket);
+
+	mmsghdr messages[kBatchSize];
+	iovec vecs[kBatchSize];
+	char* buffer = (char*)malloc(kBatchSize * packetSize);
+	memset(buffer, 0x55, kBatchSize * packetSize);
+	prepare_messages(messages, vecs, buffer, packetSize);
+
+	int64 sent = 0;
+	bigtime_t start = system_time();
+	bigtime_t end = start + duration;
+	while (system_time() < end) {
+		switch (mode) {
+			case SEND_SINGLE:
+				for (uint32 i = 0; i < kBatchSize; i++) {
+					if (send(sendSocket, buffer, packetSize, 0) >= 0)
+						sent++;
+				}
+				break;
+
+			case SEND_MMSG:
+			{
+				int count = sendmmsg(sendSocket, messages, kBatchSize, 0);
+				if (count > 0)
+					sent += count;
+				break;
+			}
+
+			case SEND_SEGMENT:
+				if (send(sendSocket, buffer, kBatchSize * packetSize, 0) >= 0)
+					sent += kBatchSize;
+				break;
+		}
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	sStop = true;
+	pthread_join(thread, NULL);
+
+	static const char* kModeNames[] = { "send()", "sendmmsg()",
+		"UDP_SEGMENT" };
+	double seconds = elapsed / 1000000.0;
+	printf("  %-12s %10.0f sent/s %10.0f received/s %8.1f MB/s\n",
+		kModeNames[mode], sent / seconds, sReceived / seconds,
+		sReceived * packetSize / seconds / (1024 * 1024));
+
+	free(buffer);
+	close(sendSocket);
+	close(receiveSocket);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	size_t packetSize = 512;
+	if (argc > 1)
+		packetSize = min_c(atol(argv[1]), (long)kMaxPacketSize);
+	bigtime_t duration = 2000000;
+	if (argc > 2)
+		duration = atol(argv[2]) * 1000000LL;
+
+	test_semantics();
+
+	printf("%zu bytes, %" B_PRIu32 " packets per call:\n", packetSize,
+		kBatchSize);
+	run(SEND_SINGLE, packetSize, duration);
+	run(SEND_MMSG, packetSize, duration);
+	run(SEND_SEGMENT, packetSize, duration);
+
+	return 0;
+}
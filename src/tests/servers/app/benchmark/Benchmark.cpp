@@ -15,8 +15,11 @@
 #include "TestWindow.h"
 
 // tests
+#include "FillRectTest.h"
 #include "HorizontalLineTest.h"
+#include "PictureTest.h"
 #include "RandomLineTest.h"
+#include "ScaledBitmapTest.h"
 #include "StringTest.h"
 #include "VerticalLineTest.h"
 
@@ -27,8 +30,13 @@ struct test_info {
 };
 
 const test_info kTestInfos[] = {
+	{ "FillRects",			FillRectTest::CreateTest },
+	{ "ClippedFillRects",	FillRectTest::CreateClippedTest },
 	{ "HorizontalLines",	HorizontalLineTest::CreateTest },
+	{ "MixedSizeStrings",	StringTest::CreateMixedSizeTest },
+	{ "Pictures",			PictureTest::CreateTest },
 	{ "RandomLines",		RandomLineTest::CreateTest },
+	{ "ScaledBitmaps",		ScaledBitmapTest::CreateTest },
 	{ "Strings",			StringTest::CreateTest },
 	{ "VerticalLines",		VerticalLineTest::CreateTest },
 	{ NULL, NULL }
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "FillRectTest.h"
+
+#include <stdio.h>
+
+#include <GradientLinear.h>
+#include <Region.h>
+#include <View.h>
+
+
+static const int32 kCheckerSize = 32;
+
+
+FillRectTest::FillRectTest(bool clipped)
+	: Test(),
+	  fTestDuration(0),
+	  fTestStart(-1),
+
+	  fPixelsFilled(0),
+	  fPixelsPerIteration(0),
+
+	  fIterations(0),
+	  fMaxIterations(1000),
+
+	  fViewBounds(0, 0, -1, -1),
+	  fClipped(clipped)
+{
+}
+
+
+FillRectTest::~FillRectTest()
+{
+}
+
+
+void
+FillRectTest::Prepare(BView* view)
+{
+	fViewBounds = view->Bounds();
+
+	if (fClipped) {
+		// A checkerboard clipping region results in many small dirty rects
+		// that need to be transferred to the front buffer
+		BRegion region;
+		for (int32 y = 0; y <= fViewBounds.IntegerHeight(); y += kCheckerSize) {
+			for (int32 x = (y / kCheckerSize % 2) * kCheckerSize;
+					x <= fViewBounds.IntegerWidth(); x += 2 * kCheckerSize) {
+				region.Include(BRect(x, y, x + kCheckerSize - 1,
+					y + kCheckerSize - 1));
+			}
+		}
+		BRegion bounds(fViewBounds);
+		region.IntersectWith(&bounds);
+		view->ConstrainClippingRegion(&region);
+
+		fPixelsPerIteration = 0;
+		for (int32 i = 0; i < region.CountRects(); i++) {
+			clipping_rect rect = region.RectAtInt(i);
+			fPixelsPerIteration += (uint64)(rect.right - rect.left + 1)
+				* (rect.bottom - rect.top + 1);
+		}
+	} else {
+		fPixelsPerIteration = (uint64)(fViewBounds.IntegerWidth() + 1)
+			* (fViewBounds.IntegerHeight() + 1);
+	}
+
+	fTestDuration = 0;
+	fPixelsFilled = 0;
+	fIterations = 0;
+	fTestStart = system_time();
+}
+
+
+bool
+FillRectTest::RunIteration(BView* view)
+{
+	BGradientLinear gradient(fViewBounds.LeftTop(),
+		fViewBounds.LeftBottom());
+	gradient.AddColor((rgb_color){ 255, 0, 0, 255 }, 0);
+	gradient.AddColor((rgb_color){ 0, 0, 255, 255 }, 255);
+
+	bigtime_t now = system_time();
+
+	// alternate between solid and vertical gradient fills, which both
+	// take the optimized code paths of the app_server
+	if (fIterations % 2 == 0) {
+		view->SetHighColor(fIterations % 256, 128, 255 - fIterations % 256);
+		view->FillRect(fViewBounds);
+	} else
+		view->FillRect(fViewBounds, gradient);
+
+	view->Sync();
+
+	fTestDuration += system_time() - now;
+	fPixelsFilled += fPixelsPerIteration;
+	fIterations++;
+
+	return fIterations < fMaxIterations;
+}
+
+
+void
+FillRectTest::PrintResults(BView* view)
+{
+	if (fTestDuration == 0) {
+		printf("Test was not run.\n");
+		return;
+	}
+	bigtime_t timeLeak = system_time() - fTestStart - fTestDuration;
+
+	Test::PrintResults(view);
+
+	printf("Rect size: %ldx%ld%s\n", fViewBounds.IntegerWidth() + 1,
+		fViewBounds.IntegerHeight() + 1,
+		fClipped ? " (checkerboard clipping)" : "");
+	printf("Total pixels filled: %llu\n", fPixelsFilled);
+	printf("Megapixels per second: %.3f\n",
+		fPixelsFilled * 1.0 / fTestDuration);
+	printf("Average time between iterations: %.4f seconds.\n",
+		(float)timeLeak / fIterations / 1000000);
+}
+
+
+Test*
+FillRectTest::CreateTest()
+{
+	return new FillRectTest();
+}
+
+
+Test*
+FillRectTest::CreateClippedTest()
+{
+	return new FillRectTest(true);
+}
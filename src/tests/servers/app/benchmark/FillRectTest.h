@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef FILL_RECT_TEST_H
+#define FILL_RECT_TEST_H
+
+#include <Rect.h>
+
+#include "Test.h"
+
+class FillRectTest : public Test {
+public:
+								FillRectTest(bool clipped = false);
+	virtual						~FillRectTest();
+
+	virtual	void				Prepare(BView* view);
+	virtual	bool				RunIteration(BView* view);
+	virtual	void				PrintResults(BView* view);
+
+	static	Test*				CreateTest();
+	static	Test*				CreateClippedTest();
+
+private:
+	bigtime_t					fTestDuration;
+	bigtime_t					fTestStart;
+	uint64						fPixelsFilled;
+	uint64						fPixelsPerIteration;
+
+	uint32						fIterations;
+	uint32						fMaxIterations;
+
+	BRect						fViewBounds;
+	bool						fClipped;
+};
+
+#endif // FILL_RECT_TEST_H
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "PictureTest.h"
+
+#include <stdio.h>
+
+#include <Picture.h>
+#include <Polygon.h>
+#include <Shape.h>
+#include <View.h>
+
+
+// Size of a single picture, and of the grid the pictures are drawn in. The
+// grid extends well beyond the view, like a long list that is scrolled, so
+// most of the pictures are clipped away completely.
+static const float kPictureSize = 48;
+static const int32 kGridColumns = 16;
+static const int32 kGridRows = 64;
+
+
+PictureTest::PictureTest()
+	: Test(),
+	  fTestDuration(0),
+	  fTestStart(-1),
+
+	  fPicturesDrawn(0),
+	  fPicturesVisible(0),
+
+	  fIterations(0),
+	  fMaxIterations(200),
+
+	  fPicture(NULL),
+	  fViewBounds(0, 0, -1, -1)
+{
+}
+
+
+PictureTest::~PictureTest()
+{
+	delete fPicture;
+}
+
+
+void
+PictureTest::Prepare(BView* view)
+{
+	fViewBounds = view->Bounds();
+
+	_RecordPicture(view);
+
+	fTestDuration = 0;
+	fPicturesDrawn = 0;
+	fPicturesVisible = 0;
+	fIterations = 0;
+	fTestStart = system_time();
+}
+
+
+bool
+PictureTest::RunIteration(BView* view)
+{
+	bigtime_t now = system_time();
+
+	for (int32 row = 0; row < kGridRows; row++) {
+		for (int32 column = 0; column < kGridColumns; column++) {
+			BPoint where(column * kPictureSize, row * kPictureSize);
+			view->DrawPicture(fPicture, where);
+
+			if (fViewBounds.Intersects(BRect(where.x, where.y,
+					where.x + kPictureSize - 1, where.y + kPictureSize - 1))) {
+				fPicturesVisible++;
+			}
+		}
+	}
+	view->Sync();
+
+	fTestDuration += system_time() - now;
+	fPicturesDrawn += kGridRows * kGridColumns;
+	fIterations++;
+
+	return fIterations < fMaxIterations;
+}
+
+
+void
+PictureTest::PrintResults(BView* view)
+{
+	if (fTestDuration == 0) {
+		printf("Test was not run.\n");
+		return;
+	}
+	bigtime_t timeLeak = system_time() - fTestStart - fTestDuration;
+
+	Test::PrintResults(view);
+
+	printf("Pictures drawn: %llu (%llu visible)\n", fPicturesDrawn,
+		fPicturesVisible);
+	printf("Pictures per second: %.1f\n",
+		fPicturesDrawn * 1000000.0 / fTestDuration);
+	printf("Average time between iterations: %.4f seconds.\n",
+		(float)timeLeak / fIterations / 1000000);
+}
+
+
+Test*
+PictureTest::CreateTest()
+{
+	return new PictureTest();
+}
+
+
+void
+PictureTest::_RecordPicture(BView* view)
+{
+	delete fPicture;
+	fPicture = NULL;
+
+	view->PushState();
+	view->BeginPicture(new BPicture());
+
+	// a list item like icon: a shape, a polygon and a label
+	BShape shape;
+	shape.MoveTo(BPoint(4, 24));
+	shape.BezierTo(BPoint(4, 8), BPoint(20, 4), BPoint(24, 4));
+	shape.LineTo(BPoint(40, 20));
+	shape.BezierTo(BPoint(44, 28), BPoint(36, 40), BPoint(24, 40));
+	shape.Close();
+
+	view->SetHighColor(51, 102, 187);
+	view->MovePenTo(B_ORIGIN);
+	view->FillShape(&shape);
+	view->SetHighColor(0, 0, 0);
+	view->SetPenSize(2);
+	view->StrokeShape(&shape);
+
+	BPoint points[] = {
+		BPoint(28, 28), BPoint(44, 30), BPoint(40, 44), BPoint(30, 40)
+	};
+	BPolygon polygon(points, 4);
+	view->SetHighColor(220, 60, 40);
+	view->FillPolygon(&polygon);
+	view->SetPenSize(1);
+	view->StrokePolygon(&polygon);
+
+	view->SetFontSize(9);
+	view->DrawString("Item", BPoint(6, 46));
+
+	fPicture = view->EndPicture();
+	view->PopState();
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef PICTURE_TEST_H
+#define PICTURE_TEST_H
+
+#include <Rect.h>
+
+#include "Test.h"
+
+class BPicture;
+
+class PictureTest : public Test {
+public:
+								PictureTest();
+	virtual						~PictureTest();
+
+	virtual	void				Prepare(BView* view);
+	virtual	bool				RunIteration(BView* view);
+	virtual	void				PrintResults(BView* view);
+
+	static	Test*				CreateTest();
+
+private:
+			void				_RecordPicture(BView* view);
+
+	bigtime_t					fTestDuration;
+	bigtime_t					fTestStart;
+	uint64						fPicturesDrawn;
+	uint64						fPicturesVisible;
+
+	uint32						fIterations;
+	uint32						fMaxIterations;
+
+	BPicture*					fPicture;
+	BRect						fViewBounds;
+};
+
+#endif // PICTURE_TEST_H
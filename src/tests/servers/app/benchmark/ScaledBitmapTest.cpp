@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "ScaledBitmapTest.h"
+
+#include <stdio.h>
+
+#include <Bitmap.h>
+#include <View.h>
+
+
+ScaledBitmapTest::ScaledBitmapTest()
+	: Test(),
+	  fTestDuration(0),
+	  fTestStart(-1),
+
+	  fPixelsDrawn(0),
+
+	  fIterations(0),
+	  fMaxIterations(500),
+
+	  fBitmap(NULL),
+	  fViewBounds(0, 0, -1, -1)
+{
+}
+
+
+ScaledBitmapTest::~ScaledBitmapTest()
+{
+	delete fBitmap;
+}
+
+
+void
+ScaledBitmapTest::Prepare(BView* view)
+{
+	fViewBounds = view->Bounds();
+
+	// a small bitmap with a pattern that makes the filtering visible
+	delete fBitmap;
+	fBitmap = new BBitmap(BRect(0, 0, 127, 127), B_RGB32);
+	uint8* bits = (uint8*)fBitmap->Bits();
+	int32 bpr = fBitmap->BytesPerRow();
+	for (int32 y = 0; y < 128; y++) {
+		uint8* pixel = bits + y * bpr;
+		for (int32 x = 0; x < 128; x++) {
+			pixel[0] = x * 2;
+			pixel[1] = y * 2;
+			pixel[2] = ((x / 8 + y / 8) % 2) * 255;
+			pixel[3] = 255;
+			pixel += 4;
+		}
+	}
+
+	fTestDuration = 0;
+	fPixelsDrawn = 0;
+	fIterations = 0;
+	fTestStart = system_time();
+}
+
+
+bool
+ScaledBitmapTest::RunIteration(BView* view)
+{
+	bigtime_t now = system_time();
+
+	view->DrawBitmap(fBitmap, fBitmap->Bounds(), fViewBounds,
+		B_FILTER_BITMAP_BILINEAR);
+	view->Sync();
+
+	fTestDuration += system_time() - now;
+	fPixelsDrawn += (uint64)(fViewBounds.IntegerWidth() + 1)
+		* (fViewBounds.IntegerHeight() + 1);
+	fIterations++;
+
+	return fIterations < fMaxIterations;
+}
+
+
+void
+ScaledBitmapTest::PrintResults(BView* view)
+{
+	if (fTestDuration == 0) {
+		printf("Test was not run.\n");
+		return;
+	}
+	bigtime_t timeLeak = system_time() - fTestStart - fTestDuration;
+
+	Test::PrintResults(view);
+
+	printf("Bitmap scaled to: %ldx%ld\n", fViewBounds.IntegerWidth() + 1,
+		fViewBounds.IntegerHeight() + 1);
+	printf("Total pixels drawn: %llu\n", fPixelsDrawn);
+	printf("Megapixels per second: %.3f\n",
+		fPixelsDrawn * 1.0 / fTestDuration);
+	printf("Average time between iterations: %.4f seconds.\n",
+		(float)timeLeak / fIterations / 1000000);
+}
+
+
+Test*
+ScaledBitmapTest::CreateTest()
+{
+	return new ScaledBitmapTest();
+}
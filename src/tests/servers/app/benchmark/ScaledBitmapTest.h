@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef SCALED_BITMAP_TEST_H
+#define SCALED_BITMAP_TEST_H
+
+#include <Rect.h>
+
+#include "Test.h"
+
+class BBitmap;
+
+class ScaledBitmapTest : public Test {
+public:
+								ScaledBitmapTest();
+	virtual						~ScaledBitmapTest();
+
+	virtual	void				Prepare(BView* view);
+	virtual	bool				RunIteration(BView* view);
+	virtual	void				PrintResults(BView* view);
+
+	static	Test*				CreateTest();
+
+private:
+	bigtime_t					fTestDuration;
+	bigtime_t					fTestStart;
+	uint64						fPixelsDrawn;
+
+	uint32						fIterations;
+	uint32						fMaxIterations;
+
+	BBitmap*					fBitmap;
+	BRect						fViewBounds;
+};
+
+#endif // SCALED_BITMAP_TEST_H
@@ -7,13 +7,19 @@
 
 #include <stdio.h>
 
+#include <Font.h>
 #include <String.h>
 #include <View.h>
 
 #include "TestSupport.h"
 
 
-StringTest::StringTest()
+static const float kMinMixedFontSize = 8.0;
+static const int32 kMixedFontSizeCount = 20;
+	// every size needs its own font cache entry
+
+
+StringTest::StringTest(bool mixedSizes)
 	: Test(),
 	  fTestDuration(0),
 	  fTestStart(-1),
@@ -23,7 +29,10 @@ StringTest::StringTest()
 	  fMaxIterations(1500),
 
 	  fStartHeight(11.0),
-	  fLineHeight(15.0)
+	  fLineHeight(15.0),
+
+	  fMixedSizes(mixedSizes),
+	  fFontSize(12.0)
 {
 }
 
@@ -38,6 +47,14 @@ StringTest::Prepare(BView* view)
 {
 //	SetupClipping(view);
 
+	BFont font;
+	view->GetFont(&font);
+	fFontSize = font.Size();
+	if (fMixedSizes) {
+		// lay out the lines for the largest size
+		view->SetFontSize(kMinMixedFontSize + kMixedFontSizeCount - 1);
+	}
+
 	font_height fh;
 	view->GetFontHeight(&fh);
 	fLineHeight = ceilf(fh.ascent) + ceilf(fh.descent)
@@ -70,6 +87,8 @@ StringTest::RunIteration(BView* view)
 	char buffer[fGlyphsPerLine + 1];
 	buffer[fGlyphsPerLine] = 0;
 
+	int32 line = 0;
+
 	bigtime_t now = system_time();
 
 	while (true) {
@@ -77,6 +96,11 @@ StringTest::RunIteration(BView* view)
 		for (uint32 j = 0; j < fGlyphsPerLine; j++)
 			buffer[j] = 'A' + rand() % ('z' - 'A');
 
+		if (fMixedSizes) {
+			view->SetFontSize(kMinMixedFontSize
+				+ (fIterations + line++) % kMixedFontSizeCount);
+		}
+
 		view->DrawString(buffer, textLocation);
 
 		fGlyphsRendered += fGlyphsPerLine;
@@ -92,6 +116,9 @@ StringTest::RunIteration(BView* view)
 	fTestDuration += system_time() - now;
 	fIterations++;
 
+	if (fMixedSizes)
+		view->SetFontSize(fFontSize);
+
 	return fIterations < fMaxIterations;
 }
 
@@ -108,6 +135,10 @@ StringTest::PrintResults(BView* view)
 	Test::PrintResults(view);
 
 	printf("Glyphs per DrawString() call: %ld\n", fGlyphsPerLine);
+	if (fMixedSizes) {
+		printf("Font sizes: %.0f - %.0f\n", kMinMixedFontSize,
+			kMinMixedFontSize + kMixedFontSizeCount - 1);
+	}
 	printf("Glyphs per second: %.3f\n",
 		fGlyphsRendered * 1000000.0 / fTestDuration);
 	printf("Average time between iterations: %.4f seconds.\n",
@@ -121,3 +152,9 @@ StringTest::CreateTest()
 	return new StringTest();
 }
 
+
+Test*
+StringTest::CreateMixedSizeTest()
+{
+	return new StringTest(true);
+}
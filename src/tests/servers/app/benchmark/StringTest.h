@@ -11,7 +11,7 @@
 
 class StringTest : public Test {
 public:
-								StringTest();
+								StringTest(bool mixedSizes = false);
 	virtual						~StringTest();
 
 	virtual	void				Prepare(BView* view);
@@ -19,6 +19,7 @@ public:
 	virtual	void				PrintResults(BView* view);
 
 	static	Test*				CreateTest();
+	static	Test*				CreateMixedSizeTest();
 
 private:
 	bigtime_t					fTestDuration;
@@ -31,6 +32,9 @@ private:
 	float						fStartHeight;
 	float						fLineHeight;
 	BRect						fViewBounds;
+
+	bool						fMixedSizes;
+	float						fFontSize;
 };
 
 #endif // STRING_TEST_H
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how long moving and resizing windows takes while other windows
+	are busy drawing. Moving or resizing a window needs the Desktop's window
+	lock for writing, which the drawing windows hold for reading while they
+	process their drawing commands.
+
+	The number of drawing windows can be given, the default is 3.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Application.h>
+#include <OS.h>
+#include <View.h>
+#include <Window.h>
+
+
+static const int32 kIterations = 200;
+
+
+class DrawingView : public BView {
+public:
+	DrawingView(BRect frame)
+		:
+		BView(frame, "drawing", B_FOLLOW_ALL, B_WILL_DRAW)
+	{
+	}
+
+	void DrawLots()
+	{
+		BRect bounds = Bounds();
+		for (int32 i = 0; i < 2000; i++) {
+			SetHighColor(rand() % 255, rand() % 255, rand() % 255);
+			BPoint a(rand() % (int32)bounds.Width(),
+				rand() % (int32)bounds.Height());
+			BPoint b(rand() % (int32)bounds.Width(),
+				rand() % (int32)bounds.Height());
+			if (i % 4 == 0)
+				FillRect(BRect(a, b));
+			else
+				StrokeLine(a, b);
+		}
+		Sync();
+	}
+};
+
+
+class LatencyApplication : public BApplication {
+public:
+	LatencyApplication(int32 drawingWindows)
+		:
+		BApplication("application/x-vnd.Haiku-MoveResizeLatency"),
+		fDrawingWindowCount(drawingWindows),
+		fQuitting(false)
+	{
+	}
+
+	virtual void ReadyToRun()
+	{
+		for (int32 i = 0; i < fDrawingWindowCount; i++) {
+			BRect frame(50 + i * 40, 50 + i * 40, 449 + i * 40, 349 + i * 40);
+			BWindow* window = new BWindow(frame, "Drawing",
+				B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+			DrawingView* view = new DrawingView(window->Bounds());
+			window->AddChild(view);
+			window->Show();
+
+			thread_id thread = spawn_thread(&_DrawingThread, "drawing",
+				B_NORMAL_PRIORITY, view);
+			resume_thread(thread);
+		}
+
+		fWindow = new BWindow(BRect(500, 100, 699, 249), "Moving",
+			B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+		fWindow->AddChild(new BView(fWindow->Bounds(), "view",
+			B_FOLLOW_ALL, B_WILL_DRAW));
+		fWindow->Show();
+
+		thread_id thread = spawn_thread(&_MeasureThread, "measure",
+			B_NORMAL_PRIORITY, this);
+		resume_thread(thread);
+	}
+
+private:
+	static status_t _DrawingThread(void* data)
+	{
+		DrawingView* view = (DrawingView*)data;
+		LatencyApplication* app = (LatencyApplication*)be_app;
+
+		while (!app->fQuitting) {
+			if (!view->LockLooper())
+				break;
+			view->DrawLots();
+			view->UnlockLooper();
+		}
+		return B_OK;
+	}
+
+	static status_t _MeasureThread(void* data)
+	{
+		LatencyApplication* app = (LatencyApplication*)data;
+		BWindow* window = app->fWindow;
+
+		// give the drawing windows some time to get busy
+		snooze(500000);
+
+		printf("%" B_PRId32 " drawing windows:\n", app->fDrawingWindowCount);
+
+		bigtime_t total = 0;
+		bigtime_t maximum = 0;
+		for (int32 i = 0; i < kIterations; i++) {
+			bigtime_t start = system_time();
+			window->MoveTo(500 + (i % 20) * 5, 100 + (i % 10) * 5);
+			bigtime_t latency = system_time() - start;
+			total += latency;
+			maximum = max_c(maximum, latency);
+			snooze(5000);
+		}
+		_PrintResult("Move", total, maximum);
+
+		total = 0;
+		maximum = 0;
+		for (int32 i = 0; i < kIterations; i++) {
+			bigtime_t start = system_time();
+			window->ResizeTo(200 + (i % 20) * 5, 150 + (i % 10) * 5);
+			bigtime_t latency = system_time() - start;
+			total += latency;
+			maximum = max_c(maximum, latency);
+			snooze(5000);
+		}
+		_PrintResult("Resize", total, maximum);
+
+		// let the drawing threads finish before their windows go away
+		app->fQuitting = true;
+		snooze(200000);
+		be_app->PostMessage(B_QUIT_REQUESTED);
+		return B_OK;
+	}
+
+	static void _PrintResult(const char* name, bigtime_t total,
+		bigtime_t maximum)
+	{
+		printf("  %-16s %10.1f us average, %8" B_PRId64 " us maximum\n", name,
+			(double)total / kIterations, maximum);
+	}
+
+private:
+	int32			fDrawingWindowCount;
+	BWindow*		fWindow;
+	volatile bool	fQuitting;
+};
+
+
+int
+main(int argc, char** argv)
+{
+	int32 drawingWindows = 3;
+	if (argc > 1)
+		drawingWindows = atol(argv[1]);
+
+	LatencyApplication app(drawingWindows);
+	app.Run();
+	return 0;
+}
@@ -6,6 +6,7 @@
 #include <TestSuite.h>
 #include <TestSuiteAddon.h>
 
+#include "DrawBitmapSSE2Test.h"
 #include "SimpleTransformTest.h"
 
 
@@ -14,6 +15,7 @@ getTestSuite()
 {
 	BTestSuite* suite = new BTestSuite("AppServerUnitTests");
 
+	DrawBitmapSSE2Test::AddTests(*suite);
 	SimpleTransformTest::AddTests(*suite);
 
 	return suite;
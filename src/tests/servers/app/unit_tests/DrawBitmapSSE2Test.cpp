@@ -0,0 +1,190 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "DrawBitmapSSE2Test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <GraphicsDefs.h>
+
+#include "DrawBitmapSSE2.h"
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+
+
+// The kernels must produce exactly the same pixels as the scalar versions in
+// DrawBitmapNoScale.h and DrawBitmapNearestNeighbor.h, which are repeated
+// here as reference.
+
+static const int32 kMaxPixels = 67;
+	// not a multiple of four, so the scalar tail is covered as well
+
+
+static void
+reference_alpha_row(uint8* dst, const uint8* src, int32 numPixels)
+{
+	while (numPixels--) {
+		if (src[3] == 255) {
+			*(uint32*)dst = *(uint32*)src;
+		} else {
+			dst[0] = ((src[0] - dst[0]) * src[3] + (dst[0] << 8)) >> 8;
+			dst[1] = ((src[1] - dst[1]) * src[3] + (dst[1] << 8)) >> 8;
+			dst[2] = ((src[2] - dst[2]) * src[3] + (dst[2] << 8)) >> 8;
+		}
+		dst += 4;
+		src += 4;
+	}
+}
+
+
+static void
+reference_over_row(uint8* dst, const uint8* src, int32 numPixels)
+{
+	uint32* d = (uint32*)dst;
+	const uint32* s = (const uint32*)src;
+	while (numPixels--) {
+		if (*s != B_TRANSPARENT_MAGIC_RGBA32)
+			*d = *s;
+		d++;
+		s++;
+	}
+}
+
+
+static void
+fill_random(uint8* buffer, int32 numPixels)
+{
+	for (int32 i = 0; i < numPixels * 4; i++)
+		buffer[i] = rand();
+}
+
+
+void
+DrawBitmapSSE2Test::AlphaRow()
+{
+#ifdef PAINTER_SSE2_KERNELS
+	uint8 source[kMaxPixels * 4];
+	uint8 expected[kMaxPixels * 4];
+	uint8 result[kMaxPixels * 4];
+
+	srand(42);
+	for (int32 i = 0; i < 10000; i++) {
+		int32 numPixels = i % (kMaxPixels + 1);
+		fill_random(source, numPixels);
+		fill_random(expected, numPixels);
+		memcpy(result, expected, numPixels * 4);
+
+		reference_alpha_row(expected, source, numPixels);
+		bgr32_alpha_row_sse2(result, source, numPixels);
+		CPPUNIT_ASSERT(memcmp(expected, result, numPixels * 4) == 0);
+	}
+#endif
+}
+
+
+void
+DrawBitmapSSE2Test::AlphaRowEdgeCases()
+{
+#ifdef PAINTER_SSE2_KERNELS
+	uint8 source[kMaxPixels * 4];
+	uint8 expected[kMaxPixels * 4];
+	uint8 result[kMaxPixels * 4];
+
+	// every alpha value against black, white and a semi-transparent
+	// destination
+	const uint32 destinations[] = { 0xff000000, 0xffffffff, 0x80ff8000 };
+	for (uint32 d = 0; d < sizeof(destinations) / sizeof(uint32); d++) {
+		for (int32 alpha = 0; alpha < 256; alpha += kMaxPixels) {
+			for (int32 i = 0; i < kMaxPixels; i++) {
+				uint8 value = min_c(alpha + i, 255);
+				((uint32*)source)[i] = (value << 24) | 0x00ff00ff;
+				((uint32*)expected)[i] = destinations[d];
+			}
+			memcpy(result, expected, sizeof(result));
+
+			reference_alpha_row(expected, source, kMaxPixels);
+			bgr32_alpha_row_sse2(result, source, kMaxPixels);
+			CPPUNIT_ASSERT(memcmp(expected, result, sizeof(result)) == 0);
+		}
+	}
+#endif
+}
+
+
+void
+DrawBitmapSSE2Test::OverRow()
+{
+#ifdef PAINTER_SSE2_KERNELS
+	uint8 source[kMaxPixels * 4];
+	uint8 expected[kMaxPixels * 4];
+	uint8 result[kMaxPixels * 4];
+
+	srand(42);
+	for (int32 i = 0; i < 1000; i++) {
+		int32 numPixels = i % (kMaxPixels + 1);
+		fill_random(source, numPixels);
+		for (int32 j = 0; j < numPixels; j++) {
+			if (rand() % 3 == 0)
+				((uint32*)source)[j] = B_TRANSPARENT_MAGIC_RGBA32;
+		}
+		fill_random(expected, numPixels);
+		memcpy(result, expected, numPixels * 4);
+
+		reference_over_row(expected, source, numPixels);
+		bgr32_over_row_sse2(result, source, numPixels);
+		CPPUNIT_ASSERT(memcmp(expected, result, numPixels * 4) == 0);
+	}
+#endif
+}
+
+
+void
+DrawBitmapSSE2Test::NearestNeighborRow()
+{
+#ifdef PAINTER_SSE2_KERNELS
+	uint8 source[kMaxPixels * 4];
+	uint16 xIndices[kMaxPixels * 2];
+	uint32 expected[kMaxPixels * 2];
+	uint32 result[kMaxPixels * 2];
+
+	srand(42);
+	fill_random(source, kMaxPixels);
+
+	for (int32 numPixels = 0; numPixels <= kMaxPixels * 2; numPixels++) {
+		// scale the source row up to numPixels pixels
+		for (int32 i = 0; i < numPixels; i++) {
+			xIndices[i] = i * kMaxPixels / numPixels * 4;
+			expected[i] = *(uint32*)(source + xIndices[i]);
+		}
+
+		bgr32_nearest_neighbor_row_sse2(result, source, xIndices, numPixels);
+		CPPUNIT_ASSERT(memcmp(expected, result, numPixels * 4) == 0);
+	}
+#endif
+}
+
+
+/* static */ void
+DrawBitmapSSE2Test::AddTests(BTestSuite& parent)
+{
+	CppUnit::TestSuite* suite = new CppUnit::TestSuite("DrawBitmapSSE2Test");
+
+	suite->addTest(new CppUnit::TestCaller<DrawBitmapSSE2Test>(
+		"DrawBitmapSSE2Test::AlphaRow",
+		&DrawBitmapSSE2Test::AlphaRow));
+	suite->addTest(new CppUnit::TestCaller<DrawBitmapSSE2Test>(
+		"DrawBitmapSSE2Test::AlphaRowEdgeCases",
+		&DrawBitmapSSE2Test::AlphaRowEdgeCases));
+	suite->addTest(new CppUnit::TestCaller<DrawBitmapSSE2Test>(
+		"DrawBitmapSSE2Test::OverRow",
+		&DrawBitmapSSE2Test::OverRow));
+	suite->addTest(new CppUnit::TestCaller<DrawBitmapSSE2Test>(
+		"DrawBitmapSSE2Test::NearestNeighborRow",
+		&DrawBitmapSSE2Test::NearestNeighborRow));
+
+	parent.addTest("DrawBitmapSSE2Test", suite);
+}
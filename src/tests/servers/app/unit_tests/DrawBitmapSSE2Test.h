@@ -0,0 +1,23 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef DRAW_BITMAP_SSE2_TEST_H
+#define DRAW_BITMAP_SSE2_TEST_H
+
+#include <TestCase.h>
+#include <TestSuite.h>
+
+
+class DrawBitmapSSE2Test : public BTestCase {
+public:
+	static	void			AddTests(BTestSuite& parent);
+
+			void			AlphaRow();
+			void			AlphaRowEdgeCases();
+			void			OverRow();
+			void			NearestNeighborRow();
+};
+
+
+#endif // DRAW_BITMAP_SSE2_TEST_H
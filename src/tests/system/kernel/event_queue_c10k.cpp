@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Compares how long it takes to find the few busy connections among many
+	idle ones with poll(), and with a BEventLoop. Every round, a byte is
+	written to a number of randomly chosen sockets, and the server side
+	waits until it has read all of them.
+
+	Usage: event_queue_c10k [connections] [active per round] [rounds]
+*/
+
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <EventLoop.h>
+#include <OS.h>
+
+
+struct Counter : BSupportKit::BEventListener {
+	int32	calls;
+	int32	object;
+	int32	events;
+
+	Counter()
+		:
+		calls(0),
+		object(-1),
+		events(0)
+	{
+	}
+
+	virtual void EventsReceived(BSupportKit::BEventLoop* loop, int32 _object,
+		uint16 type, int32 _events)
+	{
+		calls++;
+		object = _object;
+		events = _events;
+	}
+};
+
+
+struct Reader : BSupportKit::BEventListener {
+	int32	bytesRead;
+
+	Reader()
+		:
+		bytesRead(0)
+	{
+	}
+
+	virtual void EventsReceived(BSupportKit::BEventLoop* loop, int32 object,
+		uint16 type, int32 events)
+	{
+		// edge-triggered: read everything there is
+		char buffer[16];
+		ssize_t bytes;
+		while ((bytes = read(object, buffer, sizeof(buffer))) > 0)
+			bytesRead += bytes;
+	}
+};
+
+
+static void
+test_semantics()
+{
+	BSupportKit::BEventLoop loop;
+	assert(loop.InitCheck() == B_OK);
+
+	int fds[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+	Counter counter;
+	loop.WatchFile(fds[0], B_EVENT_READ, &counter);
+	assert(loop.Dispatch(0) == 0);
+
+	// edge-triggered: the event is reported once, even if the data is not
+	// read completely
+	write(fds[1], "ab", 2);
+	assert(loop.Dispatch(0) == 1 && counter.calls == 1
+		&& counter.object == fds[0] && (counter.events & B_EVENT_READ) != 0);
+	char byte;
+	read(fds[0], &byte, 1);
+	assert(loop.Dispatch(0) == 0 && counter.calls == 1);
+
+	write(fds[1], "c", 1);
+	assert(loop.Dispatch(0) == 1 && counter.calls == 2);
+
+	// level-triggered: reported for as long as there is data
+	loop.WatchFile(fds[0], B_EVENT_READ | B_EVENT_LEVEL_TRIGGERED, &counter);
+	assert(loop.Dispatch(0) == 1 && counter.calls == 3);
+	assert(loop.Dispatch(0) == 1 && counter.calls == 4);
+
+	// unwatched objects are not reported anymore
+	loop.UnwatchFile(fds[0]);
+	assert(loop.Dispatch(0) == 0 && counter.calls == 4);
+
+	// a closed descriptor is reported as invalid
+	loop.WatchFile(fds[0], B_EVENT_READ, &counter);
+	loop.ApplyChanges();
+	close(fds[0]);
+	assert(loop.Dispatch(0) >= 1
+		&& (counter.events & B_EVENT_INVALID) != 0);
+	close(fds[1]);
+
+	// watching something that does not exist fails
+	counter.events = 0;
+	loop.WatchFile(fds[0], B_EVENT_READ, &counter);
+	assert(loop.ApplyChanges() == B_ERROR
+		&& counter.events == B_EVENT_INVALID);
+
+	// ports and semaphores
+	port_id port = create_port(1, "event loop test");
+	Counter portCounter;
+	loop.Watch(port, B_OBJECT_TYPE_PORT, B_EVENT_READ, &portCounter);
+	sem_id semaphore = create_sem(0, "event loop test");
+	Counter semaphoreCounter;
+	loop.Watch(semaphore, B_OBJECT_TYPE_SEMAPHORE, B_EVENT_ACQUIRE_SEMAPHORE,
+		&semaphoreCounter);
+	assert(loop.Dispatch(0) == 0);
+
+	write_port(port, 1, NULL, 0);
+	release_sem(semaphore);
+	assert(loop.Dispatch(0) == 2 && portCounter.calls == 1
+		&& semaphoreCounter.calls == 1);
+
+	delete_port(port);
+	delete_sem(semaphore);
+
+	// Quit() ends Run()
+	loop.Quit();
+	assert(loop.Run() == B_OK);
+}
+
+
+static bigtime_t
+run_poll(const int* server, const int* client, int32 count, int32 active,
+	int32 rounds)
+{
+	pollfd* fds = new pollfd[count];
+	for (int32 i = 0; i < count; i++) {
+		fds[i].fd = server[i];
+		fds[i].events = POLLIN;
+	}
+
+	bigtime_t start = system_time();
+	for (int32 round = 0; round < rounds; round++) {
+		for (int32 i = 0; i < active; i++)
+			write(client[rand() % count], "x", 1);
+
+		int32 bytesRead = 0;
+		while (bytesRead < active) {
+			int ready = poll(fds, count, -1);
+			for (int32 i = 0; i < count && ready > 0; i++) {
+				if (fds[i].revents == 0)
+					continue;
+
+				ready--;
+				char buffer[16];
+				ssize_t bytes;
+				while ((bytes = read(fds[i].fd, buffer, sizeof(buffer))) > 0)
+					bytesRead += bytes;
+			}
+		}
+	}
+	bigtime_t time = system_time() - start;
+
+	delete[] fds;
+	return time;
+}
+
+
+static bigtime_t
+run_event_loop(const int* server, const int* client, int32 count,
+	int32 active, int32 rounds)
+{
+	BSupportKit::BEventLoop loop;
+	Reader reader;
+	for (int32 i = 0; i < count; i++)
+		loop.WatchFile(server[i], B_EVENT_READ, &reader);
+	loop.ApplyChanges();
+
+	bigtime_t start = system_time();
+	for (int32 round = 0; round < rounds; round++) {
+		for (int32 i = 0; i < active; i++)
+			write(client[rand() % count], "x", 1);
+
+		while (reader.bytesRead < (round + 1) * active)
+			loop.Dispatch();
+	}
+	return system_time() - start;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 count = 10000;
+	int32 active = 100;
+	int32 rounds = 1000;
+	if (argc > 1)
+		count = atol(argv[1]);
+	if (argc > 2)
+		active = atol(argv[2]);
+	if (argc > 3)
+		rounds = atol(argv[3]);
+
+	test_semantics();
+
+	rlimit limit = { (rlim_t)count * 2 + 64, (rlim_t)count * 2 + 64 };
+	setrlimit(RLIMIT_NOFILE, &limit);
+
+	int* server = new int[count];
+	int* client = new int[count];
+	for (int32 i = 0; i < count; i++) {
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+			fprintf(stderr, "Could only create %" B_PRId32 " connections: "
+				"%s\n", i, strerror(errno));
+			count = i;
+			break;
+		}
+		fcntl(fds[0], F_SETFL, O_NONBLOCK);
+		server[i] = fds[0];
+		client[i] = fds[1];
+	}
+
+	printf("%" B_PRId32 " connections, %" B_PRId32 " active per round:\n",
+		count, active);
+
+	bigtime_t time = run_poll(server, client, count, active, rounds);
+	printf("  poll()      %8.1f usecs per round\n", (double)time / rounds);
+	time = run_event_loop(server, client, count, active, rounds);
+	printf("  BEventLoop  %8.1f usecs per round\n", (double)time / rounds);
+
+	for (int32 i = 0; i < count; i++) {
+		close(server[i]);
+		close(client[i]);
+	}
+	delete[] server;
+	delete[] client;
+
+	return 0;
+}
@@ -0,0 +1,506 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Tests the answer cache of the resolver against a stub name server on the
+	loopback interface, as well as the parallel A/AAAA queries of
+	getaddrinfo() and BNetworkAddressResolver::ResolveAsync(), and measures
+	how long cached and uncached lookups take when the server answers with a
+	delay.
+
+	Usage: dns_cache_test [delay in ms]
+*/
+
+
+#undef NDEBUG
+
+#include <arpa/inet.h>
+#include <arpa/nameser.h>
+#include <assert.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <resolv.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Autolock.h>
+#include <Looper.h>
+#include <NetworkAddress.h>
+#include <NetworkAddressResolver.h>
+#include <OS.h>
+
+
+static const uint32 kTTL = 2;
+static const uint32 kNegativeTTL = 1;
+
+
+struct Server {
+	int				socket;
+	sockaddr_in		address;
+	bigtime_t		delay;
+	int32			queries;
+};
+
+struct Reply {
+	Server*			server;
+	u_char			packet[512];
+	size_t			length;
+	sockaddr_in		client;
+};
+
+
+/*!	Collects the message BNetworkAddressResolver::ResolveAsync() sends. */
+class ResultLooper : public BLooper {
+public:
+	ResultLooper()
+		:
+		BLooper("resolve result"),
+		fSemaphore(create_sem(0, "resolve result"))
+	{
+	}
+
+	virtual ~ResultLooper()
+	{
+		delete_sem(fSemaphore);
+	}
+
+	virtual void MessageReceived(BMessage* message)
+	{
+		if (message->what == B_NETWORK_ADDRESS_RESOLVED) {
+			fResult = *message;
+			release_sem(fSemaphore);
+		} else
+			BLooper::MessageReceived(message);
+	}
+
+	status_t WaitForResult(BMessage& result)
+	{
+		status_t status = acquire_sem_etc(fSemaphore, 1, B_RELATIVE_TIMEOUT,
+			10000000);
+		if (status != B_OK)
+			return status;
+
+		BAutolock locker(this);
+		result = fResult;
+		return B_OK;
+	}
+
+private:
+	sem_id			fSemaphore;
+	BMessage		fResult;
+};
+
+
+/*!	Sends a reply after the delay of its server, in a thread of its own, so
+	that the server can answer queries that arrive in the meantime.
+*/
+static void*
+reply_thread(void* data)
+{
+	Reply* reply = (Reply*)data;
+
+	snooze(reply->server->delay);
+	sendto(reply->server->socket, reply->packet, reply->length, 0,
+		(sockaddr*)&reply->client, sizeof(reply->client));
+
+	delete reply;
+	return NULL;
+}
+
+
+/*!	Answers queries for names starting with "missing" with NXDOMAIN, AAAA
+	queries with ::1, and all others with 127.0.0.1. Negative answers carry an
+	SOA record in their authority section, so that they may be cached.
+*/
+static void*
+server_thread(void* data)
+{
+	Server* server = (Server*)data;
+
+	while (true) {
+		u_char packet[512];
+		sockaddr_in client;
+		socklen_t clientLength = sizeof(client);
+		ssize_t length = recvfrom(server->socket, packet, sizeof(packet), 0,
+			(sockaddr*)&client, &clientLength);
+		if (length <= 0) {
+			// an empty datagram ends the test
+			break;
+		}
+		if (length < HFIXEDSZ)
+			continue;
+
+		atomic_add(&server->queries, 1);
+
+		// skip the question
+		u_char* end = packet + HFIXEDSZ;
+		while (end < packet + length && *end != 0)
+			end += *end + 1;
+		end += 1 + 2 * NS_INT16SZ;
+		if (end > packet + length)
+			continue;
+		uint16 type = ns_get16(end - 2 * NS_INT16SZ);
+
+		bool missing = strncmp((char*)packet + HFIXEDSZ + 1, "missing", 7)
+			== 0;
+
+		HEADER* header = (HEADER*)packet;
+		header->qr = 1;
+		header->ra = 1;
+		header->ancount = htons(missing ? 0 : 1);
+		header->nscount = htons(missing ? 1 : 0);
+		header->arcount = 0;
+		header->rcode = missing ? NXDOMAIN : NOERROR;
+
+		u_char* cp = end;
+		if (missing) {
+			// SOA for the root zone
+			*cp++ = 0;
+			NS_PUT16(T_SOA, cp);
+			NS_PUT16(C_IN, cp);
+			NS_PUT32(kNegativeTTL, cp);
+			NS_PUT16(2 + 5 * NS_INT32SZ, cp);
+			*cp++ = 0;
+			*cp++ = 0;
+			for (int i = 0; i < 5; i++)
+				NS_PUT32(kNegativeTTL, cp);
+		} else {
+			// pointer to the name in the question
+			*cp++ = 0xc0;
+			*cp++ = HFIXEDSZ;
+			if (type == T_AAAA) {
+				NS_PUT16(T_AAAA, cp);
+				NS_PUT16(C_IN, cp);
+				NS_PUT32(kTTL, cp);
+				NS_PUT16(NS_IN6ADDRSZ, cp);
+				memcpy(cp, &in6addr_loopback, NS_IN6ADDRSZ);
+				cp += NS_IN6ADDRSZ;
+			} else {
+				NS_PUT16(T_A, cp);
+				NS_PUT16(C_IN, cp);
+				NS_PUT32(kTTL, cp);
+				NS_PUT16(NS_INADDRSZ, cp);
+				in_addr_t address = htonl(INADDR_LOOPBACK);
+				memcpy(cp, &address, NS_INADDRSZ);
+				cp += NS_INADDRSZ;
+			}
+		}
+
+		if (server->delay == 0) {
+			sendto(server->socket, packet, cp - packet, 0, (sockaddr*)&client,
+				clientLength);
+			continue;
+		}
+
+		Reply* reply = new Reply;
+		reply->server = server;
+		memcpy(reply->packet, packet, cp - packet);
+		reply->length = cp - packet;
+		reply->client = client;
+
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &reply_thread, reply) == 0)
+			pthread_detach(thread);
+		else
+			delete reply;
+	}
+	return NULL;
+}
+
+
+/*!	Sets up a name server on the loopback interface, and starts answering
+	queries.
+*/
+static bool
+start_server(Server& server, pthread_t& thread)
+{
+	server.delay = 0;
+	server.queries = 0;
+
+	server.socket = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&server.address, 0, sizeof(server.address));
+	server.address.sin_len = sizeof(server.address);
+	server.address.sin_family = AF_INET;
+	server.address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addressLength = sizeof(server.address);
+	if (bind(server.socket, (sockaddr*)&server.address,
+			sizeof(server.address)) != 0
+		|| getsockname(server.socket, (sockaddr*)&server.address,
+			&addressLength) != 0) {
+		perror("Could not set up the name server");
+		return false;
+	}
+
+	return pthread_create(&thread, NULL, &server_thread, &server) == 0;
+}
+
+
+static void
+stop_server(Server& server, pthread_t thread)
+{
+	int stop = socket(AF_INET, SOCK_DGRAM, 0);
+	sendto(stop, NULL, 0, 0, (sockaddr*)&server.address,
+		sizeof(server.address));
+	close(stop);
+	pthread_join(thread, NULL);
+	close(server.socket);
+}
+
+
+/*!	Sends an A query for \a name, and returns the TTL of the first record of
+	the answer, or -1 if there is none.
+*/
+static int32
+query(res_state state, const char* name, int* rcode = NULL)
+{
+	u_char answer[512];
+	int length = res_nquery(state, name, C_IN, T_A, answer, sizeof(answer));
+	if (rcode != NULL)
+		*rcode = ((HEADER*)answer)->rcode;
+	if (length < 0)
+		return -1;
+
+	ns_msg message;
+	ns_rr rr;
+	if (ns_initparse(answer, length, &message) < 0
+		|| ns_parserr(&message, ns_s_an, 0, &rr) < 0)
+		return -1;
+
+	return ns_rr_ttl(rr);
+}
+
+
+static void
+test_semantics(Server& server, res_state state)
+{
+	// a repeated query is answered from the cache
+	int32 queries = server.queries;
+	assert(query(state, "cached.test") == (int32)kTTL);
+	assert(server.queries == queries + 1);
+	assert(query(state, "CACHED.test") == (int32)kTTL);
+	assert(server.queries == queries + 1);
+
+	// the TTL goes down while the answer is cached, and it expires
+	snooze(1100000);
+	assert(query(state, "cached.test") == (int32)kTTL - 1);
+	assert(server.queries == queries + 1);
+	snooze(1000000);
+	assert(query(state, "cached.test") == (int32)kTTL);
+	assert(server.queries == queries + 2);
+
+	// negative answers are cached for the time of their SOA record
+	int rcode;
+	queries = server.queries;
+	assert(query(state, "missing.test", &rcode) == -1);
+	assert(rcode == NXDOMAIN);
+	assert(query(state, "missing.test", &rcode) == -1);
+	assert(rcode == NXDOMAIN);
+	assert(server.queries == queries + 1);
+	snooze(kNegativeTTL * 1000000 + 100000);
+	assert(query(state, "missing.test") == -1);
+	assert(server.queries == queries + 2);
+
+	// the cache can be turned off
+	queries = server.queries;
+	state->options |= RES_NOCACHE;
+	assert(query(state, "uncached.test") == (int32)kTTL);
+	assert(query(state, "uncached.test") == (int32)kTTL);
+	assert(server.queries == queries + 2);
+	state->options &= ~RES_NOCACHE;
+}
+
+
+/*!	Rotating the name servers must not keep their answers from being found in
+	the cache.
+*/
+static void
+test_rotate(Server& server, Server& otherServer, res_state state)
+{
+	state->nsaddr_list[1] = otherServer.address;
+	state->nscount = 2;
+	state->options |= RES_ROTATE;
+
+	int32 queries = server.queries + otherServer.queries;
+	assert(query(state, "rotated.test") == (int32)kTTL);
+	assert(query(state, "rotated.test") == (int32)kTTL);
+	assert(query(state, "rotated.test") == (int32)kTTL);
+	assert(server.queries + otherServer.queries == queries + 1);
+
+	// another set of servers does not share the answers
+	state->nscount = 1;
+	state->options &= ~RES_ROTATE;
+	assert(query(state, "rotated.test") == (int32)kTTL);
+	assert(server.queries + otherServer.queries == queries + 2);
+}
+
+
+/*!	Lets getaddrinfo() ask \a server: it takes its resolver states from the
+	pool, and the helper threads of its parallel queries copy the name
+	servers of the state they were started from.
+*/
+static void
+use_server_for_getaddrinfo(Server& server)
+{
+	res_state state = __res_get_state();
+	assert(state != NULL);
+
+	union res_sockaddr_union address;
+	memset(&address, 0, sizeof(address));
+	address.sin = server.address;
+	res_setservers(state, &address, 1);
+	state->options &= ~(RES_DEFNAMES | RES_DNSRCH);
+
+	__res_put_state(state);
+}
+
+
+/*!	The AAAA and A queries of an AF_UNSPEC lookup are sent in parallel, so
+	that it takes about as long as one of them.
+*/
+static void
+test_parallel_queries(Server& server)
+{
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	int32 queries = server.queries;
+	server.delay = 200000;
+
+	addrinfo* info;
+	bigtime_t start = system_time();
+	assert(getaddrinfo("parallel.test", "80", &hints, &info) == 0);
+	bigtime_t time = system_time() - start;
+
+	server.delay = 0;
+	assert(server.queries == queries + 2);
+	assert(time < 3 * 200000 / 2);
+
+	bool foundIPv4 = false;
+	bool foundIPv6 = false;
+	for (addrinfo* current = info; current != NULL;
+			current = current->ai_next) {
+		if (current->ai_family == AF_INET) {
+			assert(((sockaddr_in*)current->ai_addr)->sin_addr.s_addr
+				== htonl(INADDR_LOOPBACK));
+			foundIPv4 = true;
+		} else if (current->ai_family == AF_INET6) {
+			assert(IN6_IS_ADDR_LOOPBACK(
+				&((sockaddr_in6*)current->ai_addr)->sin6_addr));
+			foundIPv6 = true;
+		}
+	}
+	assert(foundIPv4 && foundIPv6);
+	freeaddrinfo(info);
+
+	printf("parallel A/AAAA queries took %.2f ms for a 200 ms server delay\n",
+		time / 1000.0);
+}
+
+
+/*!	ResolveAsync() returns right away, and sends the addresses it found to
+	its target later.
+*/
+static void
+test_resolve_async(Server& server)
+{
+	ResultLooper* looper = new ResultLooper;
+	looper->Run();
+
+	int32 queries = server.queries;
+	server.delay = 200000;
+
+	bigtime_t start = system_time();
+	assert(BNetworkAddressResolver::ResolveAsync(AF_INET, "async.test",
+		(uint16)80, B_UNCONFIGURED_ADDRESS_FAMILIES,
+		BMessenger(NULL, looper)) == B_OK);
+	assert(system_time() - start < 200000);
+
+	BMessage result;
+	assert(looper->WaitForResult(result) == B_OK);
+	server.delay = 0;
+	assert(server.queries == queries + 1);
+
+	assert(result.GetInt32("status", B_ERROR) == B_OK);
+	assert(strcmp(result.GetString("name", ""), "async.test") == 0);
+	assert(strcmp(result.GetString("service", ""), "80") == 0);
+
+	BNetworkAddress address;
+	assert(result.FindFlat("address", &address) == B_OK);
+	assert(address == BNetworkAddress(INADDR_LOOPBACK, 80));
+
+	// a name that does not exist is reported as well
+	assert(BNetworkAddressResolver::ResolveAsync(AF_INET, "missing.async.test",
+		(uint16)80, B_UNCONFIGURED_ADDRESS_FAMILIES,
+		BMessenger(NULL, looper)) == B_OK);
+	assert(looper->WaitForResult(result) == B_OK);
+	assert(result.GetInt32("status", B_OK) != B_OK);
+	assert(!result.HasFlat("address", &address));
+
+	looper->Lock();
+	looper->Quit();
+}
+
+
+static bigtime_t
+time_query(res_state state, const char* name)
+{
+	bigtime_t start = system_time();
+	query(state, name);
+	return system_time() - start;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bigtime_t delay = 20000;
+	if (argc > 1)
+		delay = atol(argv[1]) * 1000;
+
+	Server server;
+	Server otherServer;
+	pthread_t thread;
+	pthread_t otherThread;
+	if (!start_server(server, thread)
+		|| !start_server(otherServer, otherThread))
+		return 1;
+
+	struct __res_state state;
+	memset(&state, 0, sizeof(state));
+	if (res_ninit(&state) != 0) {
+		fprintf(stderr, "Could not initialize the resolver\n");
+		return 1;
+	}
+	state.nsaddr_list[0] = server.address;
+	state.nscount = 1;
+	state.options &= ~(RES_DEFNAMES | RES_DNSRCH);
+
+	test_semantics(server, &state);
+	test_rotate(server, otherServer, &state);
+
+	use_server_for_getaddrinfo(server);
+	test_parallel_queries(server);
+	test_resolve_async(server);
+
+	server.delay = delay;
+	printf("%" B_PRIdBIGTIME " ms server delay:\n", server.delay / 1000);
+	printf("  uncached    %8.2f ms\n",
+		time_query(&state, "timed.test") / 1000.0);
+	printf("  cached      %8.2f ms\n",
+		time_query(&state, "timed.test") / 1000.0);
+
+	res_ndestroy(&state);
+
+	stop_server(server, thread);
+	stop_server(otherServer, otherThread);
+
+	return 0;
+}
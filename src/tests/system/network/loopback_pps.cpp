@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how many UDP packets per second can be sent over the loopback
+	interface, for a range of packet sizes. A second thread receives the
+	packets. The network buffer statistics of the stack show how many
+	buffers and data headers were needed per packet.
+
+	Usage: loopback_pps [seconds per size]
+*/
+
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/sockio.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+#include <net_stat.h>
+
+
+static const size_t kPacketSizes[] = { 16, 64, 512, 1024, 1472, 4096, 16384 };
+static const size_t kMaxPacketSize = 16384;
+
+static volatile bool sStop;
+static int64 sReceived;
+
+
+static void*
+receiver(void* data)
+{
+	int fd = *(int*)data;
+	char buffer[kMaxPacketSize];
+
+	while (!sStop) {
+		ssize_t bytes = recv(fd, buffer, sizeof(buffer), 0);
+		if (bytes < 0) {
+			if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+				continue;
+			break;
+		}
+		atomic_add64(&sReceived, 1);
+	}
+	return NULL;
+}
+
+
+static bool
+get_buffer_stats(int fd, net_buffer_stats& stats)
+{
+	return ioctl(fd, B_SOCKET_GET_BUFFER_STATS, &stats, sizeof(stats)) == 0;
+}
+
+
+static void
+run(size_t packetSize, bigtime_t duration)
+{
+	int receiveSocket = socket(AF_INET, SOCK_DGRAM, 0);
+	int sendSocket = socket(AF_INET, SOCK_DGRAM, 0);
+	if (receiveSocket < 0 || sendSocket < 0) {
+		perror("socket");
+		exit(1);
+	}
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+	if (bind(receiveSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("bind");
+		exit(1);
+	}
+
+	socklen_t addressLength = sizeof(address);
+	getsockname(receiveSocket, (sockaddr*)&address, &addressLength);
+	if (connect(sendSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("connect");
+		exit(1);
+	}
+
+	// don't let the receiver block forever once we stop sending
+	struct timeval timeout = { 0, 100000 };
+	setsockopt(receiveSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+		sizeof(timeout));
+
+	int bufferSize = 1024 * 1024;
+	setsockopt(receiveSocket, SOL_SOCKET, SO_RCVBUF, &bufferSize,
+		sizeof(bufferSize));
+
+	sStop = false;
+	sReceived = 0;
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &receiver, &receiveSocket);
+
+	net_buffer_stats before;
+	bool haveStats = get_buffer_stats(sendSocket, before);
+
+	char buffer[kMaxPacketSize];
+	memset(buffer, 0x55, sizeof(buffer));
+
+	int64 sent = 0;
+	bigtime_t start = system_time();
+	bigtime_t end = start + duration;
+	while (system_time() < end) {
+		for (int32 i = 0; i < 64; i++) {
+			if (send(sendSocket, buffer, packetSize, 0) >= 0)
+				sent++;
+		}
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	net_buffer_stats after;
+	haveStats = haveStats && get_buffer_stats(sendSocket, after);
+
+	sStop = true;
+	pthread_join(thread, NULL);
+
+	double seconds = elapsed / 1000000.0;
+	printf("%6zu bytes: %10.0f sent/s %10.0f received/s %8.1f MB/s",
+		packetSize, sent / seconds, sReceived / seconds,
+		sReceived * packetSize / seconds / (1024 * 1024));
+	if (haveStats && sent > 0) {
+		printf(", %.2f buffers, %.2f data headers per packet",
+			(double)(after.ever_allocated_net_buffers
+				- before.ever_allocated_net_buffers) / sent,
+			(double)(after.ever_allocated_data_headers
+				- before.ever_allocated_data_headers) / sent);
+	}
+	putchar('\n');
+
+	close(sendSocket);
+	close(receiveSocket);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bigtime_t duration = 2000000;
+	if (argc > 1)
+		duration = atol(argv[1]) * 1000000LL;
+
+	for (size_t i = 0; i < sizeof(kPacketSizes) / sizeof(kPacketSizes[0]);
+			i++) {
+		run(kPacketSizes[i], duration);
+	}
+
+	return 0;
+}
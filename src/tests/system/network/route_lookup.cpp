@@ -0,0 +1,386 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Checks the longest prefix matching of IPv4 and IPv6 routes, and that
+	sockets notice route changes, then measures route lookups per second with
+	a large routing table. The routes are added to the loopback interface,
+	and looked up directly, as well as by sending UDP datagrams along them,
+	once to the same destination, where the socket can keep its route, and
+	once to changing destinations.
+
+	Usage: route_lookup [number of routes] [lookups]
+*/
+
+
+#undef NDEBUG
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <net/if.h>
+#include <net/route.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/sockio.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+
+static const char* kInterface = "loop";
+
+
+static sockaddr_in
+make_address(in_addr_t address)
+{
+	sockaddr_in result;
+	memset(&result, 0, sizeof(result));
+	result.sin_len = sizeof(result);
+	result.sin_family = AF_INET;
+	result.sin_addr.s_addr = htonl(address);
+	return result;
+}
+
+
+static sockaddr_in6
+make_address6(const char* address)
+{
+	sockaddr_in6 result;
+	memset(&result, 0, sizeof(result));
+	result.sin6_len = sizeof(result);
+	result.sin6_family = AF_INET6;
+	inet_pton(AF_INET6, address, &result.sin6_addr);
+	return result;
+}
+
+
+static in_addr_t
+prefix_mask(int length)
+{
+	return length == 0 ? 0 : ~(in_addr_t)0 << (32 - length);
+}
+
+
+static sockaddr_in6
+prefix_mask6(int length)
+{
+	sockaddr_in6 mask = make_address6("::");
+	for (int i = 0; i < length; i++)
+		mask.sin6_addr.s6_addr[i / 8] |= 0x80 >> (i % 8);
+	return mask;
+}
+
+
+static bool
+control_route(int socket, int option, sockaddr* destination, sockaddr* mask,
+	uint32 flags)
+{
+	ifreq request;
+	memset(&request, 0, sizeof(request));
+	strlcpy(request.ifr_name, kInterface, IF_NAMESIZE);
+	request.ifr_route.destination = destination;
+	request.ifr_route.mask = mask;
+	request.ifr_route.flags = flags;
+
+	return ioctl(socket, option, &request, sizeof(request)) == 0;
+}
+
+
+static bool
+control_route(int socket, int option, in_addr_t destination, int length,
+	uint32 flags = 0)
+{
+	sockaddr_in address = make_address(destination);
+	sockaddr_in mask = make_address(prefix_mask(length));
+
+	return control_route(socket, option, (sockaddr*)&address,
+		length < 32 ? (sockaddr*)&mask : NULL,
+		(length < 32 ? 0 : RTF_HOST) | flags);
+}
+
+
+static bool
+control_route6(int socket, int option, const char* destination, int length)
+{
+	sockaddr_in6 address = make_address6(destination);
+	sockaddr_in6 mask = prefix_mask6(length);
+
+	return control_route(socket, option, (sockaddr*)&address,
+		length < 128 ? (sockaddr*)&mask : NULL, length < 128 ? 0 : RTF_HOST);
+}
+
+
+/*!	Returns the prefix length of the route to \a destination, or -1 if there
+	is none.
+*/
+static int
+route_prefix(int socket, const sockaddr* destination)
+{
+	union {
+		route_entry request;
+		uint8 buffer[512];
+	};
+	memset(&request, 0, sizeof(request));
+	request.destination = (sockaddr*)destination;
+
+	if (ioctl(socket, SIOCGETRT, buffer, sizeof(buffer)) != 0)
+		return -1;
+
+	int maxLength = 32;
+	const uint8* mask = NULL;
+	if (destination->sa_family == AF_INET6) {
+		maxLength = 128;
+		if (request.mask != NULL)
+			mask = ((sockaddr_in6*)request.mask)->sin6_addr.s6_addr;
+	} else if (request.mask != NULL)
+		mask = (const uint8*)&((sockaddr_in*)request.mask)->sin_addr;
+
+	if (mask == NULL)
+		return maxLength;
+
+	int length = 0;
+	while (length < maxLength
+		&& (mask[length / 8] & (0x80 >> (length % 8))) != 0)
+		length++;
+	return length;
+}
+
+
+static int
+route_prefix(int socket, in_addr_t destination)
+{
+	sockaddr_in address = make_address(destination);
+	return route_prefix(socket, (sockaddr*)&address);
+}
+
+
+static int
+route_prefix6(int socket, const char* destination)
+{
+	sockaddr_in6 address = make_address6(destination);
+	return route_prefix(socket, (sockaddr*)&address);
+}
+
+
+/*!	The bulk routes are /28 networks in 10.0.0.0/8, except for 10.200.0.0/16,
+	which is used to check the longest prefix matching.
+*/
+static in_addr_t
+bulk_route(int32 index)
+{
+	in_addr_t address = (10u << 24) + ((in_addr_t)index << 4);
+	if ((address >> 16) == ((10u << 8) | 200))
+		address += 1u << 16;
+	return address;
+}
+
+
+static void
+test_semantics(int socket)
+{
+	const in_addr_t network = (10u << 24) | (200u << 16);
+
+	assert(control_route(socket, SIOCADDRT, network, 16));
+	assert(control_route(socket, SIOCADDRT, network | (1 << 8), 24));
+	assert(control_route(socket, SIOCADDRT, network | (1 << 8) | 7, 32));
+
+	assert(route_prefix(socket, network | (2 << 8) | 1) == 16);
+	assert(route_prefix(socket, network | (1 << 8) | 1) == 24);
+	assert(route_prefix(socket, network | (1 << 8) | 7) == 32);
+
+	// adding the same route twice fails
+	assert(!control_route(socket, SIOCADDRT, network | (1 << 8), 24));
+	assert(errno == EEXIST);
+
+	// removing a route falls back to the next shorter prefix
+	assert(control_route(socket, SIOCDELRT, network | (1 << 8), 24));
+	assert(route_prefix(socket, network | (1 << 8) | 1) == 16);
+	assert(route_prefix(socket, network | (1 << 8) | 7) == 32);
+
+	assert(control_route(socket, SIOCDELRT, network | (1 << 8) | 7, 32));
+	assert(route_prefix(socket, network | (1 << 8) | 7) == 16);
+}
+
+
+static bool
+send_to(int socket, in_addr_t destination)
+{
+	sockaddr_in address = make_address(destination);
+	address.sin_port = htons(9);
+
+	char data[32] = {};
+	return sendto(socket, data, sizeof(data), 0, (sockaddr*)&address,
+		sizeof(address)) == (ssize_t)sizeof(data);
+}
+
+
+/*!	A socket must not keep sending along the route it used before, once the
+	routing changed. Uses the 10.200.0.0/16 route test_semantics() leaves
+	behind.
+*/
+static void
+test_route_cache(int socket)
+{
+	const in_addr_t network = (10u << 24) | (200u << 16);
+	const in_addr_t destination = network | (3 << 8) | 1;
+
+	int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+	assert(sender >= 0);
+	assert(send_to(sender, destination));
+
+	// a more specific route is used right away
+	assert(control_route(socket, SIOCADDRT, network | (3 << 8), 24,
+		RTF_REJECT));
+	assert(!send_to(sender, destination));
+	assert(errno == ENETUNREACH);
+
+	assert(control_route(socket, SIOCDELRT, network | (3 << 8), 24,
+		RTF_REJECT));
+	assert(send_to(sender, destination));
+
+	// a removed route is no longer used, unless there is a default route
+	// to fall back to
+	assert(control_route(socket, SIOCDELRT, network, 16));
+	if (route_prefix(socket, destination) < 0) {
+		assert(!send_to(sender, destination));
+		assert(errno == ENETUNREACH);
+	}
+	assert(control_route(socket, SIOCADDRT, network, 16));
+	assert(send_to(sender, destination));
+
+	close(sender);
+}
+
+
+/*!	IPv6 routes are matched by their longest prefix, too. */
+static void
+test_ipv6_semantics()
+{
+	int socket = ::socket(AF_INET6, SOCK_DGRAM, 0);
+	if (socket < 0) {
+		printf("IPv6 is not available, skipping its tests\n");
+		return;
+	}
+
+	assert(control_route6(socket, SIOCADDRT, "fd00:200::", 32));
+	assert(control_route6(socket, SIOCADDRT, "fd00:200:1::", 48));
+	assert(control_route6(socket, SIOCADDRT, "fd00:200:1::7", 128));
+
+	assert(route_prefix6(socket, "fd00:200:2::1") == 32);
+	assert(route_prefix6(socket, "fd00:200:1::1") == 48);
+	assert(route_prefix6(socket, "fd00:200:1::7") == 128);
+
+	assert(control_route6(socket, SIOCDELRT, "fd00:200:1::", 48));
+	assert(route_prefix6(socket, "fd00:200:1::1") == 32);
+	assert(route_prefix6(socket, "fd00:200:1::7") == 128);
+
+	assert(control_route6(socket, SIOCDELRT, "fd00:200:1::7", 128));
+	assert(control_route6(socket, SIOCDELRT, "fd00:200::", 32));
+	close(socket);
+}
+
+
+static double
+lookups_per_second(int socket, int32 routes, int32 lookups)
+{
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < lookups; i++) {
+		if (routes > 0)
+			route_prefix(socket, bulk_route((i * 7919) % routes) | 1);
+		else
+			route_prefix(socket, (10u << 24) | (200u << 16) | (i & 0xffff));
+	}
+	return lookups * 1000000.0 / (system_time() - start);
+}
+
+
+/*!	Sends \a count datagrams to addresses in 10.200.0.0/16. With \a changing
+	set, every datagram goes to another destination.
+*/
+static double
+sends_per_second(int32 count, bool changing)
+{
+	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket < 0)
+		return 0;
+
+	char data[32] = {};
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < count; i++) {
+		sockaddr_in address = make_address((10u << 24) | (200u << 16)
+			| (changing ? (i % 65000) + 1 : 1));
+		address.sin_port = htons(9);
+		sendto(socket, data, sizeof(data), 0, (sockaddr*)&address,
+			sizeof(address));
+	}
+	bigtime_t time = system_time() - start;
+
+	close(socket);
+	return count * 1000000.0 / time;
+}
+
+
+static void
+print_results(int socket, int32 routes, int32 lookups)
+{
+	printf("%8" B_PRId32 " routes:  %10.0f lookups/s  %10.0f sends/s  "
+		"%10.0f sends/s to changing destinations\n", routes,
+		lookups_per_second(socket, routes, lookups),
+		sends_per_second(lookups, false), sends_per_second(lookups, true));
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 count = 100000;
+	if (argc > 1)
+		count = atol(argv[1]);
+	int32 lookups = 100000;
+	if (argc > 2)
+		lookups = atol(argv[2]);
+
+	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	test_semantics(socket);
+	test_route_cache(socket);
+	test_ipv6_semantics();
+
+	// the datagrams are sent along the /16 route the test left behind
+	const in_addr_t network = (10u << 24) | (200u << 16);
+
+	print_results(socket, 0, lookups);
+
+	int32 added = 0;
+	for (; added < count; added++) {
+		if (!control_route(socket, SIOCADDRT, bulk_route(added), 28)) {
+			fprintf(stderr, "Could not add route %" B_PRId32 ": %s\n", added,
+				strerror(errno));
+			break;
+		}
+	}
+
+	if (added > 0)
+		assert(route_prefix(socket, bulk_route(added / 2) | 1) == 28);
+	assert(route_prefix(socket, network | 1) == 16);
+
+	print_results(socket, added, lookups);
+
+	for (int32 i = 0; i < added; i++)
+		control_route(socket, SIOCDELRT, bulk_route(i), 28);
+	control_route(socket, SIOCDELRT, network, 16);
+
+	close(socket);
+
+	return added == count ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures the throughput of a bulk TCP transfer over the loopback
+	interface with each congestion control algorithm. The loopback device
+	is told to delay and drop packets for the duration of the test, so that
+	it behaves like a long distance link.
+
+	Usage: tcp_bulk_transfer [delay in ms] [loss in percent] [size in MB]
+*/
+
+
+#undef NDEBUG
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/sockio.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+#include <loopback_control.h>
+
+
+static const size_t kChunkSize = 64 * 1024;
+static const char* kAlgorithms[] = { "newreno", "cubic" };
+
+
+static bool
+loopback_emulation_control(int option, loopback_emulation& emulation)
+{
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return false;
+
+	ifreq request;
+	memset(&request, 0, sizeof(request));
+	strlcpy(request.ifr_name, "loop", IF_NAMESIZE);
+	request.ifr_data = (uint8_t*)&emulation;
+
+	bool success = ioctl(fd, option, &request, sizeof(request)) == 0;
+	close(fd);
+	return success;
+}
+
+
+static void
+test_semantics()
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	char name[TCP_CA_NAME_MAX];
+	socklen_t length = sizeof(name);
+	assert(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length) == 0
+		&& strcmp(name, "newreno") == 0);
+
+	assert(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "cubic", 5) == 0);
+	length = sizeof(name);
+	assert(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length) == 0
+		&& strcmp(name, "cubic") == 0 && length == 6);
+
+	assert(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "unknown", 7) < 0
+		&& errno == ENOENT);
+	length = sizeof(name);
+	assert(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length) == 0
+		&& strcmp(name, "cubic") == 0);
+
+	// only the given length of the name is used
+	const char unterminated[] = { 'n', 'e', 'w', 'r', 'e', 'n', 'o', 'x' };
+	assert(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, unterminated, 7)
+		== 0);
+	length = sizeof(name);
+	assert(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length) == 0
+		&& strcmp(name, "newreno") == 0);
+
+	close(fd);
+
+	// the emulation settings are checked
+	loopback_emulation emulation = { LOOPBACK_MAX_DELAY + 1, 0 };
+	assert(!loopback_emulation_control(SIOCSDRVSPEC, emulation));
+	emulation.delay = 0;
+	emulation.loss = LOOPBACK_LOSS_SCALE + 1;
+	assert(!loopback_emulation_control(SIOCSDRVSPEC, emulation));
+}
+
+
+static void*
+drain(void* data)
+{
+	int socket = *(int*)data;
+	char* buffer = (char*)malloc(kChunkSize);
+	while (recv(socket, buffer, kChunkSize, 0) > 0)
+		;
+	free(buffer);
+	return NULL;
+}
+
+
+static void
+run(const char* algorithm, off_t size)
+{
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_len = sizeof(address);
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(listener, (sockaddr*)&address, sizeof(address));
+	listen(listener, 1);
+
+	socklen_t addressLength = sizeof(address);
+	getsockname(listener, (sockaddr*)&address, &addressLength);
+
+	int client = socket(AF_INET, SOCK_STREAM, 0);
+	assert(setsockopt(client, IPPROTO_TCP, TCP_CONGESTION, algorithm,
+		strlen(algorithm)) == 0);
+	if (connect(client, (sockaddr*)&address, sizeof(address)) != 0) {
+		perror("connect");
+		exit(1);
+	}
+	int server = accept(listener, NULL, NULL);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, &drain, &server);
+
+	char* buffer = (char*)malloc(kChunkSize);
+	memset(buffer, 0x55, kChunkSize);
+
+	bigtime_t start = system_time();
+	for (off_t sent = 0; sent < size; ) {
+		ssize_t bytesSent = send(client, buffer,
+			min_c(size - sent, (off_t)kChunkSize), 0);
+		if (bytesSent <= 0) {
+			perror("send");
+			break;
+		}
+		sent += bytesSent;
+	}
+
+	int sendBufferSize = 0;
+	socklen_t length = sizeof(sendBufferSize);
+	getsockopt(client, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, &length);
+	int receiveBufferSize = 0;
+	length = sizeof(receiveBufferSize);
+	getsockopt(server, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, &length);
+
+	shutdown(client, SHUT_WR);
+	pthread_join(thread, NULL);
+	bigtime_t time = system_time() - start;
+
+	printf("  %-8s %8.1f MB/s, send buffer %7d, receive buffer %7d bytes\n",
+		algorithm, size / (1024.0 * 1024) * 1000000 / time, sendBufferSize,
+		receiveBufferSize);
+
+	free(buffer);
+	close(client);
+	close(server);
+	close(listener);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	loopback_emulation emulation = { 20000, 0 };
+	if (argc > 1)
+		emulation.delay = atol(argv[1]) * 1000;
+	if (argc > 2)
+		emulation.loss = (uint32)(atof(argv[2]) * LOOPBACK_LOSS_SCALE / 100);
+	off_t size = 64;
+	if (argc > 3)
+		size = atol(argv[3]);
+	size *= 1024 * 1024;
+
+	loopback_emulation previous;
+	if (!loopback_emulation_control(SIOCGDRVSPEC, previous)) {
+		fprintf(stderr, "The loopback device cannot emulate a slower "
+			"network: %s\n", strerror(errno));
+		return 1;
+	}
+
+	test_semantics();
+
+	if (!loopback_emulation_control(SIOCSDRVSPEC, emulation)) {
+		fprintf(stderr, "Could not set up the loopback device: %s\n",
+			strerror(errno));
+		return 1;
+	}
+
+	printf("%" B_PRIu32 " ms round trip time, %g%% loss, %" B_PRIdOFF
+		" MB:\n", emulation.delay * 2 / 1000,
+		emulation.loss * 100.0 / LOOPBACK_LOSS_SCALE, size / (1024 * 1024));
+	for (size_t i = 0; i < sizeof(kAlgorithms) / sizeof(kAlgorithms[0]); i++)
+		run(kAlgorithms[i], size);
+
+	loopback_emulation_control(SIOCSDRVSPEC, previous);
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*!	Measures how many TCP connections per second can be opened and closed
+	over the loopback interface by several threads at once, while many idle
+	connections are kept open. Every connection needs an ephemeral port, and
+	every segment has to be matched to its connection.
+
+	Usage: tcp_connection_churn [threads] [idle connections] [seconds]
+*/
+
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <OS.h>
+
+
+static sockaddr_in sAddress;
+static volatile bool sStop;
+static int64 sConnections;
+static int64 sFailures;
+
+
+static void*
+acceptor(void* data)
+{
+	int listener = *(int*)data;
+
+	while (true) {
+		int fd = accept(listener, NULL, NULL);
+		if (fd < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		// echo a single byte, so that each connection carries some data
+		char byte;
+		if (recv(fd, &byte, 1, 0) == 1)
+			send(fd, &byte, 1, 0);
+		close(fd);
+	}
+	return NULL;
+}
+
+
+static void*
+churner(void* /*data*/)
+{
+	while (!sStop) {
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0) {
+			atomic_add64(&sFailures, 1);
+			continue;
+		}
+
+		// don't leave the port in TIME_WAIT, or we would soon run out of them
+		struct linger linger = { 1, 0 };
+		setsockopt(fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+
+		char byte = 'x';
+		if (connect(fd, (sockaddr*)&sAddress, sizeof(sAddress)) == 0
+			&& send(fd, &byte, 1, 0) == 1 && recv(fd, &byte, 1, 0) == 1) {
+			atomic_add64(&sConnections, 1);
+		} else
+			atomic_add64(&sFailures, 1);
+
+		close(fd);
+	}
+	return NULL;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 threadCount = 4;
+	int32 idleCount = 1000;
+	bigtime_t duration = 5000000;
+	if (argc > 1)
+		threadCount = atol(argv[1]);
+	if (argc > 2)
+		idleCount = atol(argv[2]);
+	if (argc > 3)
+		duration = atol(argv[3]) * 1000000LL;
+
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	memset(&sAddress, 0, sizeof(sAddress));
+	sAddress.sin_len = sizeof(sAddress);
+	sAddress.sin_family = AF_INET;
+	sAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(listener, (sockaddr*)&sAddress, sizeof(sAddress)) != 0
+		|| listen(listener, 1024) != 0) {
+		perror("listen");
+		return 1;
+	}
+
+	socklen_t addressLength = sizeof(sAddress);
+	getsockname(listener, (sockaddr*)&sAddress, &addressLength);
+
+	// the idle connections fill the connection and port tables
+	int idleListener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in idleAddress = sAddress;
+	idleAddress.sin_port = 0;
+	bind(idleListener, (sockaddr*)&idleAddress, sizeof(idleAddress));
+	listen(idleListener, 1024);
+	addressLength = sizeof(idleAddress);
+	getsockname(idleListener, (sockaddr*)&idleAddress, &addressLength);
+
+	int* idle = new int[idleCount * 2];
+	int32 opened = 0;
+	for (; opened < idleCount; opened++) {
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0
+			|| connect(fd, (sockaddr*)&idleAddress, sizeof(idleAddress))
+				!= 0) {
+			fprintf(stderr, "Could only open %" B_PRId32 " idle connections: "
+				"%s\n", opened, strerror(errno));
+			if (fd >= 0)
+				close(fd);
+			break;
+		}
+		idle[opened * 2] = fd;
+		idle[opened * 2 + 1] = accept(idleListener, NULL, NULL);
+	}
+
+	pthread_t acceptThread;
+	pthread_create(&acceptThread, NULL, &acceptor, &listener);
+
+	pthread_t* threads = new pthread_t[threadCount];
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < threadCount; i++)
+		pthread_create(&threads[i], NULL, &churner, NULL);
+
+	snooze(duration);
+	sStop = true;
+	for (int32 i = 0; i < threadCount; i++)
+		pthread_join(threads[i], NULL);
+	bigtime_t elapsed = system_time() - start;
+
+	printf("%" B_PRId32 " threads, %" B_PRId32 " idle connections: "
+		"%10.0f connections/s, %" B_PRId64 " failed\n", threadCount, opened,
+		sConnections / (elapsed / 1000000.0), sFailures);
+
+	shutdown(listener, SHUT_RDWR);
+	close(listener);
+	pthread_join(acceptThread, NULL);
+
+	for (int32 i = 0; i < opened * 2; i++)
+		close(idle[i]);
+	close(idleListener);
+
+	delete[] threads;
+	delete[] idle;
+	return 0;
+}
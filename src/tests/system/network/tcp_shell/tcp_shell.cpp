@@ -30,6 +30,7 @@
 
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/tcp.h>
 
 #include <ctype.h>
 #include <errno.h>
@@ -1706,6 +1707,37 @@ do_round_trip_time(int argc, char** argv)
 }
 
 
+static void
+do_congestion(int argc, char** argv)
+{
+	if (argc == 1) {
+		// show current algorithm
+		char name[TCP_CA_NAME_MAX];
+		int length = sizeof(name);
+		if (gTCPModule->getsockopt(gClientSocket->first_protocol, IPPROTO_TCP,
+				TCP_CONGESTION, name, &length) == B_OK)
+			printf("Congestion control: %s\n", name);
+	} else if (argc == 2 && argv[1][0] != '-') {
+		// set it on both ends; the accepted socket inherits it from the server
+		status_t status = gTCPModule->setsockopt(gClientSocket->first_protocol,
+			IPPROTO_TCP, TCP_CONGESTION, argv[1], strlen(argv[1]));
+		if (status == B_OK) {
+			status = gTCPModule->setsockopt(gServerSocket->first_protocol,
+				IPPROTO_TCP, TCP_CONGESTION, argv[1], strlen(argv[1]));
+		}
+		if (status != B_OK) {
+			fprintf(stderr, "Could not set congestion control \"%s\": %s\n",
+				argv[1], strerror(status));
+		}
+	} else {
+		// print usage
+		puts("usage: congestion [newreno|cubic]\n\n"
+			"Sets the congestion control algorithm of the client and the server;\n"
+			"without any arguments, the current algorithm is printed.");
+	}
+}
+
+
 static void
 do_dprintf(int argc, char** argv)
 {
@@ -1728,6 +1760,7 @@ static cmd_entry sBuiltinCommands[] = {
 	{"reorder", do_reorder, "Lets you reorder packets during transfer"},
 	{"help", do_help, "prints this help text"},
 	{"rtt", do_round_trip_time, "Specifies the round trip time"},
+	{"congestion", do_congestion, "Selects the congestion control algorithm"},
 	{"quit", NULL, "exits the application"},
 	{NULL, NULL, NULL},
 };